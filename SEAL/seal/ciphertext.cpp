@@ -1,10 +1,28 @@
 #include "seal/ciphertext.h"
+#include "seal/util/common.h"
+#include "seal/util/bitpack.h"
 
 using namespace std;
 using namespace seal::util;
 
 namespace seal
 {
+    namespace
+    {
+        // Written after the hash block in place of the size, which is never negative, to tell
+        // the current format from the one without flags, which is still loaded
+        constexpr int32_t flags_format_marker = -1;
+
+        // Version of the packed format, written after the flags
+        constexpr uint8_t packed_format_version = 1;
+
+        constexpr uint8_t ntt_form_flag = 1;
+
+        constexpr uint8_t seeded_flag = 2;
+
+        constexpr uint8_t packed_flag = 4;
+    }
+
     Ciphertext &Ciphertext::operator =(const Ciphertext &assign)
     {
         // Check for self-assignment
@@ -13,12 +31,17 @@ namespace seal
             return *this;
         }
 
-        // First copy over hash block
+        // First copy over hash block and NTT form flag
         hash_block_ = assign.hash_block_;
+        is_ntt_form_ = assign.is_ntt_form_;
 
         // Then resize
         resize(assign.size_, assign.poly_coeff_count_, assign.coeff_mod_count_);
 
+        // Resizing discards the seed, so copy it over only now
+        seed_ = assign.seed_;
+        seed_coeff_modulus_ = assign.seed_coeff_modulus_;
+
         // Size is guaranteed to be OK now so copy over
         // Note: set_uint_uint checks if the value pointers are equal and makes a copy only if they are not
         set_uint_uint(assign.ciphertext_array_.get(), size_ * poly_coeff_count_ * coeff_mod_count_, ciphertext_array_.get());
@@ -85,6 +108,7 @@ namespace seal
         Pointer new_allocation(allocate_uint(new_uint64_count, pool));
         set_uint_uint(ciphertext_array_.get(), copy_uint64_count, new_allocation.get());
         ciphertext_array_.acquire(new_allocation);
+        clear_seed();
 
         // Set the size and size_capacity
         size_capacity_ = size_capacity;
@@ -100,16 +124,92 @@ namespace seal
         }
     }
 
-    void Ciphertext::save(ostream &stream) const
+    void Ciphertext::save_header(ostream &stream, uint8_t flags) const
     {
         stream.write(reinterpret_cast<const char*>(&hash_block_), sizeof(EncryptionParameters::hash_block_type));
+        stream.write(reinterpret_cast<const char*>(&flags_format_marker), sizeof(int32_t));
+        stream.write(reinterpret_cast<const char*>(&flags), sizeof(uint8_t));
+        if (flags & packed_flag)
+        {
+            stream.write(reinterpret_cast<const char*>(&packed_format_version), sizeof(uint8_t));
+        }
         int32_t size32 = static_cast<int32_t>(size_);
         stream.write(reinterpret_cast<const char*>(&size32), sizeof(int32_t));
         int32_t poly_coeff_count32 = static_cast<int32_t>(poly_coeff_count_);
         stream.write(reinterpret_cast<const char*>(&poly_coeff_count32), sizeof(int32_t));
         int32_t coeff_mod_count32 = static_cast<int32_t>(coeff_mod_count_);
         stream.write(reinterpret_cast<const char*>(&coeff_mod_count32), sizeof(int32_t));
-        stream.write(reinterpret_cast<const char*>(ciphertext_array_.get()), size_ * poly_coeff_count_ * coeff_mod_count_ * bytes_per_uint64);
+    }
+
+    void Ciphertext::save(ostream &stream) const
+    {
+        if (!has_seed())
+        {
+            save_metadata(stream);
+            stream.write(reinterpret_cast<const char*>(ciphertext_array_.get()), size_ * poly_coeff_count_ * coeff_mod_count_ * bytes_per_uint64);
+            return;
+        }
+
+        // The lowest bit is the NTT form flag, and the next one is set if the polynomials with
+        // odd index are replaced by their seed
+        save_header(stream, (is_ntt_form_ ? ntt_form_flag : 0) | seeded_flag);
+        int poly_uint64_count = poly_coeff_count_ * coeff_mod_count_;
+        for (int i = 0; i < size_; i += 2)
+        {
+            stream.write(reinterpret_cast<const char*>(ciphertext_array_.get() + i * poly_uint64_count), poly_uint64_count * bytes_per_uint64);
+        }
+        stream.write(reinterpret_cast<const char*>(seed_.data()), seed_.size() * bytes_per_uint64);
+        stream.write(reinterpret_cast<const char*>(seed_coeff_modulus_.data()), coeff_mod_count_ * bytes_per_uint64);
+    }
+
+    void Ciphertext::save_metadata(ostream &stream) const
+    {
+        // The polynomials generated from a seed are part of the data that follows
+        save_header(stream, is_ntt_form_ ? ntt_form_flag : 0);
+    }
+
+    void Ciphertext::save_packed(ostream &stream) const
+    {
+        // The packed format version follows the flags
+        save_header(stream, (is_ntt_form_ ? ntt_form_flag : 0) | (has_seed() ? seeded_flag : 0) | packed_flag);
+
+        // Polynomials generated from a seed are not saved
+        int poly_step = has_seed() ? 2 : 1;
+        int poly_uint64_count = poly_coeff_count_ * coeff_mod_count_;
+
+        // Each component modulo a prime is stored with the bit count of its largest coefficient,
+        // which is at most the bit count of the prime
+        vector<uint8_t> bit_counts(coeff_mod_count_, 0);
+        for (int j = 0; j < coeff_mod_count_; j++)
+        {
+            uint64_t coeff_or = 0;
+            for (int i = 0; i < size_; i += poly_step)
+            {
+                const uint64_t *component = ciphertext_array_.get() + i * poly_uint64_count + j * poly_coeff_count_;
+                for (int k = 0; k < poly_coeff_count_; k++)
+                {
+                    coeff_or |= component[k];
+                }
+            }
+            bit_counts[j] = static_cast<uint8_t>(get_significant_bit_count(coeff_or));
+        }
+        stream.write(reinterpret_cast<const char*>(bit_counts.data()), coeff_mod_count_);
+
+        vector<uint64_t> packed(get_packed_uint64_count(poly_coeff_count_, bits_per_uint64));
+        for (int i = 0; i < size_; i += poly_step)
+        {
+            for (int j = 0; j < coeff_mod_count_; j++)
+            {
+                pack_uint64(ciphertext_array_.get() + i * poly_uint64_count + j * poly_coeff_count_,
+                    poly_coeff_count_, bit_counts[j], packed.data());
+                stream.write(reinterpret_cast<const char*>(packed.data()), get_packed_byte_count(poly_coeff_count_, bit_counts[j]));
+            }
+        }
+        if (has_seed())
+        {
+            stream.write(reinterpret_cast<const char*>(seed_.data()), seed_.size() * bytes_per_uint64);
+            stream.write(reinterpret_cast<const char*>(seed_coeff_modulus_.data()), coeff_mod_count_ * bytes_per_uint64);
+        }
     }
 
     void Ciphertext::python_save(std::string &path) const
@@ -121,19 +221,157 @@ namespace seal
 
     void Ciphertext::load(istream &stream)
     {
-        stream.read(reinterpret_cast<char*>(&hash_block_), sizeof(EncryptionParameters::hash_block_type));
+        load_deferred(stream);
+        if (has_seed())
+        {
+            expand_seed();
+        }
+    }
+
+    void Ciphertext::load_deferred(istream &stream)
+    {
+        EncryptionParameters::hash_block_type read_hash_block;
+        stream.read(reinterpret_cast<char*>(&read_hash_block), sizeof(EncryptionParameters::hash_block_type));
+
+        // Ciphertexts saved without flags are in coefficient form and have no seed
         int32_t read_size32 = 0;
         stream.read(reinterpret_cast<char*>(&read_size32), sizeof(int32_t));
+        uint8_t read_flags8 = 0;
+        if (read_size32 == flags_format_marker)
+        {
+            stream.read(reinterpret_cast<char*>(&read_flags8), sizeof(uint8_t));
+            if (read_flags8 & packed_flag)
+            {
+                uint8_t read_version8 = 0;
+                stream.read(reinterpret_cast<char*>(&read_version8), sizeof(uint8_t));
+                if (read_version8 != packed_format_version)
+                {
+                    throw invalid_argument("unsupported packed ciphertext version");
+                }
+            }
+            stream.read(reinterpret_cast<char*>(&read_size32), sizeof(int32_t));
+        }
+        bool is_seeded = (read_flags8 & seeded_flag) != 0;
+        bool is_packed = (read_flags8 & packed_flag) != 0;
         int32_t read_poly_coeff_count32 = 0;
         stream.read(reinterpret_cast<char*>(&read_poly_coeff_count32), sizeof(int32_t));
         int32_t read_coeff_mod_count32 = 0;
         stream.read(reinterpret_cast<char*>(&read_coeff_mod_count32), sizeof(int32_t));
+        if (read_size32 < 0 || read_poly_coeff_count32 < 0 || read_coeff_mod_count32 < 0)
+        {
+            throw invalid_argument("ciphertext has invalid size");
+        }
+        if (is_seeded && (read_size32 & 1))
+        {
+            throw invalid_argument("seeded ciphertext must have even size");
+        }
 
         // Resize
+        hash_block_ = read_hash_block;
+        is_ntt_form_ = (read_flags8 & ntt_form_flag) != 0;
         resize(read_size32, read_poly_coeff_count32, read_coeff_mod_count32);
 
-        // Read data
-        stream.read(reinterpret_cast<char*>(ciphertext_array_.get()), size_ * poly_coeff_count_ * coeff_mod_count_ * bytes_per_uint64);
+        // Read data; polynomials generated from a seed are not saved
+        int poly_step = is_seeded ? 2 : 1;
+        int poly_uint64_count = poly_coeff_count_ * coeff_mod_count_;
+        if (is_packed)
+        {
+            vector<uint8_t> bit_counts(coeff_mod_count_);
+            stream.read(reinterpret_cast<char*>(bit_counts.data()), coeff_mod_count_);
+            for (uint8_t bit_count : bit_counts)
+            {
+                if (bit_count > bits_per_uint64)
+                {
+                    throw invalid_argument("packed ciphertext has invalid bit count");
+                }
+            }
+            vector<uint64_t> packed(get_packed_uint64_count(poly_coeff_count_, bits_per_uint64));
+            for (int i = 0; i < size_; i += poly_step)
+            {
+                for (int j = 0; j < coeff_mod_count_; j++)
+                {
+                    // The last word may be read only partially
+                    int packed_uint64_count = get_packed_uint64_count(poly_coeff_count_, bit_counts[j]);
+                    if (packed_uint64_count > 0)
+                    {
+                        packed[packed_uint64_count - 1] = 0;
+                    }
+                    stream.read(reinterpret_cast<char*>(packed.data()), get_packed_byte_count(poly_coeff_count_, bit_counts[j]));
+                    unpack_uint64(packed.data(), poly_coeff_count_, bit_counts[j],
+                        ciphertext_array_.get() + i * poly_uint64_count + j * poly_coeff_count_);
+                }
+            }
+        }
+        else if (is_seeded)
+        {
+            for (int i = 0; i < size_; i += poly_step)
+            {
+                stream.read(reinterpret_cast<char*>(ciphertext_array_.get() + i * poly_uint64_count), poly_uint64_count * bytes_per_uint64);
+            }
+        }
+        else
+        {
+            stream.read(reinterpret_cast<char*>(ciphertext_array_.get()), size_ * poly_uint64_count * bytes_per_uint64);
+        }
+
+        if (is_seeded)
+        {
+            HashFunction::sha3_block_type read_seed;
+            stream.read(reinterpret_cast<char*>(read_seed.data()), read_seed.size() * bytes_per_uint64);
+            vector<uint64_t> read_coeff_modulus(coeff_mod_count_);
+            stream.read(reinterpret_cast<char*>(read_coeff_modulus.data()), coeff_mod_count_ * bytes_per_uint64);
+            for (uint64_t modulus : read_coeff_modulus)
+            {
+                if (modulus < 2)
+                {
+                    throw invalid_argument("seeded ciphertext has invalid coefficient modulus");
+                }
+            }
+            seed_ = read_seed;
+            seed_coeff_modulus_ = move(read_coeff_modulus);
+        }
+    }
+
+    void Ciphertext::generate_seed(const vector<SmallModulus> &coeff_modulus, UniformRandomGenerator *random)
+    {
+        for (auto &seed_word : seed_)
+        {
+            seed_word = static_cast<uint64_t>(random->generate());
+            seed_word = (seed_word << 32) | random->generate();
+        }
+        seed_coeff_modulus_.clear();
+        for (const SmallModulus &modulus : coeff_modulus)
+        {
+            seed_coeff_modulus_.push_back(modulus.value());
+        }
+        expand_seed();
+    }
+
+    void Ciphertext::expand_seed()
+    {
+        // Rejection sampling from words masked to the bit length of each modulus accepts at 
+        // least half of the words, and gives exactly uniform coefficients
+        Shake256Stream random(seed_.data(), static_cast<int>(seed_.size()));
+        int poly_uint64_count = poly_coeff_count_ * coeff_mod_count_;
+        for (int poly_index = 1; poly_index < size_; poly_index += 2)
+        {
+            uint64_t *destination = ciphertext_array_.get() + poly_index * poly_uint64_count;
+            for (uint64_t modulus : seed_coeff_modulus_)
+            {
+                int bit_count = get_significant_bit_count(modulus);
+                uint64_t mask = bit_count == bits_per_uint64 ? ~static_cast<uint64_t>(0) : (1ULL << bit_count) - 1;
+                for (int i = 0; i < poly_coeff_count_ - 1; i++)
+                {
+                    uint64_t value;
+                    do
+                    {
+                        value = random.generate() & mask;
+                    } while (value >= modulus);
+                    *destination++ = value;
+                }
+                *destination++ = 0;
+            }
+        }
     }
 
     void Ciphertext::python_load(std::string &path)
@@ -172,6 +410,9 @@ namespace seal
         int old_uint64_count = size_ * poly_coeff_count_ * coeff_mod_count_;
         int new_uint64_count = size * poly_coeff_count * coeff_mod_count;
 
+        // The ciphertext is about to be overwritten
+        clear_seed();
+
         if (is_alias() && new_uint64_count > old_capacity_uint64_count)
         {
             throw logic_error("cannot resize aliased Ciphertext");
@@ -3,9 +3,12 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include "seal/util/uintcore.h"
+#include "seal/util/hash.h"
 #include "seal/encryptionparams.h"
 #include "seal/memorypoolhandle.h"
+#include "seal/randomgen.h"
 
 namespace seal
 {
@@ -39,6 +42,13 @@ namespace seal
     an aliased ciphertext cannot be changed with the reserve function, unless it is first reallocated
     in a memory pool using the unalias function.
 
+    @par NTT Form
+    A ciphertext can be in the usual coefficient representation, or in NTT form where each
+    polynomial modulo each prime in the coefficient modulus has been transformed with the
+    Number Theoretic Transform. Whether a ciphertext is in NTT form is recorded in the
+    ciphertext itself, and is preserved by those Evaluator functions that support NTT form
+    inputs. Newly encrypted ciphertexts are never in NTT form.
+
     @par Thread Safety
     In general, reading from ciphertext is thread-safe as long as no other thread is concurrently
     mutating it. This is due to the underlying data structure storing the ciphertext not being
@@ -145,13 +155,16 @@ namespace seal
         Ciphertext(const Ciphertext &copy) :
             pool_(copy.pool_ ? copy.pool_ : MemoryPoolHandle::Global()),
             hash_block_(copy.hash_block_),
+            is_ntt_form_(copy.is_ntt_form_),
             size_capacity_(copy.size_capacity_),
             size_(copy.size_),
             poly_coeff_count_(copy.poly_coeff_count_),
             coeff_mod_count_(copy.coeff_mod_count_),
 
             // pool_ is guaranteed to be good at this point so allocate memory
-            ciphertext_array_(util::allocate_uint(size_capacity_ * poly_coeff_count_ * coeff_mod_count_, pool_))
+            ciphertext_array_(util::allocate_uint(size_capacity_ * poly_coeff_count_ * coeff_mod_count_, pool_)),
+            seed_(copy.seed_),
+            seed_coeff_modulus_(copy.seed_coeff_modulus_)
         {
             // Copy over value
             util::set_uint_uint(copy.ciphertext_array_.get(), size_ * poly_coeff_count_ * coeff_mod_count_,
@@ -216,6 +229,7 @@ namespace seal
 
             // Need to set hash block first
             hash_block_ = parms.hash_block();
+            clear_seed();
 
             size_capacity_ = size_capacity;
             size_ = size;
@@ -349,10 +363,12 @@ namespace seal
         {
             // C++11 compatibility
             hash_block_ = { { 0 } };
+            is_ntt_form_ = false;
             size_capacity_ = 2;
             size_ = 2;
             poly_coeff_count_ = 0;
             coeff_mod_count_ = 0;
+            clear_seed();
             ciphertext_array_.release();
         }
 
@@ -478,20 +494,74 @@ namespace seal
             return size_ * poly_coeff_count_ * coeff_mod_count_;
         }
 
+        /**
+        Returns whether the ciphertext is in NTT form.
+
+        @see Evaluator::transform_to_ntt() for transforming a ciphertext to NTT form.
+        */
+        inline bool is_ntt_form() const
+        {
+            return is_ntt_form_;
+        }
+
+        /**
+        Returns whether the polynomials of the ciphertext with odd index are generated from a
+        seed. This is the case for fresh symmetric encryptions, and for the components of
+        evaluation keys and Galois keys. Such a ciphertext is saved in a compact form consisting
+        of the polynomials with even index and the seed, which is expanded again when the
+        ciphertext is loaded. Any operation that modifies the ciphertext discards the seed.
+
+        @see Encryptor for symmetric encryption with a secret key.
+        @see KeyGenerator for generating evaluation keys and Galois keys.
+        */
+        inline bool has_seed() const
+        {
+            return !seed_coeff_modulus_.empty();
+        }
+
         /**
         Saves the ciphertext to an output stream. The output is in binary format and not 
-        human-readable. The output stream must have the "binary" flag set.
+        human-readable. The output stream must have the "binary" flag set. If the ciphertext
+        has a seed, only its polynomials with even index are written, together with the seed.
 
         @param[in] stream The stream to save the ciphertext to
         @see load() to load a saved ciphertext.
         */
         void save(std::ostream &stream) const;
+
+        /**
+        Saves the ciphertext to an output stream in a packed format. The coefficients modulo
+        each prime of the coefficient modulus are stored using only as many bits as the largest
+        of them needs, which is at most the bit count of the prime, instead of 64 bits each. For
+        primes of 30 to 60 bits this saves between 6 and 53 percent of the space. The output is
+        in binary format and not human-readable. The output stream must have the "binary" flag
+        set. The packed format carries a version number, and load() accepts both formats.
+
+        @param[in] stream The stream to save the ciphertext to
+        @see load() to load a saved ciphertext.
+        */
+        void save_packed(std::ostream &stream) const;
+
+        /**
+        Saves the metadata of the ciphertext to an output stream, which is everything that
+        save() writes except for the polynomial data. The metadata followed by the
+        uint64_count() words starting at pointer() is read by load() as the same ciphertext,
+        without its seed if it has one. This allows the polynomial data to be passed on
+        without copying it into the stream. The output stream must have the "binary" flag set.
+
+        @param[in] stream The stream to save the metadata to
+        @see save() to save the whole ciphertext.
+        */
+        void save_metadata(std::ostream &stream) const;
         void python_save(std::string &path) const;
         /**
-        Loads a ciphertext from an input stream overwriting the current ciphertext.
+        Loads a ciphertext from an input stream overwriting the current ciphertext. The
+        ciphertext can be saved either with save() or with save_packed().
 
         @param[in] stream The stream to load the ciphertext from
+        @throws std::invalid_argument if the ciphertext was saved in a newer packed format
         @see save() to save a ciphertext.
+        @see save_packed() to save a ciphertext in a packed format.
         */
         void load(std::istream &stream);
         void python_load(std::string &path);
@@ -516,6 +586,22 @@ namespace seal
 
         void resize(int size, int poly_coeff_count, int coeff_mod_count, const MemoryPoolHandle &pool);
 
+        // Samples a fresh seed, and generates the polynomials with odd index from it
+        void generate_seed(const std::vector<SmallModulus> &coeff_modulus,
+            UniformRandomGenerator *random);
+
+        // Fills the polynomials with odd index with coefficients uniformly distributed modulo
+        // each prime, generated deterministically from the seed; the last coefficients are zero
+        void expand_seed();
+
+        // Loads a ciphertext like load(), but leaves the polynomials generated from a seed to
+        // be filled in later by expand_seed()
+        void load_deferred(std::istream &stream);
+
+        // Writes the hash block, the format marker, the given flags and the dimensions that
+        // precede the polynomial data in every saved format
+        void save_header(std::ostream &stream, std::uint8_t flags) const;
+
         inline void resize(int size, int poly_coeff_count, int coeff_mod_count)
         {
             if (!is_alias() && !pool_)
@@ -565,14 +651,24 @@ namespace seal
             {
                 throw std::out_of_range("poly_index must be within [0, size)");
             }
+            clear_seed();
             util::set_zero_uint(poly_coeff_count_ * coeff_mod_count_, ciphertext_array_.get() + poly_index * poly_coeff_count_ * coeff_mod_count_);
         }
 
         inline void set_zero()
         {
+            clear_seed();
             util::set_zero_uint(size_ * poly_coeff_count_ * coeff_mod_count_, ciphertext_array_.get());
         }
 
+        // Discards the seed. Must be called before writing to a ciphertext that may have a seed,
+        // since the pointer accessors below have no side effects so that several threads can
+        // call them at once.
+        inline void clear_seed()
+        {
+            seed_coeff_modulus_.clear();
+        }
+
         inline std::uint64_t *mutable_pointer()
         {
             return ciphertext_array_.get();
@@ -618,6 +714,8 @@ namespace seal
 
         // C++11 compatibility
         EncryptionParameters::hash_block_type hash_block_{ { 0 } };
+
+        bool is_ntt_form_ = false;
         
         int size_capacity_ = 2;
 
@@ -629,6 +727,11 @@ namespace seal
 
         util::Pointer ciphertext_array_;
 
+        util::HashFunction::sha3_block_type seed_;
+
+        // The coefficient modulus needed to expand the seed, or empty if there is no seed
+        std::vector<std::uint64_t> seed_coeff_modulus_;
+
         friend class Decryptor;
 
         friend class Encryptor;
@@ -636,5 +739,11 @@ namespace seal
         friend class Evaluator;
 
         friend class KeyGenerator;
+
+        friend class EvaluationKeys;
+
+        friend class GaloisKeys;
+
+        friend class MappedArchive;
     };
 }
@@ -146,6 +146,17 @@ namespace seal
             return qualifiers_;
         }
 
+        if (multiply_method_ == MultiplyMethod::hps)
+        {
+            hps_converter_ = HPSConverter(parms_.coeff_modulus(), coeff_count, coeff_count_power, parms_.plain_modulus(), pool_);
+            if (!hps_converter_.is_generated())
+            {
+                // Parameters are not valid
+                qualifiers_.parameters_set = false;
+                return qualifiers_;
+            }
+        }
+
         // Check for plain_lift 
         // If all the small coefficient moduli are larger than plain modulus, we can quickly lift plain coefficients to RNS form
         qualifiers_.enable_fast_plain_lift = true;
@@ -162,7 +173,20 @@ namespace seal
     }
 
     SEALContext::SEALContext(const EncryptionParameters &parms, const MemoryPoolHandle &pool) :
-        pool_(pool), parms_(parms), base_converter_(pool_), plain_ntt_tables_(pool_) 
+        SEALContext(parms, MultiplyMethod::behz, pool, true)
+    {
+    }
+
+    SEALContext::SEALContext(const EncryptionParameters &parms, MultiplyMethod multiply_method, 
+        const MemoryPoolHandle &pool) :
+        SEALContext(parms, multiply_method, pool, true)
+    {
+    }
+
+    SEALContext::SEALContext(const EncryptionParameters &parms, MultiplyMethod multiply_method, 
+        const MemoryPoolHandle &pool, bool create_level_contexts) :
+        pool_(pool), parms_(parms), base_converter_(pool_), multiply_method_(multiply_method), 
+        hps_converter_(pool_), plain_ntt_tables_(pool_) 
     {
         if (!pool)
         {
@@ -179,5 +203,104 @@ namespace seal
         }
 
         qualifiers_ = validate();
+
+        // The contexts for the prefixes of the coefficient modulus are created on first use
+        if (create_level_contexts && qualifiers_.parameters_set)
+        {
+            level_contexts_ = make_shared<LevelContexts>(parms_, multiply_method_, pool_);
+        }
+    }
+
+    const SEALContext &SEALContext::level_context(int level) const
+    {
+        if (level < min_level() || level > max_level())
+        {
+            throw out_of_range("level must be within [min_level, max_level]");
+        }
+        if (level == max_level())
+        {
+            return *this;
+        }
+        return level_contexts_->context(level);
+    }
+
+    bool SEALContext::is_level_context_created(int level) const
+    {
+        if (level < min_level() || level > max_level())
+        {
+            throw out_of_range("level must be within [min_level, max_level]");
+        }
+        if (level == max_level())
+        {
+            return true;
+        }
+        return level_contexts_->is_created(level);
+    }
+
+    SEALContext::LevelContexts::LevelContexts(const EncryptionParameters &parms, MultiplyMethod multiply_method,
+        const MemoryPoolHandle &pool) : parms_(parms), multiply_method_(multiply_method), pool_(pool)
+    {
+        // Only the hash blocks are computed here. The levels go down to the shortest prefix of 
+        // the coefficient modulus whose product still exceeds the plain modulus.
+        EncryptionParameters level_parms(parms_);
+        vector<SmallModulus> level_coeff_modulus(parms_.coeff_modulus());
+        while (level_coeff_modulus.size() > 1)
+        {
+            level_coeff_modulus.pop_back();
+            int level = level_coeff_modulus.size();
+            Pointer level_product(allocate_uint(level, pool_));
+            Pointer tmp_product(allocate_uint(level, pool_));
+            set_uint(1, level, level_product.get());
+            for (int i = 0; i < level; i++)
+            {
+                multiply_uint_uint64(level_product.get(), level, level_coeff_modulus[i].value(), level, tmp_product.get());
+                set_uint_uint(tmp_product.get(), level, level_product.get());
+            }
+            if (!is_less_than_uint_uint(parms_.plain_modulus().pointer(), parms_.plain_modulus().uint64_count(), 
+                level_product.get(), level))
+            {
+                break;
+            }
+
+            level_parms.set_coeff_modulus(level_coeff_modulus);
+            levels_.emplace_back(new Level);
+            levels_.back()->hash_block = level_parms.hash_block();
+        }
+    }
+
+    int SEALContext::LevelContexts::level(const EncryptionParameters::hash_block_type &hash_block) const
+    {
+        int max_level = parms_.coeff_modulus().size();
+        for (int i = 0; i < static_cast<int>(levels_.size()); i++)
+        {
+            if (levels_[i]->hash_block == hash_block)
+            {
+                return max_level - 1 - i;
+            }
+        }
+        return 0;
+    }
+
+    const SEALContext &SEALContext::LevelContexts::context(int level)
+    {
+        Level &entry = *levels_[parms_.coeff_modulus().size() - 1 - level];
+        call_once(entry.create_flag, [&]() {
+            EncryptionParameters level_parms(parms_);
+            level_parms.set_coeff_modulus(vector<SmallModulus>(parms_.coeff_modulus().begin(),
+                parms_.coeff_modulus().begin() + level));
+            shared_ptr<const SEALContext> level_context(new SEALContext(level_parms, multiply_method_, pool_, false));
+            if (!level_context->qualifiers_.parameters_set)
+            {
+                throw logic_error("encryption parameters are not valid at this level");
+            }
+            entry.context = level_context;
+            entry.created = true;
+        });
+        return *entry.context;
+    }
+
+    bool SEALContext::LevelContexts::is_created(int level) const
+    {
+        return levels_[parms_.coeff_modulus().size() - 1 - level]->created;
     }
 }
@@ -4,11 +4,16 @@
 #include <utility>
 #include <string>
 #include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
 #include "seal/encryptionparams.h"
 #include "seal/biguint.h"
 #include "seal/bigpoly.h"
 #include "seal/randomgen.h"
 #include "seal/memorypoolhandle.h"
+#include "seal/threadpoolhandle.h"
 #include "seal/util/smallntt.h"
 #include "seal/util/baseconverter.h"
 
@@ -91,6 +96,27 @@ namespace seal
         friend class SEALContext;
     };
 
+    /**
+    Selects the RNS algorithm that Evaluator uses for multiplying and squaring ciphertexts.
+    
+    @par BEHZ
+    The method of Bajard, Eynard, Hasan, and Zucca extends the ciphertexts to an auxiliary base 
+    Bsk using fast base conversions with Montgomery reduction, and divides by the coefficient 
+    modulus with a fast floor followed by a Shenoy-Kumaresan conversion back. This is the default.
+
+    @par HPS
+    The method of Halevi, Polyakov, and Shoup extends the ciphertexts exactly to an auxiliary base
+    P, and performs the scaling and rounding with the help of double-precision floating-point
+    arithmetic directly in P before converting back. It needs fewer auxiliary primes and less 
+    work per coefficient, and is often faster. Which method is faster depends on the parameters
+    and the platform, so it is worth measuring both.
+    */
+    enum class MultiplyMethod
+    {
+        behz,
+        hps
+    };
+
     /**
     Performs sanity checks (validation) and pre-computations for a given set of encryption
     parameters. While the EncryptionParameters class is intended to be a light-weight class 
@@ -110,6 +136,17 @@ namespace seal
     were for some reason not appropriately set, the parameters_set flag will be false,
     and a new SEALContext will have to be created after the parameters are corrected.
 
+    @par Levels
+    Ciphertexts can be switched to smaller coefficient moduli with Evaluator::mod_switch_to_next
+    and Evaluator::mod_switch_to. The coefficient moduli available for this are the prefixes of
+    the coefficient modulus in the encryption parameters, i.e. the moduli obtained by dropping
+    primes from the end of the list. The number of primes in such a prefix is called its level,
+    so the level of a ciphertext is given by Ciphertext::coeff_mod_count(). The lowest level is
+    the shortest prefix whose product still exceeds the plain modulus. The SEALContext performs
+    the pre-computations for a lower level only when that level is first used, e.g. when a
+    ciphertext is switched down to it or decrypted at it, so that callers who never switch
+    the coefficient modulus do not pay for the lower levels.
+
     @see EncryptionParameters for more details on the parameters.
     @see EncryptionParameterQualifiers for more details on the qualifiers.
     */
@@ -129,6 +166,22 @@ namespace seal
         SEALContext(const EncryptionParameters &parms,
             const MemoryPoolHandle &pool = MemoryPoolHandle::Global());
 
+        /**
+        Creates an instance of SEALContext that uses a given multiplication method, and performs 
+        several pre-computations on the given EncryptionParameters. The results of the 
+        pre-computations are stored in allocations from the memory pool pointed to by the optionally
+        given MemoryPoolHandle. By default the global memory pool is used. The SEALContext instances
+        for the lower levels use the same multiplication method.
+
+        @param[in] parms The encryption parameters
+        @param[in] multiply_method The method used for multiplying ciphertexts
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if pool is uninitialized
+        @see MultiplyMethod for more details on the multiplication methods.
+        */
+        SEALContext(const EncryptionParameters &parms, MultiplyMethod multiply_method,
+            const MemoryPoolHandle &pool = MemoryPoolHandle::Global());
+
         /**
         Creates a new SEALContext instance by creating a deep copy of a given instance.
 
@@ -240,7 +293,81 @@ namespace seal
             return parms_.random_generator();
         }
 
+        /**
+        Returns the method that Evaluator instances created from this SEALContext use for
+        multiplying ciphertexts.
+        */
+        inline MultiplyMethod multiply_method() const
+        {
+            return multiply_method_;
+        }
+
+        /**
+        Returns the highest level, i.e. the number of primes in the coefficient modulus.
+        */
+        inline int max_level() const
+        {
+            return static_cast<int>(parms_.coeff_modulus().size());
+        }
+
+        /**
+        Returns the lowest level that ciphertexts can be switched down to.
+        */
+        inline int min_level() const
+        {
+            return level_contexts_ ? level_contexts_->min_level() : max_level();
+        }
+
+        /**
+        Returns the SEALContext for the encryption parameters at a given level. The encryption
+        parameters are the same as those of the current SEALContext, except that only the first
+        level many primes of the coefficient modulus are kept. For the highest level the current
+        SEALContext itself is returned. The SEALContext for a lower level is created on the first
+        call for that level and shared by all copies of the current SEALContext.
+
+        @param[in] level The level
+        @throws std::out_of_range if level is not between min_level() and max_level()
+        @throws std::logic_error if the encryption parameters are not valid at the given level
+        */
+        const SEALContext &level_context(int level) const;
+
+        /**
+        Returns whether the pre-computations for a given level have been performed, i.e. whether
+        the SEALContext for that level has been created. This is always true for the highest level.
+
+        @param[in] level The level
+        @throws std::out_of_range if level is not between min_level() and max_level()
+        */
+        bool is_level_context_created(int level) const;
+
+        /**
+        Returns the ThreadPoolHandle that Evaluator instances created from this SEALContext
+        use by default. The returned ThreadPoolHandle is uninitialized unless a thread pool
+        has been set with set_thread_pool(...).
+        */
+        inline const ThreadPoolHandle &thread_pool() const
+        {
+            return thread_pool_;
+        }
+
+        /**
+        Sets the thread pool that Evaluator instances created from this SEALContext use by
+        default to parallelize individual operations. Evaluator instances that have already
+        been created are not affected. Setting an uninitialized ThreadPoolHandle restores
+        the default sequential behavior.
+
+        @param[in] thread_pool The ThreadPoolHandle pointing to a thread pool
+        @see ThreadPoolHandle for more details on thread pools.
+        */
+        inline void set_thread_pool(const ThreadPoolHandle &thread_pool)
+        {
+            thread_pool_ = thread_pool;
+        }
+
     private:
+        SEALContext(const EncryptionParameters &parms, MultiplyMethod multiply_method, 
+            const MemoryPoolHandle &pool, bool create_level_contexts);
+
         EncryptionParameterQualifiers validate();
 
         MemoryPoolHandle pool_;
@@ -251,12 +378,66 @@ namespace seal
 
         util::BaseConverter base_converter_;
 
+        MultiplyMethod multiply_method_;
+
+        util::HPSConverter hps_converter_;
+
         std::vector<util::SmallNTTTables> small_ntt_tables_;
 
         util::SmallNTTTables plain_ntt_tables_;
 
         BigUInt total_coeff_modulus_;
 
+        ThreadPoolHandle thread_pool_;
+
+        // The SEALContext instances for the lower levels, created on first use. They are shared
+        // by the copies of a SEALContext and by the Evaluator and Decryptor instances created 
+        // from it, so that each level is pre-computed at most once.
+        class LevelContexts
+        {
+        public:
+            LevelContexts(const EncryptionParameters &parms, MultiplyMethod multiply_method,
+                const MemoryPoolHandle &pool);
+
+            inline int min_level() const
+            {
+                return static_cast<int>(parms_.coeff_modulus().size() - levels_.size());
+            }
+
+            // Returns the lower level whose encryption parameters have the given hash block,
+            // or 0 if there is none
+            int level(const EncryptionParameters::hash_block_type &hash_block) const;
+
+            // Returns the SEALContext for a lower level, creating it on the first call
+            const SEALContext &context(int level);
+
+            bool is_created(int level) const;
+
+        private:
+            struct Level
+            {
+                EncryptionParameters::hash_block_type hash_block;
+
+                std::once_flag create_flag;
+
+                std::atomic<bool> created{ false };
+
+                std::shared_ptr<const SEALContext> context;
+            };
+
+            EncryptionParameters parms_;
+
+            MultiplyMethod multiply_method_;
+
+            MemoryPoolHandle pool_;
+
+            // Levels from max_level() - 1 down to min_level()
+            std::vector<std::unique_ptr<Level> > levels_;
+        };
+
+        // Null for the contexts of the lower levels themselves
+        std::shared_ptr<LevelContexts> level_contexts_;
+
         friend class Decryptor;
 
         friend class Encryptor;
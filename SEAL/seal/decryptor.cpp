@@ -32,7 +32,34 @@ namespace seal
         {
             throw invalid_argument("pool is uninitialized");
         }
-        
+
+        initialize(context, secret_key.data().pointer());
+
+        // The Decryptors for the lower levels are created on first use
+        level_contexts_ = context.level_contexts_;
+        create_level_decryptors();
+    }
+
+    void Decryptor::create_level_decryptors()
+    {
+        if (level_contexts_)
+        {
+            int level_count = base_converter_.coeff_base_mod_count() - level_contexts_->min_level();
+            for (int i = 0; i < level_count; i++)
+            {
+                level_decryptors_.emplace_back(new LevelDecryptor);
+            }
+        }
+    }
+
+    Decryptor::Decryptor(const SEALContext &context, const uint64_t *secret_key, const MemoryPoolHandle &pool) :
+        pool_(pool), parms_(context.parms()), qualifiers_(context.qualifiers()), base_converter_(context.base_converter_)
+    {
+        initialize(context, secret_key);
+    }
+
+    void Decryptor::initialize(const SEALContext &context, const uint64_t *secret_key)
+    {
         int coeff_count = parms_.poly_modulus().coeff_count();
         int poly_coeff_uint64_count = parms_.poly_modulus().coeff_uint64_count();
         int coeff_mod_count = base_converter_.coeff_base_mod_count();
@@ -61,7 +88,7 @@ namespace seal
 
         // Allocate secret_key_ and copy over value
         secret_key_ = allocate_poly(coeff_count, coeff_mod_count, pool_);
-        set_poly_poly(secret_key.data().pointer(), coeff_count, coeff_mod_count, secret_key_.get());
+        set_poly_poly(secret_key, coeff_count, coeff_mod_count, secret_key_.get());
 
         // Set the secret_key_array to have size 1 (first power of secret) 
         secret_key_array_ = allocate_poly(coeff_count, coeff_mod_count, pool_);
@@ -106,10 +133,40 @@ namespace seal
         // Initialize moduli.
         mod_ = Modulus(product_modulus_.get(), coeff_mod_count);
         polymod_ = PolyModulus(parms_.poly_modulus().pointer(), coeff_count, poly_coeff_uint64_count);
+
+        // The Decryptors for the lower levels are created again on first use
+        level_contexts_ = copy.level_contexts_;
+        create_level_decryptors();
+    }
+
+    Decryptor *Decryptor::level_decryptor(const EncryptionParameters::hash_block_type &hash_block) const
+    {
+        if (hash_block == parms_.hash_block() || !level_contexts_)
+        {
+            return nullptr;
+        }
+        int level = level_contexts_->level(hash_block);
+        if (!level)
+        {
+            return nullptr;
+        }
+
+        // The secret key at a lower level consists of the first components of the secret key
+        LevelDecryptor &entry = *level_decryptors_[base_converter_.coeff_base_mod_count() - 1 - level];
+        call_once(entry.create_flag, [&]() {
+            entry.decryptor.reset(new Decryptor(level_contexts_->context(level), secret_key_.get(), pool_));
+        });
+        return entry.decryptor.get();
     }
 
     void Decryptor::decrypt(const Ciphertext &encrypted, Plaintext &destination, const MemoryPoolHandle &pool)
     {
+        if (Decryptor *decryptor = level_decryptor(encrypted.hash_block_))
+        {
+            decryptor->decrypt(encrypted, destination, pool);
+            return;
+        }
+
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = base_converter_.coeff_base_mod_count();
         int array_poly_uint64_count = coeff_count * coeff_mod_count;
@@ -160,7 +217,10 @@ namespace seal
                 set_uint_uint(current_array1, coeff_count, copy_operand1.get());
 
                 // Lazy reduction
-                ntt_negacyclic_harvey_lazy(copy_operand1.get(), small_ntt_tables_[i]);
+                if (!encrypted.is_ntt_form_)
+                {
+                    ntt_negacyclic_harvey_lazy(copy_operand1.get(), small_ntt_tables_[i]);
+                }
 
                 dyadic_product_coeffmod(copy_operand1.get(), current_array2, coeff_count, small_ntt_tables_[i].modulus(), copy_operand1.get());
                 add_poly_poly_coeffmod(tmp_dest_modq.get() + (i * coeff_count), copy_operand1.get(), coeff_count, small_ntt_tables_[i].modulus(), 
@@ -170,6 +230,13 @@ namespace seal
                 current_array2 += array_poly_uint64_count;
             }
 
+            // In NTT form c_0 is added before the inverse NTT
+            if (encrypted.is_ntt_form_)
+            {
+                add_poly_poly_coeffmod(tmp_dest_modq.get() + (i * coeff_count), encrypted.pointer() + (i * coeff_count),
+                    coeff_count, small_ntt_tables_[i].modulus(), tmp_dest_modq.get() + (i * coeff_count));
+            }
+
             // Perform inverse NTT
             inverse_ntt_negacyclic_harvey(tmp_dest_modq.get() + (i * coeff_count), small_ntt_tables_[i]);
         }
@@ -181,9 +248,12 @@ namespace seal
             //    coeff_count, coeff_modulus_[i], tmp_dest_modq.get() + (i * coeff_count));
 
             // Lazy reduction
-            for (int j = 0; j < coeff_count; j++)
+            if (!encrypted.is_ntt_form_)
             {
-                tmp_dest_modq[j + (i * coeff_count)] += encrypted[j + (i * coeff_count)];
+                for (int j = 0; j < coeff_count; j++)
+                {
+                    tmp_dest_modq[j + (i * coeff_count)] += encrypted[j + (i * coeff_count)];
+                }
             }
 
             // Compute |gamma * plain|qi * ct(s)
@@ -346,6 +416,11 @@ namespace seal
 
     int Decryptor::invariant_noise_budget(const Ciphertext &encrypted, const MemoryPoolHandle &pool)
     {
+        if (Decryptor *decryptor = level_decryptor(encrypted.hash_block_))
+        {
+            return decryptor->invariant_noise_budget(encrypted, pool);
+        }
+
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = parms_.coeff_modulus().size();
         int array_poly_uint64_count = coeff_count * coeff_mod_count;
@@ -395,7 +470,10 @@ namespace seal
                 set_uint_uint(current_array1, coeff_count, copy_operand1.get());
 
                 // Lazy reduction
-                ntt_negacyclic_harvey_lazy(copy_operand1.get(), small_ntt_tables_[i]);
+                if (!encrypted.is_ntt_form_)
+                {
+                    ntt_negacyclic_harvey_lazy(copy_operand1.get(), small_ntt_tables_[i]);
+                }
 
                 dyadic_product_coeffmod(copy_operand1.get(), current_array2, coeff_count, small_ntt_tables_[i].modulus(), copy_operand1.get());
                 add_poly_poly_coeffmod(noise_poly.get() + (i * coeff_count), copy_operand1.get(), coeff_count, small_ntt_tables_[i].modulus(),
@@ -405,6 +483,13 @@ namespace seal
                 current_array2 += array_poly_uint64_count;
             }
 
+            // In NTT form c_0 is added before the inverse NTT
+            if (encrypted.is_ntt_form_)
+            {
+                add_poly_poly_coeffmod(noise_poly.get() + (i * coeff_count), encrypted.pointer() + (i * coeff_count),
+                    coeff_count, small_ntt_tables_[i].modulus(), noise_poly.get() + (i * coeff_count));
+            }
+
             // Perform inverse NTT
             inverse_ntt_negacyclic_harvey(noise_poly.get() + (i * coeff_count), small_ntt_tables_[i]);
         }
@@ -412,8 +497,11 @@ namespace seal
         for (int i = 0; i < coeff_mod_count; i++)
         {
             // add c_0 into noise_poly
-            add_poly_poly_coeffmod(noise_poly.get() + (i * coeff_count), encrypted.pointer() + (i * coeff_count),
-                coeff_count, parms_.coeff_modulus()[i], noise_poly.get() + (i * coeff_count));
+            if (!encrypted.is_ntt_form_)
+            {
+                add_poly_poly_coeffmod(noise_poly.get() + (i * coeff_count), encrypted.pointer() + (i * coeff_count),
+                    coeff_count, parms_.coeff_modulus()[i], noise_poly.get() + (i * coeff_count));
+            }
 
             // Multiply by parms_.plain_modulus() and reduce mod parms_.coeff_modulus() to get parms_.coeff_modulus()*noise
             multiply_poly_scalar_coeffmod(noise_poly.get() + (i * coeff_count), coeff_count,
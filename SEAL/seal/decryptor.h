@@ -1,6 +1,8 @@
 #pragma once
 
 #include <utility>
+#include <vector>
+#include <memory>
 #include "seal/bigpolyarray.h"
 #include "seal/encryptionparams.h"
 #include "seal/context.h"
@@ -33,6 +35,11 @@ namespace seal
     Decryptor across any number of threads, but in each thread call the decrypt function
     by giving it a thread-local MemoryPoolHandle to use. It is important for a developer
     to understand how this works to avoid unnecessary performance bottlenecks.
+
+    @par Levels
+    The Decryptor can decrypt ciphertexts, and compute their invariant noise budget, at any
+    level that they have been switched down to with Evaluator::mod_switch_to_next or
+    Evaluator::mod_switch_to.
     */
     class Decryptor
     {
@@ -146,6 +153,16 @@ namespace seal
 
         Decryptor &operator =(Decryptor &&assign) = delete;
 
+        Decryptor(const SEALContext &context, const std::uint64_t *secret_key, const MemoryPoolHandle &pool);
+
+        void initialize(const SEALContext &context, const std::uint64_t *secret_key);
+
+        // Returns the Decryptor for the lower level that the given hash block belongs to, or
+        // nullptr if it belongs to no lower level
+        Decryptor *level_decryptor(const EncryptionParameters::hash_block_type &hash_block) const;
+
+        void create_level_decryptors();
+
         void compute_secret_key_array(int max_power);
 
         void compose(std::uint64_t *value);
@@ -175,5 +192,20 @@ namespace seal
         util::Pointer secret_key_array_;
 
         mutable util::ReaderWriterLocker secret_key_array_locker_;
+
+        // The contexts for the lower levels, shared with the SEALContext, or null if this 
+        // Decryptor is for a lower level
+        std::shared_ptr<SEALContext::LevelContexts> level_contexts_;
+
+        struct LevelDecryptor
+        {
+            std::once_flag create_flag;
+
+            std::shared_ptr<Decryptor> decryptor;
+        };
+
+        // Decryptors for the lower levels, from max level - 1 down to the lowest level, created
+        // on first use
+        std::vector<std::unique_ptr<LevelDecryptor> > level_decryptors_;
     };
 }
@@ -32,6 +32,43 @@ namespace seal
             throw invalid_argument("pool is uninitialized");
         }
 
+        initialize(context);
+
+        // Allocate space and copy over key
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = parms_.coeff_modulus().size();
+        public_key_ = allocate_poly(2 * coeff_count, coeff_mod_count, pool_);
+        set_poly_poly(public_key.data().pointer(0), 2 * coeff_count, coeff_mod_count, public_key_.get());
+    }
+
+    Encryptor::Encryptor(const SEALContext &context, const SecretKey &secret_key, const MemoryPoolHandle &pool) :
+        pool_(pool), parms_(context.parms()), qualifiers_(context.qualifiers())
+    {
+        // Verify parameters
+        if (!qualifiers_.parameters_set)
+        {
+            throw invalid_argument("encryption parameters are not valid");
+        }
+        if (secret_key.hash_block() != parms_.hash_block())
+        {
+            throw invalid_argument("secret key is not valid for encryption parameters");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        initialize(context);
+
+        // Allocate space and copy over key
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = parms_.coeff_modulus().size();
+        secret_key_ = allocate_poly(coeff_count, coeff_mod_count, pool_);
+        set_poly_poly(secret_key.data().pointer(), coeff_count, coeff_mod_count, secret_key_.get());
+    }
+
+    void Encryptor::initialize(const SEALContext &context)
+    {
         int coeff_count = parms_.poly_modulus().coeff_count();
         int poly_coeff_uint64_count = parms_.poly_modulus().coeff_uint64_count();
         int coeff_mod_count = parms_.coeff_modulus().size();
@@ -39,10 +76,6 @@ namespace seal
         // Set SmallNTTTables
         small_ntt_tables_.resize(coeff_mod_count, pool_);
         small_ntt_tables_ = context.small_ntt_tables_;
-        
-        // Allocate space and copy over key
-        public_key_ = allocate_poly(2 * coeff_count, coeff_mod_count, pool_);
-        set_poly_poly(public_key.data().pointer(0), 2 * coeff_count, coeff_mod_count, public_key_.get());
 
         // Calculate coeff_modulus / plain_modulus and upper_half_increment.
         coeff_div_plain_modulus_ = allocate_uint(coeff_mod_count, pool_);
@@ -95,6 +128,17 @@ namespace seal
 
         // Make destination have right size and hash block
         destination.resize(parms_, 2);
+        destination.is_ntt_form_ = false;
+
+        if (secret_key_.is_set())
+        {
+            // c_0 = Delta * m - (a * s + e) and c_1 = a, where a is expanded from a seed
+            unique_ptr<UniformRandomGenerator> random(parms_.random_generator()->create());
+            encrypt_zero_symmetric(destination, random.get(), pool);
+
+            preencrypt(plain.pointer(), plain.coeff_count(), destination.mutable_pointer());
+            return;
+        }
 
         /*
         Ciphertext (c_0,c_1) should be a BigPolyArray
@@ -140,6 +184,35 @@ namespace seal
         }
     }
 
+    void Encryptor::encrypt_zero_symmetric(Ciphertext &destination, UniformRandomGenerator *random, 
+        const MemoryPoolHandle &pool)
+    {
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = parms_.coeff_modulus().size();
+
+        // Sample a fresh 256-bit seed and expand it to c_1 = a; the seed stays valid until
+        // destination is modified
+        uint64_t *c0 = destination.mutable_pointer(0);
+        uint64_t *c1 = destination.mutable_pointer(1);
+        destination.generate_seed(parms_.coeff_modulus(), random);
+
+        // Compute c_0 = -(a * s + e)
+        Pointer noise(allocate_poly(coeff_count, coeff_mod_count, pool));
+        set_poly_coeffs_normal(noise.get(), random);
+        for (int i = 0; i < coeff_mod_count; i++)
+        {
+            uint64_t *c0_ptr = c0 + (i * coeff_count);
+            set_uint_uint(c1 + (i * coeff_count), coeff_count, c0_ptr);
+            ntt_negacyclic_harvey(c0_ptr, small_ntt_tables_[i]);
+            dyadic_product_coeffmod(c0_ptr, secret_key_.get() + (i * coeff_count), coeff_count, 
+                parms_.coeff_modulus()[i], c0_ptr);
+            inverse_ntt_negacyclic_harvey(c0_ptr, small_ntt_tables_[i]);
+            add_poly_poly_coeffmod(c0_ptr, noise.get() + (i * coeff_count), coeff_count, 
+                parms_.coeff_modulus()[i], c0_ptr);
+            negate_poly_coeffmod(c0_ptr, coeff_count, parms_.coeff_modulus()[i], c0_ptr);
+        }
+    }
+
     void Encryptor::preencrypt(const uint64_t *plain, int plain_coeff_count, uint64_t *destination)
     {
         int coeff_count = parms_.poly_modulus().coeff_count();
@@ -292,8 +365,16 @@ namespace seal
         coeff_div_plain_modulus_ = allocate_uint(coeff_uint64_count, pool_);
         set_uint_uint(copy.coeff_div_plain_modulus_.get(), coeff_uint64_count, coeff_div_plain_modulus_.get());
 
-        public_key_ = allocate_poly(2 * coeff_count, coeff_uint64_count, pool_);
-        set_poly_poly(copy.public_key_.get(), 2 * coeff_count, coeff_uint64_count, public_key_.get());
+        if (copy.public_key_.is_set())
+        {
+            public_key_ = allocate_poly(2 * coeff_count, coeff_uint64_count, pool_);
+            set_poly_poly(copy.public_key_.get(), 2 * coeff_count, coeff_uint64_count, public_key_.get());
+        }
+        if (copy.secret_key_.is_set())
+        {
+            secret_key_ = allocate_poly(coeff_count, coeff_uint64_count, pool_);
+            set_poly_poly(copy.secret_key_.get(), coeff_count, coeff_uint64_count, secret_key_.get());
+        }
 
         // Initialize moduli.
         polymod_ = PolyModulus(parms_.poly_modulus().pointer(), coeff_count, poly_coeff_uint64_count);
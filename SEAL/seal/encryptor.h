@@ -9,12 +9,22 @@
 #include "seal/context.h"
 #include "seal/util/smallntt.h"
 #include "seal/publickey.h"
+#include "seal/secretkey.h"
 
 namespace seal
 {
     /**
     Encrypts Plaintext objects into Ciphertext objects. Constructing an Encryptor requires
-    a SEALContext with valid encryption parameters, and the public key. 
+    a SEALContext with valid encryption parameters, and either the public key or the secret
+    key. 
+
+    @par Symmetric Encryption
+    An Encryptor constructed with the secret key encrypts without the public key. The second
+    polynomial of such a ciphertext is uniformly random, and is generated from a fresh 256-bit
+    seed by expanding it with SHAKE256. Until the ciphertext is modified it keeps the seed,
+    and is saved as its first polynomial and the seed, which takes only half of the space of
+    a ciphertext encrypted with the public key. This is useful when a client uploads data
+    to a server for computation. Loading the ciphertext expands the seed again.
 
     @par Overloads
     For the encrypt function we provide two overloads concerning the memory pool used in 
@@ -45,6 +55,21 @@ namespace seal
         Encryptor(const SEALContext &context, const PublicKey &public_key,
             const MemoryPoolHandle &pool = MemoryPoolHandle::Global());
 
+        /**
+        Creates an Encryptor instance for symmetric encryption initialized with the specified 
+        SEALContext and secret key. Dynamically allocated member variables are allocated from 
+        the memory pool pointed to by the given MemoryPoolHandle. By default the global memory
+        pool is used.
+
+        @param[in] context The SEALContext
+        @param[in] secret_key The secret key
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encryption parameters or secret key are not valid
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        Encryptor(const SEALContext &context, const SecretKey &secret_key,
+            const MemoryPoolHandle &pool = MemoryPoolHandle::Global());
+
         /**
         Creates a deep copy of a given Encryptor.
 
@@ -94,6 +119,12 @@ namespace seal
 
         Encryptor &operator =(Encryptor &&assign) = delete;
 
+        void initialize(const SEALContext &context);
+
+        // Sets destination to (-(a * s + e), a) where a is expanded from a fresh seed
+        void encrypt_zero_symmetric(Ciphertext &destination, UniformRandomGenerator *random, 
+            const MemoryPoolHandle &pool);
+
         void preencrypt(const std::uint64_t *plain, int plain_coeff_count, std::uint64_t *destination);
 
         void set_poly_coeffs_normal(std::uint64_t *poly, UniformRandomGenerator *random) const;
@@ -118,6 +149,9 @@ namespace seal
 
         util::Pointer public_key_;
 
+        // The secret key in NTT form if the Encryptor is symmetric, and unset otherwise
+        util::Pointer secret_key_;
+
         util::PolyModulus polymod_;
     };
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <stdexcept>
 
 using namespace std;
+using namespace seal::util;
 
 namespace seal
 {
@@ -35,6 +36,11 @@ namespace seal
     }
 
     void EvaluationKeys::load(std::istream &stream)
+    {
+        load(stream, ThreadPoolHandle());
+    }
+
+    void EvaluationKeys::load(std::istream &stream, const ThreadPoolHandle &thread_pool)
     {
         // Clear current keys
         keys_.clear();
@@ -65,8 +71,33 @@ namespace seal
             keys_[index].resize(keys_dim2);
             for (int32_t j = 0; j < keys_dim2; j++)
             {
-                keys_[index][j].load(stream);
+                keys_[index][j].load_deferred(stream);
+            }
+        }
+
+        // Generate the polynomials that were saved as seeds
+        vector<Ciphertext*> seeded_keys;
+        for (auto &key : keys_)
+        {
+            for (auto &key_component : key)
+            {
+                if (key_component.has_seed())
+                {
+                    seeded_keys.push_back(&key_component);
+                }
             }
         }
+        int seeded_key_count = static_cast<int>(seeded_keys.size());
+        if (thread_pool && seeded_key_count > 1)
+        {
+            static_cast<ThreadPool&>(thread_pool).parallel_for(seeded_key_count, [&](int index) {
+                seeded_keys[index]->expand_seed();
+            });
+            return;
+        }
+        for (Ciphertext *key_component : seeded_keys)
+        {
+            key_component->expand_seed();
+        }
     }
 }
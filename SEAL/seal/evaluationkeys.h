@@ -4,6 +4,7 @@
 #include <vector>
 #include "seal/ciphertext.h"
 #include "seal/encryptionparams.h"
+#include "seal/threadpoolhandle.h"
 
 namespace seal
 {
@@ -34,6 +35,15 @@ namespace seal
     would want to optimize the dbc to be as large as possible for performance. The dbc is 
     upper-bounded by the value of 60, and lower-bounded by the value of 1.
 
+    @par Compact Serialization
+    Each evaluation key is a list of ciphertexts that encrypt multiples of a power of the
+    secret key, and half of the polynomials in them are uniformly random. KeyGenerator
+    generates these from a seed for each ciphertext, so save() writes only the other half of
+    the polynomials together with the seeds, and load() generates the random polynomials
+    again. This halves the size of the saved keys. Most of the time spent loading goes into
+    generating the polynomials, which can be spread over several threads by passing a thread
+    pool to load().
+
     @par Thread Safety
     In general, reading from EvaluationKeys is thread-safe as long as no other thread is
     concurrently mutating it. This is due to the underlying data structure storing the 
@@ -159,6 +169,19 @@ namespace seal
         */
         void load(std::istream &stream);
 
+        /**
+        Loads an EvaluationKeys instance from an input stream overwriting the current EvaluationKeys
+        instance. The polynomials that were saved in the form of a seed are generated in
+        parallel using the given thread pool.
+
+        @param[in] stream The stream to load the EvaluationKeys instance from
+        @param[in] thread_pool The ThreadPoolHandle pointing to a thread pool, or an
+        uninitialized ThreadPoolHandle to load sequentially
+        @see save() to save an EvaluationKeys instance.
+        @see ThreadPoolHandle for more details on thread pools.
+        */
+        void load(std::istream &stream, const ThreadPoolHandle &thread_pool);
+
         /**
         Enables access to private members of seal::EvaluationKeys for .NET wrapper.
         */
@@ -203,6 +226,8 @@ namespace seal
 
         friend class Evaluator;
 
+        friend class MappedArchive;
+
         friend class KeyGenerator;
     };
 }
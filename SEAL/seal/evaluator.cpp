@@ -1,7 +1,9 @@
 #include <algorithm>
 #include <stdexcept>
 #include <cmath>
+#include <limits>
 #include "seal/evaluator.h"
+#include "seal/galoiskeystore.h"
 #include "seal/util/common.h"
 #include "seal/util/uintcore.h"
 #include "seal/util/uintarith.h"
@@ -15,10 +17,24 @@ using namespace seal::util;
 
 namespace seal
 {
+    namespace
+    {
+        // Number of coefficients handled by one add_many or dot_product_plain task; small
+        // enough to give the thread pool several tasks per polynomial, large enough to
+        // stream through memory
+        const int coeff_block_size = 1024;
+    }
+
     Evaluator::Evaluator(const SEALContext &context, const MemoryPoolHandle &pool) :
-        pool_(pool), parms_(context.parms()), qualifiers_(context.qualifiers()), 
-        base_converter_(context.base_converter_), 
-        coeff_modulus_(context.coeff_modulus()) 
+        Evaluator(context, context.thread_pool_, pool)
+    {
+    }
+
+    Evaluator::Evaluator(const SEALContext &context, const ThreadPoolHandle &thread_pool, 
+        const MemoryPoolHandle &pool) :
+        pool_(pool), thread_pool_(thread_pool), parms_(context.parms()), qualifiers_(context.qualifiers()), 
+        base_converter_(context.base_converter_), multiply_method_(context.multiply_method_),
+        hps_converter_(context.hps_converter_), coeff_modulus_(context.coeff_modulus()) 
     {
         // Verify parameters
         if (!qualifiers_.parameters_set)
@@ -45,6 +61,14 @@ namespace seal
         // Copy over bsk moduli array
         bsk_mod_array_ = base_converter_.get_bsk_mod_array();
 
+        // With HPS multiplication the auxiliary base is P
+        if (multiply_method_ == MultiplyMethod::hps)
+        {
+            bsk_base_mod_count_ = hps_converter_.p_base_mod_count();
+            bsk_small_ntt_tables_ = hps_converter_.get_p_small_ntt_table();
+            bsk_mod_array_ = hps_converter_.get_p_mod_array();
+        }
+
         // Copy over inverse of coeff moduli products mod each coeff moduli
         inv_coeff_products_mod_coeff_array_ = base_converter_.get_inv_coeff_mod_coeff_array();
 
@@ -121,11 +145,44 @@ namespace seal
 
         // Calculate map from Zmstar to generator representation
         populate_Zmstar_to_generator();
+
+        // Calculate the inverse of the last prime modulo each of the other primes
+        inv_last_coeff_mod_array_ = allocate_zero_uint(coeff_mod_count, pool_);
+        for (int i = 0; i < coeff_mod_count - 1; i++)
+        {
+            if (!try_invert_uint_mod(coeff_modulus_.back().value(), coeff_modulus_[i], inv_last_coeff_mod_array_[i]))
+            {
+                throw invalid_argument("coeff_modulus primes are not coprime");
+            }
+        }
+
+        // If this Evaluator is for a lower level, the Evaluator for the highest level
+        // overwrites these
+        top_level_hash_block_ = parms_.hash_block();
+        top_level_coeff_mod_count_ = coeff_mod_count;
+        key_inv_coeff_products_mod_coeff_array_ = inv_coeff_products_mod_coeff_array_;
+
+        // The Evaluators for the lower levels are created on first use
+        level_contexts_ = context.level_contexts_;
+        create_level_evaluators();
+    }
+
+    void Evaluator::create_level_evaluators()
+    {
+        if (level_contexts_)
+        {
+            int level_count = static_cast<int>(coeff_modulus_.size()) - level_contexts_->min_level();
+            for (int i = 0; i < level_count; i++)
+            {
+                level_evaluators_.emplace_back(new LevelEvaluator);
+            }
+        }
     }
 
     Evaluator::Evaluator(const Evaluator &copy) :
-        pool_(copy.pool_), parms_(copy.parms_), qualifiers_(copy.qualifiers_),
-        base_converter_(copy.base_converter_),
+        pool_(copy.pool_), thread_pool_(copy.thread_pool_), parms_(copy.parms_), qualifiers_(copy.qualifiers_),
+        base_converter_(copy.base_converter_), multiply_method_(copy.multiply_method_),
+        hps_converter_(copy.hps_converter_),
         coeff_small_ntt_tables_(copy.coeff_small_ntt_tables_),
         bsk_small_ntt_tables_(copy.bsk_small_ntt_tables_),
         plain_upper_half_threshold_(copy.plain_upper_half_threshold_),
@@ -134,7 +191,10 @@ namespace seal
         bsk_mod_array_(copy.bsk_mod_array_),
         inv_coeff_products_mod_coeff_array_(copy.inv_coeff_products_mod_coeff_array_),
         bsk_base_mod_count_(copy.bsk_base_mod_count_),
-        Zmstar_to_generator_(copy.Zmstar_to_generator_)
+        Zmstar_to_generator_(copy.Zmstar_to_generator_),
+        top_level_hash_block_(copy.top_level_hash_block_),
+        top_level_coeff_mod_count_(copy.top_level_coeff_mod_count_),
+        key_inv_coeff_products_mod_coeff_array_(copy.key_inv_coeff_products_mod_coeff_array_)
     {
         int coeff_count = parms_.poly_modulus().coeff_count();
         int poly_coeff_uint64_count = parms_.poly_modulus().coeff_uint64_count();
@@ -168,6 +228,65 @@ namespace seal
         // Initialize moduli.
         mod_ = Modulus(product_modulus_.get(), coeff_mod_count);
         polymod_ = PolyModulus(parms_.poly_modulus().pointer(), coeff_count, poly_coeff_uint64_count);
+
+        // Copy the inverses of the last prime
+        inv_last_coeff_mod_array_ = allocate_uint(coeff_mod_count, pool_);
+        set_uint_uint(copy.inv_last_coeff_mod_array_.get(), coeff_mod_count, inv_last_coeff_mod_array_.get());
+
+        // The Evaluators for the lower levels are created again on first use
+        level_contexts_ = copy.level_contexts_;
+        create_level_evaluators();
+    }
+
+    Evaluator *Evaluator::level_evaluator(const EncryptionParameters::hash_block_type &hash_block) const
+    {
+        if (hash_block == parms_.hash_block() || !level_contexts_)
+        {
+            return nullptr;
+        }
+        int level = level_contexts_->level(hash_block);
+        return level ? level_evaluator(level) : nullptr;
+    }
+
+    Evaluator *Evaluator::level_evaluator(int level) const
+    {
+        LevelEvaluator &entry = *level_evaluators_[coeff_modulus_.size() - 1 - level];
+        call_once(entry.create_flag, [&]() {
+            auto evaluator = make_shared<Evaluator>(level_contexts_->context(level), thread_pool_, pool_);
+            evaluator->top_level_hash_block_ = top_level_hash_block_;
+            evaluator->top_level_coeff_mod_count_ = top_level_coeff_mod_count_;
+            evaluator->key_inv_coeff_products_mod_coeff_array_.assign(inv_coeff_products_mod_coeff_array_.begin(),
+                inv_coeff_products_mod_coeff_array_.begin() + level);
+            entry.evaluator = evaluator;
+        });
+        return entry.evaluator.get();
+    }
+
+    void Evaluator::parallel_for(int count, const function<void(int)> &func) const
+    {
+        if (thread_pool_ && count > 1)
+        {
+            static_cast<ThreadPool&>(thread_pool_).parallel_for(count, func);
+            return;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            func(i);
+        }
+    }
+
+    void Evaluator::parallel_for(int count, const function<void(int)> &func, const MemoryPoolHandle &pool) const
+    {
+        // Thread-unsafe memory pools cannot be shared by the tasks
+        if (dynamic_cast<MemoryPoolMT*>(&static_cast<MemoryPool&>(pool)) == nullptr)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                func(i);
+            }
+            return;
+        }
+        parallel_for(count, func);
     }
 
     void Evaluator::compose(uint64_t *value, const MemoryPoolHandle &pool)
@@ -232,6 +351,12 @@ namespace seal
 
     void Evaluator::negate(Ciphertext &encrypted)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->negate(encrypted);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -243,6 +368,8 @@ namespace seal
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
 
+        encrypted.clear_seed();
+
         // Negate each poly in the array
         for (int j = 0; j < encrypted_size; j++)
         {
@@ -256,6 +383,12 @@ namespace seal
 
     void Evaluator::add(Ciphertext &encrypted1, const Ciphertext &encrypted2)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted1.hash_block_))
+        {
+            evaluator->add(encrypted1, encrypted2);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -273,6 +406,10 @@ namespace seal
         {
             throw invalid_argument("encrypted2 is not valid for encryption parameters");
         }
+        if (encrypted1.is_ntt_form_ != encrypted2.is_ntt_form_)
+        {
+            throw invalid_argument("NTT form mismatch");
+        }
 
         // Prepare destination
         encrypted1.resize(parms_, max_count);
@@ -303,16 +440,96 @@ namespace seal
             throw invalid_argument("encrypteds cannot be empty");
         }
 
-        destination = encrypteds[0];
-        int encrypteds_size = encrypteds.size();
-        for (size_t i = 1; i < encrypteds_size; i++)
+        if (Evaluator *evaluator = level_evaluator(encrypteds[0].hash_block_))
+        {
+            evaluator->add_many(encrypteds, destination);
+            return;
+        }
+
+        // Extract encryption parameters.
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+
+        // Verify parameters.
+        int max_count = 0;
+        bool destination_is_input = false;
+        for (const auto &encrypted : encrypteds)
+        {
+            if (encrypted.hash_block_ != parms_.hash_block())
+            {
+                throw invalid_argument("encrypteds is not valid for encryption parameters");
+            }
+            if (encrypted.is_ntt_form_ != encrypteds[0].is_ntt_form_)
+            {
+                throw invalid_argument("NTT form mismatch");
+            }
+            max_count = max(max_count, encrypted.size());
+            destination_is_input = destination_is_input || &encrypted == &destination;
+        }
+
+        // Prepare destination, or a temporary if destination is one of the inputs
+        Ciphertext temp(parms_, pool_);
+        Ciphertext &sum = destination_is_input ? temp : destination;
+        sum.resize(parms_, max_count);
+        sum.is_ntt_form_ = encrypteds[0].is_ntt_form_;
+
+        // Each task sums one block of coefficients of one polynomial modulo one prime over
+        // all the inputs. The sums are accumulated without reduction for as many additions as
+        // fit in 64 bits, and only then reduced.
+        int block_count = (coeff_count + coeff_block_size - 1) / coeff_block_size;
+        parallel_for(max_count * coeff_mod_count * block_count, [&](int task) {
+            int block_index = task % block_count;
+            int i = (task / block_count) % coeff_mod_count;
+            int j = task / (block_count * coeff_mod_count);
+            int offset = (i * coeff_count) + (block_index * coeff_block_size);
+            int length = min(coeff_block_size, coeff_count - (block_index * coeff_block_size));
+            const SmallModulus &modulus = coeff_modulus_[i];
+            uint64_t lazy_count = numeric_limits<uint64_t>::max() / modulus.value() - 1;
+
+            uint64_t *sum_ptr = sum.mutable_pointer(j) + offset;
+            auto reduce = [&]() {
+                for (int m = 0; m < length; m++)
+                {
+                    uint64_t wide_sum[2]{ sum_ptr[m], 0 };
+                    sum_ptr[m] = barrett_reduce_128(wide_sum, modulus);
+                }
+            };
+            set_zero_uint(length, sum_ptr);
+            uint64_t pending_count = 0;
+            for (const auto &encrypted : encrypteds)
+            {
+                if (encrypted.size() <= j)
+                {
+                    continue;
+                }
+                const uint64_t *encrypted_ptr = encrypted.pointer(j) + offset;
+                for (int m = 0; m < length; m++)
+                {
+                    sum_ptr[m] += encrypted_ptr[m];
+                }
+                if (++pending_count == lazy_count)
+                {
+                    reduce();
+                    pending_count = 0;
+                }
+            }
+            reduce();
+        });
+
+        if (destination_is_input)
         {
-            add(destination, encrypteds[i]);
+            destination = temp;
         }
     }
 
     void Evaluator::sub(Ciphertext &encrypted1, const Ciphertext &encrypted2)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted1.hash_block_))
+        {
+            evaluator->sub(encrypted1, encrypted2);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -330,6 +547,10 @@ namespace seal
         {
             throw invalid_argument("encrypted2 is not valid for encryption parameters");
         }
+        if (encrypted1.is_ntt_form_ != encrypted2.is_ntt_form_)
+        {
+            throw invalid_argument("NTT form mismatch");
+        }
 
         // Prepare destination
         encrypted1.resize(parms_, max_count);
@@ -359,10 +580,16 @@ namespace seal
 
     void Evaluator::multiply(Ciphertext &encrypted1, const Ciphertext &encrypted2, const MemoryPoolHandle &pool)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted1.hash_block_))
+        {
+            evaluator->multiply(encrypted1, encrypted2, pool);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
-        int bsk_mtilde_count = bsk_base_mod_count_ + 1;
+        int base_mod_count = coeff_mod_count + bsk_base_mod_count_;
         int encrypted1_size = encrypted1.size();
         int encrypted2_size = encrypted2.size();
 
@@ -375,336 +602,351 @@ namespace seal
         {
             throw invalid_argument("encrypted2 is not valid for encryption parameters");
         }
+        if (encrypted1.is_ntt_form_ || encrypted2.is_ntt_form_)
+        {
+            throw invalid_argument("encrypted1 and encrypted2 cannot be in NTT form");
+        }
         if (!pool)
         {
             throw invalid_argument("pool is uninitialized");
         }
 
-        // Determine destination.size()
-        // Default is 3 (c_0, c_1, c_2)
-        int dest_count = encrypted1_size + encrypted2_size - 1;
-
-        // Prepare destination
-        encrypted1.resize(parms_, dest_count);
+        // Extend both operands to q U Bsk and transform them to NTT form
+        Pointer prepared1(allocate_poly(coeff_count * encrypted1_size, base_mod_count, pool));
+        Pointer prepared2(allocate_poly(coeff_count * encrypted2_size, base_mod_count, pool));
+        const Ciphertext *encrypteds[2]{ &encrypted1, &encrypted2 };
+        uint64_t *destinations[2]{ prepared1.get(), prepared2.get() };
+        prepare_operands(encrypteds, destinations, 2, pool);
 
-        int encrypted_ptr_increment = coeff_count * coeff_mod_count;
-        int encrypted_bsk_mtilde_ptr_increment = coeff_count * bsk_mtilde_count;
-        int encrypted_bsk_ptr_increment = coeff_count * bsk_base_mod_count_;
+        multiply_prepared(prepared1.get(), encrypted1_size, prepared2.get(), encrypted2_size, encrypted1, pool);
+    }
 
-        // Make temp polys for FastBConverter result from q ---> Bsk U {m_tilde}
-        Pointer tmp_encrypted1_bsk_mtilde(allocate_poly(coeff_count * encrypted1_size, bsk_mtilde_count, pool));
-        Pointer tmp_encrypted2_bsk_mtilde(allocate_poly(coeff_count * encrypted2_size, bsk_mtilde_count, pool));
+    void Evaluator::multiply(const PreparedCiphertext &prepared1, const Ciphertext &encrypted2, 
+        Ciphertext &destination, const MemoryPoolHandle &pool)
+    {
+        if (Evaluator *evaluator = level_evaluator(prepared1.hash_block_))
+        {
+            evaluator->multiply(prepared1, encrypted2, destination, pool);
+            return;
+        }
 
-        // Make temp polys for FastBConverter result from Bsk U {m_tilde} -----> Bsk
-        Pointer tmp_encrypted1_bsk(allocate_poly(coeff_count * encrypted1_size, bsk_base_mod_count_, pool));
-        Pointer tmp_encrypted2_bsk(allocate_poly(coeff_count * encrypted2_size, bsk_base_mod_count_, pool));
+        // Extract encryption parameters.
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+        int base_mod_count = coeff_mod_count + bsk_base_mod_count_;
+        int encrypted2_size = encrypted2.size();
 
-        // Step 0: fast base convert from q to Bsk U {m_tilde}
-        // Step 1: reduce q-overflows in Bsk
-        // Iterate over all the ciphertexts inside encrypted1
-        for (int i = 0; i < encrypted1_size; i++)
+        // Verify parameters.
+        if (prepared1.hash_block_ != parms_.hash_block())
         {
-            base_converter_.fastbconv_mtilde(encrypted1.pointer(i), 
-                tmp_encrypted1_bsk_mtilde.get() + (i * encrypted_bsk_mtilde_ptr_increment), pool);
-            base_converter_.mont_rq(tmp_encrypted1_bsk_mtilde.get() + (i * encrypted_bsk_mtilde_ptr_increment), 
-                tmp_encrypted1_bsk.get() + (i * encrypted_bsk_ptr_increment));
+            throw invalid_argument("prepared1 is not valid for encryption parameters");
         }
-        
-        // Iterate over all the ciphertexts inside encrypted2
-        for (int i = 0; i < encrypted2_size; i++)
+        if (prepared1.multiply_method_ != multiply_method_ || prepared1.aux_base_mod_count_ != bsk_base_mod_count_ ||
+            prepared1.uint64_count_ != coeff_count * prepared1.size_ * base_mod_count)
         {
-            base_converter_.fastbconv_mtilde(encrypted2.pointer(i), 
-                tmp_encrypted2_bsk_mtilde.get() + (i * encrypted_bsk_mtilde_ptr_increment), pool);
-            base_converter_.mont_rq(tmp_encrypted2_bsk_mtilde.get() + (i * encrypted_bsk_mtilde_ptr_increment), 
-                tmp_encrypted2_bsk.get() + (i * encrypted_bsk_ptr_increment));
+            throw invalid_argument("prepared1 was prepared for a different multiplication method");
+        }
+        if (encrypted2.hash_block_ != parms_.hash_block())
+        {
+            throw invalid_argument("encrypted2 is not valid for encryption parameters");
+        }
+        if (encrypted2.is_ntt_form_)
+        {
+            throw invalid_argument("encrypted2 cannot be in NTT form");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
         }
-        
-        // Step 2: compute product and multiply plain modulus to the result
-        // We need to multiply both in q and Bsk. Values in encrypted_safe are in base q and values in tmp_encrypted_bsk are in base Bsk
-        // We iterate over destination poly array and generate each poly based on the indices of inputs (arbitrary sizes for ciphertexts)
-        // First allocate two temp polys: one for results in base q and the other for the result in base Bsk
-        // These need to be zero for the arbitrary size multiplication; not for 2x2 though
-        Pointer tmp_des_coeff_base(allocate_zero_poly(coeff_count * dest_count, coeff_mod_count, pool));
-        Pointer tmp_des_bsk_base(allocate_zero_poly(coeff_count * dest_count, bsk_base_mod_count_, pool));
-
-        // Allocate two tmp polys: one for NTT multiplication results in base q and one for result in base Bsk
-        Pointer tmp1_poly_coeff_base(allocate_poly(coeff_count, coeff_mod_count, pool));
-        Pointer tmp1_poly_bsk_base(allocate_poly(coeff_count, bsk_base_mod_count_, pool));
-        Pointer tmp2_poly_coeff_base(allocate_poly(coeff_count, coeff_mod_count, pool));
-        Pointer tmp2_poly_bsk_base(allocate_poly(coeff_count, bsk_base_mod_count_, pool));
-
-        int current_encrypted1_limit = 0;
 
-        // First convert all the inputs into NTT form
-        Pointer copy_encrypted1_ntt_coeff_mod(allocate_poly(coeff_count * encrypted1_size, coeff_mod_count, pool));
-        set_poly_poly(encrypted1.pointer(), coeff_count * encrypted1_size, coeff_mod_count, copy_encrypted1_ntt_coeff_mod.get());
+        // Only encrypted2 needs to be extended and transformed
+        Pointer prepared2(allocate_poly(coeff_count * encrypted2_size, base_mod_count, pool));
+        const Ciphertext *encrypteds[1]{ &encrypted2 };
+        uint64_t *destinations[1]{ prepared2.get() };
+        prepare_operands(encrypteds, destinations, 1, pool);
 
-        Pointer copy_encrypted1_ntt_bsk_base_mod(allocate_poly(coeff_count * encrypted1_size, bsk_base_mod_count_, pool));
-        set_poly_poly(tmp_encrypted1_bsk.get(), coeff_count * encrypted1_size, bsk_base_mod_count_, copy_encrypted1_ntt_bsk_base_mod.get());
+        multiply_prepared(prepared1.data_.get(), prepared1.size_, prepared2.get(), encrypted2_size, destination, pool);
+    }
 
-        Pointer copy_encrypted2_ntt_coeff_mod(allocate_poly(coeff_count * encrypted2_size, coeff_mod_count, pool));
-        set_poly_poly(encrypted2.pointer(), coeff_count * encrypted2_size, coeff_mod_count, copy_encrypted2_ntt_coeff_mod.get());
+    void Evaluator::prepare(const Ciphertext &encrypted, PreparedCiphertext &destination, const MemoryPoolHandle &pool)
+    {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->prepare(encrypted, destination, pool);
+            return;
+        }
 
-        Pointer copy_encrypted2_ntt_bsk_base_mod(allocate_poly(coeff_count * encrypted2_size, bsk_base_mod_count_, pool));
-        set_poly_poly(tmp_encrypted2_bsk.get(), coeff_count * encrypted2_size, bsk_base_mod_count_, copy_encrypted2_ntt_bsk_base_mod.get());
+        // Extract encryption parameters.
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+        int base_mod_count = coeff_mod_count + bsk_base_mod_count_;
+        int encrypted_size = encrypted.size();
 
-        for (int i = 0; i < encrypted1_size; i++)
+        // Verify parameters.
+        if (encrypted.hash_block_ != parms_.hash_block())
         {
-            for (int j = 0; j < coeff_mod_count; j++)
-            {
-                // Lazy reduction
-                ntt_negacyclic_harvey_lazy(copy_encrypted1_ntt_coeff_mod.get() + (j * coeff_count) + (i * encrypted_ptr_increment), coeff_small_ntt_tables_[j]);
-            }
-            for (int j = 0; j < bsk_base_mod_count_; j++)
-            {
-                // Lazy reduction
-                ntt_negacyclic_harvey_lazy(copy_encrypted1_ntt_bsk_base_mod.get() + (j * coeff_count) + (i * encrypted_bsk_ptr_increment), bsk_small_ntt_tables_[j]);
-            }
+            throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-
-        for (int i = 0; i < encrypted2_size; i++)
+        if (encrypted.is_ntt_form_)
         {
-            for (int j = 0; j < coeff_mod_count; j++)
-            {
-                // Lazy reduction
-                ntt_negacyclic_harvey_lazy(copy_encrypted2_ntt_coeff_mod.get() + (j * coeff_count) + (i * encrypted_ptr_increment), coeff_small_ntt_tables_[j]);
-            }
-            for (int j = 0; j < bsk_base_mod_count_; j++)
-            {
-                // Lazy reduction
-                ntt_negacyclic_harvey_lazy(copy_encrypted2_ntt_bsk_base_mod.get() + (j * coeff_count) + (i * encrypted_bsk_ptr_increment), bsk_small_ntt_tables_[j]);
-            }
+            throw invalid_argument("encrypted cannot be in NTT form");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
         }
 
-        // Perform Karatsuba multiplication on size 2 ciphertexts
-        if (encrypted1_size == 2 && encrypted2_size == 2)
+        // Reuse the memory of destination if the size matches
+        int uint64_count = coeff_count * encrypted_size * base_mod_count;
+        if (destination.uint64_count_ != uint64_count)
         {
-            Pointer tmp_first_mul_coeff_base(allocate_poly(coeff_count, coeff_mod_count, pool));
+            destination.data_ = allocate_uint(uint64_count, destination.pool_);
+            destination.uint64_count_ = uint64_count;
+        }
+        const Ciphertext *encrypteds[1]{ &encrypted };
+        uint64_t *destinations[1]{ destination.data_.get() };
+        prepare_operands(encrypteds, destinations, 1, pool);
+        destination.hash_block_ = encrypted.hash_block_;
+        destination.multiply_method_ = multiply_method_;
+        destination.aux_base_mod_count_ = bsk_base_mod_count_;
+        destination.size_ = encrypted_size;
+    }
 
-            // Compute c0 + c1 and c0*d0 in base q
-            uint64_t *temp_ptr_1 = tmp1_poly_coeff_base.get();
-            uint64_t *temp_ptr_2 = copy_encrypted1_ntt_coeff_mod.get();
-            uint64_t *temp_ptr_3 = temp_ptr_2 + encrypted_ptr_increment;
-            for (int i = 0; i < coeff_mod_count; i++)
-            {
-                //add_poly_poly_coeffmod(copy_encrypted1_ntt_coeff_mod.get() + (i * coeff_count), 
-                //    copy_encrypted1_ntt_coeff_mod.get() + (i * coeff_count) + encrypted_ptr_increment, 
-                //    coeff_count, coeff_modulus_[i], tmp1_poly_coeff_base.get() + (i * coeff_count));
+    void Evaluator::prepare_operands(const Ciphertext *const *encrypteds, uint64_t *const *destinations, int count, 
+        const MemoryPoolHandle &pool)
+    {
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+        int bsk_mtilde_count = bsk_base_mod_count_ + 1;
+        int base_mod_count = coeff_mod_count + bsk_base_mod_count_;
+        int encrypted_ptr_increment = coeff_count * coeff_mod_count;
+        int encrypted_bsk_mtilde_ptr_increment = coeff_count * bsk_mtilde_count;
+        int encrypted_bsk_ptr_increment = coeff_count * bsk_base_mod_count_;
 
-                // Lazy reduction
-                for (int j = 0; j < coeff_count; j++)
-                {
-                    *temp_ptr_1++ = *temp_ptr_2++ + *temp_ptr_3++;
-                }
-                dyadic_product_coeffmod(copy_encrypted1_ntt_coeff_mod.get() + (i * coeff_count), 
-                    copy_encrypted2_ntt_coeff_mod.get() + (i * coeff_count), coeff_count, coeff_modulus_[i], 
-                    tmp_first_mul_coeff_base.get() + (i * coeff_count));
-            }
+        // Task index i stands for component i - offsets[k] of operand k
+        int offsets[3]{ 0, 0, 0 };
+        for (int k = 0; k < count; k++)
+        {
+            offsets[k + 1] = offsets[k] + encrypteds[k]->size();
+        }
+        int total_size = offsets[count];
+        auto locate = [&](int index, int &k) {
+            k = index < offsets[1] ? 0 : 1;
+            return index - offsets[k];
+        };
 
-            Pointer tmp_first_mul_bsk_base(allocate_poly(coeff_count, bsk_base_mod_count_, pool));
+        // Make temp polys for FastBConverter result from q ---> Bsk U {m_tilde}
+        Pointer tmp_bsk_mtilde;
+        if (multiply_method_ == MultiplyMethod::behz)
+        {
+            tmp_bsk_mtilde = allocate_poly(coeff_count * total_size, bsk_mtilde_count, pool);
+        }
 
-            // Compute c0 + c1 and c0*d0 in base bsk
-            temp_ptr_1 = tmp1_poly_bsk_base.get();
-            temp_ptr_2 = copy_encrypted1_ntt_bsk_base_mod.get();
-            temp_ptr_3 = temp_ptr_2 + encrypted_bsk_ptr_increment;
-            for (int i = 0; i < bsk_base_mod_count_; i++)
+        // Step 0: fast base convert from q to Bsk U {m_tilde}
+        // Step 1: reduce q-overflows in Bsk
+        // With HPS, instead convert exactly from q to P
+        // Iterate over all the components of all the operands
+        parallel_for(total_size, [&](int index) {
+            int k;
+            int i = locate(index, k);
+            const uint64_t *encrypted_ptr = encrypteds[k]->pointer(i);
+            uint64_t *bsk_ptr = destinations[k] + (encrypteds[k]->size() * encrypted_ptr_increment) + 
+                (i * encrypted_bsk_ptr_increment);
+            if (multiply_method_ == MultiplyMethod::hps)
             {
-                //add_poly_poly_coeffmod(copy_encrypted1_ntt_bsk_base_mod.get() + (i * coeff_count), 
-                //    copy_encrypted1_ntt_bsk_base_mod.get() + (i * coeff_count) + encrypted_bsk_ptr_increment, 
-                //    coeff_count, bsk_mod_array_[i], tmp1_poly_bsk_base.get() + (i * coeff_count));
-                for (int j = 0; j < coeff_count; j++)
-                {
-                    *temp_ptr_1++ = *temp_ptr_2++ + *temp_ptr_3++;
-                }
-                dyadic_product_coeffmod(copy_encrypted1_ntt_bsk_base_mod.get() + (i * coeff_count), 
-                    copy_encrypted2_ntt_bsk_base_mod.get() + (i * coeff_count), coeff_count, bsk_mod_array_[i], 
-                    tmp_first_mul_bsk_base.get() + (i * coeff_count));
+                hps_converter_.exact_convert_q_to_p(encrypted_ptr, bsk_ptr, pool);
+                return;
             }
-
-            Pointer tmp_second_mul_coeff_base(allocate_poly(coeff_count, coeff_mod_count, pool));
-
-            // Compute d0 + d1 and c1*d1 in base q
-            temp_ptr_1 = tmp2_poly_coeff_base.get();
-            temp_ptr_2 = copy_encrypted2_ntt_coeff_mod.get();
-            temp_ptr_3 = temp_ptr_2 + encrypted_ptr_increment;
-            for (int i = 0; i < coeff_mod_count; i++)
+            uint64_t *bsk_mtilde_ptr = tmp_bsk_mtilde.get() + (index * encrypted_bsk_mtilde_ptr_increment);
+            base_converter_.fastbconv_mtilde(encrypted_ptr, bsk_mtilde_ptr, pool);
+            base_converter_.mont_rq(bsk_mtilde_ptr, bsk_ptr);
+        }, pool);
+
+        // Each task transforms one component of one operand modulo one prime in q U Bsk; the 
+        // components modulo q are copied over first
+        parallel_for(total_size * base_mod_count, [&](int index) {
+            int k;
+            int i = locate(index / base_mod_count, k);
+            int j = index % base_mod_count;
+
+            // Reduce fully, since the 2x2 tensor product adds the transformed components before
+            // multiplying them, and the primes of Bsk have 61 bits
+            if (j < coeff_mod_count)
             {
-                //add_poly_poly_coeffmod(copy_encrypted2_ntt_coeff_mod.get() + (i * coeff_count), 
-                //    copy_encrypted2_ntt_coeff_mod.get() + (i * coeff_count) + encrypted_ptr_increment, 
-                //    coeff_count, coeff_modulus_[i], tmp2_poly_coeff_base.get() + (i * coeff_count));
-                for (int j = 0; j < coeff_count; j++)
-                {
-                    *temp_ptr_1++ = *temp_ptr_2++ + *temp_ptr_3++;
-                }
-                dyadic_product_coeffmod(copy_encrypted1_ntt_coeff_mod.get() + (i * coeff_count) + encrypted_ptr_increment, 
-                    copy_encrypted2_ntt_coeff_mod.get() + (i * coeff_count) + encrypted_ptr_increment, 
-                    coeff_count, coeff_modulus_[i], tmp_second_mul_coeff_base.get() + (i * coeff_count));
+                uint64_t *poly_ptr = destinations[k] + (i * encrypted_ptr_increment) + (j * coeff_count);
+                set_uint_uint(encrypteds[k]->pointer(i) + (j * coeff_count), coeff_count, poly_ptr);
+                ntt_negacyclic_harvey(poly_ptr, coeff_small_ntt_tables_[j]);
             }
-
-            Pointer tmp_second_mul_bsk_base(allocate_poly(coeff_count, bsk_base_mod_count_, pool));
-
-            // Compute d0 + d1 and c1*d1 in base bsk
-            temp_ptr_1 = tmp2_poly_bsk_base.get();
-            temp_ptr_2 = copy_encrypted2_ntt_bsk_base_mod.get();
-            temp_ptr_3 = temp_ptr_2 + encrypted_bsk_ptr_increment;
-            for (int i = 0; i < bsk_base_mod_count_; i++)
+            else
             {
-                //add_poly_poly_coeffmod(copy_encrypted2_ntt_bsk_base_mod.get() + (i * coeff_count), 
-                //    copy_encrypted2_ntt_bsk_base_mod.get() + (i * coeff_count) + encrypted_bsk_ptr_increment, 
-                //    coeff_count, bsk_mod_array_[i], tmp2_poly_bsk_base.get() + (i * coeff_count));
-                for (int j = 0; j < coeff_count; j++)
-                {
-                    *temp_ptr_1++ = *temp_ptr_2++ + *temp_ptr_3++;
-                }
-                dyadic_product_coeffmod(copy_encrypted1_ntt_bsk_base_mod.get() + (i * coeff_count) + encrypted_bsk_ptr_increment, 
-                    copy_encrypted2_ntt_bsk_base_mod.get() + (i * coeff_count) + encrypted_bsk_ptr_increment, 
-                    coeff_count, bsk_mod_array_[i], tmp_second_mul_bsk_base.get() + (i * coeff_count));
+                j -= coeff_mod_count;
+                uint64_t *poly_ptr = destinations[k] + (encrypteds[k]->size() * encrypted_ptr_increment) + 
+                    (i * encrypted_bsk_ptr_increment) + (j * coeff_count);
+                ntt_negacyclic_harvey(poly_ptr, bsk_small_ntt_tables_[j]);
             }
+        });
+    }
 
-            Pointer tmp_mul_poly_coeff_base(allocate_poly(coeff_count, coeff_mod_count, pool));
-            Pointer tmp_mul_poly_bsk_base(allocate_poly(coeff_count, bsk_base_mod_count_, pool));
-
-            // Set destination first and third polys in base q
-            // Des[0] in base q
-            set_poly_poly(tmp_first_mul_coeff_base.get(), coeff_count, coeff_mod_count, tmp_des_coeff_base.get());
+    void Evaluator::multiply_prepared(const uint64_t *prepared1, int encrypted1_size, const uint64_t *prepared2, 
+        int encrypted2_size, Ciphertext &destination, const MemoryPoolHandle &pool)
+    {
+        // Extract encryption parameters.
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+        int base_mod_count = coeff_mod_count + bsk_base_mod_count_;
+        int encrypted_ptr_increment = coeff_count * coeff_mod_count;
+        int encrypted_bsk_ptr_increment = coeff_count * bsk_base_mod_count_;
 
-            // Des[2] in base q
-            set_poly_poly(tmp_second_mul_coeff_base.get(), coeff_count, coeff_mod_count, tmp_des_coeff_base.get() + 2 * encrypted_ptr_increment);
-            
-            // Compute (c0 + c1)*(d0 + d1) - c0*d0 - c1*d1 in base q
-            for (int i = 0; i < coeff_mod_count; i++)
-            {
-                dyadic_product_coeffmod(tmp1_poly_coeff_base.get() + (i * coeff_count), tmp2_poly_coeff_base.get() + (i * coeff_count), 
-                    coeff_count, coeff_modulus_[i], tmp_mul_poly_coeff_base.get() + (i * coeff_count));
-                sub_poly_poly_coeffmod(tmp_mul_poly_coeff_base.get() + (i * coeff_count), 
-                    tmp_first_mul_coeff_base.get() + (i * coeff_count), coeff_count, coeff_modulus_[i], 
-                    tmp_mul_poly_coeff_base.get() + (i * coeff_count));
-                
-                // Des[1] in base q
-                sub_poly_poly_coeffmod(tmp_mul_poly_coeff_base.get() + (i * coeff_count), 
-                    tmp_second_mul_coeff_base.get() + (i * coeff_count), coeff_count, coeff_modulus_[i], 
-                    tmp_des_coeff_base.get() + (i * coeff_count) + encrypted_ptr_increment);
-            }
+        // Determine destination.size()
+        // Default is 3 (c_0, c_1, c_2)
+        int dest_count = encrypted1_size + encrypted2_size - 1;
 
-            // Set destination first and third polys in base bsk
-            // Des[0] in base bsk
-            set_poly_poly(tmp_first_mul_bsk_base.get(), coeff_count, bsk_base_mod_count_, tmp_des_bsk_base.get());
+        // Prepare destination
+        destination.resize(parms_, dest_count);
+        destination.is_ntt_form_ = false;
 
-            // Des[2] in base q
-            set_poly_poly(tmp_second_mul_bsk_base.get(), coeff_count, bsk_base_mod_count_, 
-                tmp_des_bsk_base.get() + 2 * encrypted_bsk_ptr_increment);
+        // The operands in NTT form modulo q, followed by the operands in NTT form modulo Bsk
+        const uint64_t *copy_encrypted1_ntt_coeff_mod = prepared1;
+        const uint64_t *copy_encrypted1_ntt_bsk_base_mod = prepared1 + (encrypted1_size * encrypted_ptr_increment);
+        const uint64_t *copy_encrypted2_ntt_coeff_mod = prepared2;
+        const uint64_t *copy_encrypted2_ntt_bsk_base_mod = prepared2 + (encrypted2_size * encrypted_ptr_increment);
 
-            // Compute (c0 + c1)*(d0 + d1)  - c0d0 - c1d1 in base bsk
-            for (int i = 0; i < bsk_base_mod_count_; i++)
-            {
-                dyadic_product_coeffmod(tmp1_poly_bsk_base.get() + (i * coeff_count), 
-                    tmp2_poly_bsk_base.get() + (i * coeff_count), coeff_count, bsk_mod_array_[i], 
-                    tmp_mul_poly_bsk_base.get() + (i * coeff_count));
-                sub_poly_poly_coeffmod(tmp_mul_poly_bsk_base.get() + (i * coeff_count), 
-                    tmp_first_mul_bsk_base.get() + (i * coeff_count), coeff_count, bsk_mod_array_[i], 
-                    tmp_mul_poly_bsk_base.get() + (i * coeff_count));
+        // Step 2: compute product and multiply plain modulus to the result
+        // We need to multiply both in q and Bsk. Values in encrypted_safe are in base q and values in tmp_encrypted_bsk are in base Bsk
+        // We iterate over destination poly array and generate each poly based on the indices of inputs (arbitrary sizes for ciphertexts)
+        // First allocate two temp polys: one for results in base q and the other for the result in base Bsk
+        // These need to be zero for the arbitrary size multiplication; not for 2x2 though
+        Pointer tmp_des_coeff_base(allocate_zero_poly(coeff_count * dest_count, coeff_mod_count, pool));
+        Pointer tmp_des_bsk_base(allocate_zero_poly(coeff_count * dest_count, bsk_base_mod_count_, pool));
 
-                // Des[1] in bsk
-                sub_poly_poly_coeffmod(tmp_mul_poly_bsk_base.get() + (i * coeff_count), 
-                    tmp_second_mul_bsk_base.get() + (i * coeff_count), coeff_count, bsk_mod_array_[i], 
-                    tmp_des_bsk_base.get() + (i * coeff_count) + encrypted_bsk_ptr_increment); 
-            }
+        // The products are computed independently modulo each prime in q U Bsk. Task j works on the
+        // j-th prime of q if j < coeff_mod_count, and on the (j - coeff_mod_count)-th prime of Bsk otherwise.
+        if (encrypted1_size == 2 && encrypted2_size == 2)
+        {
+            // Compute all three outputs in a single pass over the operands. Karatsuba saves one
+            // of the four products per coefficient but was slower than schoolbook with native
+            // 64-bit products, so it is used only when configured with --enable-karatsuba.
+            parallel_for(base_mod_count, [&](int j) {
+                bool in_coeff_base = j < coeff_mod_count;
+                int base_index = in_coeff_base ? j : j - coeff_mod_count;
+                const SmallModulus &modulus = in_coeff_base ? coeff_modulus_[base_index] : bsk_mod_array_[base_index];
+                int ptr_increment = in_coeff_base ? encrypted_ptr_increment : encrypted_bsk_ptr_increment;
+                int offset = base_index * coeff_count;
+
+                const uint64_t *c0 = (in_coeff_base ? copy_encrypted1_ntt_coeff_mod : copy_encrypted1_ntt_bsk_base_mod) + offset;
+                const uint64_t *c1 = c0 + ptr_increment;
+                const uint64_t *d0 = (in_coeff_base ? copy_encrypted2_ntt_coeff_mod : copy_encrypted2_ntt_bsk_base_mod) + offset;
+                const uint64_t *d1 = d0 + ptr_increment;
+                uint64_t *des = (in_coeff_base ? tmp_des_coeff_base.get() : tmp_des_bsk_base.get()) + offset;
+#ifdef SEAL_USE_KARATSUBA_2X2
+                dyadic_product_2x2_karatsuba_coeffmod(c0, c1, d0, d1, coeff_count, modulus, 
+                    des, des + ptr_increment, des + 2 * ptr_increment);
+#else
+                dyadic_product_2x2_coeffmod(c0, c1, d0, d1, coeff_count, modulus, 
+                    des, des + ptr_increment, des + 2 * ptr_increment);
+#endif
+            });
         }
         else
         {
-            // Perform multiplication on arbitrary size ciphertexts
-            for (int secret_power_index = 0; secret_power_index < dest_count; secret_power_index++)
-            {
-                // Loop over encrypted1 components [i], seeing if a match exists with an encrypted2 
-                // component [j] such that [i+j]=[secret_power_index]
-                // Only need to check encrypted1 components up to and including [secret_power_index], 
-                // and strictly less than [encrypted_array.size()]
-                current_encrypted1_limit = min(encrypted1_size, secret_power_index + 1);
+            // Allocate two tmp polys: one for NTT multiplication results in base q and one for result in base Bsk
+            Pointer tmp1_poly_coeff_base(allocate_poly(coeff_count, coeff_mod_count, pool));
+            Pointer tmp1_poly_bsk_base(allocate_poly(coeff_count, bsk_base_mod_count_, pool));
 
-                for (int encrypted1_index = 0; encrypted1_index < current_encrypted1_limit; encrypted1_index++)
+            // Perform multiplication on arbitrary size ciphertexts
+            parallel_for(base_mod_count, [&](int j) {
+                bool in_coeff_base = j < coeff_mod_count;
+                int base_index = in_coeff_base ? j : j - coeff_mod_count;
+                const SmallModulus &modulus = in_coeff_base ? coeff_modulus_[base_index] : bsk_mod_array_[base_index];
+                int ptr_increment = in_coeff_base ? encrypted_ptr_increment : encrypted_bsk_ptr_increment;
+                int offset = base_index * coeff_count;
+
+                const uint64_t *encrypted1_ptr = (in_coeff_base ? copy_encrypted1_ntt_coeff_mod : copy_encrypted1_ntt_bsk_base_mod) + offset;
+                const uint64_t *encrypted2_ptr = (in_coeff_base ? copy_encrypted2_ntt_coeff_mod : copy_encrypted2_ntt_bsk_base_mod) + offset;
+                uint64_t *tmp1 = (in_coeff_base ? tmp1_poly_coeff_base.get() : tmp1_poly_bsk_base.get()) + offset;
+                uint64_t *des = (in_coeff_base ? tmp_des_coeff_base.get() : tmp_des_bsk_base.get()) + offset;
+
+                for (int secret_power_index = 0; secret_power_index < dest_count; secret_power_index++)
                 {
-                    // check if a corresponding component in encrypted2 exists
-                    if (encrypted2_size > secret_power_index - encrypted1_index)
-                    {
-                        int encrypted2_index = secret_power_index - encrypted1_index;
+                    // Loop over encrypted1 components [i], seeing if a match exists with an encrypted2 
+                    // component [j] such that [i+j]=[secret_power_index]
+                    // Only need to check encrypted1 components up to and including [secret_power_index], 
+                    // and strictly less than [encrypted_array.size()]
+                    int current_encrypted1_limit = min(encrypted1_size, secret_power_index + 1);
 
-                        // NTT Multiplication and addition for results in q
-                        for (int i = 0; i < coeff_mod_count; i++)
+                    for (int encrypted1_index = 0; encrypted1_index < current_encrypted1_limit; encrypted1_index++)
+                    {
+                        // check if a corresponding component in encrypted2 exists
+                        if (encrypted2_size > secret_power_index - encrypted1_index)
                         {
-                            dyadic_product_coeffmod(copy_encrypted1_ntt_coeff_mod.get() + (i * coeff_count) + (encrypted_ptr_increment * encrypted1_index), 
-                                copy_encrypted2_ntt_coeff_mod.get() + (i * coeff_count) + (encrypted_ptr_increment * encrypted2_index), 
-                                coeff_count, coeff_modulus_[i], tmp1_poly_coeff_base.get() + (i * coeff_count));
-                            add_poly_poly_coeffmod(tmp1_poly_coeff_base.get() + (i * coeff_count), 
-                                tmp_des_coeff_base.get() + (i * coeff_count) + (secret_power_index * coeff_count * coeff_mod_count), coeff_count, 
-                                coeff_modulus_[i], tmp_des_coeff_base.get() + (i * coeff_count) + (secret_power_index * coeff_count * coeff_mod_count));
-                        }
+                            int encrypted2_index = secret_power_index - encrypted1_index;
 
-                        // NTT Multiplication and addition for results in Bsk
-                        for (int i = 0; i < bsk_base_mod_count_; i++)
-                        {
-                            dyadic_product_coeffmod(copy_encrypted1_ntt_bsk_base_mod.get() + (i * coeff_count) + (encrypted_bsk_ptr_increment * encrypted1_index), 
-                                copy_encrypted2_ntt_bsk_base_mod.get() + (i * coeff_count) + (encrypted_bsk_ptr_increment * encrypted2_index), 
-                                coeff_count, bsk_mod_array_[i], tmp1_poly_bsk_base.get() + (i * coeff_count));
-                            add_poly_poly_coeffmod(tmp1_poly_bsk_base.get() + (i * coeff_count), 
-                                tmp_des_bsk_base.get() + (i * coeff_count) + (secret_power_index * coeff_count * bsk_base_mod_count_), 
-                                coeff_count, bsk_mod_array_[i], 
-                                tmp_des_bsk_base.get() + (i * coeff_count) + (secret_power_index * coeff_count * bsk_base_mod_count_));
+                            // NTT Multiplication and addition
+                            dyadic_product_coeffmod(encrypted1_ptr + (ptr_increment * encrypted1_index), 
+                                encrypted2_ptr + (ptr_increment * encrypted2_index), coeff_count, modulus, tmp1);
+                            add_poly_poly_coeffmod(tmp1, des + (secret_power_index * ptr_increment), coeff_count, 
+                                modulus, des + (secret_power_index * ptr_increment));
                         }
                     }
                 }
-            }
-        }
-        // Convert back outputs from NTT form
-        for (int i = 0; i < dest_count; i++)
-        {
-            for (int j = 0; j < coeff_mod_count; j++)
+            });
+        }
+
+        // Now we convert back outputs from NTT form, and multiply plain modulus to both results in base q and Bsk 
+        // and allocate them together in one container as (te0)q(te'0)Bsk | ... |te count)q (te' count)Bsk to make 
+        // it ready for fast_floor. With HPS the plain modulus is part of the scaling instead.
+        Pointer tmp_coeff_bsk_together(allocate_poly(coeff_count, dest_count * base_mod_count, pool));
+        uint64_t plain_modulus = multiply_method_ == MultiplyMethod::hps ? 1 : parms_.plain_modulus().value();
+        parallel_for(dest_count * base_mod_count, [&](int index) {
+            int i = index / base_mod_count;
+            int j = index % base_mod_count;
+            uint64_t *together_ptr = tmp_coeff_bsk_together.get() + (index * coeff_count);
+            if (j < coeff_mod_count)
             {
-                inverse_ntt_negacyclic_harvey(tmp_des_coeff_base.get() + (i * (encrypted_ptr_increment)) + (j * coeff_count), coeff_small_ntt_tables_[j]);
+                uint64_t *des_ptr = tmp_des_coeff_base.get() + (i * encrypted_ptr_increment) + (j * coeff_count);
+                inverse_ntt_negacyclic_harvey(des_ptr, coeff_small_ntt_tables_[j]);
+                multiply_poly_scalar_coeffmod(des_ptr, coeff_count, plain_modulus, coeff_modulus_[j], together_ptr);
             }
-            for (int j = 0; j < bsk_base_mod_count_; j++)
+            else
             {
-                inverse_ntt_negacyclic_harvey(tmp_des_bsk_base.get() + (i * (encrypted_bsk_ptr_increment)) + (j * coeff_count), bsk_small_ntt_tables_[j]);
+                j -= coeff_mod_count;
+                uint64_t *des_ptr = tmp_des_bsk_base.get() + (i * encrypted_bsk_ptr_increment) + (j * coeff_count);
+                inverse_ntt_negacyclic_harvey(des_ptr, bsk_small_ntt_tables_[j]);
+                multiply_poly_scalar_coeffmod(des_ptr, coeff_count, plain_modulus, bsk_mod_array_[j], together_ptr);
             }
-        }
-
-        // Now we multiply plain modulus to both results in base q and Bsk and allocate them together in one 
-        // container as (te0)q(te'0)Bsk | ... |te count)q (te' count)Bsk to make it ready for fast_floor 
-        Pointer tmp_coeff_bsk_together(allocate_poly(coeff_count, dest_count * (coeff_mod_count + bsk_base_mod_count_), pool));
-        uint64_t *tmp_coeff_bsk_together_ptr = tmp_coeff_bsk_together.get();
+        });
 
-        // Base q 
-        for (int i = 0; i < dest_count; i++)
-        {
-            for (int j = 0; j < coeff_mod_count; j++)
-            {
-                multiply_poly_scalar_coeffmod(tmp_des_coeff_base.get() + (j * coeff_count) + (i * encrypted_ptr_increment), 
-                    coeff_count, parms_.plain_modulus().value(), coeff_modulus_[j], tmp_coeff_bsk_together_ptr + (j * coeff_count));
-            }
-            tmp_coeff_bsk_together_ptr += encrypted_ptr_increment;
-            
-            for (int k = 0; k < bsk_base_mod_count_; k++)
+        // Allocate a new poly for fast floor result in Bsk
+        Pointer tmp_result_bsk(allocate_poly(coeff_count, dest_count * bsk_base_mod_count_, pool));
+        parallel_for(dest_count, [&](int i) {
+            const uint64_t *together_ptr = tmp_coeff_bsk_together.get() + (i * (encrypted_ptr_increment + encrypted_bsk_ptr_increment));
+            uint64_t *result_bsk_ptr = tmp_result_bsk.get() + (i * encrypted_bsk_ptr_increment);
+            if (multiply_method_ == MultiplyMethod::hps)
             {
-                multiply_poly_scalar_coeffmod(tmp_des_bsk_base.get() + (k * coeff_count) + (i * encrypted_bsk_ptr_increment), 
-                    coeff_count, parms_.plain_modulus().value(), bsk_mod_array_[k], tmp_coeff_bsk_together_ptr + (k * coeff_count));
+                // Step 3: scale by t/q and round from q U P to P
+                hps_converter_.scale_and_round(together_ptr, result_bsk_ptr, pool);
+
+                // Step 4: exact base convert from P to q
+                hps_converter_.exact_convert_p_to_q(result_bsk_ptr, destination.mutable_pointer(i), pool);
+                return;
             }
-            tmp_coeff_bsk_together_ptr += encrypted_bsk_ptr_increment;
-        }
 
-        // Allocate a new poly for fast floor result in Bsk
-        Pointer tmp_result_bsk(allocate_poly(coeff_count, dest_count * bsk_base_mod_count_, pool));
-        for (int i = 0; i < dest_count; i++)
-        {
             // Step 3: fast floor from q U {Bsk} to Bsk 
-            base_converter_.fast_floor(tmp_coeff_bsk_together.get() + (i * (encrypted_ptr_increment + encrypted_bsk_ptr_increment)), 
-                tmp_result_bsk.get() + (i * encrypted_bsk_ptr_increment), pool);
+            base_converter_.fast_floor(together_ptr, result_bsk_ptr, pool);
 
             // Step 4: fast base convert from Bsk to q
-            base_converter_.fastbconv_sk(tmp_result_bsk.get() + (i * encrypted_bsk_ptr_increment), encrypted1.mutable_pointer(i), pool);
-        }
+            base_converter_.fastbconv_sk(result_bsk_ptr, destination.mutable_pointer(i), pool);
+        }, pool);
     }
 
     void Evaluator::square(Ciphertext &encrypted, const MemoryPoolHandle &pool)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->square(encrypted, pool);
+            return;
+        }
+
         int encrypted_size = encrypted.size();
 
         // Optimization implemented currently only for size 2 ciphertexts
@@ -729,6 +971,10 @@ namespace seal
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
+        if (encrypted.is_ntt_form_)
+        {
+            throw invalid_argument("encrypted cannot be in NTT form");
+        }
         if (!pool)
         {
             throw invalid_argument("pool is uninitialized");
@@ -737,22 +983,34 @@ namespace seal
         // Prepare destination
         encrypted.resize(parms_, dest_count);
 
+        int base_mod_count = coeff_mod_count + bsk_base_mod_count_;
+
         // Make temp poly for FastBConverter result from q ---> Bsk U {m_tilde}
-        Pointer tmp_encrypted_bsk_mtilde(allocate_poly(coeff_count * encrypted_size, bsk_mtilde_count, pool));
+        Pointer tmp_encrypted_bsk_mtilde;
+        if (multiply_method_ == MultiplyMethod::behz)
+        {
+            tmp_encrypted_bsk_mtilde = allocate_poly(coeff_count * encrypted_size, bsk_mtilde_count, pool);
+        }
 
         // Make temp poly for FastBConverter result from Bsk U {m_tilde} -----> Bsk
         Pointer tmp_encrypted_bsk(allocate_poly(coeff_count * encrypted_size, bsk_base_mod_count_, pool));
 
         // Step 0: fast base convert from q to Bsk U {m_tilde}
         // Step 1: reduce q-overflows in Bsk
+        // With HPS, instead convert exactly from q to P
         // Iterate over all the ciphertexts inside encrypted1
-        for (int i = 0; i < encrypted_size; i++)
-        {
+        parallel_for(encrypted_size, [&](int i) {
+            if (multiply_method_ == MultiplyMethod::hps)
+            {
+                hps_converter_.exact_convert_q_to_p(encrypted.pointer(i),
+                    tmp_encrypted_bsk.get() + (i * encrypted_bsk_ptr_increment), pool);
+                return;
+            }
             base_converter_.fastbconv_mtilde(encrypted.pointer(i),
                 tmp_encrypted_bsk_mtilde.get() + (i * encrypted_bsk_mtilde_ptr_increment), pool);
             base_converter_.mont_rq(tmp_encrypted_bsk_mtilde.get() + (i * encrypted_bsk_mtilde_ptr_increment),
                 tmp_encrypted_bsk.get() + (i * encrypted_bsk_ptr_increment));
-        }
+        }, pool);
 
         // Step 2: compute product and multiply plain modulus to the result
         // We need to multiply both in q and Bsk. Values in encrypted_safe are in base q and values in 
@@ -770,125 +1028,102 @@ namespace seal
         Pointer copy_encrypted_ntt_bsk_base_mod(allocate_poly(coeff_count * encrypted_size, bsk_base_mod_count_, pool));
         set_poly_poly(tmp_encrypted_bsk.get(), coeff_count * encrypted_size, bsk_base_mod_count_, copy_encrypted_ntt_bsk_base_mod.get());
 
-        for (int i = 0; i < encrypted_size; i++)
-        {
-            for (int j = 0; j < coeff_mod_count; j++)
+        // Each task transforms one poly modulo one prime in q U Bsk
+        parallel_for(encrypted_size * base_mod_count, [&](int index) {
+            int i = index / base_mod_count;
+            int j = index % base_mod_count;
+            if (j < coeff_mod_count)
             {
                 ntt_negacyclic_harvey_lazy(copy_encrypted_ntt_coeff_mod.get() + (j * coeff_count) + (i * encrypted_ptr_increment), coeff_small_ntt_tables_[j]);
             }
-            for (int j = 0; j < bsk_base_mod_count_; j++)
+            else
             {
+                j -= coeff_mod_count;
                 ntt_negacyclic_harvey_lazy(copy_encrypted_ntt_bsk_base_mod.get() + (j * coeff_count) + (i * encrypted_bsk_ptr_increment), bsk_small_ntt_tables_[j]);
             }
-        }
-
-        // Perform fast squaring
-        // Compute c0^2 in base q
-        for (int i = 0; i < coeff_mod_count; i++)
-        {
-            // Des[0] in q
-            dyadic_product_coeffmod(copy_encrypted_ntt_coeff_mod.get() + (i * coeff_count),
-                copy_encrypted_ntt_coeff_mod.get() + (i * coeff_count), coeff_count, coeff_modulus_[i],
-                tmp_des_coeff_base.get() + (i * coeff_count));
-
-            // Des[2] in q
-            dyadic_product_coeffmod(copy_encrypted_ntt_coeff_mod.get() + (i * coeff_count) + encrypted_ptr_increment,
-                copy_encrypted_ntt_coeff_mod.get() + (i * coeff_count) + encrypted_ptr_increment, coeff_count,
-                coeff_modulus_[i], tmp_des_coeff_base.get() + (i * coeff_count) + (2 * encrypted_ptr_increment));
-        }
-
-        // Compute c0^2 in base bsk
-        for (int i = 0; i < bsk_base_mod_count_; i++)
-        {
-            // Des[0] in bsk
-            dyadic_product_coeffmod(copy_encrypted_ntt_bsk_base_mod.get() + (i * coeff_count),
-                copy_encrypted_ntt_bsk_base_mod.get() + (i * coeff_count), coeff_count, bsk_mod_array_[i],
-                tmp_des_bsk_base.get() + (i * coeff_count));
-
-            // Des[2] in bsk
-            dyadic_product_coeffmod(copy_encrypted_ntt_bsk_base_mod.get() + (i * coeff_count) + encrypted_bsk_ptr_increment,
-                copy_encrypted_ntt_bsk_base_mod.get() + (i * coeff_count) + encrypted_bsk_ptr_increment, coeff_count,
-                bsk_mod_array_[i], tmp_des_bsk_base.get() + (i * coeff_count) + (2 * encrypted_bsk_ptr_increment));
-        }
+        });
 
         Pointer tmp_second_mul_coeff_base(allocate_poly(coeff_count, coeff_mod_count, pool));
-
-        // Compute 2*c0*c1 in base q
-        for (int i = 0; i < coeff_mod_count; i++)
-        {
-            dyadic_product_coeffmod(copy_encrypted_ntt_coeff_mod.get() + (i * coeff_count),
-                copy_encrypted_ntt_coeff_mod.get() + (i * coeff_count) + encrypted_ptr_increment, coeff_count,
-                coeff_modulus_[i], tmp_second_mul_coeff_base.get() + (i * coeff_count));
-            add_poly_poly_coeffmod(tmp_second_mul_coeff_base.get() + (i * coeff_count),
-                tmp_second_mul_coeff_base.get() + (i * coeff_count), coeff_count, coeff_modulus_[i],
-                tmp_des_coeff_base.get() + (i * coeff_count) + encrypted_ptr_increment);
-        }
-
         Pointer tmp_second_mul_bsk_base(allocate_poly(coeff_count, bsk_base_mod_count_, pool));
 
-        // Compute 2*c0*c1 in base bsk
-        for (int i = 0; i < bsk_base_mod_count_; i++)
-        {
-            dyadic_product_coeffmod(copy_encrypted_ntt_bsk_base_mod.get() + (i * coeff_count),
-                copy_encrypted_ntt_bsk_base_mod.get() + (i * coeff_count) + encrypted_bsk_ptr_increment,
-                coeff_count, bsk_mod_array_[i], tmp_second_mul_bsk_base.get() + (i * coeff_count));
-            add_poly_poly_coeffmod(tmp_second_mul_bsk_base.get() + (i * coeff_count),
-                tmp_second_mul_bsk_base.get() + (i * coeff_count), coeff_count, bsk_mod_array_[i],
-                tmp_des_bsk_base.get() + (i * coeff_count) + encrypted_bsk_ptr_increment);
-        }
-
-        // Convert back outputs from NTT form
-        for (int i = 0; i < dest_count; i++)
-        {
-            for (int j = 0; j < coeff_mod_count; j++)
+        // Perform fast squaring independently modulo each prime in q U Bsk. Task j works on the j-th prime 
+        // of q if j < coeff_mod_count, and on the (j - coeff_mod_count)-th prime of Bsk otherwise.
+        parallel_for(base_mod_count, [&](int j) {
+            bool in_coeff_base = j < coeff_mod_count;
+            int base_index = in_coeff_base ? j : j - coeff_mod_count;
+            const SmallModulus &modulus = in_coeff_base ? coeff_modulus_[base_index] : bsk_mod_array_[base_index];
+            int ptr_increment = in_coeff_base ? encrypted_ptr_increment : encrypted_bsk_ptr_increment;
+            int offset = base_index * coeff_count;
+
+            const uint64_t *c0 = (in_coeff_base ? copy_encrypted_ntt_coeff_mod.get() : copy_encrypted_ntt_bsk_base_mod.get()) + offset;
+            const uint64_t *c1 = c0 + ptr_increment;
+            uint64_t *tmp_second_mul = (in_coeff_base ? tmp_second_mul_coeff_base.get() : tmp_second_mul_bsk_base.get()) + offset;
+            uint64_t *des = (in_coeff_base ? tmp_des_coeff_base.get() : tmp_des_bsk_base.get()) + offset;
+
+            // Des[0] = c0^2 and Des[2] = c1^2
+            dyadic_product_coeffmod(c0, c0, coeff_count, modulus, des);
+            dyadic_product_coeffmod(c1, c1, coeff_count, modulus, des + (2 * ptr_increment));
+
+            // Des[1] = 2*c0*c1
+            dyadic_product_coeffmod(c0, c1, coeff_count, modulus, tmp_second_mul);
+            add_poly_poly_coeffmod(tmp_second_mul, tmp_second_mul, coeff_count, modulus, des + ptr_increment);
+        });
+
+        // Now we convert back outputs from NTT form, and multiply plain modulus to both results in base q and Bsk 
+        // and allocate them together in one container as (te0)q(te'0)Bsk | ... |te count)q (te' count)Bsk to make 
+        // it ready for fast_floor. With HPS the plain modulus is part of the scaling instead.
+        Pointer tmp_coeff_bsk_together(allocate_poly(coeff_count, dest_count * base_mod_count, pool));
+        uint64_t plain_modulus = multiply_method_ == MultiplyMethod::hps ? 1 : parms_.plain_modulus().value();
+        parallel_for(dest_count * base_mod_count, [&](int index) {
+            int i = index / base_mod_count;
+            int j = index % base_mod_count;
+            uint64_t *together_ptr = tmp_coeff_bsk_together.get() + (index * coeff_count);
+            if (j < coeff_mod_count)
             {
-                inverse_ntt_negacyclic_harvey_lazy(tmp_des_coeff_base.get() + (i * (encrypted_ptr_increment)) + (j * coeff_count),
-                    coeff_small_ntt_tables_[j]);
+                uint64_t *des_ptr = tmp_des_coeff_base.get() + (i * encrypted_ptr_increment) + (j * coeff_count);
+                inverse_ntt_negacyclic_harvey_lazy(des_ptr, coeff_small_ntt_tables_[j]);
+                multiply_poly_scalar_coeffmod(des_ptr, coeff_count, plain_modulus, coeff_modulus_[j], together_ptr);
             }
-            for (int j = 0; j < bsk_base_mod_count_; j++)
+            else
             {
-                inverse_ntt_negacyclic_harvey_lazy(tmp_des_bsk_base.get() + (i * (encrypted_bsk_ptr_increment)) + (j * coeff_count), bsk_small_ntt_tables_[j]);
+                j -= coeff_mod_count;
+                uint64_t *des_ptr = tmp_des_bsk_base.get() + (i * encrypted_bsk_ptr_increment) + (j * coeff_count);
+                inverse_ntt_negacyclic_harvey_lazy(des_ptr, bsk_small_ntt_tables_[j]);
+                multiply_poly_scalar_coeffmod(des_ptr, coeff_count, plain_modulus, bsk_mod_array_[j], together_ptr);
             }
-        }
+        });
 
-        // Now we multiply plain modulus to both results in base q and Bsk and allocate them together in one 
-        // container as (te0)q(te'0)Bsk | ... |te count)q (te' count)Bsk to make it ready for fast_floor 
-        Pointer tmp_coeff_bsk_together(allocate_poly(coeff_count, dest_count * (coeff_mod_count + bsk_base_mod_count_), pool));
-        uint64_t *tmp_coeff_bsk_together_ptr = tmp_coeff_bsk_together.get();
-
-        // Base q 
-        for (int i = 0; i < dest_count; i++)
-        {
-            for (int j = 0; j < coeff_mod_count; j++)
+        // Allocate a new poly for fast floor result in Bsk
+        Pointer tmp_result_bsk(allocate_poly(coeff_count, dest_count * bsk_base_mod_count_, pool));
+        parallel_for(dest_count, [&](int i) {
+            const uint64_t *together_ptr = tmp_coeff_bsk_together.get() + (i * (encrypted_ptr_increment + encrypted_bsk_ptr_increment));
+            uint64_t *result_bsk_ptr = tmp_result_bsk.get() + (i * encrypted_bsk_ptr_increment);
+            if (multiply_method_ == MultiplyMethod::hps)
             {
-                multiply_poly_scalar_coeffmod(tmp_des_coeff_base.get() + (j * coeff_count) + (i * encrypted_ptr_increment),
-                    coeff_count, parms_.plain_modulus().value(), coeff_modulus_[j], tmp_coeff_bsk_together_ptr + (j * coeff_count));
-            }
-            tmp_coeff_bsk_together_ptr += encrypted_ptr_increment;
+                // Step 3: scale by t/q and round from q U P to P
+                hps_converter_.scale_and_round(together_ptr, result_bsk_ptr, pool);
 
-            for (int k = 0; k < bsk_base_mod_count_; k++)
-            {
-                multiply_poly_scalar_coeffmod(tmp_des_bsk_base.get() + (k * coeff_count) + (i * encrypted_bsk_ptr_increment),
-                    coeff_count, parms_.plain_modulus().value(), bsk_mod_array_[k], tmp_coeff_bsk_together_ptr + (k * coeff_count));
+                // Step 4: exact base convert from P to q
+                hps_converter_.exact_convert_p_to_q(result_bsk_ptr, encrypted.mutable_pointer(i), pool);
+                return;
             }
-            tmp_coeff_bsk_together_ptr += encrypted_bsk_ptr_increment;
-        }
 
-        // Allocate a new poly for fast floor result in Bsk
-        Pointer tmp_result_bsk(allocate_poly(coeff_count, dest_count * bsk_base_mod_count_, pool));
-        for (int i = 0; i < dest_count; i++)
-        {
             // Step 3: fast floor from q U {Bsk} to Bsk 
-            base_converter_.fast_floor(tmp_coeff_bsk_together.get() + (i * (encrypted_ptr_increment + encrypted_bsk_ptr_increment)),
-                tmp_result_bsk.get() + (i * encrypted_bsk_ptr_increment), pool);
+            base_converter_.fast_floor(together_ptr, result_bsk_ptr, pool);
 
             // Step 4: fast base convert from Bsk to q
-            base_converter_.fastbconv_sk(tmp_result_bsk.get() + (i * encrypted_bsk_ptr_increment), encrypted.mutable_pointer(i), pool);
-        }
+            base_converter_.fastbconv_sk(result_bsk_ptr, encrypted.mutable_pointer(i), pool);
+        }, pool);
     }
 
     void Evaluator::relinearize(Ciphertext &encrypted, const EvaluationKeys &evaluation_keys, int destination_size, const MemoryPoolHandle &pool)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->relinearize(encrypted, evaluation_keys, destination_size, pool);
+            return;
+        }
+
         // Extract encryption parameters.
         int encrypted_size = encrypted.size();
 
@@ -901,7 +1136,7 @@ namespace seal
         {
             throw invalid_argument("destination_size must be greater than or equal to 2 and less than or equal to current count");
         }
-        if (evaluation_keys.hash_block() != parms_.hash_block())
+        if (evaluation_keys.hash_block() != top_level_hash_block_)
         {
             throw invalid_argument("evaluation_keys is not valid for encryption parameters");
         }
@@ -919,6 +1154,7 @@ namespace seal
         {
             return;
         }
+        encrypted.clear_seed();
 
         // Calculate number of relinearize_one_step calls needed
         int relins_needed = encrypted_size - destination_size;
@@ -926,7 +1162,8 @@ namespace seal
         // Update temp to store the current result after relinearization
         for (int i = 0; i < relins_needed; i++)
         {
-            relinearize_one_step(encrypted.mutable_pointer(), encrypted_size, evaluation_keys, pool);
+            relinearize_one_step(encrypted.mutable_pointer(), encrypted_size, evaluation_keys, 
+                encrypted.is_ntt_form_, pool);
             encrypted_size--;
         }
 
@@ -935,7 +1172,8 @@ namespace seal
         encrypted.resize(parms_, destination_size);
     }
 
-    void Evaluator::relinearize_one_step(uint64_t *encrypted, int encrypted_size, const EvaluationKeys &evaluation_keys, const MemoryPoolHandle &pool)
+    void Evaluator::relinearize_one_step(uint64_t *encrypted, int encrypted_size, const EvaluationKeys &evaluation_keys, 
+        bool is_ntt_form, const MemoryPoolHandle &pool)
     {
 #ifdef SEAL_DEBUG
         if (encrypted == nullptr)
@@ -946,7 +1184,7 @@ namespace seal
         {
             throw invalid_argument("encrypted_size must be at least 3");
         }
-        if (evaluation_keys.hash_block() != parms_.hash_block())
+        if (evaluation_keys.hash_block() != top_level_hash_block_)
         {
             throw invalid_argument("evaluation_keys is not valid for encryption parameters");
         }
@@ -963,113 +1201,145 @@ namespace seal
         int coeff_mod_count = coeff_modulus_.size();
         int array_poly_uint64_count = coeff_count * coeff_mod_count;
 
-        const uint64_t *encrypted_coeff = encrypted + (encrypted_size - 1) * array_poly_uint64_count;
-        Pointer encrypted_coeff_prod_inv_coeff(allocate_uint(coeff_count, pool));
+        // Calculate (encrypted[count-1] * evaluation_key.first, encrypted[count-1] * evaluation_key.second)
+        // and add it to (encrypted[0], encrypted[1]); the last component is multiplied by s^(count-1),
+        // which is the power encrypted in evaluation key count-3
+        switch_key_inplace(encrypted + (encrypted_size - 1) * array_poly_uint64_count, evaluation_keys.data()[encrypted_size - 3],
+            evaluation_keys.decomposition_bit_count(), encrypted, is_ntt_form, pool);
+    }
+
+    Pointer Evaluator::decompose_key_switch_source(const uint64_t *source, const vector<Ciphertext> &key,
+        int decomposition_bit_count, vector<int> &decomp_offsets, const MemoryPoolHandle &pool)
+    {
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+
+        // Decompose source into base w
+        // Want to create an array of polys, each of whose components i is (source)^(i) - in the notation of FV paper
+        // The decomposed factors modulo prime i start at decomp_offsets[i]
+        decomp_offsets.assign(coeff_mod_count + 1, 0);
+        for (int i = 0; i < coeff_mod_count; i++)
+        {
+            decomp_offsets[i + 1] = decomp_offsets[i] + key[i].size() / 2;
+        }
+        Pointer source_prod_inv_coeff(allocate_poly(coeff_count, coeff_mod_count, pool));
+        Pointer decomp_source(allocate_poly(coeff_count, decomp_offsets[coeff_mod_count], pool));
+        parallel_for(coeff_mod_count, [&](int i) {
+            uint64_t *source_prod_inv_coeff_ptr = source_prod_inv_coeff.get() + (i * coeff_count);
+            multiply_poly_scalar_coeffmod(source + (i * coeff_count), coeff_count, 
+                key_inv_coeff_products_mod_coeff_array_[i], coeff_modulus_[i], source_prod_inv_coeff_ptr);
+
+            int shift = 0;
+            for (int k = decomp_offsets[i]; k < decomp_offsets[i + 1]; k++)
+            {
+                uint64_t *decomp_ptr = decomp_source.get() + (k * coeff_count);
+                for (int coeff_index = 0; coeff_index < coeff_count; coeff_index++)
+                {
+                    decomp_ptr[coeff_index] = source_prod_inv_coeff_ptr[coeff_index] >> shift;
+                    decomp_ptr[coeff_index] &= (1ULL << decomposition_bit_count) - 1;
+                }
+                shift += decomposition_bit_count;
+            }
+        });
+        return decomp_source;
+    }
+
+    void Evaluator::switch_key_inplace(const uint64_t *source, const vector<Ciphertext> &key, 
+        int decomposition_bit_count, uint64_t *destination, bool is_ntt_form, const MemoryPoolHandle &pool)
+    {
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+        int array_poly_uint64_count = coeff_count * coeff_mod_count;
+
+        // The decomposition needs source in coefficient representation
+        Pointer source_copy;
+        if (is_ntt_form)
+        {
+            source_copy = allocate_poly(coeff_count, coeff_mod_count, pool);
+            set_poly_poly(source, coeff_count, coeff_mod_count, source_copy.get());
+            parallel_for(coeff_mod_count, [&](int j) {
+                inverse_ntt_negacyclic_harvey(source_copy.get() + (j * coeff_count), coeff_small_ntt_tables_[j]);
+            });
+            source = source_copy.get();
+        }
 
-        // Decompose encrypted_array[count-1] into base w
-        // Want to create an array of polys, each of whose components i is (encrypted_array[count-1])^(i) - in the notation of FV paper
-        // This allocation stores one of the decomposed factors modulo one of the primes
-        Pointer decomp_encrypted_last(allocate_uint(coeff_count, pool));
+        vector<int> decomp_offsets;
+        Pointer decomp_source(decompose_key_switch_source(source, key, decomposition_bit_count, decomp_offsets, pool));
 
-        // Lazy reduction   
+        // Lazy reduction
         Pointer wide_innerresult0(allocate_zero_poly(coeff_count, 2 * coeff_mod_count, pool));
         Pointer wide_innerresult1(allocate_zero_poly(coeff_count, 2 * coeff_mod_count, pool));
         Pointer innerresult(allocate_poly(coeff_count, coeff_mod_count, pool));
-        Pointer temp_decomp_coeff(allocate_uint(coeff_count, pool));
+        Pointer temp_decomp_coeff(allocate_poly(coeff_count, coeff_mod_count, pool));
 
         /*
         For lazy reduction to work here, we need to ensure that the 128-bit accumulators (wide_innerresult0 and wide_innerresult1)
         do not overflow. Since the modulus primes are at most 60 bits, if the total number of summands is K, then the size of the
         total sum of products (without reduction) is at most 62 + 60 + bit_length(K). We need this to be at most 128, thus we need
-        bit_length(K) <= 6. Thus, we need K <= 63. In this case, this means sum_i evaluation_keys.data()[0][i].size() / 2 <= 63.
-        */
-        for (int i = 0; i < coeff_mod_count; i++)
-        {
-            multiply_poly_scalar_coeffmod(encrypted_coeff + (i * coeff_count), coeff_count, 
-                inv_coeff_products_mod_coeff_array_[i], coeff_modulus_[i], encrypted_coeff_prod_inv_coeff.get());
+        bit_length(K) <= 6. Thus, we need K <= 63. In this case, this means sum_i key[i].size() / 2 <= 63.
 
-            int shift = 0;
-            const Ciphertext &key_component_ref = evaluation_keys.data()[0][i];
-            int keys_size = key_component_ref.size();
-            for (int k = 0; k < keys_size; k += 2)
+        The accumulation modulo each prime j is independent of the others, so each task handles one prime.
+        */
+        parallel_for(coeff_mod_count, [&](int j) {
+            uint64_t *temp_decomp_coeff_ptr = temp_decomp_coeff.get() + (j * coeff_count);
+            uint64_t *wide_innerresult0_poly_ptr = wide_innerresult0.get() + (j * 2 * coeff_count);
+            uint64_t *wide_innerresult1_poly_ptr = wide_innerresult1.get() + (j * 2 * coeff_count);
+            for (int i = 0; i < coeff_mod_count; i++)
             {
-                const uint64_t *key_ptr_0 = key_component_ref.pointer(k);
-                const uint64_t *key_ptr_1 = key_component_ref.pointer(k + 1);
-
-                // Decompose here
-                int decomposition_bit_count = evaluation_keys.decomposition_bit_count();
-                for (int coeff_index = 0; coeff_index < coeff_count; coeff_index++)
+                const Ciphertext &key_component_ref = key[i];
+                int keys_size = key_component_ref.size();
+                for (int k = 0; k < keys_size; k += 2)
                 {
-                    decomp_encrypted_last[coeff_index] = encrypted_coeff_prod_inv_coeff[coeff_index] >> shift;
-                    decomp_encrypted_last[coeff_index] &= (1ULL << decomposition_bit_count) - 1;
-                }
-
-                uint64_t *wide_innerresult0_ptr = wide_innerresult0.get();
-                uint64_t *wide_innerresult1_ptr = wide_innerresult1.get();
-                for (int j = 0; j < coeff_mod_count; j++)
-                {
-                    uint64_t *temp_decomp_coeff_ptr = temp_decomp_coeff.get();
-                    set_uint_uint(decomp_encrypted_last.get(), coeff_count, temp_decomp_coeff_ptr);
+                    const uint64_t *key_ptr_0 = key_component_ref.pointer(k) + (j * coeff_count);
+                    const uint64_t *key_ptr_1 = key_component_ref.pointer(k + 1) + (j * coeff_count);
+                    set_uint_uint(decomp_source.get() + ((decomp_offsets[i] + (k >> 1)) * coeff_count), 
+                        coeff_count, temp_decomp_coeff_ptr);
 
                     // We don't reduce here, so might get up to two extra bits. Thus 62 bits at most.
                     ntt_negacyclic_harvey_lazy(temp_decomp_coeff_ptr, coeff_small_ntt_tables_[j]);
 
                     // Lazy reduction
                     uint64_t wide_innerproduct[2];
-                    for (int m = 0; m < coeff_count; m++, wide_innerresult0_ptr += 2)
+                    uint64_t *wide_innerresult0_ptr = wide_innerresult0_poly_ptr;
+                    uint64_t *wide_innerresult1_ptr = wide_innerresult1_poly_ptr;
+                    for (int m = 0; m < coeff_count; m++, wide_innerresult0_ptr += 2, wide_innerresult1_ptr += 2)
                     {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_0++, wide_innerproduct);
+                        multiply_uint64(temp_decomp_coeff_ptr[m], key_ptr_0[m], wide_innerproduct);
                         unsigned char carry = add_uint64(wide_innerresult0_ptr[0], wide_innerproduct[0], 0,
                             wide_innerresult0_ptr);
                         wide_innerresult0_ptr[1] += wide_innerproduct[1] + carry;
-                    }
 
-                    temp_decomp_coeff_ptr = temp_decomp_coeff.get();
-                    for (int m = 0; m < coeff_count; m++, wide_innerresult1_ptr += 2)
-                    {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_1++, wide_innerproduct);
-                        unsigned char carry = add_uint64(wide_innerresult1_ptr[0], wide_innerproduct[0], 0,
+                        multiply_uint64(temp_decomp_coeff_ptr[m], key_ptr_1[m], wide_innerproduct);
+                        carry = add_uint64(wide_innerresult1_ptr[0], wide_innerproduct[0], 0,
                             wide_innerresult1_ptr);
                         wide_innerresult1_ptr[1] += wide_innerproduct[1] + carry;
                     }
                 }
-                shift += decomposition_bit_count;
             }
-        }
 
-        uint64_t *innerresult_poly_ptr = innerresult.get();
-        uint64_t *wide_innerresult_poly_ptr = wide_innerresult0.get();
-        uint64_t *encrypted_ptr = encrypted;
-        uint64_t *innerresult_coeff_ptr = innerresult_poly_ptr;
-        uint64_t *wide_innerresult_coeff_ptr = wide_innerresult_poly_ptr;
-        for (int i = 0; i < coeff_mod_count; i++, innerresult_poly_ptr += coeff_count,
-            wide_innerresult_poly_ptr += 2 * coeff_count, encrypted_ptr += coeff_count)
-        {
-            for (int m = 0; m < coeff_count; m++, wide_innerresult_coeff_ptr += 2)
+            uint64_t *innerresult_poly_ptr = innerresult.get() + (j * coeff_count);
+            for (int m = 0; m < coeff_count; m++)
             {
-                *innerresult_coeff_ptr++ = barrett_reduce_128(wide_innerresult_coeff_ptr, coeff_modulus_[i]);
+                innerresult_poly_ptr[m] = barrett_reduce_128(wide_innerresult0_poly_ptr + (2 * m), coeff_modulus_[j]);
             }
-            inverse_ntt_negacyclic_harvey(innerresult_poly_ptr, coeff_small_ntt_tables_[i]);
-            add_poly_poly_coeffmod(encrypted_ptr, innerresult_poly_ptr, coeff_count,
-                coeff_modulus_[i], encrypted_ptr);
-        }
+            if (!is_ntt_form)
+            {
+                inverse_ntt_negacyclic_harvey(innerresult_poly_ptr, coeff_small_ntt_tables_[j]);
+            }
+            add_poly_poly_coeffmod(destination + (j * coeff_count), innerresult_poly_ptr, coeff_count,
+                coeff_modulus_[j], destination + (j * coeff_count));
 
-        innerresult_poly_ptr = innerresult.get();
-        wide_innerresult_poly_ptr = wide_innerresult1.get();
-        encrypted_ptr = encrypted + array_poly_uint64_count;
-        innerresult_coeff_ptr = innerresult_poly_ptr;
-        wide_innerresult_coeff_ptr = wide_innerresult_poly_ptr;
-        for (int i = 0; i < coeff_mod_count; i++, innerresult_poly_ptr += coeff_count,
-            wide_innerresult_poly_ptr += 2 * coeff_count, encrypted_ptr += coeff_count)
-        {
-            for (int m = 0; m < coeff_count; m++, wide_innerresult_coeff_ptr += 2)
+            for (int m = 0; m < coeff_count; m++)
             {
-                *innerresult_coeff_ptr++ = barrett_reduce_128(wide_innerresult_coeff_ptr, coeff_modulus_[i]);
+                innerresult_poly_ptr[m] = barrett_reduce_128(wide_innerresult1_poly_ptr + (2 * m), coeff_modulus_[j]);
             }
-            inverse_ntt_negacyclic_harvey(innerresult_poly_ptr, coeff_small_ntt_tables_[i]);
-            add_poly_poly_coeffmod(encrypted_ptr, innerresult_poly_ptr, coeff_count,
-                coeff_modulus_[i], encrypted_ptr);
-        }
+            if (!is_ntt_form)
+            {
+                inverse_ntt_negacyclic_harvey(innerresult_poly_ptr, coeff_small_ntt_tables_[j]);
+            }
+            add_poly_poly_coeffmod(destination + array_poly_uint64_count + (j * coeff_count), innerresult_poly_ptr, 
+                coeff_count, coeff_modulus_[j], destination + array_poly_uint64_count + (j * coeff_count));
+        });
     }
 
     void Evaluator::multiply_many(vector<Ciphertext> &encrypteds, const EvaluationKeys &evaluation_keys, Ciphertext &destination, const MemoryPoolHandle &pool)
@@ -1084,6 +1354,12 @@ namespace seal
             throw invalid_argument("pool is uninitialized");
         }
 
+        if (Evaluator *evaluator = level_evaluator(encrypteds[0].hash_block_))
+        {
+            evaluator->multiply_many(encrypteds, evaluation_keys, destination, pool);
+            return;
+        }
+
         // If there is only one ciphertext, return it after checking validity.
         if (encrypteds.size() == 1)
         {
@@ -1096,58 +1372,237 @@ namespace seal
             return;
         }
 
-        // Repeatedly multiply and add to the back of the vector until the end is reached
-        Ciphertext product(parms_, pool);
-        for (size_t i = 0; i < encrypteds.size() - 1; i += 2)
+        // Multiply in a balanced tree. The products on each level are independent, so they
+        // are computed in parallel; an odd ciphertext out is carried to the next level.
+        vector<const Ciphertext*> operands;
+        operands.reserve(encrypteds.size());
+        for (const auto &encrypted : encrypteds)
+        {
+            operands.push_back(&encrypted);
+        }
+        vector<Ciphertext> products;
+        while (operands.size() > 1)
+        {
+            int product_count = static_cast<int>(operands.size() / 2);
+            vector<Ciphertext> next_products(product_count, Ciphertext(parms_, pool));
+            parallel_for(product_count, [&](int i) {
+                // We only compare pointers to determine if a faster path can be taken.
+                // This is under the assumption that if the two pointers are the same and
+                // the parameter sets match, then it makes no sense for one of the ciphertexts
+                // to be of different size than the other. More generally, it seems like 
+                // a reasonable assumption that if the pointers are the same, then the
+                // ciphertexts are the same.
+                const Ciphertext &operand1 = *operands[2 * i];
+                const Ciphertext &operand2 = *operands[2 * i + 1];
+                if (operand1.pointer() == operand2.pointer())
+                {
+                    square(operand1, next_products[i], pool);
+                }
+                else
+                {
+                    multiply(operand1, operand2, next_products[i], pool);
+                }
+                relinearize(next_products[i], evaluation_keys, pool);
+            }, pool);
+
+            const Ciphertext *carried = nullptr;
+            if (operands.size() % 2)
+            {
+                carried = operands.back();
+                if (!products.empty() && carried == &products.back())
+                {
+                    next_products.emplace_back(move(products.back()));
+                    carried = nullptr;
+                }
+            }
+            products = move(next_products);
+            operands.clear();
+            for (const auto &product : products)
+            {
+                operands.push_back(&product);
+            }
+            if (carried)
+            {
+                operands.push_back(carried);
+            }
+        }
+        destination = *operands[0];
+    }
+
+    void Evaluator::dot_product(const vector<Ciphertext> &encrypteds1, const vector<Ciphertext> &encrypteds2,
+        Ciphertext &destination, const MemoryPoolHandle &pool)
+    {
+        // Verify parameters.
+        if (encrypteds1.empty())
+        {
+            throw invalid_argument("encrypteds1 cannot be empty");
+        }
+        if (encrypteds1.size() != encrypteds2.size())
+        {
+            throw invalid_argument("encrypteds1 and encrypteds2 must have the same size");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        if (Evaluator *evaluator = level_evaluator(encrypteds1[0].hash_block_))
+        {
+            evaluator->dot_product(encrypteds1, encrypteds2, destination, pool);
+            return;
+        }
+
+        // Extract encryption parameters.
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+
+        int max_count = 0;
+        bool destination_is_input = false;
+        for (size_t i = 0; i < encrypteds1.size(); i++)
         {
-            // We only compare pointers to determine if a faster path can be taken.
-            // This is under the assumption that if the two pointers are the same and
-            // the parameter sets match, then it makes no sense for one of the ciphertexts
-            // to be of different size than the other. More generally, it seems like 
-            // a reasonable assumption that if the pointers are the same, then the
-            // ciphertexts are the same.
-            if (encrypteds[i].pointer() == encrypteds[i + 1].pointer())
+            if (encrypteds1[i].hash_block_ != parms_.hash_block() || 
+                encrypteds2[i].hash_block_ != parms_.hash_block())
             {
-                square(encrypteds[i], product, pool);
+                throw invalid_argument("encrypteds1 or encrypteds2 is not valid for encryption parameters");
             }
-            else
+            max_count = max(max_count, encrypteds1[i].size() + encrypteds2[i].size() - 1);
+            destination_is_input = destination_is_input || 
+                &encrypteds1[i] == &destination || &encrypteds2[i] == &destination;
+        }
+
+        // Prepare destination, or a temporary if destination is one of the inputs
+        Ciphertext temp(parms_, pool);
+        Ciphertext &sum = destination_is_input ? temp : destination;
+        sum.resize(parms_, max_count);
+        sum.is_ntt_form_ = false;
+        set_zero_poly(coeff_count * max_count, coeff_mod_count, sum.mutable_pointer());
+
+        // Each product has to be scaled down separately, since the auxiliary base used in
+        // multiplication has no room for a sum of products. The scaled products are added up
+        // in 64-bit words that are reduced only when the next product could overflow them.
+        uint64_t lazy_count = numeric_limits<uint64_t>::max();
+        for (const auto &modulus : coeff_modulus_)
+        {
+            lazy_count = min(lazy_count, numeric_limits<uint64_t>::max() / modulus.value() - 1);
+        }
+        auto reduce = [&]() {
+            parallel_for(max_count * coeff_mod_count, [&](int index) {
+                const SmallModulus &modulus = coeff_modulus_[index % coeff_mod_count];
+                uint64_t *sum_ptr = sum.mutable_pointer() + (index * coeff_count);
+                for (int m = 0; m < coeff_count; m++)
+                {
+                    uint64_t wide_sum[2]{ sum_ptr[m], 0 };
+                    sum_ptr[m] = barrett_reduce_128(wide_sum, modulus);
+                }
+            });
+        };
+        Ciphertext product(parms_, max_count, pool);
+        uint64_t pending_count = 0;
+        for (size_t i = 0; i < encrypteds1.size(); i++)
+        {
+            multiply(encrypteds1[i], encrypteds2[i], product, pool);
+            const uint64_t *product_ptr = product.pointer();
+            uint64_t *sum_ptr = sum.mutable_pointer();
+            int product_uint64_count = product.size() * coeff_count * coeff_mod_count;
+            for (int m = 0; m < product_uint64_count; m++)
+            {
+                sum_ptr[m] += product_ptr[m];
+            }
+            if (++pending_count == lazy_count)
             {
-                multiply(encrypteds[i], encrypteds[i + 1], product, pool);
+                reduce();
+                pending_count = 0;
             }
-            relinearize(product, evaluation_keys, pool);
-            encrypteds.emplace_back(product);
         }
-        destination = encrypteds[encrypteds.size() - 1];
+        reduce();
+
+        if (destination_is_input)
+        {
+            destination = temp;
+        }
     }
 
     void Evaluator::exponentiate(Ciphertext &encrypted, uint64_t exponent, const EvaluationKeys &evaluation_keys, const MemoryPoolHandle &pool)
     {
+        if (exponent == 0)
+        {
+            throw invalid_argument("exponent cannot be 0");
+        }
+        exponentiate(encrypted, ExponentiationPlan(exponent), evaluation_keys, pool);
+    }
+
+    void Evaluator::exponentiate(Ciphertext &encrypted, const ExponentiationPlan &plan, const EvaluationKeys &evaluation_keys, const MemoryPoolHandle &pool)
+    {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->exponentiate(encrypted, plan, evaluation_keys, pool);
+            return;
+        }
+
         // Verify parameters.
         if (encrypted.hash_block_ != parms_.hash_block())
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-        if (exponent == 0)
+        if (encrypted.is_ntt_form_)
         {
-            throw invalid_argument("exponent cannot be 0");
+            throw invalid_argument("encrypted cannot be in NTT form");
         }
         if (!pool)
         {
             throw invalid_argument("pool is uninitialized");
         }
 
-        if (exponent == 1)
+        if (plan.steps().empty())
         {
             return;
         }
 
-        // Create a vector of aliased ciphertexts
-        vector<Ciphertext> exp_vector(exponent, Ciphertext(parms_, encrypted.size(), encrypted.mutable_pointer()));
-        multiply_many(exp_vector, evaluation_keys, encrypted, pool);
+        // Run the steps of the plan on a few ciphertext slots, starting from a copy of
+        // encrypted, and relinearize products that grow larger than allowed
+        vector<Ciphertext> slots(plan.slot_count(), Ciphertext(parms_, pool));
+        slots[0] = encrypted;
+        for (const auto &step : plan.steps())
+        {
+            Ciphertext &destination = slots[step.destination];
+            if (step.operand1 == step.operand2)
+            {
+                if (step.destination == step.operand1)
+                {
+                    square(destination, pool);
+                }
+                else
+                {
+                    square(slots[step.operand1], destination, pool);
+                }
+            }
+            else
+            {
+                if (step.destination == step.operand1)
+                {
+                    multiply(destination, slots[step.operand2], pool);
+                }
+                else
+                {
+                    multiply(slots[step.operand1], slots[step.operand2], destination, pool);
+                }
+            }
+            if (destination.size() > plan.max_size())
+            {
+                relinearize(destination, evaluation_keys, plan.max_size(), pool);
+            }
+        }
+        encrypted = slots[plan.result_slot()];
     }
 
     void Evaluator::add_plain(Ciphertext &encrypted, const Plaintext &plain)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->add_plain(encrypted, plain);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -1168,6 +1623,20 @@ namespace seal
             throw invalid_argument("plain is not valid for encryption parameters");
         }
 #endif
+        encrypted.clear_seed();
+
+        if (encrypted.is_ntt_form_)
+        {
+            Pointer scaled_plain_ntt(allocate_zero_poly(coeff_count, coeff_mod_count, pool_));
+            scale_plain_to_ntt(plain, scaled_plain_ntt.get());
+            for (int j = 0; j < coeff_mod_count; j++)
+            {
+                add_poly_poly_coeffmod(encrypted.pointer() + (j * coeff_count), scaled_plain_ntt.get() + (j * coeff_count),
+                    coeff_count, coeff_modulus_[j], encrypted.mutable_pointer() + (j * coeff_count));
+            }
+            return;
+        }
+
         // This is Encryptor::preencrypt
         // Multiply plain by scalar coeff_div_plain_modulus_ and reposition if in upper-half.
         for (int i = 0; i < plain.coeff_count(); i++)
@@ -1197,6 +1666,12 @@ namespace seal
 
     void Evaluator::sub_plain(Ciphertext &encrypted, const Plaintext &plain)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->sub_plain(encrypted, plain);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -1217,6 +1692,20 @@ namespace seal
             throw invalid_argument("plain is not valid for encryption parameters");
         }
 #endif
+        encrypted.clear_seed();
+
+        if (encrypted.is_ntt_form_)
+        {
+            Pointer scaled_plain_ntt(allocate_zero_poly(coeff_count, coeff_mod_count, pool_));
+            scale_plain_to_ntt(plain, scaled_plain_ntt.get());
+            for (int j = 0; j < coeff_mod_count; j++)
+            {
+                sub_poly_poly_coeffmod(encrypted.pointer() + (j * coeff_count), scaled_plain_ntt.get() + (j * coeff_count),
+                    coeff_count, coeff_modulus_[j], encrypted.mutable_pointer() + (j * coeff_count));
+            }
+            return;
+        }
+
         // This is Encryptor::preencrypt changed to subtract instead
         // Multiply plain by scalar coeff_div_plain_modulus_ and reposition if in upper-half.
         for (int i = 0; i < plain.coeff_count(); i++)
@@ -1244,8 +1733,49 @@ namespace seal
         }
     }
 
+    void Evaluator::scale_plain_to_ntt(const Plaintext &plain, uint64_t *destination)
+    {
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+
+        // This is Encryptor::preencrypt writing to a zero polynomial instead
+        // Multiply plain by scalar coeff_div_plain_modulus_ and reposition if in upper-half.
+        for (int i = 0; i < plain.coeff_count(); i++)
+        {
+            if (plain[i] >= plain_upper_half_threshold_)
+            {
+                // Loop over primes
+                for (int j = 0; j < coeff_mod_count; j++)
+                {
+                    uint64_t temp[2]{ 0 };
+                    multiply_uint64(*(coeff_div_plain_modulus_.get() + j), plain[i], temp);
+                    temp[1] += add_uint64(temp[0], *(upper_half_increment_.get() + j), 0, temp);
+                    destination[i + (j * coeff_count)] = barrett_reduce_128(temp, coeff_modulus_[j]);
+                }
+            }
+            else
+            {
+                for (int j = 0; j < coeff_mod_count; j++)
+                {
+                    destination[i + (j * coeff_count)] = multiply_uint_uint_mod(coeff_div_plain_modulus_[j], plain[i], coeff_modulus_[j]);
+                }
+            }
+        }
+
+        // Transform to NTT domain
+        parallel_for(coeff_mod_count, [&](int j) {
+            ntt_negacyclic_harvey(destination + (j * coeff_count), coeff_small_ntt_tables_[j]);
+        });
+    }
+
     void Evaluator::multiply_plain(Ciphertext &encrypted, const Plaintext &plain, const MemoryPoolHandle &pool)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->multiply_plain(encrypted, plain, pool);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -1279,6 +1809,8 @@ namespace seal
             throw invalid_argument("pool is uninitialized");
         }
 
+        encrypted.clear_seed();
+
         // Multiplying just by a constant?
         if (plain_coeff_count == 1)
         {
@@ -1394,29 +1926,31 @@ namespace seal
 
         // Need to multiply each component in encrypted with decomposed_poly (plain poly)
         // Transform plain poly only once
-        for (int i = 0; i < coeff_mod_count; i++)
-        {
+        parallel_for(coeff_mod_count, [&](int i) {
             ntt_negacyclic_harvey(poly_to_transform + (i * coeff_count), coeff_small_ntt_tables_[i]);
-        }
+        });
 
-        for (int i = 0; i < encrypted_size; i++)
-        {
-            uint64_t *encrypted_ptr = encrypted.mutable_pointer(i);
-            for (int j = 0; j < coeff_mod_count; j++, encrypted_ptr += coeff_count)
-            {
-                // Explicit inline to avoid unnecessary copy
-                //ntt_multiply_poly_nttpoly(encrypted.pointer(i) + (j * coeff_count), poly_to_transform + (j * coeff_count),
-                //    coeff_small_ntt_tables_[j], encrypted.mutable_pointer(i) + (j * coeff_count), pool);
+        parallel_for(encrypted_size * coeff_mod_count, [&](int index) {
+            int i = index / coeff_mod_count;
+            int j = index % coeff_mod_count;
+            uint64_t *encrypted_ptr = encrypted.mutable_pointer(i) + (j * coeff_count);
 
-                int coeff_count = coeff_small_ntt_tables_[j].coeff_count() + 1;
+            // Explicit inline to avoid unnecessary copy
+            //ntt_multiply_poly_nttpoly(encrypted.pointer(i) + (j * coeff_count), poly_to_transform + (j * coeff_count),
+            //    coeff_small_ntt_tables_[j], encrypted.mutable_pointer(i) + (j * coeff_count), pool);
 
-                // Lazy reduction
+            // Lazy reduction; a ciphertext in NTT form stays in NTT form
+            if (!encrypted.is_ntt_form_)
+            {
                 ntt_negacyclic_harvey_lazy(encrypted_ptr, coeff_small_ntt_tables_[j]);
-                dyadic_product_coeffmod(encrypted_ptr, poly_to_transform + (j * coeff_count),
-                    coeff_count, coeff_small_ntt_tables_[j].modulus(), encrypted_ptr);
+            }
+            dyadic_product_coeffmod(encrypted_ptr, poly_to_transform + (j * coeff_count),
+                coeff_count, coeff_small_ntt_tables_[j].modulus(), encrypted_ptr);
+            if (!encrypted.is_ntt_form_)
+            {
                 inverse_ntt_negacyclic_harvey(encrypted_ptr, coeff_small_ntt_tables_[j]);
             }
-        }
+        });
     }
 
     void Evaluator::transform_to_ntt(Plaintext &plain, const MemoryPoolHandle &pool)
@@ -1490,14 +2024,19 @@ namespace seal
         }
 
         // Transform to NTT domain
-        for (int i = 0; i < coeff_mod_count; i++)
-        {
+        parallel_for(coeff_mod_count, [&](int i) {
             ntt_negacyclic_harvey(plain.pointer() + (i * coeff_count), coeff_small_ntt_tables_[i]);
-        }
+        });
     }
 
     void Evaluator::transform_to_ntt(Ciphertext &encrypted)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->transform_to_ntt(encrypted);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -1508,19 +2047,30 @@ namespace seal
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-
-        // Transform each polynomial to NTT domain
-        for (int i = 0; i < encrypted_size; i++)
+        if (encrypted.is_ntt_form_)
         {
-            for (int j = 0; j < coeff_mod_count; j++)
-            {
-                ntt_negacyclic_harvey(encrypted.mutable_pointer(i) + (j * coeff_count), coeff_small_ntt_tables_[j]);
-            }
+            throw invalid_argument("encrypted is already in NTT form");
         }
+
+        encrypted.clear_seed();
+
+        // Transform each polynomial to NTT domain
+        parallel_for(encrypted_size * coeff_mod_count, [&](int index) {
+            int i = index / coeff_mod_count;
+            int j = index % coeff_mod_count;
+            ntt_negacyclic_harvey(encrypted.mutable_pointer(i) + (j * coeff_count), coeff_small_ntt_tables_[j]);
+        });
+        encrypted.is_ntt_form_ = true;
     }
 
     void Evaluator::transform_from_ntt(Ciphertext &encrypted_ntt)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted_ntt.hash_block_))
+        {
+            evaluator->transform_from_ntt(encrypted_ntt);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -1531,19 +2081,30 @@ namespace seal
         {
             throw invalid_argument("encrypted_ntt is not valid for encryption parameters");
         }
-
-        // Transform each polynomial from NTT domain
-        for (int i = 0; i < encrypted_ntt_size; i++)
+        if (!encrypted_ntt.is_ntt_form_)
         {
-            for (int j = 0; j < coeff_mod_count; j++)
-            {
-                inverse_ntt_negacyclic_harvey(encrypted_ntt.mutable_pointer(i) + (j * coeff_count), coeff_small_ntt_tables_[j]);
-            }
+            throw invalid_argument("encrypted_ntt is not in NTT form");
         }
+
+        encrypted_ntt.clear_seed();
+
+        // Transform each polynomial from NTT domain
+        parallel_for(encrypted_ntt_size * coeff_mod_count, [&](int index) {
+            int i = index / coeff_mod_count;
+            int j = index % coeff_mod_count;
+            inverse_ntt_negacyclic_harvey(encrypted_ntt.mutable_pointer(i) + (j * coeff_count), coeff_small_ntt_tables_[j]);
+        });
+        encrypted_ntt.is_ntt_form_ = false;
     }
 
     void Evaluator::multiply_plain_ntt(Ciphertext &encrypted_ntt, const Plaintext &plain_ntt)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted_ntt.hash_block_))
+        {
+            evaluator->multiply_plain_ntt(encrypted_ntt, plain_ntt);
+            return;
+        }
+
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = coeff_modulus_.size();
@@ -1554,7 +2115,12 @@ namespace seal
         {
             throw invalid_argument("encrypted_ntt is not valid for encryption parameters");
         }
-        if (plain_ntt.coeff_count() != coeff_count * coeff_mod_count)
+        if (!encrypted_ntt.is_ntt_form_)
+        {
+            throw invalid_argument("encrypted_ntt is not in NTT form");
+        }
+        if (plain_ntt.coeff_count() != coeff_count * coeff_mod_count && 
+            plain_ntt.coeff_count() != coeff_count * top_level_coeff_mod_count_)
         {
             throw invalid_argument("plain_ntt is not valid for encryption parameters");
         }
@@ -1578,6 +2144,8 @@ namespace seal
             throw invalid_argument("plain_ntt cannot be zero");
         }
 #endif
+        encrypted_ntt.clear_seed();
+
         for (int i = 0; i < encrypted_size; i++)
         {
             for (int j = 0; j < coeff_mod_count; j++)
@@ -1588,8 +2156,159 @@ namespace seal
         }
     }
 
+    void Evaluator::dot_product_plain(const vector<Ciphertext> &encrypteds_ntt, const vector<Plaintext> &plains_ntt, 
+        Ciphertext &destination_ntt)
+    {
+        if (encrypteds_ntt.empty())
+        {
+            throw invalid_argument("encrypteds_ntt cannot be empty");
+        }
+        if (encrypteds_ntt.size() != plains_ntt.size())
+        {
+            throw invalid_argument("encrypteds_ntt and plains_ntt must have the same size");
+        }
+
+        vector<const Ciphertext*> encrypted_ptrs;
+        vector<const Plaintext*> plain_ptrs;
+        for (size_t i = 0; i < encrypteds_ntt.size(); i++)
+        {
+            encrypted_ptrs.push_back(&encrypteds_ntt[i]);
+            plain_ptrs.push_back(&plains_ntt[i]);
+        }
+        dot_product_plain(encrypted_ptrs, plain_ptrs, destination_ntt, pool_);
+    }
+
+    void Evaluator::dot_product_plain(const vector<const Ciphertext*> &encrypteds_ntt, 
+        const vector<const Plaintext*> &plains_ntt, Ciphertext &destination_ntt, const MemoryPoolHandle &pool)
+    {
+        if (Evaluator *evaluator = level_evaluator(encrypteds_ntt[0]->hash_block_))
+        {
+            evaluator->dot_product_plain(encrypteds_ntt, plains_ntt, destination_ntt, pool);
+            return;
+        }
+
+        // Extract encryption parameters.
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+
+        // Verify parameters.
+        int max_count = 0;
+        bool destination_is_input = false;
+        for (size_t i = 0; i < encrypteds_ntt.size(); i++)
+        {
+            const Ciphertext &encrypted_ntt = *encrypteds_ntt[i];
+            const Plaintext &plain_ntt = *plains_ntt[i];
+            if (encrypted_ntt.hash_block_ != parms_.hash_block())
+            {
+                throw invalid_argument("encrypteds_ntt is not valid for encryption parameters");
+            }
+            if (!encrypted_ntt.is_ntt_form_)
+            {
+                throw invalid_argument("encrypteds_ntt is not in NTT form");
+            }
+            if (plain_ntt.coeff_count() != coeff_count * coeff_mod_count && 
+                plain_ntt.coeff_count() != coeff_count * top_level_coeff_mod_count_)
+            {
+                throw invalid_argument("plains_ntt is not valid for encryption parameters");
+            }
+#ifdef SEAL_THROW_ON_MULTIPLY_PLAIN_BY_ZERO
+            if (plain_ntt.is_zero())
+            {
+                throw invalid_argument("plains_ntt cannot contain zero");
+            }
+#endif
+            max_count = max(max_count, encrypted_ntt.size());
+            destination_is_input = destination_is_input || &encrypted_ntt == &destination_ntt;
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        // Prepare destination, or a temporary if destination is one of the inputs
+        Ciphertext temp(parms_, pool);
+        Ciphertext &sum = destination_is_input ? temp : destination_ntt;
+        sum.resize(parms_, max_count);
+        sum.is_ntt_form_ = true;
+
+        // Each task computes one block of coefficients of one polynomial modulo one prime.
+        // The products are accumulated in 128-bit words, and reduced only when the next
+        // product could overflow them, i.e. after 2^(128 - 2 * bit_count(q)) - 1 products.
+        int product_coeff_count = coeff_count - 1;
+        int block_count = (product_coeff_count + coeff_block_size - 1) / coeff_block_size;
+        parallel_for(max_count * coeff_mod_count * block_count, [&](int task) {
+            int block_index = task % block_count;
+            int i = (task / block_count) % coeff_mod_count;
+            int j = task / (block_count * coeff_mod_count);
+            int offset = (i * coeff_count) + (block_index * coeff_block_size);
+            int length = min(coeff_block_size, product_coeff_count - (block_index * coeff_block_size));
+            const SmallModulus &modulus = coeff_modulus_[i];
+            int modulus_bit_count = modulus.bit_count();
+            uint64_t lazy_count = 2 * modulus_bit_count > 64 ? 
+                (uint64_t(1) << (128 - 2 * modulus_bit_count)) - 1 : numeric_limits<uint64_t>::max();
+
+            Pointer wide_sum(allocate_zero_uint(2 * length, pool));
+            uint64_t *wide_sum_ptr = wide_sum.get();
+            auto reduce = [&]() {
+                for (int m = 0; m < length; m++)
+                {
+                    wide_sum_ptr[2 * m] = barrett_reduce_128(wide_sum_ptr + (2 * m), modulus);
+                    wide_sum_ptr[2 * m + 1] = 0;
+                }
+            };
+            uint64_t pending_count = 0;
+            for (size_t k = 0; k < encrypteds_ntt.size(); k++)
+            {
+                if (encrypteds_ntt[k]->size() <= j)
+                {
+                    continue;
+                }
+                const uint64_t *encrypted_ptr = encrypteds_ntt[k]->pointer(j) + offset;
+                const uint64_t *plain_ptr = plains_ntt[k]->pointer() + offset;
+                uint64_t wide_product[2];
+                for (int m = 0; m < length; m++)
+                {
+                    multiply_uint64(encrypted_ptr[m], plain_ptr[m], wide_product);
+                    unsigned char carry = add_uint64(wide_sum_ptr[2 * m], wide_product[0], 0, wide_sum_ptr + (2 * m));
+                    wide_sum_ptr[2 * m + 1] += wide_product[1] + carry;
+                }
+                if (++pending_count == lazy_count)
+                {
+                    reduce();
+                    pending_count = 0;
+                }
+            }
+
+            uint64_t *sum_ptr = sum.mutable_pointer(j) + offset;
+            for (int m = 0; m < length; m++)
+            {
+                sum_ptr[m] = barrett_reduce_128(wide_sum_ptr + (2 * m), modulus);
+            }
+        }, pool);
+
+        // The highest coefficient of each polynomial is always zero
+        for (int j = 0; j < max_count; j++)
+        {
+            for (int i = 0; i < coeff_mod_count; i++)
+            {
+                sum.mutable_pointer(j)[(i * coeff_count) + product_coeff_count] = 0;
+            }
+        }
+
+        if (destination_is_input)
+        {
+            destination_ntt = temp;
+        }
+    }
+
     void Evaluator::apply_galois(Ciphertext &encrypted, uint64_t galois_elt, const GaloisKeys &galois_keys, const MemoryPoolHandle &pool)
     {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->apply_galois(encrypted, galois_elt, galois_keys, pool);
+            return;
+        }
+
         // Extract paramters
         int coeff_count = parms_.poly_modulus().coeff_count();
         int coeff_mod_count = parms_.coeff_modulus().size();
@@ -1604,7 +2323,7 @@ namespace seal
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-        if (galois_keys.hash_block_ != parms_.hash_block())
+        if (galois_keys.hash_block_ != top_level_hash_block_)
         {
             throw invalid_argument("galois_keys is not valid for encryption parameters");
         }
@@ -1617,186 +2336,559 @@ namespace seal
             throw invalid_argument("pool is uninitialized");
         }
 
+        encrypted.clear_seed();
+
         int n = coeff_count - 1;
-        int m = n << 1;
-        int subgroup_size = n >> 1;
         int n_power_of_two = get_power_of_two(n);
 
         // Check if Galois key is generated or not.
-        // If not, attempt a bit decomposition; maybe we have log(n) many keys
+        // If not, compose the automorphism from the fewest ones that have keys
         if (!galois_keys.has_key(galois_elt))
         {
-            // galois_elt = 3^order1 * (-1)^order2
-            uint64_t order1 = Zmstar_to_generator_.at(galois_elt).first;
-            uint64_t order2 = Zmstar_to_generator_.at(galois_elt).second;
-
-            // We use either 3 or -3 as our generator, depending on which gives smaller HW
-            uint64_t two_power_of_gen = 3;
-
-            // Does order1 or n/2-order1 have smaller Hamming weight?
-            if (hamming_weight(subgroup_size - order1) < hamming_weight(order1))
+            for (uint64_t path_elt : galois_path(galois_elt, galois_keys))
             {
-                order1 = subgroup_size - order1;
-                try_mod_inverse(3, m, two_power_of_gen);
+                apply_galois(encrypted, path_elt, galois_keys, pool);
             }
+            return;
+        }
 
-            while(order1)
+        // Apply Galois for each ciphertext
+        Pointer temp0(allocate_zero_uint(coeff_count * coeff_mod_count, pool));
+        Pointer temp1(allocate_zero_uint(coeff_count * coeff_mod_count, pool));
+        parallel_for(2 * coeff_mod_count, [&](int index) {
+            int i = index % coeff_mod_count;
+            uint64_t *temp_ptr = (index < coeff_mod_count) ? temp0.get() : temp1.get();
+            const uint64_t *encrypted_ptr = encrypted.pointer(index / coeff_mod_count) + (i * coeff_count);
+            if (encrypted.is_ntt_form_)
             {
-                if (order1 & 1)
-                {
-                    if (!galois_keys.has_key(two_power_of_gen))
-                    {
-                        throw invalid_argument("galois key not present");
-                    }
-                    apply_galois(encrypted, two_power_of_gen, galois_keys, pool);
-                }
-                two_power_of_gen *= two_power_of_gen;
-                two_power_of_gen &= (m - 1);
-                order1 >>= 1;
+                // In NTT form the automorphism is just a permutation of the values
+                apply_galois_ntt(encrypted_ptr, n_power_of_two, galois_elt, temp_ptr + (i * coeff_count));
             }
-            if (order2)
+            else
             {
-                if (!galois_keys.has_key(m - 1))
-                {
-                    throw invalid_argument("galois key not present");
-                }
-                apply_galois(encrypted, m - 1, galois_keys, pool);
+                util::apply_galois(encrypted_ptr, n_power_of_two, galois_elt, coeff_modulus_[i], 
+                    temp_ptr + (i * coeff_count));
             }
+        });
+
+        // Calculate (temp1 * galois_key.first, temp1 * galois_key.second) + (temp0, 0)
+        set_poly_poly(temp0.get(), coeff_count, coeff_mod_count, encrypted.mutable_pointer());
+        set_zero_poly(coeff_count, coeff_mod_count, encrypted.mutable_pointer(1));
+        // The key may be loaded on demand; holding it keeps it in memory until the switch is done
+        shared_ptr<const vector<Ciphertext> > key = galois_keys.acquire_key(galois_elt);
+        switch_key_inplace(temp1.get(), *key, galois_keys.decomposition_bit_count(),
+            encrypted.mutable_pointer(), encrypted.is_ntt_form_, pool);
+    }
+
+    void Evaluator::rotate_rows(Ciphertext &encrypted, int steps, const GaloisKeys &galois_keys, const MemoryPoolHandle &pool)
+    {
+        // Is there anything to do?
+        if (steps == 0)
+        {
             return;
         }
 
-        // Apply Galois for each ciphertext
-        Pointer temp0(allocate_zero_uint(coeff_count * coeff_mod_count, pool));
-        for (int i = 0; i < coeff_mod_count; i++)
+        // Perform rotation and key switching
+        apply_galois(encrypted, get_row_rotation_galois_elt(steps), galois_keys, pool);
+    }
+
+    void Evaluator::rotate_rows_many(const Ciphertext &encrypted, const vector<int> &steps, 
+        const GaloisKeys &galois_keys, vector<Ciphertext> &destination, const MemoryPoolHandle &pool)
+    {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
         {
-            util::apply_galois(encrypted.pointer() + (i * coeff_count), n_power_of_two,
-                galois_elt, coeff_modulus_[i], temp0.get() + (i * coeff_count));
+            evaluator->rotate_rows_many(encrypted, steps, galois_keys, destination, pool);
+            return;
         }
-        Pointer temp1(allocate_zero_uint(coeff_count * coeff_mod_count, pool));
-        for (int i = 0; i < coeff_mod_count; i++)
+
+        // Extract parameters
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+        int array_poly_uint64_count = coeff_count * coeff_mod_count;
+        int steps_count = steps.size();
+
+        // Verify parameters
+        if (encrypted.hash_block_ != parms_.hash_block())
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (galois_keys.hash_block_ != top_level_hash_block_)
+        {
+            throw invalid_argument("galois_keys is not valid for encryption parameters");
+        }
+        if (encrypted.size() != 2)
+        {
+            throw invalid_argument("ciphertext size must be 2");
+        }
+        if (!pool)
         {
-            util::apply_galois(encrypted.pointer(1) + (i * coeff_count), n_power_of_two,
-                galois_elt, coeff_modulus_[i], temp1.get() + (i * coeff_count));
+            throw invalid_argument("pool is uninitialized");
         }
 
-        // Calculate (temp1 * galois_key.first, temp1 * galois_key.second) + (temp0, 0)
-        const uint64_t *encrypted_coeff = temp1.get();
-        Pointer encrypted_coeff_prod_inv_coeff(allocate_uint(coeff_count, pool));
+        // If encrypted is an element of destination, it is overwritten or moved by the resize
+        // below, so rotate a copy of it instead
+        for (const Ciphertext &destination_element : destination)
+        {
+            if (&destination_element == &encrypted)
+            {
+                Ciphertext encrypted_copy(encrypted);
+                rotate_rows_many(encrypted_copy, steps, galois_keys, destination, pool);
+                return;
+            }
+        }
 
-        // decompose encrypted_array[count-1] into base w
-        // want to create an array of polys, each of whose components i is (encrypted_array[count-1])^(i) - in the notation of FV paper
-        // This allocation stores one of the decomposed factors modulo one of the primes
-        Pointer decomp_encrypted_last(allocate_uint(coeff_count, pool));
+        int n_power_of_two = get_power_of_two(coeff_count - 1);
 
-        // Lazy reduction
-        Pointer wide_innerresult0(allocate_zero_poly(coeff_count, 2 * coeff_mod_count, pool));
-        Pointer wide_innerresult1(allocate_zero_poly(coeff_count, 2 * coeff_mod_count, pool));
-        Pointer innerresult(allocate_poly(coeff_count, coeff_mod_count, pool));
-        Pointer temp_decomp_coeff(allocate_uint(coeff_count, pool));
+        // Rotations with a Galois key present are hoisted; the others are composed of several 
+        // rotations by apply_galois. A step count of zero is just a copy.
+        vector<uint64_t> galois_elts(steps_count, 0);
+        vector<int> hoisted_indices;
+        for (int i = 0; i < steps_count; i++)
+        {
+            if (steps[i] != 0)
+            {
+                galois_elts[i] = get_row_rotation_galois_elt(steps[i]);
+                if (galois_keys.has_key(galois_elts[i]))
+                {
+                    hoisted_indices.push_back(i);
+                }
+            }
+        }
 
-        /*
-        For lazy reduction to work here, we need to ensure that the 128-bit accumulators (wide_innerresult0 and wide_innerresult1)
-        do not overflow. Since the modulus primes are at most 60 bits, if the total number of summands is K, then the size of the
-        total sum of products (without reduction) is at most 62 + 60 + bit_length(K). We need this to be at most 128, thus we need
-        bit_length(K) <= 6. Thus, we need K <= 63. In this case, this means sum_i galois_keys.key(galois_elt)[i].size() / 2 <= 63.
-        */
-        for (int i = 0; i < coeff_mod_count; i++)
+        destination.resize(steps_count);
+        for (int i = 0; i < steps_count; i++)
+        {
+            if (steps[i] == 0)
+            {
+                destination[i] = encrypted;
+            }
+            else if (!galois_keys.has_key(galois_elts[i]))
+            {
+                rotate_rows(encrypted, steps[i], galois_keys, destination[i], pool);
+            }
+        }
+        if (hoisted_indices.empty())
         {
-            multiply_poly_scalar_coeffmod(encrypted_coeff + (i * coeff_count), coeff_count, 
-                inv_coeff_products_mod_coeff_array_[i], coeff_modulus_[i], encrypted_coeff_prod_inv_coeff.get());
+            return;
+        }
 
-            int shift = 0;
-            const Ciphertext &key_component_ref = galois_keys.key(galois_elt)[i];
-            int keys_size = key_component_ref.size();
-            for (int k = 0; k < keys_size; k += 2)
+        // Start loading the keys that are loaded on demand while c1 is decomposed
+        if (galois_keys.store())
+        {
+            vector<uint64_t> hoisted_elts;
+            for (int hoisted_index : hoisted_indices)
             {
-                const uint64_t *key_ptr_0 = key_component_ref.pointer(k);
-                const uint64_t *key_ptr_1 = key_component_ref.pointer(k + 1);
+                hoisted_elts.push_back(galois_elts[hoisted_index]);
+            }
+            galois_keys.store()->prefetch(hoisted_elts, thread_pool_);
+        }
+
+        // The decomposition needs c1 in coefficient representation
+        bool is_ntt_form = encrypted.is_ntt_form_;
+        const uint64_t *c1 = encrypted.pointer(1);
+        Pointer c1_copy;
+        if (is_ntt_form)
+        {
+            c1_copy = allocate_poly(coeff_count, coeff_mod_count, pool);
+            set_poly_poly(c1, coeff_count, coeff_mod_count, c1_copy.get());
+            parallel_for(coeff_mod_count, [&](int j) {
+                inverse_ntt_negacyclic_harvey(c1_copy.get() + (j * coeff_count), coeff_small_ntt_tables_[j]);
+            });
+            c1 = c1_copy.get();
+        }
+
+        // Decompose c1 only once. All keys in galois_keys have the same decomposition_bit_count,
+        // so the decomposition works for any of them.
+        vector<int> decomp_offsets;
+        Pointer decomp_c1(decompose_key_switch_source(c1, 
+            *galois_keys.acquire_key(galois_elts[hoisted_indices[0]]), galois_keys.decomposition_bit_count(), 
+            decomp_offsets, pool));
+        int decomp_count = decomp_offsets[coeff_mod_count];
+
+        // Transform each decomposed factor to NTT form modulo every prime only once. Applying a Galois 
+        // automorphism to a decomposed factor commutes with the NTT, and does not change its norm, so
+        // the automorphisms can be applied to the transformed factors instead of to c1.
+        // We don't reduce here, so might get up to two extra bits. Thus 62 bits at most.
+        Pointer decomp_c1_ntt(allocate_poly(coeff_count * decomp_count, coeff_mod_count, pool));
+        parallel_for(decomp_count * coeff_mod_count, [&](int index) {
+            int j = index % coeff_mod_count;
+            uint64_t *decomp_c1_ntt_ptr = decomp_c1_ntt.get() + (index * coeff_count);
+            set_uint_uint(decomp_c1.get() + ((index / coeff_mod_count) * coeff_count), coeff_count, decomp_c1_ntt_ptr);
+            ntt_negacyclic_harvey_lazy(decomp_c1_ntt_ptr, coeff_small_ntt_tables_[j]);
+        });
+
+        // Transform c0 to NTT form as well, unless it already is
+        const uint64_t *c0_ntt = encrypted.pointer();
+        Pointer c0_copy;
+        if (!is_ntt_form)
+        {
+            c0_copy = allocate_poly(coeff_count, coeff_mod_count, pool);
+            set_poly_poly(encrypted.pointer(), coeff_count, coeff_mod_count, c0_copy.get());
+            parallel_for(coeff_mod_count, [&](int j) {
+                ntt_negacyclic_harvey(c0_copy.get() + (j * coeff_count), coeff_small_ntt_tables_[j]);
+            });
+            c0_ntt = c0_copy.get();
+        }
 
-                // Decompose here
-                int decomposition_bit_count = galois_keys.decomposition_bit_count();
-                for (int coeff_index = 0; coeff_index < coeff_count; coeff_index++)
+        // Lazy reduction
+        Pointer wide_innerresult0(allocate_poly(coeff_count, 2 * coeff_mod_count, pool));
+        Pointer wide_innerresult1(allocate_poly(coeff_count, 2 * coeff_mod_count, pool));
+        Pointer temp_galois(allocate_zero_poly(coeff_count, coeff_mod_count, pool));
+
+        for (int hoisted_index : hoisted_indices)
+        {
+            uint64_t galois_elt = galois_elts[hoisted_index];
+            shared_ptr<const vector<Ciphertext> > key_pointer = galois_keys.acquire_key(galois_elt);
+            const vector<Ciphertext> &key = *key_pointer;
+            Ciphertext &rotated = destination[hoisted_index];
+            rotated.resize(parms_, 2);
+            rotated.is_ntt_form_ = is_ntt_form;
+
+            /*
+            For lazy reduction to work here, we need to ensure that the 128-bit accumulators (wide_innerresult0 and wide_innerresult1)
+            do not overflow. Since the modulus primes are at most 60 bits, if the total number of summands is K, then the size of the
+            total sum of products (without reduction) is at most 62 + 60 + bit_length(K). We need this to be at most 128, thus we need
+            bit_length(K) <= 6. Thus, we need K <= 63. In this case, this means sum_i key[i].size() / 2 <= 63.
+            */
+            parallel_for(coeff_mod_count, [&](int j) {
+                // The last coefficient of temp_galois_ptr is never written and stays zero
+                uint64_t *temp_galois_ptr = temp_galois.get() + (j * coeff_count);
+                uint64_t *wide_innerresult0_poly_ptr = wide_innerresult0.get() + (j * 2 * coeff_count);
+                uint64_t *wide_innerresult1_poly_ptr = wide_innerresult1.get() + (j * 2 * coeff_count);
+                set_zero_uint(2 * coeff_count, wide_innerresult0_poly_ptr);
+                set_zero_uint(2 * coeff_count, wide_innerresult1_poly_ptr);
+                for (int i = 0; i < coeff_mod_count; i++)
                 {
-                    decomp_encrypted_last[coeff_index] = encrypted_coeff_prod_inv_coeff[coeff_index] >> shift;
-                    decomp_encrypted_last[coeff_index] &= (1ULL << decomposition_bit_count) - 1;
+                    const Ciphertext &key_component_ref = key[i];
+                    int keys_size = key_component_ref.size();
+                    for (int k = 0; k < keys_size; k += 2)
+                    {
+                        const uint64_t *key_ptr_0 = key_component_ref.pointer(k) + (j * coeff_count);
+                        const uint64_t *key_ptr_1 = key_component_ref.pointer(k + 1) + (j * coeff_count);
+                        apply_galois_ntt(decomp_c1_ntt.get() + (((decomp_offsets[i] + (k >> 1)) * coeff_mod_count + j) * coeff_count),
+                            n_power_of_two, galois_elt, temp_galois_ptr);
+
+                        // Lazy reduction
+                        uint64_t wide_innerproduct[2];
+                        uint64_t *wide_innerresult0_ptr = wide_innerresult0_poly_ptr;
+                        uint64_t *wide_innerresult1_ptr = wide_innerresult1_poly_ptr;
+                        for (int m = 0; m < coeff_count; m++, wide_innerresult0_ptr += 2, wide_innerresult1_ptr += 2)
+                        {
+                            multiply_uint64(temp_galois_ptr[m], key_ptr_0[m], wide_innerproduct);
+                            unsigned char carry = add_uint64(wide_innerresult0_ptr[0], wide_innerproduct[0], 0,
+                                wide_innerresult0_ptr);
+                            wide_innerresult0_ptr[1] += wide_innerproduct[1] + carry;
+
+                            multiply_uint64(temp_galois_ptr[m], key_ptr_1[m], wide_innerproduct);
+                            carry = add_uint64(wide_innerresult1_ptr[0], wide_innerproduct[0], 0,
+                                wide_innerresult1_ptr);
+                            wide_innerresult1_ptr[1] += wide_innerproduct[1] + carry;
+                        }
+                    }
                 }
 
-                uint64_t *wide_innerresult0_ptr = wide_innerresult0.get();
-                uint64_t *wide_innerresult1_ptr = wide_innerresult1.get();
-                for (int j = 0; j < coeff_mod_count; j++)
+                // Compute (galois(c0) + temp1 * galois_key.first) in NTT form, and transform back if needed
+                uint64_t *rotated_ptr = rotated.mutable_pointer() + (j * coeff_count);
+                for (int m = 0; m < coeff_count; m++)
+                {
+                    rotated_ptr[m] = barrett_reduce_128(wide_innerresult0_poly_ptr + (2 * m), coeff_modulus_[j]);
+                }
+                apply_galois_ntt(c0_ntt + (j * coeff_count), n_power_of_two, galois_elt, temp_galois_ptr);
+                add_poly_poly_coeffmod(rotated_ptr, temp_galois_ptr, coeff_count, coeff_modulus_[j], rotated_ptr);
+                if (!is_ntt_form)
                 {
-                    uint64_t *temp_decomp_coeff_ptr = temp_decomp_coeff.get();
-                    set_uint_uint(decomp_encrypted_last.get(), coeff_count, temp_decomp_coeff_ptr);
+                    inverse_ntt_negacyclic_harvey(rotated_ptr, coeff_small_ntt_tables_[j]);
+                }
 
-                    // We don't reduce here, so might get up to two extra bits. Thus 62 bits at most.
-                    ntt_negacyclic_harvey_lazy(temp_decomp_coeff_ptr, coeff_small_ntt_tables_[j]);
+                // Compute temp1 * galois_key.second in NTT form, and transform back if needed
+                rotated_ptr += array_poly_uint64_count;
+                for (int m = 0; m < coeff_count; m++)
+                {
+                    rotated_ptr[m] = barrett_reduce_128(wide_innerresult1_poly_ptr + (2 * m), coeff_modulus_[j]);
+                }
+                if (!is_ntt_form)
+                {
+                    inverse_ntt_negacyclic_harvey(rotated_ptr, coeff_small_ntt_tables_[j]);
+                }
+            });
+        }
+    }
 
-                    // Lazy reduction
-                    uint64_t wide_innerproduct[2];
-                    for (int m = 0; m < coeff_count; m++, wide_innerresult0_ptr += 2)
-                    {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_0++, wide_innerproduct);
-                        unsigned char carry = add_uint64(wide_innerresult0_ptr[0], wide_innerproduct[0], 0,
-                            wide_innerresult0_ptr);
-                        wide_innerresult0_ptr[1] += wide_innerproduct[1] + carry;
-                    }
+    void Evaluator::multiply_plain_matrix(const Ciphertext &encrypted, const PlainMatrix &matrix,
+        const GaloisKeys &galois_keys, Ciphertext &destination, const MemoryPoolHandle &pool)
+    {
+        if (Evaluator *evaluator = level_evaluator(encrypted.hash_block_))
+        {
+            evaluator->multiply_plain_matrix(encrypted, matrix, galois_keys, destination, pool);
+            return;
+        }
 
-                    temp_decomp_coeff_ptr = temp_decomp_coeff.get();
-                    for (int m = 0; m < coeff_count; m++, wide_innerresult1_ptr += 2)
-                    {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_1++, wide_innerproduct);
-                        unsigned char carry = add_uint64(wide_innerresult1_ptr[0], wide_innerproduct[0], 0,
-                            wide_innerresult1_ptr);
-                        wide_innerresult1_ptr[1] += wide_innerproduct[1] + carry;
-                    }
+        // Verify parameters
+        if (encrypted.hash_block_ != parms_.hash_block())
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (matrix.hash_block() != top_level_hash_block_)
+        {
+            throw invalid_argument("matrix is not valid for encryption parameters");
+        }
+        if (galois_keys.hash_block_ != top_level_hash_block_)
+        {
+            throw invalid_argument("galois_keys is not valid for encryption parameters");
+        }
+        if (encrypted.size() != 2)
+        {
+            throw invalid_argument("ciphertext size must be 2");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        // Compute the baby step rotations of the input in NTT form with one hoisted decomposition;
+        // only baby steps with a nonzero diagonal in some giant step are needed
+        int baby_step_count = matrix.baby_step_count();
+        bool is_ntt_form = encrypted.is_ntt_form_;
+        vector<int> baby_steps;
+        vector<int> rotated_indices(baby_step_count, -1);
+        for (int b = 0; b < baby_step_count; b++)
+        {
+            for (int g = 0; g < matrix.giant_step_count(); g++)
+            {
+                if (matrix.diagonals()[g][b].coeff_count() != 0)
+                {
+                    rotated_indices[b] = baby_steps.size();
+                    baby_steps.push_back(b);
+                    break;
                 }
-                shift += decomposition_bit_count;
             }
         }
+        vector<Ciphertext> rotated;
+        if (is_ntt_form)
+        {
+            rotate_rows_many(encrypted, baby_steps, galois_keys, rotated, pool);
+        }
+        else
+        {
+            Ciphertext encrypted_ntt(encrypted);
+            transform_to_ntt(encrypted_ntt);
+            rotate_rows_many(encrypted_ntt, baby_steps, galois_keys, rotated, pool);
+        }
 
-        uint64_t *temp_ptr = temp0.get();
-        uint64_t *innerresult_poly_ptr = innerresult.get();
-        uint64_t *wide_innerresult_poly_ptr = wide_innerresult0.get();
-        uint64_t *encrypted_ptr = encrypted.mutable_pointer();
-        uint64_t *innerresult_coeff_ptr = innerresult_poly_ptr;
-        uint64_t *wide_innerresult_coeff_ptr = wide_innerresult_poly_ptr;
-        for (int i = 0; i < coeff_mod_count; i++, innerresult_poly_ptr += coeff_count,
-            wide_innerresult_poly_ptr += 2 * coeff_count, encrypted_ptr += coeff_count,
-            temp_ptr += coeff_count)
+        // Each giant step is an inner product of baby step rotations and pre-rotated diagonals,
+        // which is then rotated into place and added to the result
+        Ciphertext sum(parms_, pool);
+        Ciphertext giant_step_sum(parms_, pool);
+        bool sum_is_set = false;
+        vector<const Ciphertext*> encrypted_ptrs;
+        vector<const Plaintext*> plain_ptrs;
+        for (int g = 0; g < matrix.giant_step_count(); g++)
         {
-            for (int m = 0; m < coeff_count; m++, wide_innerresult_coeff_ptr += 2)
+            encrypted_ptrs.clear();
+            plain_ptrs.clear();
+            for (int b = 0; b < baby_step_count; b++)
+            {
+                const Plaintext &diagonal = matrix.diagonals()[g][b];
+                if (diagonal.coeff_count() != 0)
+                {
+                    encrypted_ptrs.push_back(&rotated[rotated_indices[b]]);
+                    plain_ptrs.push_back(&diagonal);
+                }
+            }
+            if (encrypted_ptrs.empty())
+            {
+                continue;
+            }
+
+            dot_product_plain(encrypted_ptrs, plain_ptrs, giant_step_sum, pool);
+            rotate_rows(giant_step_sum, g * baby_step_count, galois_keys, pool);
+            if (sum_is_set)
+            {
+                add(sum, giant_step_sum);
+            }
+            else
             {
-                *innerresult_coeff_ptr++ = barrett_reduce_128(wide_innerresult_coeff_ptr, coeff_modulus_[i]);
+                swap(sum, giant_step_sum);
+                sum_is_set = true;
             }
-            inverse_ntt_negacyclic_harvey(innerresult_poly_ptr, coeff_small_ntt_tables_[i]);
-            add_poly_poly_coeffmod(temp_ptr, innerresult_poly_ptr, coeff_count,
-                coeff_modulus_[i], encrypted_ptr);
         }
 
-        innerresult_poly_ptr = innerresult.get();
-        wide_innerresult_poly_ptr = wide_innerresult1.get();
-        encrypted_ptr = encrypted.mutable_pointer(1);
-        wide_innerresult_coeff_ptr = wide_innerresult_poly_ptr;
-        for (int i = 0; i < coeff_mod_count; i++, innerresult_poly_ptr += coeff_count,
-            wide_innerresult_poly_ptr += 2 * coeff_count, encrypted_ptr += coeff_count)
+        if (!is_ntt_form)
+        {
+            transform_from_ntt(sum);
+        }
+        destination = sum;
+    }
+
+    void Evaluator::mod_switch_to_next(Ciphertext &encrypted, const MemoryPoolHandle &pool)
+    {
+        // Verify parameters.
+        Evaluator *evaluator = level_evaluator(encrypted.hash_block_);
+        if (!evaluator && encrypted.hash_block_ != parms_.hash_block())
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        int level = encrypted.coeff_mod_count();
+        if (level <= min_level())
         {
-            innerresult_coeff_ptr = encrypted_ptr;
-            for (int m = 0; m < coeff_count; m++, wide_innerresult_coeff_ptr += 2)
+            throw invalid_argument("encrypted is already at the lowest level");
+        }
+
+        // The Evaluator at the level of encrypted does the switch
+        const EncryptionParameters &next_parms = level_contexts_->context(level - 1).parms();
+        (evaluator ? evaluator : this)->mod_switch_to_next(encrypted, next_parms, pool);
+    }
+
+    void Evaluator::mod_switch_to_next(Ciphertext &encrypted, const EncryptionParameters &next_parms, 
+        const MemoryPoolHandle &pool)
+    {
+        // Extract encryption parameters.
+        int coeff_count = parms_.poly_modulus().coeff_count();
+        int coeff_mod_count = coeff_modulus_.size();
+        int encrypted_size = encrypted.size();
+
+        // Verify parameters.
+        if (encrypted.hash_block_ != parms_.hash_block())
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        encrypted.clear_seed();
+
+        int next_coeff_mod_count = coeff_mod_count - 1;
+        const SmallModulus &last_modulus = coeff_modulus_[next_coeff_mod_count];
+        uint64_t last_modulus_div_two = last_modulus.value() >> 1;
+
+        // Each poly c is replaced by (c - r) / q_last modulo the remaining primes, where r is c
+        // reduced modulo q_last to the symmetric range, so that the division rounds to nearest
+        parallel_for(encrypted_size, [&](int i) {
+            uint64_t *encrypted_ptr = encrypted.mutable_pointer(i);
+            Pointer last(allocate_uint(coeff_count, pool));
+            Pointer temp(allocate_uint(coeff_count, pool));
+
+            // Add q_last / 2 to the component modulo q_last, and subtract it back modulo q_j below
+            set_uint_uint(encrypted_ptr + (next_coeff_mod_count * coeff_count), coeff_count, last.get());
+            if (encrypted.is_ntt_form_)
+            {
+                inverse_ntt_negacyclic_harvey(last.get(), coeff_small_ntt_tables_[next_coeff_mod_count]);
+            }
+            for (int m = 0; m < coeff_count - 1; m++)
             {
-                *innerresult_coeff_ptr++ = barrett_reduce_128(wide_innerresult_coeff_ptr, coeff_modulus_[i]);
+                last[m] = add_uint_uint_mod(last[m], last_modulus_div_two, last_modulus);
             }
-            inverse_ntt_negacyclic_harvey(encrypted_ptr, coeff_small_ntt_tables_[i]);
+
+            for (int j = 0; j < next_coeff_mod_count; j++)
+            {
+                uint64_t *encrypted_poly_ptr = encrypted_ptr + (j * coeff_count);
+                uint64_t half_mod = last_modulus_div_two % coeff_modulus_[j].value();
+                modulo_poly_coeffs(last.get(), coeff_count - 1, coeff_modulus_[j], temp.get());
+                for (int m = 0; m < coeff_count - 1; m++)
+                {
+                    temp[m] = sub_uint_uint_mod(temp[m], half_mod, coeff_modulus_[j]);
+                }
+                if (encrypted.is_ntt_form_)
+                {
+                    ntt_negacyclic_harvey(temp.get(), coeff_small_ntt_tables_[j]);
+                }
+                sub_poly_poly_coeffmod(encrypted_poly_ptr, temp.get(), coeff_count - 1, coeff_modulus_[j], 
+                    encrypted_poly_ptr);
+                multiply_poly_scalar_coeffmod(encrypted_poly_ptr, coeff_count - 1, inv_last_coeff_mod_array_[j], 
+                    coeff_modulus_[j], encrypted_poly_ptr);
+            }
+        }, pool);
+
+        // Move the polys to their places in the smaller layout; the destinations never lie 
+        // after the sources, so copying forward is safe even though they overlap
+        int next_poly_uint64_count = coeff_count * next_coeff_mod_count;
+        for (int i = 1; i < encrypted_size; i++)
+        {
+            const uint64_t *source = encrypted.pointer(i);
+            copy(source, source + next_poly_uint64_count, encrypted.mutable_pointer() + (i * next_poly_uint64_count));
         }
+        encrypted.resize(next_parms, encrypted_size);
     }
 
-    void Evaluator::rotate_rows(Ciphertext &encrypted, int steps, const GaloisKeys &galois_keys, const MemoryPoolHandle &pool)
+    void Evaluator::mod_switch_to(Ciphertext &encrypted, int level, const MemoryPoolHandle &pool)
     {
-        // Is there anything to do?
-        if (steps == 0)
+        // Verify parameters.
+        if (encrypted.hash_block_ != parms_.hash_block() && !level_evaluator(encrypted.hash_block_))
         {
-            return;
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (level > encrypted.coeff_mod_count() || level < min_level())
+        {
+            throw invalid_argument("level is not valid for encrypted");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        while (encrypted.coeff_mod_count() > level)
+        {
+            mod_switch_to_next(encrypted, pool);
+        }
+    }
+
+    vector<uint64_t> Evaluator::galois_path(uint64_t galois_elt, const GaloisKeys &galois_keys) const
+    {
+        // The Galois elements 3^i * (-1)^j mod m form a group isomorphic to Z_(n/2) x Z_2, 
+        // where node j * n/2 + i stands for (i, j). Search it breadth-first from the identity
+        // for the shortest product of elements that have keys, trying both signs of each step.
+        int subgroup_size = (parms_.poly_modulus().coeff_count() - 1) >> 1;
+        vector<pair<uint64_t, uint64_t> > generators;
+        vector<uint64_t> generator_elts;
+        for (uint64_t key_elt : galois_keys.galois_elts())
+        {
+            auto generator = Zmstar_to_generator_.find(key_elt);
+            if (generator != Zmstar_to_generator_.end())
+            {
+                generators.push_back(generator->second);
+                generator_elts.push_back(key_elt);
+            }
         }
 
+        const pair<uint64_t, uint64_t> &orders = Zmstar_to_generator_.at(galois_elt);
+        int target = static_cast<int>(orders.second * subgroup_size + orders.first);
+        vector<int> previous(2 * subgroup_size, -1);
+        vector<int> previous_generator(2 * subgroup_size, -1);
+        vector<int> queue{ 0 };
+        previous[0] = 0;
+        for (size_t i = 0; i < queue.size() && previous[target] < 0; i++)
+        {
+            int order1 = queue[i] % subgroup_size;
+            int order2 = queue[i] / subgroup_size;
+            for (size_t j = 0; j < generators.size(); j++)
+            {
+                int next = static_cast<int>(((order2 + generators[j].second) & 1) * subgroup_size + 
+                    (order1 + generators[j].first) % subgroup_size);
+                if (previous[next] < 0)
+                {
+                    previous[next] = queue[i];
+                    previous_generator[next] = static_cast<int>(j);
+                    queue.push_back(next);
+                }
+            }
+        }
+        if (previous[target] < 0)
+        {
+            throw invalid_argument("galois key not present");
+        }
+
+        vector<uint64_t> path;
+        for (int node = target; node != 0; node = previous[node])
+        {
+            path.push_back(generator_elts[previous_generator[node]]);
+        }
+        return path;
+    }
+
+    uint64_t Evaluator::get_row_rotation_galois_elt(int steps)
+    {
         // Extract sign of steps. When steps is positive, the rotation is to the left,
         // and when steps is negative, it is to the right.
         bool sign = steps < 0;
@@ -1827,8 +2919,6 @@ namespace seal
             galois_elt *= gen;
             galois_elt &= (1ULL << m_power_of_two) - 1;
         }
-
-        // Perform rotation and key switching
-        apply_galois(encrypted, galois_elt, galois_keys, pool);
+        return galois_elt;
     }
 }
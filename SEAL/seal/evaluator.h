@@ -3,14 +3,20 @@
 #include <vector>
 #include <utility>
 #include <map>
+#include <functional>
+#include <memory>
 #include "seal/encryptionparams.h"
 #include "seal/context.h"
 #include "seal/evaluationkeys.h"
+#include "seal/exponentiationplan.h"
 #include "seal/smallmodulus.h"
 #include "seal/memorypoolhandle.h"
+#include "seal/threadpoolhandle.h"
 #include "seal/ciphertext.h"
 #include "seal/plaintext.h"
 #include "seal/galoiskeys.h"
+#include "seal/plainmatrix.h"
+#include "seal/preparedciphertext.h"
 #include "seal/util/polymodulus.h"
 #include "seal/util/baseconverter.h"
 #include "seal/util/uintarithsmallmod.h"
@@ -39,6 +45,8 @@ namespace seal
     in many cases some of the inputs to a computation are plaintext elements rather than
     ciphertexts. For this we provide fast "plain" operations: plain addition, plain subtraction,
     aand plain multiplication.
+    The RNS algorithm used for multiplication and squaring is chosen when the SEALContext is 
+    created (see MultiplyMethod).
 
     @par Relinearization
     One of the most important non-arithmetic operations is relinearization, which takes
@@ -65,6 +73,24 @@ namespace seal
     when e.g. one plaintext input is used in several plain multiplication, and transforming
     it several times would not make sense.
 
+    @par NTT Form
+    Ciphertexts remember whether they are in NTT form (see Ciphertext::is_ntt_form()). Negation,
+    addition, subtraction, plain addition, plain subtraction, plain multiplication, relinearization,
+    and rotations accept ciphertexts in NTT form and keep them in NTT form, transforming only those
+    parts of the data that the operation needs in coefficient representation. A computation that
+    mostly consists of such operations can therefore stay in NTT form throughout, avoiding the
+    forward and inverse transforms that each operation would otherwise have to perform.
+    Multiplication and squaring require the inputs to not be in NTT form.
+
+    @par Modulus Switching
+    Ciphertexts can be switched to a smaller coefficient modulus by dropping primes from the
+    end of the coefficient modulus with mod_switch_to_next and mod_switch_to. This scales down
+    the noise together with the coefficient modulus, and makes all subsequent operations cheaper
+    because they work modulo fewer primes. The number of primes a ciphertext is defined modulo is
+    called its level (see SEALContext). All operations accept ciphertexts at any level, but the
+    ciphertexts given to a binary operation must be at the same level. The same evaluation keys
+    and Galois keys, generated for the full coefficient modulus, are used at every level.
+
     @par Overloads
     For many functions we provide two flavors of overloads. In one set of overloads the
     operations act on the inputs "in place", overwriting typically the first of the input
@@ -81,11 +107,14 @@ namespace seal
     operations by giving them a thread-local MemoryPoolHandle to use. Thus, for many 
     operations we provide up to four different overloads, and it is important for 
     a developer to understand how these work to avoid unnecessary performance bottlenecks.
+    Passing a thread-local EvaluatorWorkspace in place of the MemoryPoolHandle goes one 
+    step further: once warmed up, operations then perform no allocations at all.
 
     @see EncryptionParameters for more details on encryption parameters.
     @see PolyCRTBuilder for more details on batching
     @see EvaluationKeys for more details on evaluation keys.
     @see GaloisKeys for more details on Galois keys.
+    @see EvaluatorWorkspace for more details on allocation-free evaluation.
     */
     class Evaluator
     {
@@ -103,6 +132,24 @@ namespace seal
         Evaluator(const SEALContext &context, 
             const MemoryPoolHandle &pool = MemoryPoolHandle::Global());
 
+        /**
+        Creates an Evaluator instance initialized with the specified SEALContext, that uses
+        the given thread pool to parallelize individual operations across the primes in the
+        coefficient modulus, overriding the thread pool set in the SEALContext. Dynamically
+        allocated member variables are allocated from the memory pool pointed to by the given
+        MemoryPoolHandle. By default the global memory pool is used.
+
+        @param[in] context The SEALContext
+        @param[in] thread_pool The ThreadPoolHandle pointing to a thread pool, or an
+        uninitialized ThreadPoolHandle to run all operations sequentially
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encryption parameters are not valid
+        @throws std::invalid_argument if pool is uninitialized
+        @see ThreadPoolHandle for more details on thread pools.
+        */
+        Evaluator(const SEALContext &context, const ThreadPoolHandle &thread_pool,
+            const MemoryPoolHandle &pool = MemoryPoolHandle::Global());
+
         /**
         Creates a deep copy of a given Evaluator.
 
@@ -147,6 +194,8 @@ namespace seal
         @param[in] encrypted2 The second ciphertext to add
         @throws std::invalid_argument if encrypted1 or encrypted2 is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted1 and encrypted2 are not both in NTT form or
+        both not in NTT form
         @throws std::logic_error if encrypted1 is aliased and needs to be reallocated
         */
         void add(Ciphertext &encrypted1, const Ciphertext &encrypted2);
@@ -160,6 +209,8 @@ namespace seal
         @param[out] destination The ciphertext to overwrite with the addition result
         @throws std::invalid_argument if encrypted1 or encrypted2 is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted1 and encrypted2 are not both in NTT form or
+        both not in NTT form
         @throws std::logic_error if destination is aliased and needs to be reallocated
         */
         inline void add(const Ciphertext &encrypted1, const Ciphertext &encrypted2, 
@@ -171,13 +222,17 @@ namespace seal
 
         /**
         Adds together a vector of ciphertexts and stores the result in the destination 
-        parameter.
+        parameter. The sum is computed in a single pass over the inputs, reducing modulo the
+        coefficient modulus only once every few additions, and the coefficients are split 
+        into blocks that are summed in parallel if the Evaluator has a thread pool.
 
         @param[in] encrypteds The ciphertexts to add
         @param[out] destination The ciphertext to overwrite with the addition result
         @throws std::invalid_argument if encrypteds is empty
         @throws std::invalid_argument if the ciphertexts are not valid for the encryption 
         parameters
+        @throws std::invalid_argument if the ciphertexts are not all in NTT form or all not
+        in NTT form
         @throws std::logic_error if destination is aliased and needs to be reallocated
         */
         void add_many(const std::vector<Ciphertext> &encrypteds, Ciphertext &destination);
@@ -190,6 +245,8 @@ namespace seal
         @param[in] encrypted2 The ciphertext to subtract
         @throws std::invalid_argument if encrypted1 or encrypted2 is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted1 and encrypted2 are not both in NTT form or
+        both not in NTT form
         @throws std::logic_error if encrypted1 is aliased and needs to be reallocated
         */
         void sub(Ciphertext &encrypted1, const Ciphertext &encrypted2);
@@ -203,6 +260,8 @@ namespace seal
         @param[out] destination The ciphertext to overwrite with the subtraction result
         @throws std::invalid_argument if encrypted1 or encrypted2 is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted1 and encrypted2 are not both in NTT form or
+        both not in NTT form
         @throws std::logic_error if destination is aliased and needs to be reallocated
         */
         inline void sub(const Ciphertext &encrypted1, const Ciphertext &encrypted2, 
@@ -222,6 +281,7 @@ namespace seal
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::invalid_argument if encrypted1 or encrypted2 is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is in NTT form
         @throws std::logic_error if encrypted1 is aliased and needs to be reallocated
         @throws std::invalid_argument if pool is uninitialized
         */
@@ -237,6 +297,7 @@ namespace seal
         @param[in] encrypted2 The second ciphertext to multiply
         @throws std::invalid_argument if encrypted1 or encrypted2 is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is in NTT form
         @throws std::logic_error if encrypted1 is aliased and needs to be reallocated
         */
         inline void multiply(Ciphertext &encrypted1, const Ciphertext &encrypted2)
@@ -256,6 +317,7 @@ namespace seal
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::invalid_argument if encrypted1 or encrypted2 is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is in NTT form
         @throws std::logic_error if destination is aliased and needs to be reallocated
         @throws std::invalid_argument if pool is uninitialized
         */
@@ -277,6 +339,7 @@ namespace seal
         @param[out] destination The ciphertext to overwrite with the multiplication result
         @throws std::invalid_argument if encrypted1 or encrypted2 is not valid for the 
         encryption parameters
+        @throws std::invalid_argument if encrypted1 or encrypted2 is in NTT form
         @throws std::logic_error if destination is aliased and needs to be reallocated
         */
         inline void multiply(const Ciphertext &encrypted1, const Ciphertext &encrypted2, 
@@ -285,6 +348,85 @@ namespace seal
             multiply(encrypted1, encrypted2, destination, pool_);
         }
 
+        /**
+        Prepares a ciphertext for being multiplied with many other ciphertexts. This function
+        extends encrypted to the auxiliary base used in multiplication, transforms it to NTT
+        form, and stores the result in the destination parameter. Dynamic memory allocations
+        in the process are allocated from the memory pool pointed to by the given 
+        MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to prepare
+        @param[out] destination The PreparedCiphertext to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if pool is uninitialized
+        @see PreparedCiphertext for more details on prepared ciphertexts.
+        */
+        void prepare(const Ciphertext &encrypted, PreparedCiphertext &destination, 
+            const MemoryPoolHandle &pool);
+
+        /**
+        Prepares a ciphertext for being multiplied with many other ciphertexts. This function
+        extends encrypted to the auxiliary base used in multiplication, transforms it to NTT
+        form, and stores the result in the destination parameter. Dynamic memory allocations
+        in the process are allocated from the memory pool pointed to by the local
+        MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to prepare
+        @param[out] destination The PreparedCiphertext to overwrite with the result
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @see PreparedCiphertext for more details on prepared ciphertexts.
+        */
+        inline void prepare(const Ciphertext &encrypted, PreparedCiphertext &destination)
+        {
+            prepare(encrypted, destination, pool_);
+        }
+
+        /**
+        Multiplies a prepared ciphertext with a ciphertext. This function computes the
+        product of the ciphertext prepared1 was prepared from and encrypted2, and stores the
+        result in the destination parameter. The result is the same as that of multiplying 
+        the ciphertexts, but only encrypted2 needs to be extended and transformed to NTT
+        form. Dynamic memory allocations in the process are allocated from the memory pool
+        pointed to by the given MemoryPoolHandle.
+
+        @param[in] prepared1 The prepared ciphertext to multiply
+        @param[in] encrypted2 The ciphertext to multiply
+        @param[out] destination The ciphertext to overwrite with the multiplication result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if prepared1 or encrypted2 is not valid for the 
+        encryption parameters
+        @throws std::invalid_argument if encrypted2 is in NTT form
+        @throws std::invalid_argument if pool is uninitialized
+        @see PreparedCiphertext for more details on prepared ciphertexts.
+        */
+        void multiply(const PreparedCiphertext &prepared1, const Ciphertext &encrypted2, 
+            Ciphertext &destination, const MemoryPoolHandle &pool);
+
+        /**
+        Multiplies a prepared ciphertext with a ciphertext. This function computes the
+        product of the ciphertext prepared1 was prepared from and encrypted2, and stores the
+        result in the destination parameter. The result is the same as that of multiplying 
+        the ciphertexts, but only encrypted2 needs to be extended and transformed to NTT
+        form. Dynamic memory allocations in the process are allocated from the memory pool
+        pointed to by the local MemoryPoolHandle.
+
+        @param[in] prepared1 The prepared ciphertext to multiply
+        @param[in] encrypted2 The ciphertext to multiply
+        @param[out] destination The ciphertext to overwrite with the multiplication result
+        @throws std::invalid_argument if prepared1 or encrypted2 is not valid for the 
+        encryption parameters
+        @throws std::invalid_argument if encrypted2 is in NTT form
+        @see PreparedCiphertext for more details on prepared ciphertexts.
+        */
+        inline void multiply(const PreparedCiphertext &prepared1, const Ciphertext &encrypted2, 
+            Ciphertext &destination)
+        {
+            multiply(prepared1, encrypted2, destination, pool_);
+        }
+
         /**
         Squares a ciphertext. This functions computes the square of encrypted. Dynamic memory 
         allocations in the process are allocated from the memory pool pointed to by the given 
@@ -294,6 +436,7 @@ namespace seal
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::invalid_argument if encrypted is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted is in NTT form
         @throws std::logic_error if encrypted is aliased and needs to be reallocated
         @throws std::invalid_argument if pool is uninitialized
         */
@@ -307,6 +450,7 @@ namespace seal
         @param[in] encrypted The ciphertext to square
         @throws std::invalid_argument if encrypted is not valid for the encryption
         parameters
+        @throws std::invalid_argument if encrypted is in NTT form
         @throws std::logic_error if encrypted is aliased and needs to be reallocated
         */
         inline void square(Ciphertext &encrypted)
@@ -324,6 +468,7 @@ namespace seal
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::invalid_argument if encrypted is not valid for the encryption 
         parameters
+        @throws std::invalid_argument if encrypted is in NTT form
         @throws std::logic_error if destination is aliased and needs to be reallocated
         @throws std::invalid_argument if pool is uninitialized
         */
@@ -343,6 +488,7 @@ namespace seal
         @param[out] destination The ciphertext to overwrite with the square
         @throws std::invalid_argument if encrypted is not valid for the encryption
         parameters
+        @throws std::invalid_argument if encrypted is in NTT form
         @throws std::logic_error if destination is aliased and needs to be reallocated
         */
         inline void square(const Ciphertext &encrypted, Ciphertext &destination)
@@ -436,9 +582,11 @@ namespace seal
         /**
         Multiplies several ciphertexts together. This function computes the product of several
         ciphertext given as an std::vector and stores the result in the destination parameter.
-        The multiplication is done in a depth-optimal order, and relinearization is performed
-        automatically after every multiplication in the process. In relinearization the given
-        evaluation keys are used. Dynamic memory allocations in the process are allocated from 
+        The multiplication is done as a balanced tree in a depth-optimal order, and 
+        relinearization is performed automatically after every multiplication in the process.
+        In relinearization the given evaluation keys are used. If the Evaluator has a thread 
+        pool and the memory pool is thread-safe, the products on each level of the tree are 
+        computed in parallel. Dynamic memory allocations in the process are allocated from 
         the memory pool pointed to by the given MemoryPoolHandle.
 
         @param[in] encrypteds The ciphertexts to multiply
@@ -459,9 +607,11 @@ namespace seal
         /**
         Multiplies several ciphertexts together. This function computes the product of several
         ciphertext given as an std::vector and stores the result in the destination parameter.
-        The multiplication is done in a depth-optimal order, and relinearization is performed
-        automatically after every multiplication in the process. In relinearization the given
-        evaluation keys are used. Dynamic memory allocations in the process are allocated from
+        The multiplication is done as a balanced tree in a depth-optimal order, and 
+        relinearization is performed automatically after every multiplication in the process.
+        In relinearization the given evaluation keys are used. If the Evaluator has a thread 
+        pool and the memory pool is thread-safe, the products on each level of the tree are 
+        computed in parallel. Dynamic memory allocations in the process are allocated from 
         the memory pool pointed to by the local MemoryPoolHandle.
 
         @param[in] encrypteds The ciphertexts to multiply
@@ -479,12 +629,63 @@ namespace seal
             multiply_many(encrypteds, evaluation_keys, destination, pool_);
         }
 
+        /**
+        Computes the inner product of two vectors of ciphertexts. This function multiplies 
+        each ciphertext in encrypteds1 with the ciphertext at the same index in encrypteds2, 
+        and stores the sum of the products in the destination parameter. The products are not
+        relinearized, so for inputs of size 2 the result has size 3. The sum is accumulated 
+        with lazy modular reduction, without creating a temporary ciphertext for each product.
+        Dynamic memory allocations in the process are allocated from the memory pool pointed 
+        to by the given MemoryPoolHandle.
+
+        @param[in] encrypteds1 The first vector of ciphertexts to multiply
+        @param[in] encrypteds2 The second vector of ciphertexts to multiply
+        @param[out] destination The ciphertext to overwrite with the inner product
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypteds1 is empty
+        @throws std::invalid_argument if encrypteds1 and encrypteds2 have different sizes
+        @throws std::invalid_argument if the ciphertexts are not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if any of the ciphertexts is in NTT form
+        @throws std::logic_error if destination is aliased and needs to be reallocated
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void dot_product(const std::vector<Ciphertext> &encrypteds1, 
+            const std::vector<Ciphertext> &encrypteds2, Ciphertext &destination, 
+            const MemoryPoolHandle &pool);
+
+        /**
+        Computes the inner product of two vectors of ciphertexts. This function multiplies 
+        each ciphertext in encrypteds1 with the ciphertext at the same index in encrypteds2, 
+        and stores the sum of the products in the destination parameter. The products are not
+        relinearized, so for inputs of size 2 the result has size 3. The sum is accumulated 
+        with lazy modular reduction, without creating a temporary ciphertext for each product.
+        Dynamic memory allocations in the process are allocated from the memory pool pointed 
+        to by the local MemoryPoolHandle.
+
+        @param[in] encrypteds1 The first vector of ciphertexts to multiply
+        @param[in] encrypteds2 The second vector of ciphertexts to multiply
+        @param[out] destination The ciphertext to overwrite with the inner product
+        @throws std::invalid_argument if encrypteds1 is empty
+        @throws std::invalid_argument if encrypteds1 and encrypteds2 have different sizes
+        @throws std::invalid_argument if the ciphertexts are not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if any of the ciphertexts is in NTT form
+        @throws std::logic_error if destination is aliased and needs to be reallocated
+        */
+        inline void dot_product(const std::vector<Ciphertext> &encrypteds1, 
+            const std::vector<Ciphertext> &encrypteds2, Ciphertext &destination)
+        {
+            dot_product(encrypteds1, encrypteds2, destination, pool_);
+        }
+
         /**
         Exponentiates a ciphertext. This functions raises encrypted to a power. Dynamic 
         memory allocations in the process are allocated from the memory pool pointed to by 
-        the given MemoryPoolHandle. The exponentiation is done in a depth-optimal order, 
-        and relinearization is performed automatically after every multiplication in the 
-        process. In relinearization the given evaluation keys are used.
+        the given MemoryPoolHandle. The exponentiation is done by repeated squaring in a 
+        depth-optimal order, and relinearization is performed automatically after every 
+        multiplication in the process. In relinearization the given evaluation keys are 
+        used.
 
         @param[in] encrypted The ciphertext to exponentiate
         @param[in] exponent The power to raise the ciphertext to
@@ -492,6 +693,7 @@ namespace seal
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::invalid_argument if encrypted or evaluation_keys is not valid for the
         encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
         @throws std::invalid_argument if exponent is zero
         @throws std::invalid_argument if the size of evaluation_keys is too small
         @throws std::logic_error if encrypted is aliased and needs to be reallocated
@@ -503,15 +705,17 @@ namespace seal
         /**
         Exponentiates a ciphertext. This functions raises encrypted to a power. Dynamic
         memory allocations in the process are allocated from the memory pool pointed to by
-        the local MemoryPoolHandle. The exponentiation is done in a depth-optimal order,
-        and relinearization is performed automatically after every multiplication in the
-        process. In relinearization the given evaluation keys are used.
+        the local MemoryPoolHandle. The exponentiation is done by repeated squaring in a
+        depth-optimal order, and relinearization is performed automatically after every
+        multiplication in the process. In relinearization the given evaluation keys are
+        used.
 
         @param[in] encrypted The ciphertext to exponentiate
         @param[in] exponent The power to raise the ciphertext to
         @param[in] evaluation_keys The evaluation keys
         @throws std::invalid_argument if encrypted or evaluation_keys is not valid for the
         encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
         @throws std::invalid_argument if exponent is zero
         @throws std::invalid_argument if the size of evaluation_keys is too small
         @throws std::logic_error if encrypted is aliased and needs to be reallocated
@@ -526,8 +730,8 @@ namespace seal
         Exponentiates a ciphertext. This functions raises encrypted to a power and stores
         the result in the destination parameter. Dynamic memory allocations in the process
         are allocated from the memory pool pointed to by the given MemoryPoolHandle. The 
-        exponentiation is done in a depth-optimal order, and relinearization is performed
-        automatically after every multiplication in the process. In relinearization the 
+        exponentiation is done by repeated squaring in a depth-optimal order, and 
+        relinearization is performed automatically after every multiplication in the process. In relinearization the 
         given evaluation keys are used. 
 
         @param[in] encrypted The ciphertext to exponentiate
@@ -537,6 +741,7 @@ namespace seal
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::invalid_argument if encrypted or evaluation_keys is not valid for the 
         encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
         @throws std::invalid_argument if exponent is zero
         @throws std::invalid_argument if the size of evaluation_keys is too small
         @throws std::logic_error if destination is aliased and needs to be reallocated
@@ -551,11 +756,11 @@ namespace seal
         }
 
         /**
-        Exponentiates a ciphertext. TThis functions raises encrypted to a power and stores
+        Exponentiates a ciphertext. This functions raises encrypted to a power and stores
         the result in the destination parameter. Dynamic memory allocations in the process
         are allocated from the memory pool pointed to by the local MemoryPoolHandle. The
-        exponentiation is done in a depth-optimal order, and relinearization is performed
-        automatically after every multiplication in the process. In relinearization the 
+        exponentiation is done by repeated squaring in a depth-optimal order, and 
+        relinearization is performed automatically after every multiplication in the process. In relinearization the 
         given evaluation keys are used.
 
         @param[in] encrypted The ciphertext to exponentiate
@@ -564,6 +769,7 @@ namespace seal
         @param[out] destination The ciphertext to overwrite with the power
         @throws std::invalid_argument if encrypted or evaluation_keys is not valid for the
         encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
         @throws std::invalid_argument if exponent is zero
         @throws std::invalid_argument if the size of evaluation_keys is too small
         @throws std::logic_error if destination is aliased and needs to be reallocated
@@ -574,6 +780,101 @@ namespace seal
             exponentiate(encrypted, exponent, evaluation_keys, destination, pool_);
         }
 
+        /**
+        Exponentiates a ciphertext following an ExponentiationPlan. This functions raises 
+        encrypted to the power plan.exponent(), performing the squarings and multiplications 
+        in the order given by the plan. A product is relinearized whenever its size exceeds 
+        plan.max_size(). Dynamic memory allocations in the process are allocated from the 
+        memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to exponentiate
+        @param[in] plan The exponentiation plan
+        @param[in] evaluation_keys The evaluation keys
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted or evaluation_keys is not valid for the
+        encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the size of evaluation_keys is too small
+        @throws std::logic_error if encrypted is aliased and needs to be reallocated
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void exponentiate(Ciphertext &encrypted, const ExponentiationPlan &plan, 
+            const EvaluationKeys &evaluation_keys, const MemoryPoolHandle &pool);
+
+        /**
+        Exponentiates a ciphertext following an ExponentiationPlan. This functions raises 
+        encrypted to the power plan.exponent(), performing the squarings and multiplications 
+        in the order given by the plan. A product is relinearized whenever its size exceeds 
+        plan.max_size(). Dynamic memory allocations in the process are allocated from the 
+        memory pool pointed to by the local MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to exponentiate
+        @param[in] plan The exponentiation plan
+        @param[in] evaluation_keys The evaluation keys
+        @throws std::invalid_argument if encrypted or evaluation_keys is not valid for the
+        encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the size of evaluation_keys is too small
+        @throws std::logic_error if encrypted is aliased and needs to be reallocated
+        */
+        inline void exponentiate(Ciphertext &encrypted, const ExponentiationPlan &plan, 
+            const EvaluationKeys &evaluation_keys)
+        {
+            exponentiate(encrypted, plan, evaluation_keys, pool_);
+        }
+
+        /**
+        Exponentiates a ciphertext following an ExponentiationPlan. This functions raises 
+        encrypted to the power plan.exponent() and stores the result in the destination 
+        parameter, performing the squarings and multiplications in the order given by the 
+        plan. A product is relinearized whenever its size exceeds plan.max_size(). Dynamic 
+        memory allocations in the process are allocated from the memory pool pointed to by 
+        the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to exponentiate
+        @param[in] plan The exponentiation plan
+        @param[in] evaluation_keys The evaluation keys
+        @param[out] destination The ciphertext to overwrite with the power
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted or evaluation_keys is not valid for the
+        encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the size of evaluation_keys is too small
+        @throws std::logic_error if destination is aliased and needs to be reallocated
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        inline void exponentiate(const Ciphertext &encrypted, const ExponentiationPlan &plan, 
+            const EvaluationKeys &evaluation_keys, Ciphertext &destination, 
+            const MemoryPoolHandle &pool)
+        {
+            destination = encrypted;
+            exponentiate(destination, plan, evaluation_keys, pool);
+        }
+
+        /**
+        Exponentiates a ciphertext following an ExponentiationPlan. This functions raises 
+        encrypted to the power plan.exponent() and stores the result in the destination 
+        parameter, performing the squarings and multiplications in the order given by the 
+        plan. A product is relinearized whenever its size exceeds plan.max_size(). Dynamic 
+        memory allocations in the process are allocated from the memory pool pointed to by 
+        the local MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to exponentiate
+        @param[in] plan The exponentiation plan
+        @param[in] evaluation_keys The evaluation keys
+        @param[out] destination The ciphertext to overwrite with the power
+        @throws std::invalid_argument if encrypted or evaluation_keys is not valid for the
+        encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if the size of evaluation_keys is too small
+        @throws std::logic_error if destination is aliased and needs to be reallocated
+        */
+        inline void exponentiate(const Ciphertext &encrypted, const ExponentiationPlan &plan,
+            const EvaluationKeys &evaluation_keys, Ciphertext &destination)
+        {
+            exponentiate(encrypted, plan, evaluation_keys, destination, pool_);
+        }
+
         /**
         Adds a ciphertext and a plaintext. This function adds a plaintext to a ciphertext.
         For the operation to be valid, the plaintext must have less than degree(poly_modulus)
@@ -822,6 +1123,7 @@ namespace seal
 
         @param[in] encrypted The ciphertext to transform
         @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is already in NTT form
         */
         void transform_to_ntt(Ciphertext &encrypted);
 
@@ -833,6 +1135,7 @@ namespace seal
         @param[in] encrypted The ciphertext to transform
         @param[out] destination_ntt The ciphertext to overwrite with the transformed result
         @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is already in NTT form
         @throws std::logic_error if destination_ntt is aliased and needs to be reallocated
         */
         inline void transform_to_ntt(const Ciphertext &encrypted, Ciphertext &destination_ntt)
@@ -847,6 +1150,7 @@ namespace seal
 
         @param[in] encrypted_ntt The ciphertext to transform
         @throws std::invalid_argument if encrypted_ntt is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted_ntt is not in NTT form
         */
         void transform_from_ntt(Ciphertext &encrypted_ntt);
 
@@ -858,6 +1162,7 @@ namespace seal
         @param[in] encrypted_ntt The ciphertext to transform
         @param[out] destination The ciphertext to overwrite with the transformed result
         @throws std::invalid_argument if encrypted_ntt is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted_ntt is not in NTT form
         @throws std::logic_error if destination is aliased and needs to be reallocated
         */
         inline void transform_from_ntt(const Ciphertext &encrypted_ntt, Ciphertext &destination)
@@ -876,6 +1181,7 @@ namespace seal
         @param[in] plain_ntt The plaintext to multiply
         @throws std::invalid_argument if encrypted_ntt or plain_ntt is not valid for the
         encryption parameters
+        @throws std::invalid_argument if encrypted_ntt is not in NTT form
         @throws std::invalid_argument if plain_ntt is zero
         */
         void multiply_plain_ntt(Ciphertext &encrypted_ntt, const Plaintext &plain_ntt);
@@ -891,6 +1197,7 @@ namespace seal
         @param[out] destination_ntt The ciphertext to overwrite with the multiplication result
         @throws std::invalid_argument if encrypted_ntt or plain_ntt is not valid for the
         encryption parameters
+        @throws std::invalid_argument if encrypted_ntt is not in NTT form
         @throws std::invalid_argument if plain_ntt is zero
         @throws std::logic_error if destination_ntt is aliased and needs to be reallocated
         */
@@ -901,13 +1208,37 @@ namespace seal
             multiply_plain_ntt(destination_ntt, plain_ntt);
         }
 
+        /**
+        Computes the inner product of a vector of ciphertexts and a vector of plaintexts. This
+        function multiplies each NTT transformed ciphertext with the NTT transformed plaintext 
+        at the same index, and stores the sum of the products in the destination_ntt parameter.
+        The result remains in the NTT domain. The products are accumulated without modular 
+        reduction in 128-bit words, and reduced only at the end or when further products could
+        overflow the accumulators, which is much faster than calling multiply_plain_ntt and 
+        add for each pair. If the Evaluator has a thread pool, the coefficients are split into 
+        blocks that are processed in parallel.
+
+        @param[in] encrypteds_ntt The ciphertexts to multiply
+        @param[in] plains_ntt The plaintexts to multiply
+        @param[out] destination_ntt The ciphertext to overwrite with the inner product
+        @throws std::invalid_argument if encrypteds_ntt is empty
+        @throws std::invalid_argument if encrypteds_ntt and plains_ntt have different sizes
+        @throws std::invalid_argument if the ciphertexts or plaintexts are not valid for the
+        encryption parameters
+        @throws std::invalid_argument if the ciphertexts are not in NTT form
+        @throws std::logic_error if destination_ntt is aliased and needs to be reallocated
+        */
+        void dot_product_plain(const std::vector<Ciphertext> &encrypteds_ntt, 
+            const std::vector<Plaintext> &plains_ntt, Ciphertext &destination_ntt);
+
         /**
         Rotates plaintext matrix rows cyclically. When batching is used, this function rotates
         the encrypted plaintext matrix rows cyclically to the left (steps > 0) or to the right
         (steps < 0). Since the size of the batched matrix is 2-by-(N/2), where N is the degree
         of the polynomial modulus, the number of steps to rotate must have absolute value at 
-        most N/2-1. Dynamic memory allocations in the process are allocated from the memory
-        pool pointed to by the given MemoryPoolHandle.
+        most N/2-1. If no Galois key is present for the given step, the rotation is composed
+        of the fewest rotations that have keys. Dynamic memory allocations in the process are
+        allocated from the memory pool pointed to by the given MemoryPoolHandle.
 
         @param[in] encrypted The ciphertext to rotate
         @param[in] steps The number of steps to rotate (negative left, positive right)
@@ -928,8 +1259,9 @@ namespace seal
         the encrypted plaintext matrix rows cyclically to the left (steps > 0) or to the right
         (steps < 0). Since the size of the batched matrix is 2-by-(N/2), where N is the degree
         of the polynomial modulus, the number of steps to rotate must have absolute value at
-        most N/2-1. Dynamic memory allocations in the process are allocated from the memory
-        pool pointed to by the local MemoryPoolHandle.
+        most N/2-1. If no Galois key is present for the given step, the rotation is composed
+        of the fewest rotations that have keys. Dynamic memory allocations in the process are
+        allocated from the memory pool pointed to by the local MemoryPoolHandle.
 
         @param[in] encrypted The ciphertext to rotate
         @param[in] steps The number of steps to rotate (negative left, positive right)
@@ -1000,6 +1332,117 @@ namespace seal
             rotate_rows(encrypted, steps, galois_keys, destination, pool_);
         }
 
+        /**
+        Rotates plaintext matrix rows cyclically by several different step counts. When 
+        batching is used, this function computes the same results as calling rotate_rows
+        once for each entry of steps, and writes the rotated ciphertexts to the destination
+        vector in the same order. The base-w decomposition of the ciphertext and its NTT
+        transform are computed only once and shared by all rotations for which a Galois key
+        is present, making this much faster than separate calls to rotate_rows. Rotations
+        for which no Galois key is present are computed as in rotate_rows. Dynamic memory
+        allocations in the process are allocated from the memory pool pointed to by the
+        given MemoryPoolHandle. The ciphertext to rotate may be an element of the destination
+        vector.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The numbers of steps to rotate (negative right, positive left)
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The vector to overwrite with the rotated ciphertexts
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for the
+        encryption parameters
+        @throws std::invalid_argument if encrypted has size other than two
+        @throws std::invalid_argument if any step count has too big absolute value
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void rotate_rows_many(const Ciphertext &encrypted, const std::vector<int> &steps,
+            const GaloisKeys &galois_keys, std::vector<Ciphertext> &destination, 
+            const MemoryPoolHandle &pool);
+
+        /**
+        Rotates plaintext matrix rows cyclically by several different step counts. When 
+        batching is used, this function computes the same results as calling rotate_rows
+        once for each entry of steps, and writes the rotated ciphertexts to the destination
+        vector in the same order. The base-w decomposition of the ciphertext and its NTT
+        transform are computed only once and shared by all rotations for which a Galois key
+        is present, making this much faster than separate calls to rotate_rows. Rotations
+        for which no Galois key is present are computed as in rotate_rows. Dynamic memory
+        allocations in the process are allocated from the memory pool pointed to by the
+        local MemoryPoolHandle. The ciphertext to rotate may be an element of the destination
+        vector.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The numbers of steps to rotate (negative right, positive left)
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The vector to overwrite with the rotated ciphertexts
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for the
+        encryption parameters
+        @throws std::invalid_argument if encrypted has size other than two
+        @throws std::invalid_argument if any step count has too big absolute value
+        @throws std::invalid_argument if necessary Galois keys are not present
+        */
+        inline void rotate_rows_many(const Ciphertext &encrypted, const std::vector<int> &steps,
+            const GaloisKeys &galois_keys, std::vector<Ciphertext> &destination)
+        {
+            rotate_rows_many(encrypted, steps, galois_keys, destination, pool_);
+        }
+
+        /**
+        Multiplies a plaintext matrix with an encrypted vector. When batching is used, this
+        function multiplies the given PlainMatrix with each row of the encrypted plaintext
+        matrix, where the vector of length d, the dimension of the matrix, must be repeated
+        with period d across each row. The result has the same layout, and is in NTT form if
+        and only if encrypted is. The product is computed with the baby-step giant-step 
+        diagonal method, which needs the rotations listed by the rotation_steps function of
+        the PlainMatrix: the baby step rotations share one hoisted key switch decomposition,
+        and each giant step needs one more key switch. Rotations for which no Galois key is
+        present are composed of several rotations as in rotate_rows. Dynamic memory 
+        allocations in the process are allocated from the memory pool pointed to by the given
+        MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] matrix The plaintext matrix to multiply
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The ciphertext to overwrite with the product
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted, matrix or galois_keys is not valid for
+        the encryption parameters
+        @throws std::invalid_argument if encrypted has size other than two
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void multiply_plain_matrix(const Ciphertext &encrypted, const PlainMatrix &matrix,
+            const GaloisKeys &galois_keys, Ciphertext &destination, const MemoryPoolHandle &pool);
+
+        /**
+        Multiplies a plaintext matrix with an encrypted vector. When batching is used, this
+        function multiplies the given PlainMatrix with each row of the encrypted plaintext
+        matrix, where the vector of length d, the dimension of the matrix, must be repeated
+        with period d across each row. The result has the same layout, and is in NTT form if
+        and only if encrypted is. The product is computed with the baby-step giant-step 
+        diagonal method, which needs the rotations listed by the rotation_steps function of
+        the PlainMatrix: the baby step rotations share one hoisted key switch decomposition,
+        and each giant step needs one more key switch. Rotations for which no Galois key is
+        present are composed of several rotations as in rotate_rows. Dynamic memory 
+        allocations in the process are allocated from the memory pool pointed to by the local
+        MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] matrix The plaintext matrix to multiply
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The ciphertext to overwrite with the product
+        @throws std::invalid_argument if encrypted, matrix or galois_keys is not valid for
+        the encryption parameters
+        @throws std::invalid_argument if encrypted has size other than two
+        @throws std::invalid_argument if necessary Galois keys are not present
+        */
+        inline void multiply_plain_matrix(const Ciphertext &encrypted, const PlainMatrix &matrix,
+            const GaloisKeys &galois_keys, Ciphertext &destination)
+        {
+            multiply_plain_matrix(encrypted, matrix, galois_keys, destination, pool_);
+        }
+
         /**
         Rotates plaintext matrix columns cyclically. When batching is used, this function
         rotates the encrypted plaintext matrix columns cyclically. Since the size of the 
@@ -1096,6 +1539,175 @@ namespace seal
             rotate_columns(encrypted, galois_keys, destination, pool_);
         }
 
+        /**
+        Switches a ciphertext down to the next level by dropping the last prime from its
+        coefficient modulus, and scaling the ciphertext down accordingly. The noise is scaled
+        down by the dropped prime too, so the noise budget stays roughly the same, except that
+        it cannot exceed what the small rounding error of the switch allows at the next level.
+        The ciphertext keeps its NTT form. Dynamic memory allocations in the process are
+        allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to switch to the next level
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is already at the lowest level
+        @throws std::invalid_argument if pool is uninitialized
+        @see SEALContext for more details on levels.
+        */
+        void mod_switch_to_next(Ciphertext &encrypted, const MemoryPoolHandle &pool);
+
+        /**
+        Switches a ciphertext down to the next level by dropping the last prime from its
+        coefficient modulus, and scaling the ciphertext down accordingly. The ciphertext
+        keeps its NTT form. Dynamic memory allocations in the process are allocated from
+        the memory pool pointed to by the local MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to switch to the next level
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is already at the lowest level
+        @see SEALContext for more details on levels.
+        */
+        inline void mod_switch_to_next(Ciphertext &encrypted)
+        {
+            mod_switch_to_next(encrypted, pool_);
+        }
+
+        /**
+        Switches a ciphertext down to the next level by dropping the last prime from its
+        coefficient modulus, and writes the result to the destination parameter. Dynamic
+        memory allocations in the process are allocated from the memory pool pointed to by
+        the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to switch to the next level
+        @param[out] destination The ciphertext to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is already at the lowest level
+        @throws std::logic_error if destination is aliased and needs to be reallocated
+        @throws std::invalid_argument if pool is uninitialized
+        @see SEALContext for more details on levels.
+        */
+        inline void mod_switch_to_next(const Ciphertext &encrypted, Ciphertext &destination,
+            const MemoryPoolHandle &pool)
+        {
+            destination = encrypted;
+            mod_switch_to_next(destination, pool);
+        }
+
+        /**
+        Switches a ciphertext down to the next level by dropping the last prime from its
+        coefficient modulus, and writes the result to the destination parameter. Dynamic
+        memory allocations in the process are allocated from the memory pool pointed to by
+        the local MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to switch to the next level
+        @param[out] destination The ciphertext to overwrite with the result
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is already at the lowest level
+        @throws std::logic_error if destination is aliased and needs to be reallocated
+        @see SEALContext for more details on levels.
+        */
+        inline void mod_switch_to_next(const Ciphertext &encrypted, Ciphertext &destination)
+        {
+            mod_switch_to_next(encrypted, destination, pool_);
+        }
+
+        /**
+        Switches a ciphertext down to a given level by repeatedly dropping the last prime from
+        its coefficient modulus. Switching to the current level of the ciphertext does nothing.
+        Dynamic memory allocations in the process are allocated from the memory pool pointed
+        to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to switch to the given level
+        @param[in] level The level to switch to
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if level is higher than the level of encrypted or lower
+        than the lowest level
+        @throws std::invalid_argument if pool is uninitialized
+        @see SEALContext for more details on levels.
+        */
+        void mod_switch_to(Ciphertext &encrypted, int level, const MemoryPoolHandle &pool);
+
+        /**
+        Switches a ciphertext down to a given level by repeatedly dropping the last prime from
+        its coefficient modulus. Switching to the current level of the ciphertext does nothing.
+        Dynamic memory allocations in the process are allocated from the memory pool pointed
+        to by the local MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to switch to the given level
+        @param[in] level The level to switch to
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if level is higher than the level of encrypted or lower
+        than the lowest level
+        @see SEALContext for more details on levels.
+        */
+        inline void mod_switch_to(Ciphertext &encrypted, int level)
+        {
+            mod_switch_to(encrypted, level, pool_);
+        }
+
+        /**
+        Switches a ciphertext down to a given level by repeatedly dropping the last prime from
+        its coefficient modulus, and writes the result to the destination parameter. Dynamic
+        memory allocations in the process are allocated from the memory pool pointed to by the
+        given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to switch to the given level
+        @param[in] level The level to switch to
+        @param[out] destination The ciphertext to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if level is higher than the level of encrypted or lower
+        than the lowest level
+        @throws std::logic_error if destination is aliased and needs to be reallocated
+        @throws std::invalid_argument if pool is uninitialized
+        @see SEALContext for more details on levels.
+        */
+        inline void mod_switch_to(const Ciphertext &encrypted, int level, Ciphertext &destination,
+            const MemoryPoolHandle &pool)
+        {
+            destination = encrypted;
+            mod_switch_to(destination, level, pool);
+        }
+
+        /**
+        Switches a ciphertext down to a given level by repeatedly dropping the last prime from
+        its coefficient modulus, and writes the result to the destination parameter. Dynamic
+        memory allocations in the process are allocated from the memory pool pointed to by the
+        local MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to switch to the given level
+        @param[in] level The level to switch to
+        @param[out] destination The ciphertext to overwrite with the result
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if level is higher than the level of encrypted or lower
+        than the lowest level
+        @throws std::logic_error if destination is aliased and needs to be reallocated
+        @see SEALContext for more details on levels.
+        */
+        inline void mod_switch_to(const Ciphertext &encrypted, int level, Ciphertext &destination)
+        {
+            mod_switch_to(encrypted, level, destination, pool_);
+        }
+
+        /**
+        Returns the lowest level that ciphertexts can be switched down to.
+        */
+        inline int min_level() const
+        {
+            return level_contexts_ ? level_contexts_->min_level() : static_cast<int>(coeff_modulus_.size());
+        }
+
+        /**
+        Returns the ThreadPoolHandle used to parallelize operations. The returned
+        ThreadPoolHandle is uninitialized if operations run sequentially.
+        */
+        inline const ThreadPoolHandle &thread_pool() const
+        {
+            return thread_pool_;
+        }
+
     private:
         Evaluator &operator =(const Evaluator &assign) = delete;
 
@@ -1204,11 +1816,78 @@ namespace seal
 
         void compose(std::uint64_t *value, const MemoryPoolHandle &pool);
 
+        // Calls func(0), ..., func(count - 1), on the thread pool if one is attached. The
+        // calls must not allocate memory.
+        void parallel_for(int count, const std::function<void(int)> &func) const;
+
+        // As above, but the calls may allocate from pool. Falls back to running sequentially
+        // if pool is not thread-safe.
+        void parallel_for(int count, const std::function<void(int)> &func, 
+            const MemoryPoolHandle &pool) const;
+
+        // Decomposes source into base w modulo each prime, as needed for key switching with key.
+        // The decomposed factors modulo prime i are the polys from decomp_offsets[i] up to, but
+        // not including, decomp_offsets[i + 1] in the returned allocation.
+        util::Pointer decompose_key_switch_source(const std::uint64_t *source, const std::vector<Ciphertext> &key,
+            int decomposition_bit_count, std::vector<int> &decomp_offsets, const MemoryPoolHandle &pool);
+
+        // Computes (destination[0], destination[1]) += (source * key[0], source * key[1]),
+        // where source is decomposed in base w modulo each prime and key is a key-switching
+        // key such as one evaluation key or the Galois key for one Galois element. If
+        // is_ntt_form is set, both source and destination are in NTT form.
+        void switch_key_inplace(const std::uint64_t *source, const std::vector<Ciphertext> &key,
+            int decomposition_bit_count, std::uint64_t *destination, bool is_ntt_form, 
+            const MemoryPoolHandle &pool);
+
         void relinearize_one_step(std::uint64_t *encrypted, int encrypted_size, 
-            const EvaluationKeys &evaluation_keys, const MemoryPoolHandle &pool);
+            const EvaluationKeys &evaluation_keys, bool is_ntt_form, const MemoryPoolHandle &pool);
+
+        // Writes the plaintext scaled by floor(q/t) into destination, which must be zero, and
+        // transforms the result to NTT form modulo each prime.
+        void scale_plain_to_ntt(const Plaintext &plain, std::uint64_t *destination);
+
+        // Extends each of the count (at most two) ciphertexts from q to Bsk, and writes it to the
+        // corresponding destination in NTT form modulo q, followed by NTT form modulo Bsk.
+        void prepare_operands(const Ciphertext *const *encrypteds, std::uint64_t *const *destinations,
+            int count, const MemoryPoolHandle &pool);
+
+        // Multiplies two operands written by prepare_operands, and writes the product to
+        // destination.
+        void multiply_prepared(const std::uint64_t *prepared1, int encrypted1_size, 
+            const std::uint64_t *prepared2, int encrypted2_size, Ciphertext &destination, 
+            const MemoryPoolHandle &pool);
+
+        // Computes the inner product of the ciphertexts and plaintexts that the pointers refer
+        // to, as in the public dot_product_plain.
+        void dot_product_plain(const std::vector<const Ciphertext*> &encrypteds_ntt,
+            const std::vector<const Plaintext*> &plains_ntt, Ciphertext &destination_ntt,
+            const MemoryPoolHandle &pool);
 
         void populate_Zmstar_to_generator();
 
+        // Returns the Evaluator for the lower level that the given hash block belongs to, or
+        // nullptr if it belongs to no lower level. Operations on ciphertexts at lower levels
+        // are forwarded to these.
+        Evaluator *level_evaluator(const EncryptionParameters::hash_block_type &hash_block) const;
+
+        // Returns the Evaluator for a lower level, creating it on the first call
+        Evaluator *level_evaluator(int level) const;
+
+        void create_level_evaluators();
+
+        // Switches a ciphertext at the level of this Evaluator down to the next level, whose
+        // encryption parameters are next_parms
+        void mod_switch_to_next(Ciphertext &encrypted, const EncryptionParameters &next_parms,
+            const MemoryPoolHandle &pool);
+
+        // Returns the shortest sequence of Galois elements that have keys in galois_keys and
+        // whose product is galois_elt.
+        std::vector<std::uint64_t> galois_path(std::uint64_t galois_elt, const GaloisKeys &galois_keys) const;
+
+        // Returns the Galois element that rotates the plaintext matrix rows by the given number
+        // of steps.
+        std::uint64_t get_row_rotation_galois_elt(int steps);
+
         // The apply_galois function applies a Galois automorphism to a ciphertext. 
         // It is needed for slot permutations. 
         // Input: encryption of M(x) and an integer p such that gcd(p, m) = 1.
@@ -1237,14 +1916,21 @@ namespace seal
 
         MemoryPoolHandle pool_;
 
+        ThreadPoolHandle thread_pool_;
+
         EncryptionParameters parms_;
 
         EncryptionParameterQualifiers qualifiers_;
         
         util::BaseConverter base_converter_;
+
+        MultiplyMethod multiply_method_;
+
+        util::HPSConverter hps_converter_;
         
         std::vector<util::SmallNTTTables> coeff_small_ntt_tables_;
 
+        // With MultiplyMethod::hps the auxiliary base used in multiplication is P instead of Bsk
         std::vector<util::SmallNTTTables> bsk_small_ntt_tables_;
 
         util::Pointer upper_half_increment_;
@@ -1276,5 +1962,32 @@ namespace seal
         int bsk_base_mod_count_;
 
         std::map<std::uint64_t, std::pair<std::uint64_t, std::uint64_t> > Zmstar_to_generator_;
+
+        // The contexts for the lower levels, shared with the SEALContext, or null if this 
+        // Evaluator is for a lower level
+        std::shared_ptr<SEALContext::LevelContexts> level_contexts_;
+
+        struct LevelEvaluator
+        {
+            std::once_flag create_flag;
+
+            std::shared_ptr<Evaluator> evaluator;
+        };
+
+        // Evaluators for the lower levels, from max level - 1 down to min_level(), created on
+        // first use
+        std::vector<std::unique_ptr<LevelEvaluator> > level_evaluators_;
+
+        // Evaluation and Galois keys are always generated for the highest level
+        EncryptionParameters::hash_block_type top_level_hash_block_;
+
+        int top_level_coeff_mod_count_;
+
+        // Inverses used to decompose key switching sources; these are taken from the highest
+        // level so that the keys for the highest level can be used at every level
+        std::vector<std::uint64_t> key_inv_coeff_products_mod_coeff_array_;
+
+        // Inverse of the last prime modulo each of the other primes
+        util::Pointer inv_last_coeff_mod_array_;
     };
 }
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "seal/memorypoolhandle.h"
+#include "seal/util/mempool.h"
+
+namespace seal
+{
+    /**
+    Holds reusable scratch memory for homomorphic operations. Operations such as multiply,
+    relinearize and the rotations in Evaluator allocate several temporary polynomials on
+    every call. Normally these come from a memory pool, which involves a lookup by size
+    and, for thread-safe memory pools, synchronization with other threads. An 
+    EvaluatorWorkspace instead hands them out from one contiguous buffer that is reused
+    from call to call. Once the first few calls have grown the buffer to the peak size
+    needed, operations using the workspace perform no allocations at all.
+
+    @par Usage
+    Create one EvaluatorWorkspace per thread, and pass it to any Evaluator function that
+    takes a MemoryPoolHandle; it converts implicitly. Only temporaries should come from
+    the workspace. Objects that outlive the call, such as ciphertexts, should keep using
+    a regular memory pool, since memory in the workspace is reclaimed only when all of it
+    has been returned.
+
+    @par Thread Safety
+    An EvaluatorWorkspace must not be used by several threads at the same time. As for
+    any thread-unsafe memory pool, the parts of an operation that allocate memory run
+    sequentially on the calling thread even if the Evaluator has a thread pool.
+
+    @par Verifying Allocation-Free Code
+    While a util::NoAllocationScope is alive, any memory pool allocation on the current
+    thread throws std::logic_error. This includes the workspace growing its buffer, so a
+    warmed-up workspace can be checked to make a region of code allocation-free.
+
+    @see MemoryPoolHandle for more details on memory pools.
+    */
+    class EvaluatorWorkspace
+    {
+    public:
+        /**
+        Creates an empty EvaluatorWorkspace. The buffer is allocated by the first 
+        operation using the workspace.
+        */
+        EvaluatorWorkspace() : EvaluatorWorkspace(0)
+        {
+        }
+
+        /**
+        Creates an EvaluatorWorkspace with a buffer of at least the given size (in bytes).
+
+        @param[in] byte_count The initial size of the buffer
+        */
+        explicit EvaluatorWorkspace(std::uint64_t byte_count) : 
+            arena_(std::make_shared<util::MemoryPoolArena>(
+                (byte_count + util::bytes_per_uint64 - 1) / util::bytes_per_uint64)),
+            pool_(arena_)
+        {
+        }
+
+        EvaluatorWorkspace(EvaluatorWorkspace &&source) = default;
+
+        EvaluatorWorkspace &operator =(EvaluatorWorkspace &&assign) = default;
+
+        /**
+        Returns a MemoryPoolHandle pointing to the workspace.
+        */
+        inline const MemoryPoolHandle &pool() const
+        {
+            return pool_;
+        }
+
+        /**
+        Returns a MemoryPoolHandle pointing to the workspace.
+        */
+        inline operator const MemoryPoolHandle &() const
+        {
+            return pool_;
+        }
+
+        /**
+        Returns the size (in bytes) of the memory held by the workspace.
+        */
+        inline std::uint64_t byte_count() const
+        {
+            return arena_->alloc_byte_count();
+        }
+
+    private:
+        EvaluatorWorkspace(const EvaluatorWorkspace &copy) = delete;
+
+        EvaluatorWorkspace &operator =(const EvaluatorWorkspace &assign) = delete;
+
+        std::shared_ptr<util::MemoryPoolArena> arena_;
+
+        MemoryPoolHandle pool_;
+    };
+}
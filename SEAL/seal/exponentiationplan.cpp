@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <stdexcept>
+#include "seal/exponentiationplan.h"
+#include "seal/util/common.h"
+
+using namespace std;
+using namespace seal::util;
+
+namespace seal
+{
+    namespace
+    {
+        // Largest window size tried by the minimum multiplies strategy; larger windows
+        // only pay off for exponents far beyond 64 bits
+        const int max_window_size = 6;
+    }
+
+    ExponentiationPlan::ExponentiationPlan(uint64_t exponent, ExponentiationStrategy strategy, int max_size) :
+        exponent_(exponent), strategy_(strategy), max_size_(max_size)
+    {
+        // Verify parameters.
+        if (exponent == 0)
+        {
+            throw invalid_argument("exponent cannot be 0");
+        }
+        if (max_size < 2)
+        {
+            throw invalid_argument("max_size must be at least 2");
+        }
+
+        reset();
+        plan_min_depth();
+        if (strategy != ExponentiationStrategy::min_multiplies)
+        {
+            return;
+        }
+
+        // Keep the minimum depth plan unless some window size needs fewer multiplications,
+        // and break ties by depth
+        int best_window_size = 0;
+        int best_multiply_count = multiply_count();
+        int best_depth = depth_;
+        for (int window_size = 2; window_size <= max_window_size; window_size++)
+        {
+            reset();
+            plan_window(window_size);
+            if (multiply_count() < best_multiply_count ||
+                (multiply_count() == best_multiply_count && depth_ < best_depth))
+            {
+                best_window_size = window_size;
+                best_multiply_count = multiply_count();
+                best_depth = depth_;
+            }
+        }
+        reset();
+        if (best_window_size == 0)
+        {
+            plan_min_depth();
+        }
+        else
+        {
+            plan_window(best_window_size);
+        }
+    }
+
+    void ExponentiationPlan::reset()
+    {
+        depth_ = 0;
+        relinearize_count_ = 0;
+        steps_.clear();
+        slots_.assign(1, SlotState{ 0, 2 });
+        result_slot_ = 0;
+    }
+
+    int ExponentiationPlan::new_slot()
+    {
+        slots_.push_back(SlotState{ 0, 2 });
+        return static_cast<int>(slots_.size()) - 1;
+    }
+
+    void ExponentiationPlan::add_step(int destination, int operand1, int operand2)
+    {
+        // Track depth and size to report the depth and the number of relinearizations
+        SlotState result{ max(slots_[operand1].depth, slots_[operand2].depth) + 1,
+            slots_[operand1].size + slots_[operand2].size - 1 };
+        if (result.size > max_size_)
+        {
+            result.size = max_size_;
+            relinearize_count_++;
+        }
+        slots_[destination] = result;
+        steps_.push_back(Step{ destination, operand1, operand2 });
+    }
+
+    void ExponentiationPlan::plan_min_depth()
+    {
+        int top_bit = get_significant_bit_count(exponent_) - 1;
+
+        // Compute x^(2^i) by repeated squaring, keeping the powers for the set bits
+        vector<int> factors;
+        if (exponent_ & 1)
+        {
+            factors.push_back(0);
+        }
+        int power_slot = 0;
+        for (int i = 1; i <= top_bit; i++)
+        {
+            int destination = ((exponent_ >> (i - 1)) & 1) ? new_slot() : power_slot;
+            add_step(destination, power_slot, power_slot);
+            power_slot = destination;
+            if ((exponent_ >> i) & 1)
+            {
+                factors.push_back(power_slot);
+            }
+        }
+
+        // Multiply the two shallowest factors together until only one is left
+        auto shallower = [this](int slot1, int slot2) {
+            return slots_[slot1].depth < slots_[slot2].depth;
+        };
+        while (factors.size() > 1)
+        {
+            stable_sort(factors.begin(), factors.end(), shallower);
+            add_step(factors[0], factors[0], factors[1]);
+            factors.erase(factors.begin() + 1);
+        }
+        result_slot_ = factors[0];
+        depth_ = slots_[result_slot_].depth;
+    }
+
+    void ExponentiationPlan::plan_window(int window_size)
+    {
+        int top_bit = get_significant_bit_count(exponent_) - 1;
+
+        // Split the exponent into odd windows of at most window_size bits, starting from
+        // the most significant bit; each window is stored as its value and lowest bit
+        vector<pair<uint64_t, int> > windows;
+        uint64_t max_value = 1;
+        for (int i = top_bit; i >= 0; )
+        {
+            if (!((exponent_ >> i) & 1))
+            {
+                i--;
+                continue;
+            }
+            int low_bit = max(i - window_size + 1, 0);
+            while (!((exponent_ >> low_bit) & 1))
+            {
+                low_bit++;
+            }
+            uint64_t value = (exponent_ >> low_bit) & ((uint64_t(1) << (i - low_bit + 1)) - 1);
+            windows.emplace_back(value, low_bit);
+            max_value = max(max_value, value);
+            i = low_bit - 1;
+        }
+
+        // Precompute the odd powers x, x^3, ..., x^max_value
+        vector<int> odd_slots{ 0 };
+        if (max_value > 1)
+        {
+            int square_slot = new_slot();
+            add_step(square_slot, 0, 0);
+            for (uint64_t value = 3; value <= max_value; value += 2)
+            {
+                int destination = new_slot();
+                add_step(destination, odd_slots.back(), square_slot);
+                odd_slots.push_back(destination);
+            }
+        }
+
+        // The accumulator starts out as an entry of the table, so its first update must
+        // go to a new slot
+        int accumulator = odd_slots[windows[0].first / 2];
+        bool shared = true;
+        auto update = [&](int operand) {
+            int destination = shared ? new_slot() : accumulator;
+            add_step(destination, accumulator, operand == -1 ? accumulator : operand);
+            accumulator = destination;
+            shared = false;
+        };
+        int position = windows[0].second;
+        for (size_t i = 1; i < windows.size(); i++)
+        {
+            for (; position > windows[i].second; position--)
+            {
+                update(-1);
+            }
+            update(odd_slots[windows[i].first / 2]);
+        }
+        for (; position > 0; position--)
+        {
+            update(-1);
+        }
+        result_slot_ = accumulator;
+        depth_ = slots_[result_slot_].depth;
+    }
+}
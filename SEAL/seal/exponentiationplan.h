@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace seal
+{
+    /**
+    Selects how an ExponentiationPlan orders the squarings and multiplications that raise a
+    ciphertext to a power.
+
+    @par Minimum Depth
+    Squares the ciphertext repeatedly, and multiplies together the powers x^(2^i) that
+    correspond to the bits set in the exponent, always combining the two factors of smallest
+    multiplicative depth first. The result has the smallest possible multiplicative depth,
+    ceil(log2(exponent)), which keeps the noise growth as low as possible. This is the default.
+
+    @par Minimum Multiplies
+    Uses left-to-right sliding window exponentiation with a table of precomputed odd powers,
+    choosing the window size that needs the fewest multiplications for the exponent. For
+    exponents with many set bits this saves up to half of the non-squaring multiplications,
+    at the cost of a slightly larger multiplicative depth.
+    */
+    enum class ExponentiationStrategy
+    {
+        min_depth = 0,
+        min_multiplies = 1
+    };
+
+    /**
+    Describes the sequence of squarings and multiplications with which Evaluator::exponentiate
+    raises a ciphertext to a power. A plan depends only on the exponent and the chosen options,
+    so it can be created once and reused for any number of ciphertexts. Before running it, the
+    planned multiplicative depth and number of multiplications can be inspected to check that
+    the encryption parameters leave enough noise budget.
+
+    The plan works on a small number of ciphertext slots. Slot 0 initially holds the input,
+    and each step writes the square of one slot, or the product of two slots, to a slot. The
+    result ends up in the slot given by result_slot().
+
+    @par Relinearization
+    By default every product is relinearized back to size 2 right away. If max_size is larger
+    than 2, a product is relinearized only when its size exceeds max_size, and then only down
+    to max_size. This trades fewer relinearizations for multiplications of larger ciphertexts.
+    The evaluation keys passed to Evaluator::exponentiate must then be large enough to
+    relinearize a ciphertext of size 2 * max_size - 1 down to max_size.
+    */
+    class ExponentiationPlan
+    {
+    public:
+        /**
+        A single step of an ExponentiationPlan. The step overwrites the slot destination with
+        the product of the slots operand1 and operand2. If operand1 and operand2 are equal, the
+        step is a squaring. The destination slot is either operand1 or a slot that holds no
+        value needed later.
+        */
+        struct Step
+        {
+            int destination;
+
+            int operand1;
+
+            int operand2;
+        };
+
+        /**
+        Creates a plan for raising a ciphertext to the given power.
+
+        @param[in] exponent The power to raise ciphertexts to
+        @param[in] strategy The strategy for ordering the multiplications
+        @param[in] max_size The largest ciphertext size to allow before relinearizing
+        @throws std::invalid_argument if exponent is zero
+        @throws std::invalid_argument if max_size is less than 2
+        */
+        ExponentiationPlan(std::uint64_t exponent,
+            ExponentiationStrategy strategy = ExponentiationStrategy::min_depth,
+            int max_size = 2);
+
+        /**
+        Returns the power the plan raises ciphertexts to.
+        */
+        inline std::uint64_t exponent() const
+        {
+            return exponent_;
+        }
+
+        /**
+        Returns the strategy the plan was created with.
+        */
+        inline ExponentiationStrategy strategy() const
+        {
+            return strategy_;
+        }
+
+        /**
+        Returns the largest ciphertext size allowed before relinearizing.
+        */
+        inline int max_size() const
+        {
+            return max_size_;
+        }
+
+        /**
+        Returns the multiplicative depth of the plan, i.e. the largest number of
+        multiplications on any path from the input to the result.
+        */
+        inline int depth() const
+        {
+            return depth_;
+        }
+
+        /**
+        Returns the number of ciphertext multiplications in the plan, including squarings.
+        */
+        inline int multiply_count() const
+        {
+            return static_cast<int>(steps_.size());
+        }
+
+        /**
+        Returns the number of relinearizations performed when the plan is applied to a
+        ciphertext of size 2.
+        */
+        inline int relinearize_count() const
+        {
+            return relinearize_count_;
+        }
+
+        /**
+        Returns the steps of the plan in the order they are to be performed.
+        */
+        inline const std::vector<Step> &steps() const
+        {
+            return steps_;
+        }
+
+        /**
+        Returns the number of ciphertext slots the steps refer to.
+        */
+        inline int slot_count() const
+        {
+            return static_cast<int>(slots_.size());
+        }
+
+        /**
+        Returns the slot holding the result once all steps have been performed.
+        */
+        inline int result_slot() const
+        {
+            return result_slot_;
+        }
+
+    private:
+        struct SlotState
+        {
+            int depth;
+
+            int size;
+        };
+
+        void reset();
+
+        int new_slot();
+
+        void add_step(int destination, int operand1, int operand2);
+
+        void plan_min_depth();
+
+        void plan_window(int window_size);
+
+        std::uint64_t exponent_;
+
+        ExponentiationStrategy strategy_;
+
+        int max_size_;
+
+        int depth_ = 0;
+
+        int relinearize_count_ = 0;
+
+        std::vector<Step> steps_;
+
+        std::vector<SlotState> slots_;
+
+        int result_slot_ = 0;
+    };
+}
@@ -1,12 +1,85 @@
 #include "seal/galoiskeys.h"
+#include "seal/galoiskeystore.h"
 #include "seal/util/common.h"
 #include <stdexcept>
+#include <numeric>
 
 using namespace std;
 using namespace seal::util;
 
 namespace seal
 {
+    GaloisKeys::GaloisKeys(const shared_ptr<GaloisKeyStore> &store) : store_(store)
+    {
+        if (!store_)
+        {
+            throw invalid_argument("store cannot be null");
+        }
+        hash_block_ = store_->hash_block();
+        decomposition_bit_count_ = store_->decomposition_bit_count();
+    }
+
+    int GaloisKeys::size() const
+    {
+        if (store_)
+        {
+            return store_->size();
+        }
+        return accumulate(keys_.begin(), keys_.end(), 0,
+            [](int current_size, const vector<Ciphertext> &next_key)
+        {
+            return current_size + static_cast<int>(next_key.size() > 0);
+        });
+    }
+
+    bool GaloisKeys::has_key(uint64_t galois_elt) const
+    {
+        // Verify parameters
+        if (!(galois_elt & 1))
+        {
+            throw invalid_argument("galois element is not valid");
+        }
+        if (store_)
+        {
+            return store_->has_key(galois_elt);
+        }
+        uint64_t index = (galois_elt - 1) >> 1;
+        return (index < keys_.size()) && !keys_[index].empty();
+    }
+
+    vector<uint64_t> GaloisKeys::galois_elts() const
+    {
+        if (store_)
+        {
+            return store_->galois_elts();
+        }
+        vector<uint64_t> result;
+        for (size_t index = 0; index < keys_.size(); index++)
+        {
+            if (!keys_[index].empty())
+            {
+                result.push_back(2 * index + 1);
+            }
+        }
+        return result;
+    }
+
+    shared_ptr<const vector<Ciphertext> > GaloisKeys::acquire_key(uint64_t galois_elt) const
+    {
+        if (!has_key(galois_elt))
+        {
+            throw invalid_argument("requested key does not exist");
+        }
+        if (store_)
+        {
+            return store_->key(galois_elt);
+        }
+
+        // The key is owned by keys_, so the pointer must not delete it
+        return shared_ptr<const vector<Ciphertext> >(shared_ptr<const vector<Ciphertext> >(), 
+            &keys_[(galois_elt - 1) >> 1]);
+    }
+
     void GaloisKeys::save(std::ostream &stream) const
     {
         // Save the hash block
@@ -16,30 +89,45 @@ namespace seal
         int32_t decomposition_bit_count32 = static_cast<int32_t>(decomposition_bit_count_);
         stream.write(reinterpret_cast<const char*>(&decomposition_bit_count32), sizeof(int32_t));
 
-        // Save the size of keys_
-        int32_t keys_dim1 = static_cast<int32_t>(keys_.size());
+        // Save the size of keys_; keys loaded from a store are saved as if they were in keys_
+        vector<uint64_t> elts = galois_elts();
+        int32_t keys_dim1 = static_cast<int32_t>(store_ ? 
+            (elts.empty() ? 0 : ((elts.back() - 1) >> 1) + 1) : keys_.size());
         stream.write(reinterpret_cast<const char*>(&keys_dim1), sizeof(int32_t));
 
         // Now loop again over keys_dim1
         for (int32_t index = 0; index < keys_dim1; index++)
         {
+            uint64_t galois_elt = 2 * static_cast<uint64_t>(index) + 1;
+            shared_ptr<const vector<Ciphertext> > key;
+            if (has_key(galois_elt))
+            {
+                key = acquire_key(galois_elt);
+            }
+
             // Save second dimension of keys_
-            int32_t keys_dim2 = keys_[index].size();
+            int32_t keys_dim2 = key ? static_cast<int32_t>(key->size()) : 0;
             stream.write(reinterpret_cast<const char*>(&keys_dim2), sizeof(int32_t));
 
             // Loop over keys_dim2 and save all (or none)
             for (int32_t j = 0; j < keys_dim2; j++)
             {
                 // Save the key
-                keys_[index][j].save(stream);
+                (*key)[j].save(stream);
             }
         }
     }
 
     void GaloisKeys::load(std::istream &stream)
+    {
+        load(stream, ThreadPoolHandle());
+    }
+
+    void GaloisKeys::load(std::istream &stream, const ThreadPoolHandle &thread_pool)
     {
         // Clear current keys
         keys_.clear();
+        store_.reset();
 
         // Read the hash block
         stream.read(reinterpret_cast<char*>(&hash_block_), sizeof(EncryptionParameters::hash_block_type));
@@ -67,8 +155,33 @@ namespace seal
             keys_[index].resize(keys_dim2);
             for (int32_t j = 0; j < keys_dim2; j++)
             {
-                keys_[index][j].load(stream);
+                keys_[index][j].load_deferred(stream);
+            }
+        }
+
+        // Generate the polynomials that were saved as seeds
+        vector<Ciphertext*> seeded_keys;
+        for (auto &key : keys_)
+        {
+            for (auto &key_component : key)
+            {
+                if (key_component.has_seed())
+                {
+                    seeded_keys.push_back(&key_component);
+                }
             }
         }
+        int seeded_key_count = static_cast<int>(seeded_keys.size());
+        if (thread_pool && seeded_key_count > 1)
+        {
+            static_cast<ThreadPool&>(thread_pool).parallel_for(seeded_key_count, [&](int index) {
+                seeded_keys[index]->expand_seed();
+            });
+            return;
+        }
+        for (Ciphertext *key_component : seeded_keys)
+        {
+            key_component->expand_seed();
+        }
     }
 }
@@ -3,8 +3,11 @@
 #include <iostream>
 #include <vector>
 #include <numeric>
+#include <memory>
+#include <cstdint>
 #include "seal/ciphertext.h"
 #include "seal/encryptionparams.h"
+#include "seal/threadpoolhandle.h"
 
 namespace seal
 {
@@ -19,6 +22,13 @@ namespace seal
     operations allow us to also rotate the matrix rows cyclically in either direction, and 
     rotate the columns (swap the rows). These operations require the Galois keys.
 
+    @par Choosing Keys
+    Each Galois key performs one rotation with a single key switch. Rotations without a key
+    are composed of the fewest rotations that have keys. KeyGenerator generates by default
+    keys for rotating by powers of two in both directions, which compose any rotation with
+    at most about log2(N)/2 key switches. To use less memory, or to make the rotations an
+    application needs faster, use a RotationPlan to choose the keys instead.
+
     @par Decomposition Bit Count
     Decomposition bit count (dbc) is a parameter that describes a performance trade-off in
     the rotation operation. Its function is exactly the same as in relinearization. Namely, 
@@ -30,6 +40,22 @@ namespace seal
     to optimize the dbc to be as large as possible for performance. The dbc is upper-bounded 
     by the value of 60, and lower-bounded by the value of 1.
 
+    @par Compact Serialization
+    Each Galois key is a list of ciphertexts that encrypt multiples of a rotated secret key,
+    and half of the polynomials in them are uniformly random. KeyGenerator generates these
+    from a seed for each ciphertext, so save() writes only the other half of the polynomials
+    together with the seeds, and load() generates the random polynomials again. This halves
+    the size of the saved keys. Most of the time spent loading goes into generating the
+    polynomials, which can be spread over several threads by passing a thread pool to
+    load().
+
+    @par Lazy Loading
+    A GaloisKeys instance can also be created from a GaloisKeyStore, in which case it holds
+    no keys itself, but loads them from the file of the store when they are first used. Such
+    an instance can be passed to Evaluator like any other GaloisKeys. Since its keys are not
+    all in memory, data() returns an empty vector, and key() cannot be used; use acquire_key()
+    instead.
+
     @par Thread Safety
     In general, reading from GaloisKeys is thread-safe as long as no other thread is 
     concurrently mutating it. This is due to the underlying data structure storing the
@@ -39,7 +65,10 @@ namespace seal
     @see PublicKey for the class that stores the public key.
     @see EvaluationKeys for the class that stores the evaluation keys.
     @see KeyGenerator for the class that generates the Galois keys.
+    @see GaloisKeyStore for the class that loads Galois keys from a file on demand.
     */
+    class GaloisKeyStore;
+
     class GaloisKeys
     {
     public:
@@ -48,6 +77,15 @@ namespace seal
         */
         GaloisKeys() = default;
 
+        /**
+        Creates a set of Galois keys that are loaded on demand from the given GaloisKeyStore.
+        The store is shared by all copies of the GaloisKeys instance.
+
+        @param[in] store The GaloisKeyStore to load the keys from
+        @throws std::invalid_argument if store is null
+        */
+        explicit GaloisKeys(const std::shared_ptr<GaloisKeyStore> &store);
+
         /**
         Creates a new GaloisKeys instance by copying a given instance.
 
@@ -79,14 +117,7 @@ namespace seal
         /**
         Returns the current number of Galois keys.
         */
-        inline int size() const
-        {
-            return std::accumulate(keys_.begin(), keys_.end(), 0,
-                [](int current_size, const std::vector<Ciphertext> &next_key)
-            {
-                return current_size + static_cast<int>(next_key.size() > 0);
-            });
-        }
+        int size() const;
 
         /*
         Returns the decomposition bit count.
@@ -97,7 +128,8 @@ namespace seal
         }
 
         /**
-        Returns a constant reference to the Galois keys data.
+        Returns a constant reference to the Galois keys data. The data is empty if the keys
+        are loaded from a GaloisKeyStore.
         */
         inline const std::vector<std::vector<Ciphertext> > &data() const
         {
@@ -110,9 +142,14 @@ namespace seal
 
         @param[in] galois_elt The Galois element
         @throw std::invalid_argument if the key corresponding to galois_elt does not exist
+        @throw std::logic_error if the keys are loaded from a GaloisKeyStore
         */
         inline const std::vector<Ciphertext> &key(std::uint64_t galois_elt) const
         {            
+            if (store_)
+            {
+                throw std::logic_error("keys are loaded from a store; use acquire_key");
+            }
             if (!has_key(galois_elt))
             {
                 throw std::invalid_argument("requested key does not exist");
@@ -127,15 +164,32 @@ namespace seal
         @param[in] galois_elt The Galois element
         @throw std::invalid_argument if Galois element is not valid
         */
-        inline bool has_key(std::uint64_t galois_elt) const
+        bool has_key(std::uint64_t galois_elt) const;
+
+        /**
+        Returns the Galois elements for which a Galois key exists, in increasing order.
+        */
+        std::vector<std::uint64_t> galois_elts() const;
+
+        /**
+        Returns a pointer to the Galois key corresponding to a given Galois element. If the
+        keys are loaded from a GaloisKeyStore, the key is loaded if it is not in memory, and
+        stays in memory at least as long as the returned pointer exists. Otherwise the pointer
+        does not own the key, which is valid only as long as the GaloisKeys instance is not
+        modified or destroyed.
+
+        @param[in] galois_elt The Galois element
+        @throw std::invalid_argument if the key corresponding to galois_elt does not exist
+        */
+        std::shared_ptr<const std::vector<Ciphertext> > acquire_key(std::uint64_t galois_elt) const;
+
+        /**
+        Returns the GaloisKeyStore that the keys are loaded from, or null if the keys are in
+        memory.
+        */
+        inline const std::shared_ptr<GaloisKeyStore> &store() const
         {
-            // Verify parameters
-            if (!(galois_elt & 1))
-            {
-                throw std::invalid_argument("galois element is not valid");
-            }
-            std::uint64_t index = (galois_elt - 1) >> 1;
-            return (index < keys_.size()) && !keys_[index].empty();
+            return store_;
         }
 
         /**
@@ -159,13 +213,26 @@ namespace seal
 
         /**
         Loads an GaloisKeys instance from an input stream overwriting the current
-        GaloisKeys instance.
+        GaloisKeys instance. The loaded keys are held in memory.
 
         @param[in] stream The stream to load the GaloisKeys instance from
         @see save() to save an GaloisKeys instance.
         */
         void load(std::istream &stream);
 
+        /**
+        Loads a GaloisKeys instance from an input stream overwriting the current GaloisKeys
+        instance. The polynomials that were saved in the form of a seed are generated in
+        parallel using the given thread pool.
+
+        @param[in] stream The stream to load the GaloisKeys instance from
+        @param[in] thread_pool The ThreadPoolHandle pointing to a thread pool, or an
+        uninitialized ThreadPoolHandle to load sequentially
+        @see save() to save a GaloisKeys instance.
+        @see ThreadPoolHandle for more details on thread pools.
+        */
+        void load(std::istream &stream, const ThreadPoolHandle &thread_pool);
+
         /**
         Enables access to private members of seal::GaloisKeys for .NET wrapper.
         */
@@ -206,8 +273,12 @@ namespace seal
 
         int decomposition_bit_count_ = 0;
 
+        std::shared_ptr<GaloisKeyStore> store_;
+
         friend class KeyGenerator;
 
         friend class Evaluator;
+
+        friend class MappedArchive;
     };
 }
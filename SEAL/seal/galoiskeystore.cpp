@@ -0,0 +1,442 @@
+#include <stdexcept>
+#include <fstream>
+#include <system_error>
+#include "seal/galoiskeystore.h"
+#include "seal/util/common.h"
+#include "seal/util/threadpool.h"
+
+using namespace std;
+using namespace seal::util;
+
+namespace seal
+{
+    namespace
+    {
+        // "SEALGKS" followed by a zero byte, read as a little-endian word
+        constexpr uint64_t store_magic = 0x00534B474C414553ULL;
+
+        constexpr uint64_t store_version = 1;
+
+        // Header: magic, version, hash block, decomposition bit count
+        constexpr uint64_t header_byte_count = (3 + sizeof(EncryptionParameters::hash_block_type) / bytes_per_uint64) * bytes_per_uint64;
+
+        // Trailer: entry count, index offset, magic
+        constexpr uint64_t trailer_byte_count = 3 * bytes_per_uint64;
+
+        // Each index entry is a Galois element and an offset
+        constexpr uint64_t index_entry_byte_count = 2 * bytes_per_uint64;
+
+        void write_uint64(ostream &stream, uint64_t value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(uint64_t));
+        }
+
+        uint64_t read_uint64(istream &stream)
+        {
+            uint64_t value = 0;
+            stream.read(reinterpret_cast<char*>(&value), sizeof(uint64_t));
+            return value;
+        }
+    }
+
+    void GaloisKeyStore::save(const GaloisKeys &galois_keys, ostream &stream)
+    {
+        streampos start = stream.tellp();
+        if (start == streampos(-1))
+        {
+            throw invalid_argument("stream does not report its position");
+        }
+
+        write_uint64(stream, store_magic);
+        write_uint64(stream, store_version);
+        for (uint64_t hash_word : galois_keys.hash_block())
+        {
+            write_uint64(stream, hash_word);
+        }
+        write_uint64(stream, static_cast<uint64_t>(galois_keys.decomposition_bit_count()));
+
+        // Write the keys in increasing order of Galois elements, and remember where each starts
+        vector<uint64_t> galois_elts = galois_keys.galois_elts();
+        vector<uint64_t> offsets;
+        for (uint64_t galois_elt : galois_elts)
+        {
+            offsets.push_back(static_cast<uint64_t>(stream.tellp() - start));
+            shared_ptr<const vector<Ciphertext> > key = galois_keys.acquire_key(galois_elt);
+            write_uint64(stream, static_cast<uint64_t>(key->size()));
+            for (const Ciphertext &key_component : *key)
+            {
+                key_component.save(stream);
+            }
+        }
+
+        uint64_t index_offset = static_cast<uint64_t>(stream.tellp() - start);
+        for (size_t i = 0; i < galois_elts.size(); i++)
+        {
+            write_uint64(stream, galois_elts[i]);
+            write_uint64(stream, offsets[i]);
+        }
+        write_uint64(stream, static_cast<uint64_t>(galois_elts.size()));
+        write_uint64(stream, index_offset);
+        write_uint64(stream, store_magic);
+    }
+
+    GaloisKeyStore::GaloisKeyStore(const string &path, size_t max_cache_byte_count) :
+        path_(path), max_cache_byte_count_(max_cache_byte_count)
+    {
+        ifstream stream(path_, ios::binary);
+        if (!stream)
+        {
+            throw runtime_error("failed to open key store");
+        }
+        stream.seekg(0, ios::end);
+        uint64_t byte_count = static_cast<uint64_t>(stream.tellg());
+        stream.seekg(0, ios::beg);
+        if (!stream || byte_count < header_byte_count + trailer_byte_count)
+        {
+            throw invalid_argument("file is not a valid key store");
+        }
+
+        // Validate the header
+        if (read_uint64(stream) != store_magic)
+        {
+            throw invalid_argument("file is not a valid key store");
+        }
+        if (read_uint64(stream) != store_version)
+        {
+            throw invalid_argument("unsupported key store version");
+        }
+        for (auto &hash_word : hash_block_)
+        {
+            hash_word = read_uint64(stream);
+        }
+        decomposition_bit_count_ = static_cast<int>(read_uint64(stream));
+
+        // Validate the trailer, and read the index
+        stream.seekg(static_cast<streamoff>(byte_count - trailer_byte_count), ios::beg);
+        uint64_t entry_count = read_uint64(stream);
+        index_offset_ = read_uint64(stream);
+        if (!stream || read_uint64(stream) != store_magic)
+        {
+            throw invalid_argument("file is not a valid key store");
+        }
+        if (index_offset_ < header_byte_count || index_offset_ > byte_count - trailer_byte_count ||
+            entry_count != (byte_count - trailer_byte_count - index_offset_) / index_entry_byte_count ||
+            (byte_count - trailer_byte_count - index_offset_) % index_entry_byte_count != 0)
+        {
+            throw invalid_argument("key store index is corrupt");
+        }
+        stream.seekg(static_cast<streamoff>(index_offset_), ios::beg);
+        for (uint64_t i = 0; i < entry_count; i++)
+        {
+            uint64_t galois_elt = read_uint64(stream);
+            uint64_t offset = read_uint64(stream);
+            if (!(galois_elt & 1) || offset < header_byte_count || offset >= index_offset_ ||
+                !index_.emplace(galois_elt, offset).second)
+            {
+                throw invalid_argument("key store index is corrupt");
+            }
+        }
+        if (!stream)
+        {
+            throw invalid_argument("key store index is corrupt");
+        }
+    }
+
+    GaloisKeyStore::~GaloisKeyStore()
+    {
+        // The prefetches use the cache, so they must complete before it is destroyed
+        {
+            lock_guard<mutex> lock(prefetch_mutex_);
+            prefetch_stop_ = true;
+        }
+        prefetch_cv_.notify_all();
+        if (prefetch_thread_.joinable())
+        {
+            prefetch_thread_.join();
+        }
+    }
+
+    bool GaloisKeyStore::has_key(uint64_t galois_elt) const
+    {
+        return index_.find(galois_elt) != index_.end();
+    }
+
+    vector<uint64_t> GaloisKeyStore::galois_elts() const
+    {
+        vector<uint64_t> result;
+        result.reserve(index_.size());
+        for (const auto &entry : index_)
+        {
+            result.push_back(entry.first);
+        }
+        return result;
+    }
+
+    shared_ptr<const vector<Ciphertext> > GaloisKeyStore::key(uint64_t galois_elt)
+    {
+        if (!has_key(galois_elt))
+        {
+            throw invalid_argument("requested key does not exist");
+        }
+        promise<key_pointer> key_promise;
+        bool added = false;
+        shared_future<key_pointer> key_future = find_or_add(galois_elt, key_promise, added);
+        if (added)
+        {
+            load(galois_elt, key_promise);
+        }
+        return key_future.get();
+    }
+
+    void GaloisKeyStore::prefetch(const vector<uint64_t> &galois_elts)
+    {
+        prefetch(galois_elts, ThreadPoolHandle());
+    }
+
+    void GaloisKeyStore::prefetch(const vector<uint64_t> &galois_elts,
+        const ThreadPoolHandle &thread_pool)
+    {
+        // Keys that do not fit in the cache together would evict each other before use
+        {
+            lock_guard<mutex> lock(mutex_);
+            if (max_cache_byte_count_ != 0)
+            {
+                size_t byte_count = 0;
+                for (uint64_t galois_elt : galois_elts)
+                {
+                    if (has_key(galois_elt) && cache_.find(galois_elt) == cache_.end())
+                    {
+                        byte_count += key_byte_count(galois_elt);
+                    }
+                }
+                if (byte_count > max_cache_byte_count_)
+                {
+                    return;
+                }
+            }
+        }
+
+        PrefetchBatch batch;
+        batch.thread_pool = thread_pool;
+        for (uint64_t galois_elt : galois_elts)
+        {
+            if (!has_key(galois_elt))
+            {
+                continue;
+            }
+            auto key_promise = make_shared<promise<key_pointer> >();
+            bool added = false;
+            find_or_add(galois_elt, *key_promise, added);
+            if (added)
+            {
+                batch.galois_elts.push_back(galois_elt);
+                batch.promises.push_back(move(key_promise));
+            }
+        }
+        if (batch.galois_elts.empty())
+        {
+            return;
+        }
+
+        unique_lock<mutex> lock(prefetch_mutex_);
+        if (!prefetch_thread_.joinable())
+        {
+            try
+            {
+                prefetch_thread_ = thread(&GaloisKeyStore::prefetch_loop, this);
+            }
+            catch (const system_error &)
+            {
+                // No thread could be started, so load the keys now instead
+                lock.unlock();
+                for (size_t i = 0; i < batch.galois_elts.size(); i++)
+                {
+                    load(batch.galois_elts[i], *batch.promises[i]);
+                }
+                return;
+            }
+        }
+        prefetch_queue_.push_back(move(batch));
+        lock.unlock();
+        prefetch_cv_.notify_one();
+    }
+
+    void GaloisKeyStore::prefetch_loop()
+    {
+        while (true)
+        {
+            PrefetchBatch batch;
+            {
+                unique_lock<mutex> lock(prefetch_mutex_);
+                prefetch_cv_.wait(lock, [this]() {
+                    return prefetch_stop_ || !prefetch_queue_.empty();
+                });
+
+                // Queued keys are still loaded when the store is destroyed, since their
+                // entries are already in the cache
+                if (prefetch_queue_.empty())
+                {
+                    return;
+                }
+                batch = move(prefetch_queue_.front());
+                prefetch_queue_.pop_front();
+            }
+
+            // load passes any error to the promise, so none escapes parallel_for
+            int key_count = static_cast<int>(batch.galois_elts.size());
+            if (batch.thread_pool && key_count > 1)
+            {
+                static_cast<ThreadPool&>(batch.thread_pool).parallel_for(key_count, [&](int index) {
+                    load(batch.galois_elts[index], *batch.promises[index]);
+                });
+                continue;
+            }
+            for (int i = 0; i < key_count; i++)
+            {
+                load(batch.galois_elts[i], *batch.promises[i]);
+            }
+        }
+    }
+
+    size_t GaloisKeyStore::max_cache_byte_count() const
+    {
+        lock_guard<mutex> lock(mutex_);
+        return max_cache_byte_count_;
+    }
+
+    void GaloisKeyStore::set_max_cache_byte_count(size_t max_cache_byte_count)
+    {
+        lock_guard<mutex> lock(mutex_);
+        max_cache_byte_count_ = max_cache_byte_count;
+        evict();
+    }
+
+    size_t GaloisKeyStore::cache_byte_count() const
+    {
+        lock_guard<mutex> lock(mutex_);
+        return cache_byte_count_;
+    }
+
+    int GaloisKeyStore::cached_key_count() const
+    {
+        lock_guard<mutex> lock(mutex_);
+        return static_cast<int>(cache_.size());
+    }
+
+    int GaloisKeyStore::load_count() const
+    {
+        lock_guard<mutex> lock(mutex_);
+        return load_count_;
+    }
+
+    shared_future<GaloisKeyStore::key_pointer> GaloisKeyStore::find_or_add(uint64_t galois_elt,
+        promise<key_pointer> &key_promise, bool &added)
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto entry = cache_.find(galois_elt);
+        if (entry != cache_.end())
+        {
+            // Mark the key as the most recently used
+            lru_.splice(lru_.begin(), lru_, entry->second.lru_position);
+            added = false;
+            return entry->second.key;
+        }
+
+        CacheEntry &new_entry = cache_[galois_elt];
+        new_entry.key = key_promise.get_future().share();
+        lru_.push_front(galois_elt);
+        new_entry.lru_position = lru_.begin();
+        added = true;
+        return new_entry.key;
+    }
+
+    void GaloisKeyStore::load(uint64_t galois_elt, promise<key_pointer> &key_promise)
+    {
+        try
+        {
+            ifstream stream(path_, ios::binary);
+            if (!stream)
+            {
+                throw runtime_error("failed to open key store");
+            }
+            stream.exceptions(ios::badbit | ios::failbit);
+            uint64_t offset = index_.at(galois_elt);
+            stream.seekg(static_cast<streamoff>(offset), ios::beg);
+
+            // Every component takes at least one byte
+            uint64_t component_count = read_uint64(stream);
+            if (component_count > index_offset_ - offset)
+            {
+                throw invalid_argument("key store is corrupt");
+            }
+            auto key = make_shared<vector<Ciphertext> >(static_cast<size_t>(component_count));
+            size_t byte_count = 0;
+            for (Ciphertext &key_component : *key)
+            {
+                key_component.load(stream);
+                byte_count += static_cast<size_t>(key_component.uint64_count()) * bytes_per_uint64;
+            }
+
+            {
+                lock_guard<mutex> lock(mutex_);
+                load_count_++;
+                loaded_key_byte_count_ = byte_count;
+                CacheEntry &entry = cache_.at(galois_elt);
+                entry.loaded = true;
+                entry.byte_count = byte_count;
+                cache_byte_count_ += byte_count;
+                evict();
+            }
+            key_promise.set_value(key);
+        }
+        catch (...)
+        {
+            // Drop the entry so that the next use of the key tries to load it again
+            {
+                lock_guard<mutex> lock(mutex_);
+                auto entry = cache_.find(galois_elt);
+                if (entry != cache_.end() && !entry->second.loaded)
+                {
+                    lru_.erase(entry->second.lru_position);
+                    cache_.erase(entry);
+                }
+            }
+            key_promise.set_exception(current_exception());
+        }
+    }
+
+    size_t GaloisKeyStore::key_byte_count(uint64_t galois_elt) const
+    {
+        if (loaded_key_byte_count_ != 0)
+        {
+            return loaded_key_byte_count_;
+        }
+
+        // The keys are written in increasing order of Galois elements
+        auto entry = index_.find(galois_elt);
+        auto next_entry = next(entry);
+        uint64_t end_offset = next_entry == index_.end() ? index_offset_ : next_entry->second;
+        return end_offset > entry->second ? static_cast<size_t>(end_offset - entry->second) : 0;
+    }
+
+    void GaloisKeyStore::evict()
+    {
+        if (max_cache_byte_count_ == 0)
+        {
+            return;
+        }
+        auto position = lru_.end();
+        while (cache_byte_count_ > max_cache_byte_count_ && position != lru_.begin())
+        {
+            --position;
+            auto entry = cache_.find(*position);
+            if (!entry->second.loaded)
+            {
+                continue;
+            }
+            cache_byte_count_ -= entry->second.byte_count;
+            cache_.erase(entry);
+            position = lru_.erase(position);
+        }
+    }
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <future>
+#include <string>
+#include <vector>
+#include "seal/ciphertext.h"
+#include "seal/encryptionparams.h"
+#include "seal/galoiskeys.h"
+#include "seal/threadpoolhandle.h"
+
+namespace seal
+{
+    /**
+    Keeps a set of Galois keys in an indexed file and loads each key only when it is first
+    used. A server holding the keys of many clients, or many rotation steps, can then keep
+    in memory only the keys that its requests actually use.
+
+    A GaloisKeyStore is used through a GaloisKeys instance created from it, which can be
+    passed to Evaluator like any other GaloisKeys. Every rotation first asks the store for
+    the keys it needs, and the store loads those that are not in memory from the file.
+
+    @par Caching
+    Loaded keys are kept in a cache with a limit on the memory they take. When the limit is
+    exceeded, the keys used least recently are dropped from the cache. Keys that are in use
+    by an ongoing operation stay in memory until the operation completes, so the limit may be
+    exceeded temporarily. A key that is larger than the limit on its own is still loaded, and
+    then dropped as soon as it is no longer used.
+
+    @par Prefetching
+    If the rotations an operation needs are known in advance, prefetch() starts loading the
+    keys in the background, so that they are likely in memory when the rotations start. A
+    single background thread of the store loads the prefetched keys one after another, or
+    spreads them over a thread pool if one is given. Keys that would not fit in the cache
+    together are not prefetched, since they would only evict each other.
+
+    @par File Format
+    The file is written by save(). It holds each key in the same format as GaloisKeys::save,
+    so keys generated from seeds take half the space, followed by an index of the Galois
+    elements.
+
+    @par Thread Safety
+    All functions of GaloisKeyStore are thread-safe, and the GaloisKeys created from it can
+    be used by several threads at the same time.
+
+    @see GaloisKeys for more information about Galois keys.
+    */
+    class GaloisKeyStore
+    {
+    public:
+        /**
+        Writes the given Galois keys to an output stream in the format that GaloisKeyStore
+        reads. The output stream must have the "binary" flag set, and should be empty, since
+        the file is read starting from the beginning.
+
+        @param[in] galois_keys The Galois keys to save
+        @param[in] stream The stream to save the keys to
+        */
+        static void save(const GaloisKeys &galois_keys, std::ostream &stream);
+
+        /**
+        Opens a file written by save() and reads its index. No keys are loaded yet.
+
+        @param[in] path The path of the file
+        @param[in] max_cache_byte_count The largest number of bytes that loaded keys take in
+        memory, or 0 for no limit
+        @throws std::runtime_error if the file cannot be opened
+        @throws std::invalid_argument if the file is not a valid key store
+        */
+        GaloisKeyStore(const std::string &path, std::size_t max_cache_byte_count = 0);
+
+        /**
+        Waits for all prefetches to complete and destroys the GaloisKeyStore.
+        */
+        ~GaloisKeyStore();
+
+        /**
+        Returns the number of keys in the store.
+        */
+        inline int size() const
+        {
+            return static_cast<int>(index_.size());
+        }
+
+        /**
+        Returns the decomposition bit count of the keys.
+        */
+        inline int decomposition_bit_count() const
+        {
+            return decomposition_bit_count_;
+        }
+
+        /**
+        Returns a constant reference to the hash block of the keys.
+
+        @see EncryptionParameters for more information about the hash block.
+        */
+        inline const EncryptionParameters::hash_block_type &hash_block() const
+        {
+            return hash_block_;
+        }
+
+        /**
+        Returns whether the store has a key for the given Galois element.
+
+        @param[in] galois_elt The Galois element
+        */
+        bool has_key(std::uint64_t galois_elt) const;
+
+        /**
+        Returns the Galois elements of the keys in the store, in increasing order.
+        */
+        std::vector<std::uint64_t> galois_elts() const;
+
+        /**
+        Returns the key for the given Galois element, loading it from the file if it is not
+        in memory. The key stays in memory at least as long as the returned pointer exists.
+
+        @param[in] galois_elt The Galois element
+        @throws std::invalid_argument if the store has no key for galois_elt
+        @throws std::runtime_error if the file cannot be read
+        */
+        std::shared_ptr<const std::vector<Ciphertext> > key(std::uint64_t galois_elt);
+
+        /**
+        Starts loading the keys for the given Galois elements in the background, unless
+        they are already in memory. Galois elements without a key are ignored. Nothing is
+        loaded if the keys not in memory take more bytes than the cache limit.
+
+        @param[in] galois_elts The Galois elements of the keys to load
+        */
+        void prefetch(const std::vector<std::uint64_t> &galois_elts);
+
+        /**
+        Starts loading the keys for the given Galois elements in the background, unless
+        they are already in memory, using the given thread pool to load several keys at
+        the same time. Galois elements without a key are ignored. Nothing is loaded if the
+        keys not in memory take more bytes than the cache limit.
+
+        @param[in] galois_elts The Galois elements of the keys to load
+        @param[in] thread_pool The ThreadPoolHandle pointing to a thread pool, or an
+        uninitialized ThreadPoolHandle to load one key at a time
+        @see ThreadPoolHandle for more details on thread pools.
+        */
+        void prefetch(const std::vector<std::uint64_t> &galois_elts,
+            const ThreadPoolHandle &thread_pool);
+
+        /**
+        Returns the largest number of bytes that loaded keys take in memory, or 0 if there is
+        no limit.
+        */
+        std::size_t max_cache_byte_count() const;
+
+        /**
+        Sets the largest number of bytes that loaded keys take in memory, dropping the keys
+        used least recently if needed.
+
+        @param[in] max_cache_byte_count The limit in bytes, or 0 for no limit
+        */
+        void set_max_cache_byte_count(std::size_t max_cache_byte_count);
+
+        /**
+        Returns the number of bytes that the keys in the cache take in memory.
+        */
+        std::size_t cache_byte_count() const;
+
+        /**
+        Returns the number of keys in the cache.
+        */
+        int cached_key_count() const;
+
+        /**
+        Returns the number of times a key has been loaded from the file.
+        */
+        int load_count() const;
+
+    private:
+        GaloisKeyStore(const GaloisKeyStore &copy) = delete;
+
+        GaloisKeyStore &operator =(const GaloisKeyStore &assign) = delete;
+
+        using key_pointer = std::shared_ptr<const std::vector<Ciphertext> >;
+
+        struct CacheEntry
+        {
+            std::shared_future<key_pointer> key;
+
+            // Keys that are still being loaded cannot be evicted
+            bool loaded = false;
+
+            std::size_t byte_count = 0;
+
+            std::list<std::uint64_t>::iterator lru_position;
+        };
+
+        // Keys queued by one call to prefetch
+        struct PrefetchBatch
+        {
+            std::vector<std::uint64_t> galois_elts;
+
+            std::vector<std::shared_ptr<std::promise<key_pointer> > > promises;
+
+            ThreadPoolHandle thread_pool;
+        };
+
+        // Returns the key for galois_elt from the cache. If it is not in the cache, adds an
+        // entry for it whose key comes from promise, and sets added so the caller loads it.
+        std::shared_future<key_pointer> find_or_add(std::uint64_t galois_elt,
+            std::promise<key_pointer> &promise, bool &added);
+
+        // Reads a key from the file and passes it, or the error reading it, to promise
+        void load(std::uint64_t galois_elt, std::promise<key_pointer> &promise);
+
+        // Drops the keys used least recently until the cache is within its limit; requires
+        // mutex_ to be locked
+        void evict();
+
+        // Returns the number of bytes the key for galois_elt takes in memory. All keys of a
+        // store have the same size, which is known once a key has been loaded; until then
+        // the size of the key in the file is used. Requires mutex_ to be locked.
+        std::size_t key_byte_count(std::uint64_t galois_elt) const;
+
+        // Loads the queued prefetch batches until the store is destroyed
+        void prefetch_loop();
+
+        std::string path_;
+
+        EncryptionParameters::hash_block_type hash_block_{ { 0 } };
+
+        int decomposition_bit_count_ = 0;
+
+        // The offset of each key in the file
+        std::map<std::uint64_t, std::uint64_t> index_;
+
+        // The keys end where the index starts
+        std::uint64_t index_offset_ = 0;
+
+        mutable std::mutex mutex_;
+
+        std::map<std::uint64_t, CacheEntry> cache_;
+
+        // Galois elements in the cache, the most recently used first
+        std::list<std::uint64_t> lru_;
+
+        std::size_t max_cache_byte_count_;
+
+        std::size_t cache_byte_count_ = 0;
+
+        int load_count_ = 0;
+
+        // The number of bytes a loaded key takes, or 0 if no key has been loaded yet
+        std::size_t loaded_key_byte_count_ = 0;
+
+        // The prefetch thread is started by the first prefetch
+        std::thread prefetch_thread_;
+
+        std::mutex prefetch_mutex_;
+
+        std::condition_variable prefetch_cv_;
+
+        std::deque<PrefetchBatch> prefetch_queue_;
+
+        bool prefetch_stop_ = false;
+    };
+}
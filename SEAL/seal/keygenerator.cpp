@@ -234,18 +234,18 @@ namespace seal
         {
             for (int l = 0; l < coeff_mod_count; l++)
             {
+                // generate NTT(a_i) for all i from a seed and store in evaluation_keys_[k][l].second[i]
+                uint64_t *key_data = evaluation_keys.mutable_data()[k][l].mutable_pointer();
+                evaluation_keys.mutable_data()[k][l].generate_seed(parms_.coeff_modulus(), random.get());
+
                 // populate evaluate_keys_[k]
                 for (int i = 0; i < decomposition_factors[l].size(); i++)
                 {
-                    // generate NTT(a_i) and store in evaluation_keys_[k][l].second[i]
-                    uint64_t *eval_keys_first = evaluation_keys.mutable_data()[k][l].mutable_pointer(2 * i);
-                    uint64_t *eval_keys_second = evaluation_keys.mutable_data()[k][l].mutable_pointer(2 * i + 1);
+                    uint64_t *eval_keys_first = key_data + (2 * i * coeff_count * coeff_mod_count);
+                    uint64_t *eval_keys_second = eval_keys_first + (coeff_count * coeff_mod_count);
 
-                    set_poly_coeffs_uniform(eval_keys_second, random.get());
                     for (int j = 0; j < coeff_mod_count; j++)
                     {
-                        ntt_negacyclic_harvey_lazy(eval_keys_second + (j * coeff_count), small_ntt_tables_[j]);
-
                         // calculate a_i*s and store in evaluation_keys_[k].first[i]
                         dyadic_product_coeffmod(eval_keys_second + (j * coeff_count), 
                             secret_key_.mutable_data().pointer() + (j * coeff_count), 
@@ -306,6 +306,7 @@ namespace seal
 
         // Clear the current keys
         galois_keys.mutable_data().clear();
+        galois_keys.store_.reset();
 
         // Extract encryption parameters.
         int coeff_count = parms_.poly_modulus().coeff_count();
@@ -368,18 +369,18 @@ namespace seal
 
             for (int l = 0; l < coeff_mod_count; l++)
             {
+                //generate NTT(a_i) for all i from a seed and store in evaluation_keys_[k][l].second[i]
+                uint64_t *key_data = galois_keys.mutable_data()[index][l].mutable_pointer();
+                galois_keys.mutable_data()[index][l].generate_seed(parms_.coeff_modulus(), random.get());
+
                 //populate evaluate_keys_[k]
                 for (int i = 0; i < decomposition_factors[l].size(); i++)
                 {
-                    //generate NTT(a_i) and store in evaluation_keys_[k][l].second[i]
-                    uint64_t *eval_keys_first = galois_keys.mutable_data()[index][l].mutable_pointer(2 * i);
-                    uint64_t *eval_keys_second = galois_keys.mutable_data()[index][l].mutable_pointer(2 * i + 1);
+                    uint64_t *eval_keys_first = key_data + (2 * i * coeff_count * coeff_mod_count);
+                    uint64_t *eval_keys_second = eval_keys_first + (coeff_count * coeff_mod_count);
 
-                    set_poly_coeffs_uniform(eval_keys_second, random.get());
                     for (int j = 0; j < coeff_mod_count; j++)
                     {
-                        // a_i in NTT form
-                        ntt_negacyclic_harvey(eval_keys_second + (j * coeff_count), small_ntt_tables_[j]);
                         // calculate a_i*s and store in evaluation_keys_[k].first[i]
                         dyadic_product_coeffmod(eval_keys_second + (j * coeff_count), secret_key_.data().pointer() + (j * coeff_count), 
                             coeff_count, parms_.coeff_modulus()[j], eval_keys_first + (j * coeff_count));
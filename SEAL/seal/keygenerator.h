@@ -10,6 +10,7 @@
 #include "seal/secretkey.h"
 #include "seal/evaluationkeys.h"
 #include "seal/galoiskeys.h"
+#include "seal/rotationplan.h"
 
 namespace seal
 {
@@ -108,6 +109,38 @@ namespace seal
         */        
         void generate_galois_keys(int decomposition_bit_count, GaloisKeys &galois_keys);
 
+        /**
+        Generates Galois keys for the given Galois elements. A Galois element is an odd 
+        number less than 2N, where N is the degree of the polynomial modulus. The element
+        3^k mod 2N rotates the rows of the batching matrix to the left by k steps, and the
+        element 2N-1 swaps the rows. Rotations for which no key is generated are composed of
+        the available ones by Evaluator::rotate_rows.
+
+        @param[in] decomposition_bit_count The decomposition bit count
+        @param[in] galois_elts The Galois elements to generate keys for
+        @param[out] galois_keys The Galois keys instance to overwrite with the generated keys
+        @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
+        @throws std::invalid_argument if any Galois element is not valid
+        @throws std::logic_error if the encryption parameters do not support batching
+        */
+        void generate_galois_keys(int decomposition_bit_count, 
+            const std::vector<std::uint64_t> &galois_elts, GaloisKeys &galois_keys);
+
+        /**
+        Generates the Galois keys chosen by a RotationPlan.
+
+        @param[in] decomposition_bit_count The decomposition bit count
+        @param[in] plan The plan of keys to generate
+        @param[out] galois_keys The Galois keys instance to overwrite with the generated keys
+        @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
+        @throws std::logic_error if the encryption parameters do not support batching
+        */
+        inline void generate_galois_keys(int decomposition_bit_count, const RotationPlan &plan,
+            GaloisKeys &galois_keys)
+        {
+            generate_galois_keys(decomposition_bit_count, plan.galois_elts(), galois_keys);
+        }
+
     private:
         KeyGenerator(const KeyGenerator &copy) = delete;
 
@@ -141,17 +174,6 @@ namespace seal
             return generated_;
         }
 
-        void generate_galois_keys(int decomposition_bit_count, 
-            const std::vector<std::uint64_t> &galois_elts, GaloisKeys &galois_keys);
-
-        inline GaloisKeys generate_galois_keys(int decomposition_bit_count, 
-            const std::vector<std::uint64_t> &galois_elts)
-        {
-            GaloisKeys keys;
-            generate_galois_keys(decomposition_bit_count, galois_elts, keys);
-            return keys;
-        }
-
         MemoryPoolHandle pool_;
 
         EncryptionParameters parms_;
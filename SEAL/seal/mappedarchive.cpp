@@ -0,0 +1,357 @@
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+#include "seal/mappedarchive.h"
+#include "seal/util/common.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace seal::util;
+
+namespace seal
+{
+    namespace
+    {
+        // "SEALMAP" followed by a zero byte, read as a little-endian word
+        constexpr uint64_t archive_magic = 0x0050414D4C414553ULL;
+
+        constexpr uint64_t archive_version = 1;
+
+        constexpr uint64_t ciphertext_kind = 1;
+
+        constexpr uint64_t evaluation_keys_kind = 2;
+
+        constexpr uint64_t galois_keys_kind = 3;
+
+        // Header: magic, version
+        constexpr uint64_t header_uint64_count = 2;
+
+        // Trailer: entry count, index offset, magic
+        constexpr uint64_t trailer_uint64_count = 3;
+    }
+
+    MappedArchiveWriter::MappedArchiveWriter(ostream &stream) : stream_(stream)
+    {
+        write_uint64(archive_magic);
+        write_uint64(archive_version);
+    }
+
+    void MappedArchiveWriter::write_uint64(uint64_t value)
+    {
+        stream_.write(reinterpret_cast<const char*>(&value), sizeof(uint64_t));
+        offset_++;
+    }
+
+    void MappedArchiveWriter::write_ciphertext(const Ciphertext &ciphertext)
+    {
+        // The data follows a header of a whole number of words, so it stays aligned
+        write_uint64(ciphertext_kind);
+        write_uint64(static_cast<uint64_t>(ciphertext.is_ntt_form()));
+        for (uint64_t hash_word : ciphertext.hash_block())
+        {
+            write_uint64(hash_word);
+        }
+        write_uint64(static_cast<uint64_t>(ciphertext.size()));
+        write_uint64(static_cast<uint64_t>(ciphertext.poly_coeff_count()));
+        write_uint64(static_cast<uint64_t>(ciphertext.coeff_mod_count()));
+        uint64_t uint64_count = static_cast<uint64_t>(ciphertext.uint64_count());
+        stream_.write(reinterpret_cast<const char*>(ciphertext.pointer()), uint64_count * bytes_per_uint64);
+        offset_ += uint64_count;
+    }
+
+    int MappedArchiveWriter::add(const Ciphertext &ciphertext)
+    {
+        if (finished_)
+        {
+            throw logic_error("archive is already finished");
+        }
+        entry_offsets_.push_back(offset_);
+        write_ciphertext(ciphertext);
+        return static_cast<int>(entry_offsets_.size()) - 1;
+    }
+
+    template<typename T>
+    int MappedArchiveWriter::add_keys(uint64_t kind, const T &keys)
+    {
+        if (finished_)
+        {
+            throw logic_error("archive is already finished");
+        }
+        entry_offsets_.push_back(offset_);
+        write_uint64(kind);
+        write_uint64(static_cast<uint64_t>(keys.decomposition_bit_count()));
+        for (uint64_t hash_word : keys.hash_block())
+        {
+            write_uint64(hash_word);
+        }
+        write_uint64(static_cast<uint64_t>(keys.data().size()));
+        for (const auto &key : keys.data())
+        {
+            write_uint64(static_cast<uint64_t>(key.size()));
+            for (const Ciphertext &key_component : key)
+            {
+                write_ciphertext(key_component);
+            }
+        }
+        return static_cast<int>(entry_offsets_.size()) - 1;
+    }
+
+    int MappedArchiveWriter::add(const EvaluationKeys &evaluation_keys)
+    {
+        return add_keys(evaluation_keys_kind, evaluation_keys);
+    }
+
+    int MappedArchiveWriter::add(const GaloisKeys &galois_keys)
+    {
+        if (galois_keys.store())
+        {
+            throw invalid_argument("galois_keys must be held in memory");
+        }
+        return add_keys(galois_keys_kind, galois_keys);
+    }
+
+    void MappedArchiveWriter::finish()
+    {
+        if (finished_)
+        {
+            throw logic_error("archive is already finished");
+        }
+        uint64_t index_offset = offset_;
+        for (uint64_t entry_offset : entry_offsets_)
+        {
+            write_uint64(entry_offset);
+        }
+        write_uint64(static_cast<uint64_t>(entry_offsets_.size()));
+        write_uint64(index_offset);
+        write_uint64(archive_magic);
+        finished_ = true;
+    }
+
+    MappedArchive::MappedArchive(const string &path)
+    {
+        uint64_t byte_count = 0;
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw runtime_error("failed to open archive");
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            throw runtime_error("failed to map archive");
+        }
+        byte_count = static_cast<uint64_t>(file_size.QuadPart);
+
+        // The view keeps the mapping alive after the handles are closed
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        if (view == nullptr)
+        {
+            throw runtime_error("failed to map archive");
+        }
+#else
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            throw runtime_error("failed to open archive");
+        }
+        struct stat file_stat;
+        if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0)
+        {
+            close(file);
+            throw runtime_error("failed to map archive");
+        }
+        byte_count = static_cast<uint64_t>(file_stat.st_size);
+
+        // The mapping stays valid after the file is closed
+        void *view = mmap(nullptr, byte_count, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        close(file);
+        if (view == MAP_FAILED)
+        {
+            throw runtime_error("failed to map archive");
+        }
+#endif
+        data_ = static_cast<uint64_t*>(view);
+        uint64_count_ = byte_count / bytes_per_uint64;
+
+        // Validate the header and the trailer, and read the index
+        try
+        {
+            if (byte_count % bytes_per_uint64 != 0 ||
+                uint64_count_ < header_uint64_count + trailer_uint64_count ||
+                data_[0] != archive_magic || data_[uint64_count_ - 1] != archive_magic)
+            {
+                throw invalid_argument("file is not a valid archive");
+            }
+            if (data_[1] != archive_version)
+            {
+                throw invalid_argument("unsupported archive version");
+            }
+            uint64_t entry_count = data_[uint64_count_ - 3];
+            index_offset_ = data_[uint64_count_ - 2];
+            if (index_offset_ < header_uint64_count ||
+                entry_count != uint64_count_ - trailer_uint64_count - index_offset_ ||
+                entry_count > static_cast<uint64_t>(numeric_limits<int>::max()))
+            {
+                throw invalid_argument("archive index is corrupt");
+            }
+            entry_offsets_.assign(data_ + index_offset_, data_ + index_offset_ + entry_count);
+            for (uint64_t entry_offset : entry_offsets_)
+            {
+                if (entry_offset < header_uint64_count || entry_offset >= index_offset_)
+                {
+                    throw invalid_argument("archive index is corrupt");
+                }
+            }
+        }
+        catch (...)
+        {
+#ifdef _WIN32
+            UnmapViewOfFile(data_);
+#else
+            munmap(data_, byte_count);
+#endif
+            throw;
+        }
+    }
+
+    MappedArchive::~MappedArchive()
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        munmap(data_, uint64_count_ * bytes_per_uint64);
+#endif
+    }
+
+    uint64_t MappedArchive::entry_offset(int index, uint64_t kind) const
+    {
+        if (index < 0 || index >= size())
+        {
+            throw out_of_range("index must be within [0, size)");
+        }
+        uint64_t offset = entry_offsets_[index];
+        if (data_[offset] != kind)
+        {
+            throw invalid_argument("archive object has a different type");
+        }
+        return offset;
+    }
+
+    uint64_t MappedArchive::read_uint64(uint64_t &offset) const
+    {
+        if (offset >= index_offset_)
+        {
+            throw invalid_argument("archive object is corrupt");
+        }
+        return data_[offset++];
+    }
+
+    void MappedArchive::alias_ciphertext(uint64_t &offset, Ciphertext &destination) const
+    {
+        if (read_uint64(offset) != ciphertext_kind)
+        {
+            throw invalid_argument("archive object is corrupt");
+        }
+        bool is_ntt_form = read_uint64(offset) != 0;
+        EncryptionParameters::hash_block_type hash_block;
+        for (auto &hash_word : hash_block)
+        {
+            hash_word = read_uint64(offset);
+        }
+        uint64_t size = read_uint64(offset);
+        uint64_t poly_coeff_count = read_uint64(offset);
+        uint64_t coeff_mod_count = read_uint64(offset);
+
+        // The data must lie before the index, and its size must fit in an int
+        uint64_t max_count = min(index_offset_ - offset, static_cast<uint64_t>(numeric_limits<int>::max()));
+        if (size < 2 || size > max_count || poly_coeff_count > max_count || coeff_mod_count > max_count ||
+            (poly_coeff_count && coeff_mod_count && size * poly_coeff_count > max_count / coeff_mod_count))
+        {
+            throw invalid_argument("archive object is corrupt");
+        }
+
+        destination.hash_block_ = hash_block;
+        destination.is_ntt_form_ = is_ntt_form;
+        destination.size_capacity_ = static_cast<int>(size);
+        destination.size_ = static_cast<int>(size);
+        destination.poly_coeff_count_ = static_cast<int>(poly_coeff_count);
+        destination.coeff_mod_count_ = static_cast<int>(coeff_mod_count);
+        destination.clear_seed();
+        destination.ciphertext_array_ = Pointer::Aliasing(data_ + offset);
+        offset += size * poly_coeff_count * coeff_mod_count;
+    }
+
+    void MappedArchive::load(int index, Ciphertext &destination) const
+    {
+        uint64_t offset = entry_offset(index, ciphertext_kind);
+        alias_ciphertext(offset, destination);
+    }
+
+    template<typename T>
+    void MappedArchive::load_keys(int index, uint64_t kind, T &destination) const
+    {
+        uint64_t offset = entry_offset(index, kind) + 1;
+        int decomposition_bit_count = static_cast<int>(read_uint64(offset));
+        EncryptionParameters::hash_block_type hash_block;
+        for (auto &hash_word : hash_block)
+        {
+            hash_word = read_uint64(offset);
+        }
+
+        // Every key takes at least one word
+        uint64_t key_count = read_uint64(offset);
+        if (key_count > index_offset_ - offset)
+        {
+            throw invalid_argument("archive object is corrupt");
+        }
+        vector<vector<Ciphertext> > keys(static_cast<size_t>(key_count));
+        for (auto &key : keys)
+        {
+            uint64_t component_count = read_uint64(offset);
+            if (component_count > index_offset_ - offset)
+            {
+                throw invalid_argument("archive object is corrupt");
+            }
+            key.resize(static_cast<size_t>(component_count));
+            for (Ciphertext &key_component : key)
+            {
+                alias_ciphertext(offset, key_component);
+            }
+        }
+
+        destination.keys_ = move(keys);
+        destination.hash_block_ = hash_block;
+        destination.decomposition_bit_count_ = decomposition_bit_count;
+    }
+
+    void MappedArchive::load(int index, EvaluationKeys &destination) const
+    {
+        load_keys(index, evaluation_keys_kind, destination);
+    }
+
+    void MappedArchive::load(int index, GaloisKeys &destination) const
+    {
+        load_keys(index, galois_keys_kind, destination);
+        destination.store_.reset();
+    }
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "seal/ciphertext.h"
+#include "seal/evaluationkeys.h"
+#include "seal/galoiskeys.h"
+
+namespace seal
+{
+    /**
+    Writes ciphertexts, evaluation keys, and Galois keys to an archive that MappedArchive can
+    map into memory. Unlike the output of the save functions, the archive stores the data of
+    every ciphertext and key exactly as it is laid out in memory, aligned to 8 bytes, so that
+    it can be used directly from the mapped file. Keys are therefore always written in full,
+    even if they were generated from seeds.
+
+    Each object added to the archive gets the next index, starting from 0. The archive is
+    complete only after finish() has been called, after which no more objects can be added.
+
+    @see MappedArchive for loading objects from an archive without copying them.
+    */
+    class MappedArchiveWriter
+    {
+    public:
+        /**
+        Creates a MappedArchiveWriter that writes an archive to the given output stream. The
+        output stream must have the "binary" flag set, and should be empty, since the archive
+        is read starting from the beginning of the file.
+
+        @param[in] stream The stream to write the archive to
+        */
+        explicit MappedArchiveWriter(std::ostream &stream);
+
+        /**
+        Adds a ciphertext to the archive and returns its index.
+
+        @param[in] ciphertext The ciphertext to add
+        @throws std::logic_error if finish() has already been called
+        */
+        int add(const Ciphertext &ciphertext);
+
+        /**
+        Adds a set of evaluation keys to the archive and returns its index.
+
+        @param[in] evaluation_keys The evaluation keys to add
+        @throws std::logic_error if finish() has already been called
+        */
+        int add(const EvaluationKeys &evaluation_keys);
+
+        /**
+        Adds a set of Galois keys to the archive and returns its index.
+
+        @param[in] galois_keys The Galois keys to add
+        @throws std::invalid_argument if galois_keys are loaded from a GaloisKeyStore
+        @throws std::logic_error if finish() has already been called
+        */
+        int add(const GaloisKeys &galois_keys);
+
+        /**
+        Writes the index of the archive, completing it.
+
+        @throws std::logic_error if finish() has already been called
+        */
+        void finish();
+
+    private:
+        MappedArchiveWriter(const MappedArchiveWriter &copy) = delete;
+
+        MappedArchiveWriter &operator =(const MappedArchiveWriter &assign) = delete;
+
+        void write_uint64(std::uint64_t value);
+
+        void write_ciphertext(const Ciphertext &ciphertext);
+
+        template<typename T>
+        int add_keys(std::uint64_t kind, const T &keys);
+
+        std::ostream &stream_;
+
+        // The number of uint64 words written so far
+        std::uint64_t offset_ = 0;
+
+        std::vector<std::uint64_t> entry_offsets_;
+
+        bool finished_ = false;
+    };
+
+    /**
+    Maps an archive written by MappedArchiveWriter into memory and loads the objects in it
+    without copying their data. A loaded ciphertext is an aliased ciphertext pointing into
+    the mapped file, and the components of loaded keys are aliased in the same way. The
+    operating system reads the pages of the file only when they are first accessed, so
+    opening even a very large archive is nearly instant.
+
+    @par Sharing and Modification
+    The file is mapped copy-on-write. Processes that map the same archive share the physical
+    memory holding it, and each page is copied only for a process that modifies it. The
+    file itself is never modified. Aliased ciphertexts can be used as inputs to homomorphic
+    operations like any other ciphertext; operations that need to enlarge them fail, so use
+    Ciphertext::unalias() to move a ciphertext into a memory pool first if needed.
+
+    @par Lifetime
+    The loaded ciphertexts and keys point into the mapping, so the MappedArchive must stay
+    alive as long as any of them are in use.
+
+    @par Thread Safety
+    Loading from a MappedArchive is thread-safe.
+
+    @see MappedArchiveWriter for writing an archive.
+    */
+    class MappedArchive
+    {
+    public:
+        /**
+        Maps the archive in the given file into memory and reads its index.
+
+        @param[in] path The path of the archive file
+        @throws std::runtime_error if the file cannot be opened or mapped
+        @throws std::invalid_argument if the file is not a valid archive
+        */
+        explicit MappedArchive(const std::string &path);
+
+        /**
+        Unmaps the archive.
+        */
+        ~MappedArchive();
+
+        /**
+        Returns the number of objects in the archive.
+        */
+        inline int size() const
+        {
+            return static_cast<int>(entry_offsets_.size());
+        }
+
+        /**
+        Loads a ciphertext from the archive. The ciphertext becomes an aliased ciphertext
+        pointing into the mapped file.
+
+        @param[in] index The index of the ciphertext in the archive
+        @param[out] destination The ciphertext to overwrite with the loaded ciphertext
+        @throws std::out_of_range if index is not within [0, size())
+        @throws std::invalid_argument if the object at index is not a ciphertext, or is
+        corrupt
+        */
+        void load(int index, Ciphertext &destination) const;
+
+        /**
+        Loads a set of evaluation keys from the archive. Each component of the keys is an
+        aliased ciphertext pointing into the mapped file.
+
+        @param[in] index The index of the evaluation keys in the archive
+        @param[out] destination The EvaluationKeys to overwrite with the loaded keys
+        @throws std::out_of_range if index is not within [0, size())
+        @throws std::invalid_argument if the object at index is not a set of evaluation
+        keys, or is corrupt
+        */
+        void load(int index, EvaluationKeys &destination) const;
+
+        /**
+        Loads a set of Galois keys from the archive. Each component of the keys is an
+        aliased ciphertext pointing into the mapped file.
+
+        @param[in] index The index of the Galois keys in the archive
+        @param[out] destination The GaloisKeys to overwrite with the loaded keys
+        @throws std::out_of_range if index is not within [0, size())
+        @throws std::invalid_argument if the object at index is not a set of Galois keys,
+        or is corrupt
+        */
+        void load(int index, GaloisKeys &destination) const;
+
+    private:
+        MappedArchive(const MappedArchive &copy) = delete;
+
+        MappedArchive &operator =(const MappedArchive &assign) = delete;
+
+        // Returns the offset of the object at index after checking that it has the given kind
+        std::uint64_t entry_offset(int index, std::uint64_t kind) const;
+
+        // Reads the word at offset, which is advanced past it
+        std::uint64_t read_uint64(std::uint64_t &offset) const;
+
+        // Aliases destination to the ciphertext at offset, which is advanced past it
+        void alias_ciphertext(std::uint64_t &offset, Ciphertext &destination) const;
+
+        template<typename T>
+        void load_keys(int index, std::uint64_t kind, T &destination) const;
+
+        std::uint64_t *data_ = nullptr;
+
+        std::uint64_t uint64_count_ = 0;
+
+        // The objects end where the index starts
+        std::uint64_t index_offset_ = 0;
+
+        std::vector<std::uint64_t> entry_offsets_;
+    };
+}
@@ -3,11 +3,14 @@
 #include <memory>
 #include <stdexcept>
 #include <utility>
+#include <chrono>
 #include "seal/util/mempool.h"
 #include "seal/util/globals.h"
 
 namespace seal
 {
+    class EvaluatorWorkspace;
+
     /**
     Manages a shared pointer to a memory pool. SEAL uses memory pools for 
     improved performance due to the large number of memory allocations needed
@@ -203,6 +206,80 @@ namespace seal
             return pool_->alloc_byte_count();
         }
 
+        /**
+        Releases unused memory back to the system. This function frees every internal
+        allocation of the memory pool pointed to by the current MemoryPoolHandle whose
+        memory has been entirely returned to the pool, and returns the number of bytes 
+        released. For a thread-safe memory pool, the memory that threads keep cached for 
+        fast reuse is first returned to the pool, including that of idle threads.
+
+        @throws std::logic_error if the MemoryPoolHandle is uninitialized
+        */
+        inline std::uint64_t trim() const
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            return pool_->trim();
+        }
+
+        /**
+        Sets an upper bound on the memory (in bytes) held by the memory pool pointed to
+        by the current MemoryPoolHandle. When an allocation would exceed the cap, the 
+        memory pool first releases unused memory as in trim(), and if that does not make
+        enough room, the allocation throws std::bad_alloc. A cap of zero (the default) 
+        means no limit. Lowering the cap below the current usage does not release any
+        memory by itself.
+
+        @param[in] byte_cap The maximum number of bytes the memory pool may allocate
+        @throws std::logic_error if the MemoryPoolHandle is uninitialized
+        */
+        inline void set_byte_cap(std::uint64_t byte_cap) const
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            pool_->set_byte_cap(byte_cap);
+        }
+
+        /**
+        Returns the byte cap of the memory pool pointed to by the current 
+        MemoryPoolHandle, or zero if there is none.
+
+        @throws std::logic_error if the MemoryPoolHandle is uninitialized
+        */
+        inline std::uint64_t byte_cap() const
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            return pool_->byte_cap();
+        }
+
+        /**
+        Enables releasing unused memory automatically. Once per the given interval the
+        memory pool pointed to by the current MemoryPoolHandle releases its unused memory
+        as in trim(). A thread-safe memory pool does this on a background thread, so that
+        memory is released also when the process goes idle. A memory pool that is not
+        thread-safe cannot be touched by another thread; it releases its unused memory 
+        when memory is returned to it and the interval has passed since the previous 
+        release. An interval of zero (the default) disables automatic release.
+
+        @param[in] interval The time between automatic releases
+        @throws std::logic_error if the MemoryPoolHandle is uninitialized
+        */
+        inline void set_idle_release(std::chrono::milliseconds interval) const
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            pool_->set_idle_release(interval);
+        }
+
         /**
         Returns whether the MemoryPoolHandle is initialized.
         */
@@ -231,6 +308,8 @@ namespace seal
         }
 
     private:
+        friend class EvaluatorWorkspace;
+
         MemoryPoolHandle(std::shared_ptr<util::MemoryPool> pool) noexcept : 
             pool_(std::move(pool))
         {
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <stdexcept>
+#include "seal/plainmatrix.h"
+#include "seal/polycrt.h"
+#include "seal/evaluator.h"
+
+using namespace std;
+
+namespace seal
+{
+    PlainMatrix::PlainMatrix(const SEALContext &context, const vector<vector<uint64_t> > &matrix,
+        int baby_step_count, const MemoryPoolHandle &pool) :
+        dimension_(static_cast<int>(matrix.size())), baby_step_count_(baby_step_count),
+        hash_block_(context.parms().hash_block())
+    {
+        // Verify parameters.
+        if (!context.qualifiers().enable_batching)
+        {
+            throw invalid_argument("encryption parameters are not valid for batching");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+        int row_size = (context.poly_modulus().coeff_count() - 1) / 2;
+        if (dimension_ == 0 || row_size % dimension_ != 0)
+        {
+            throw invalid_argument("matrix dimension must divide the row size");
+        }
+        uint64_t plain_modulus = context.plain_modulus().value();
+        bool is_zero = true;
+        for (const vector<uint64_t> &row : matrix)
+        {
+            if (row.size() != matrix.size())
+            {
+                throw invalid_argument("matrix must be square");
+            }
+            for (uint64_t value : row)
+            {
+                if (value >= plain_modulus)
+                {
+                    throw invalid_argument("matrix entry is larger than plain_modulus");
+                }
+                is_zero = is_zero && value == 0;
+            }
+        }
+        if (is_zero)
+        {
+            throw invalid_argument("matrix cannot be zero");
+        }
+        if (baby_step_count < 0 || baby_step_count > dimension_)
+        {
+            throw invalid_argument("baby_step_count is out of range");
+        }
+        if (baby_step_count == 0)
+        {
+            while (baby_step_count_ * baby_step_count_ < dimension_)
+            {
+                baby_step_count_++;
+            }
+        }
+        int giant_step_count = (dimension_ + baby_step_count_ - 1) / baby_step_count_;
+
+        PolyCRTBuilder crtbuilder(context, pool);
+        Evaluator evaluator(context, pool);
+
+        // Diagonal g * n1 + b is rotated right by g * n1 steps, i.e. its slot i holds
+        // M[i - g * n1][i + b], and repeated in both rows with period equal to the dimension
+        vector<bool> baby_step_used(baby_step_count_, false);
+        vector<bool> giant_step_used(giant_step_count, false);
+        vector<uint64_t> slots(context.poly_modulus().coeff_count() - 1);
+        diagonals_.resize(giant_step_count);
+        for (int g = 0; g < giant_step_count; g++)
+        {
+            diagonals_[g].resize(baby_step_count_, Plaintext(pool));
+            for (int b = 0; b < baby_step_count_ && g * baby_step_count_ + b < dimension_; b++)
+            {
+                bool diagonal_is_zero = true;
+                for (int i = 0; i < dimension_; i++)
+                {
+                    int row = (i - g * baby_step_count_ + dimension_) % dimension_;
+                    slots[i] = matrix[row][(i + b) % dimension_];
+                    diagonal_is_zero = diagonal_is_zero && slots[i] == 0;
+                }
+                if (diagonal_is_zero)
+                {
+                    continue;
+                }
+                for (size_t i = dimension_; i < slots.size(); i++)
+                {
+                    slots[i] = slots[i - dimension_];
+                }
+                crtbuilder.compose(slots, diagonals_[g][b]);
+                evaluator.transform_to_ntt(diagonals_[g][b]);
+                baby_step_used[b] = true;
+                giant_step_used[g] = true;
+            }
+        }
+
+        for (int b = 1; b < baby_step_count_; b++)
+        {
+            if (baby_step_used[b])
+            {
+                rotation_steps_.push_back(b);
+            }
+        }
+        for (int g = 1; g < giant_step_count; g++)
+        {
+            if (giant_step_used[g])
+            {
+                rotation_steps_.push_back(g * baby_step_count_);
+            }
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "seal/context.h"
+#include "seal/encryptionparams.h"
+#include "seal/memorypoolhandle.h"
+#include "seal/plaintext.h"
+
+namespace seal
+{
+    /**
+    Stores a square matrix of integers modulo the plaintext modulus in a form that allows
+    Evaluator::multiply_plain_matrix to multiply it with an encrypted vector of batching slots.
+    Encoding the matrix is relatively expensive, so a PlainMatrix should be created once and
+    reused for any number of ciphertexts.
+
+    @par Diagonal Method
+    The matrix is stored by its generalized diagonals: the k-th diagonal holds the entries
+    M[i][(i + k) mod d], where d is the dimension of the matrix. The product of the matrix with
+    a vector x is then the sum over k of the k-th diagonal multiplied slot-wise with x rotated
+    to the left by k steps. Diagonals that are entirely zero are skipped, so sparse and banded
+    matrices need fewer operations.
+
+    @par Baby-Step Giant-Step
+    To reduce the number of rotations from d - 1 to roughly 2 * sqrt(d), the diagonal index is
+    split as k = g * n1 + b, where n1 is the number of baby steps. The rotations of x by the
+    baby steps b = 1, ..., n1 - 1 are computed once with hoisted rotations, and each of the
+    giant step partial sums is rotated once by g * n1. For this to work the diagonals are
+    stored pre-rotated to the right by g * n1 steps, and already transformed to NTT form.
+
+    @par Slot Layout
+    The dimension must divide N/2, the length of a row of the batching matrix, where N is the
+    degree of the polynomial modulus. The encrypted vector must be repeated with period d
+    across each row. The result then has the same layout. The two rows are multiplied with the
+    matrix independently, so two vectors can be processed at the same time.
+
+    @see Evaluator::multiply_plain_matrix for multiplying a PlainMatrix with a ciphertext.
+    @see PolyCRTBuilder for more information about batching.
+    */
+    class PlainMatrix
+    {
+    public:
+        /**
+        Creates a PlainMatrix from a given square matrix. The number of baby steps defaults to
+        the square root of the dimension, rounded up, which minimizes the number of rotations.
+
+        @param[in] context The SEALContext
+        @param[in] matrix The rows of the matrix
+        @param[in] baby_step_count The number of baby steps, or 0 for the default
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if the encryption parameters are not valid for batching
+        @throws std::invalid_argument if matrix is not square
+        @throws std::invalid_argument if the dimension of matrix does not divide N/2
+        @throws std::invalid_argument if matrix has entries larger than or equal to the
+        plaintext modulus
+        @throws std::invalid_argument if matrix is zero
+        @throws std::invalid_argument if baby_step_count is negative or larger than the
+        dimension of matrix
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        PlainMatrix(const SEALContext &context,
+            const std::vector<std::vector<std::uint64_t> > &matrix, int baby_step_count = 0,
+            const MemoryPoolHandle &pool = MemoryPoolHandle::Global());
+
+        /**
+        Returns the dimension of the matrix.
+        */
+        inline int dimension() const
+        {
+            return dimension_;
+        }
+
+        /**
+        Returns the number of baby steps.
+        */
+        inline int baby_step_count() const
+        {
+            return baby_step_count_;
+        }
+
+        /**
+        Returns the number of giant steps.
+        */
+        inline int giant_step_count() const
+        {
+            return static_cast<int>(diagonals_.size());
+        }
+
+        /**
+        Returns the encoded diagonals. The entry [g][b] holds the diagonal g * n1 + b in NTT
+        form, rotated to the right by g * n1 steps. Zero diagonals, and those past the
+        dimension, are empty plaintexts.
+        */
+        inline const std::vector<std::vector<Plaintext> > &diagonals() const
+        {
+            return diagonals_;
+        }
+
+        /**
+        Returns the row rotation steps that Evaluator::multiply_plain_matrix performs. Each of
+        them is done with a single key switch if the Galois keys contain a key for it.
+        */
+        inline const std::vector<int> &rotation_steps() const
+        {
+            return rotation_steps_;
+        }
+
+        /**
+        Returns the hash block of the encryption parameters the matrix was encoded for.
+        */
+        inline const EncryptionParameters::hash_block_type &hash_block() const
+        {
+            return hash_block_;
+        }
+
+    private:
+        int dimension_;
+
+        int baby_step_count_;
+
+        std::vector<std::vector<Plaintext> > diagonals_;
+
+        std::vector<int> rotation_steps_;
+
+        EncryptionParameters::hash_block_type hash_block_;
+    };
+}
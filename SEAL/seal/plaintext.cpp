@@ -2,8 +2,11 @@
 #include "seal/util/common.h"
 #include "seal/util/uintcore.h"
 #include "seal/util/uintarith.h"
+#include "seal/util/bitpack.h"
 #include <stdexcept>
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 using namespace std;
 using namespace seal::util;
@@ -12,6 +15,12 @@ namespace seal
 {
     namespace
     {
+        // Written in place of the coefficient count to mark the packed format, which is
+        // followed by its version
+        constexpr int32_t packed_format_marker = -1;
+
+        constexpr uint8_t packed_format_version = 1;
+
         bool is_dec_char(char c)
         {
             return c >= '0' && c <= '9';
@@ -345,6 +354,28 @@ namespace seal
         stream.write(reinterpret_cast<const char*>(plaintext_poly_.get()), coeff_count_ * bytes_per_uint64);
     }
 
+    void Plaintext::save_packed(ostream &stream) const
+    {
+        stream.write(reinterpret_cast<const char*>(&packed_format_marker), sizeof(int32_t));
+        stream.write(reinterpret_cast<const char*>(&packed_format_version), sizeof(uint8_t));
+        int32_t coeff_count32 = static_cast<int32_t>(coeff_count_);
+        stream.write(reinterpret_cast<const char*>(&coeff_count32), sizeof(int32_t));
+
+        // All coefficients are stored with the bit count of the largest one, which is at most
+        // the bit count of the plaintext modulus
+        uint64_t coeff_or = 0;
+        for (int i = 0; i < coeff_count_; i++)
+        {
+            coeff_or |= plaintext_poly_[i];
+        }
+        uint8_t bit_count8 = static_cast<uint8_t>(get_significant_bit_count(coeff_or));
+        stream.write(reinterpret_cast<const char*>(&bit_count8), sizeof(uint8_t));
+
+        vector<uint64_t> packed(get_packed_uint64_count(coeff_count_, bit_count8));
+        pack_uint64(plaintext_poly_.get(), coeff_count_, bit_count8, packed.data());
+        stream.write(reinterpret_cast<const char*>(packed.data()), get_packed_byte_count(coeff_count_, bit_count8));
+    }
+
     void Plaintext::python_save(std::string &path) const
     {
         std::ofstream out(path);
@@ -356,6 +387,31 @@ namespace seal
     {
         int32_t read_coeff_count = 0;
         stream.read(reinterpret_cast<char*>(&read_coeff_count), sizeof(int32_t));
+        if (read_coeff_count == packed_format_marker)
+        {
+            uint8_t read_version8 = 0;
+            stream.read(reinterpret_cast<char*>(&read_version8), sizeof(uint8_t));
+            if (read_version8 != packed_format_version)
+            {
+                throw invalid_argument("unsupported packed plaintext version");
+            }
+            stream.read(reinterpret_cast<char*>(&read_coeff_count), sizeof(int32_t));
+            uint8_t read_bit_count8 = 0;
+            stream.read(reinterpret_cast<char*>(&read_bit_count8), sizeof(uint8_t));
+            if (read_bit_count8 > bits_per_uint64)
+            {
+                throw invalid_argument("packed plaintext has invalid bit count");
+            }
+
+            // Set new size
+            resize(read_coeff_count);
+
+            // Read data; the last word may be read only partially
+            vector<uint64_t> packed(get_packed_uint64_count(read_coeff_count, read_bit_count8), 0);
+            stream.read(reinterpret_cast<char*>(packed.data()), get_packed_byte_count(read_coeff_count, read_bit_count8));
+            unpack_uint64(packed.data(), read_coeff_count, read_bit_count8, plaintext_poly_.get());
+            return;
+        }
 
         // Set new size
         resize(read_coeff_count);
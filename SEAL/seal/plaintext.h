@@ -688,13 +688,28 @@ namespace seal
         @see load() to load a saved plaintext.
         */
         void save(std::ostream &stream) const;
+
+        /**
+        Saves the Plaintext to an output stream in a packed format. All coefficients are stored
+        using only as many bits as the largest of them needs, which is at most the bit count of
+        the plaintext modulus, instead of 64 bits each. The output is in binary format and not
+        human-readable. The output stream must have the "binary" flag set. The packed format
+        carries a version number, and load() accepts both formats.
+
+        @param[in] stream The stream to save the plaintext to
+        @see load() to load a saved plaintext.
+        */
+        void save_packed(std::ostream &stream) const;
         void python_save(std::string &path) const;
 
         /**
-        Loads a Plaintext from an input stream overwriting the current plaintext.
+        Loads a Plaintext from an input stream overwriting the current plaintext. The plaintext
+        can be saved either with save() or with save_packed().
 
         @param[in] stream The stream to load the plaintext from
+        @throws std::invalid_argument if the plaintext was saved in a newer packed format
         @see save() to save a plaintext.
+        @see save_packed() to save a plaintext in a packed format.
         */
         void load(std::istream &stream);
         void python_load(std::string &path);
@@ -116,28 +116,54 @@ namespace seal
         {
             throw logic_error("values_matrix size is too large");
         }
+        compose(values_matrix.data(), static_cast<int>(values_matrix.size()), destination);
+    }
+
+    void PolyCRTBuilder::compose(const vector<int64_t> &values_matrix, Plaintext &destination)
+    {
+        // Validate input parameters
+        if (values_matrix.size() > slots_)
+        {
+            throw logic_error("values_matrix size is too large");
+        }
+        compose(values_matrix.data(), static_cast<int>(values_matrix.size()), destination);
+    }
+
+    void PolyCRTBuilder::compose(const uint64_t *values_matrix, int count, Plaintext &destination)
+    {
+        // Validate input parameters
+        if (count < 0)
+        {
+            throw invalid_argument("count cannot be negative");
+        }
+        if (values_matrix == nullptr && count > 0)
+        {
+            throw invalid_argument("values_matrix cannot be null");
+        }
+        if (count > slots_)
+        {
+            throw logic_error("values_matrix size is too large");
+        }
 #ifdef SEAL_DEBUG
-        for (auto v : values_matrix)
+        for (int i = 0; i < count; i++)
         {
             // Validate the i-th input
-            if (v >= mod_.value())
+            if (values_matrix[i] >= mod_.value())
             {
                 throw invalid_argument("input value is larger than plain_modulus");
             }
         }
 #endif
-        int input_matrix_size = values_matrix.size();
-
         // Set destination to full size
         destination.resize(slots_);
 
         // First write the values to destination coefficients. Read 
         // in top row, then bottom row.
-        for (int i = 0; i < input_matrix_size; i++)
+        for (int i = 0; i < count; i++)
         {
             *(destination.pointer() + matrix_reps_index_map_[i]) = values_matrix[i];
         }        
-        for (int i = input_matrix_size; i < slots_; i++)
+        for (int i = count; i < slots_; i++)
         {
             *(destination.pointer() + matrix_reps_index_map_[i]) = 0;
         }
@@ -147,38 +173,44 @@ namespace seal
         inverse_ntt_negacyclic_harvey(destination.pointer(), ntt_tables_);
     }
 
-    void PolyCRTBuilder::compose(const vector<int64_t> &values_matrix, Plaintext &destination)
+    void PolyCRTBuilder::compose(const int64_t *values_matrix, int count, Plaintext &destination)
     {
         // Validate input parameters
-        if (values_matrix.size() > slots_)
+        if (count < 0)
+        {
+            throw invalid_argument("count cannot be negative");
+        }
+        if (values_matrix == nullptr && count > 0)
+        {
+            throw invalid_argument("values_matrix cannot be null");
+        }
+        if (count > slots_)
         {
             throw logic_error("values_matrix size is too large");
         }
 
         uint64_t plain_modulus_div_two = mod_.value() >> 1;
 #ifdef SEAL_DEBUG
-        for (auto v : values_matrix)
+        for (int i = 0; i < count; i++)
         {
             // Validate the i-th input
-            if (abs(v) > plain_modulus_div_two)
+            if (abs(values_matrix[i]) > plain_modulus_div_two)
             {
                 throw invalid_argument("input value is larger than plain_modulus");
             }
         }
 #endif
-        int input_matrix_size = values_matrix.size();
-
         // Set destination to full size
         destination.resize(slots_);
 
         // First write the values to destination coefficients. Read 
         // in top row, then bottom row.
-        for (int i = 0; i < input_matrix_size; i++)
+        for (int i = 0; i < count; i++)
         {
             *(destination.pointer() + matrix_reps_index_map_[i]) = (values_matrix[i] < 0) ? 
                 (mod_.value() + values_matrix[i]) : values_matrix[i];
         }
-        for (int i = input_matrix_size; i < slots_; i++)
+        for (int i = count; i < slots_; i++)
         {
             *(destination.pointer() + matrix_reps_index_map_[i]) = 0;
         }
@@ -237,6 +269,22 @@ namespace seal
 
     void PolyCRTBuilder::decompose(const Plaintext &plain, vector<uint64_t> &destination,
         const MemoryPoolHandle &pool) 
+    {
+        // Set destination size
+        destination.resize(slots_);
+        decompose(plain, destination.data(), pool);
+    }
+
+    void PolyCRTBuilder::decompose(const Plaintext &plain, vector<int64_t> &destination,
+        const MemoryPoolHandle &pool)
+    {
+        // Set destination size
+        destination.resize(slots_);
+        decompose(plain, destination.data(), pool);
+    }
+
+    void PolyCRTBuilder::decompose(const Plaintext &plain, uint64_t *destination,
+        const MemoryPoolHandle &pool) 
     {
         int coeff_count = parms_.poly_modulus().coeff_count();
 
@@ -253,14 +301,15 @@ namespace seal
             throw invalid_argument("plain is not valid for encryption parameters");
         }
 #endif
+        if (destination == nullptr)
+        {
+            throw invalid_argument("destination cannot be null");
+        }
         if (!pool)
         {
             throw invalid_argument("pool is uninitialized");
         }
 
-        // Set destination size
-        destination.resize(slots_);
-
         // Never include the leading zero coefficient (if present)
         int plain_coeff_count = min(plain.coeff_count(), slots_);
 
@@ -280,51 +329,20 @@ namespace seal
         }
     }
 
-    void PolyCRTBuilder::decompose(const Plaintext &plain, vector<int64_t> &destination,
+    void PolyCRTBuilder::decompose(const Plaintext &plain, int64_t *destination,
         const MemoryPoolHandle &pool)
     {
-        int coeff_count = parms_.poly_modulus().coeff_count();
-
-        // Validate input parameters
-        if (plain.coeff_count() > coeff_count || 
-            (plain.coeff_count() == coeff_count && plain[coeff_count - 1] != 0))
-        {
-            throw invalid_argument("plain is not valid for encryption parameters");
-        }
-#ifdef SEAL_DEBUG
-        if (plain.significant_coeff_count() >= coeff_count || !are_poly_coefficients_less_than(plain.pointer(),
-            plain.coeff_count(), 1, parms_.plain_modulus().pointer(), parms_.plain_modulus().uint64_count()))
-        {
-            throw invalid_argument("plain is not valid for encryption parameters");
-        }
-#endif
-        if (!pool)
-        {
-            throw invalid_argument("pool is uninitialized");
-        }
-
-        // Set destination size
-        destination.resize(slots_);
-
-        // Never include the leading zero coefficient (if present)
-        int plain_coeff_count = min(plain.coeff_count(), slots_);
-
-        Pointer temp_dest(allocate_uint(slots_, pool));
-
-        // Make a copy of poly
-        set_uint_uint(plain.pointer(), plain_coeff_count, temp_dest.get());
-        set_zero_uint(slots_ - plain_coeff_count, temp_dest.get() + plain_coeff_count);
-
-        // Transform destination using negacyclic NTT.
-        ntt_negacyclic_harvey(temp_dest.get(), ntt_tables_);
+        // Unbatch into destination as unsigned values, then center them in place
+        uint64_t *unsigned_destination = reinterpret_cast<uint64_t*>(destination);
+        decompose(plain, unsigned_destination, pool);
 
         // Read top row, then bottom row
         uint64_t plain_modulus_div_two = mod_.value() >> 1;
         for (int i = 0; i < slots_; i++)
         {
-            int64_t curr_value = temp_dest[matrix_reps_index_map_[i]];
+            uint64_t curr_value = unsigned_destination[i];
             destination[i] = (curr_value > plain_modulus_div_two) ?
-                (curr_value - mod_.value()) : curr_value;
+                -static_cast<int64_t>(mod_.value() - curr_value) : static_cast<int64_t>(curr_value);
         }
     }
 
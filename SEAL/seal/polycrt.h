@@ -120,6 +120,34 @@ namespace seal
         @throws std::invalid_argument if values is too large
         */
         void compose(const std::vector<std::int64_t> &values, Plaintext &destination);
+
+        /**
+        Creates a SEAL plaintext from a given matrix stored in an array. This function works
+        like the vector overload, but reads the values directly from memory owned by the
+        caller, for example the buffer of a NumPy array.
+
+        @param[in] values Pointer to the matrix of integers modulo plaintext modulus to batch
+        @param[in] count The number of values, at most equal to the slot count
+        @param[out] destination The plaintext polynomial to overwrite with the result
+        @throws std::invalid_argument if values is null and count is positive
+        @throws std::invalid_argument if count is negative
+        @throws std::logic_error if count is larger than the slot count
+        */
+        void compose(const std::uint64_t *values, int count, Plaintext &destination);
+
+        /**
+        Creates a SEAL plaintext from a given matrix of signed integers stored in an array.
+        This function works like the vector overload, but reads the values directly from
+        memory owned by the caller, for example the buffer of a NumPy array.
+
+        @param[in] values Pointer to the matrix of integers modulo plaintext modulus to batch
+        @param[in] count The number of values, at most equal to the slot count
+        @param[out] destination The plaintext polynomial to overwrite with the result
+        @throws std::invalid_argument if values is null and count is positive
+        @throws std::invalid_argument if count is negative
+        @throws std::logic_error if count is larger than the slot count
+        */
+        void compose(const std::int64_t *values, int count, Plaintext &destination);
         
         /**
         Creates a SEAL plaintext from a given matrix. This function "batches" a given matrix
@@ -226,6 +254,72 @@ namespace seal
             decompose(plain, destination, pool_);
         }
 
+        /**
+        Inverse of compose. This function "unbatches" a given SEAL plaintext into an array
+        of slot_count() integers modulo the plaintext modulus owned by the caller, for
+        example the buffer of a NumPy array. Dynamic memory allocations in the process are
+        allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] plain The plaintext polynomial to unbatch
+        @param[out] destination Pointer to an array of at least slot_count() integers to be
+        overwritten with the values of the slots
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if plain is not valid for the encryption parameters
+        @throws std::invalid_argument if destination is null
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void decompose(const Plaintext &plain, std::uint64_t *destination, const MemoryPoolHandle &pool);
+
+        /**
+        Inverse of compose. This function "unbatches" a given SEAL plaintext into an array
+        of slot_count() integers modulo the plaintext modulus owned by the caller. Dynamic
+        memory allocations in the process are allocated from the memory pool pointed to by
+        the local MemoryPoolHandle.
+
+        @param[in] plain The plaintext polynomial to unbatch
+        @param[out] destination Pointer to an array of at least slot_count() integers to be
+        overwritten with the values of the slots
+        @throws std::invalid_argument if plain is not valid for the encryption parameters
+        @throws std::invalid_argument if destination is null
+        */
+        inline void decompose(const Plaintext &plain, std::uint64_t *destination)
+        {
+            decompose(plain, destination, pool_);
+        }
+
+        /**
+        Inverse of compose. This function "unbatches" a given SEAL plaintext into an array
+        of slot_count() signed integers owned by the caller, for example the buffer of a
+        NumPy array. Dynamic memory allocations in the process are allocated from the memory
+        pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] plain The plaintext polynomial to unbatch
+        @param[out] destination Pointer to an array of at least slot_count() integers to be
+        overwritten with the values of the slots
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if plain is not valid for the encryption parameters
+        @throws std::invalid_argument if destination is null
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void decompose(const Plaintext &plain, std::int64_t *destination, const MemoryPoolHandle &pool);
+
+        /**
+        Inverse of compose. This function "unbatches" a given SEAL plaintext into an array
+        of slot_count() signed integers owned by the caller. Dynamic memory allocations in
+        the process are allocated from the memory pool pointed to by the local
+        MemoryPoolHandle.
+
+        @param[in] plain The plaintext polynomial to unbatch
+        @param[out] destination Pointer to an array of at least slot_count() integers to be
+        overwritten with the values of the slots
+        @throws std::invalid_argument if plain is not valid for the encryption parameters
+        @throws std::invalid_argument if destination is null
+        */
+        inline void decompose(const Plaintext &plain, std::int64_t *destination)
+        {
+            decompose(plain, destination, pool_);
+        }
+
         /**
         Inverse of compose. This function "unbatches" a given SEAL plaintext in-place into 
         a matrix of integers modulo the plaintext modulus. The input plaintext must have 
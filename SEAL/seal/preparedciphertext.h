@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include "seal/encryptionparams.h"
+#include "seal/context.h"
+#include "seal/memorypoolhandle.h"
+#include "seal/util/mempool.h"
+#include "seal/util/uintcore.h"
+
+namespace seal
+{
+    /**
+    Holds a ciphertext in the form in which Evaluator::multiply consumes it. Before two
+    ciphertexts are multiplied, each of them is extended from the coefficient modulus base q
+    to an auxiliary base, and transformed to NTT form in both bases. When one ciphertext is
+    multiplied with many others, for example an encrypted query with the entries of an
+    encrypted database, this work can be done only once by preparing the shared operand with
+    Evaluator::prepare, and passing the PreparedCiphertext to Evaluator::multiply. Each such
+    multiplication then only needs to transform the other operand, which saves roughly half
+    of the forward transforms.
+
+    A PreparedCiphertext takes more memory than the ciphertext it was prepared from, since
+    it holds the ciphertext also in the auxiliary base, which has one or two primes more than
+    the coefficient modulus. It can only be used with the Evaluator it was prepared with, or
+    with one created from the same SEALContext. The auxiliary base depends on the
+    MultiplyMethod of the SEALContext, so Evaluator::multiply rejects a PreparedCiphertext
+    prepared for another method even if the encryption parameters are the same.
+
+    @see Evaluator::prepare for preparing a ciphertext for multiplication.
+    */
+    class PreparedCiphertext
+    {
+    public:
+        /**
+        Creates an empty PreparedCiphertext. Memory is allocated from the global memory pool
+        once a ciphertext is prepared into it.
+        */
+        PreparedCiphertext() = default;
+
+        /**
+        Creates an empty PreparedCiphertext. Memory is allocated from the memory pool pointed
+        to by the given MemoryPoolHandle once a ciphertext is prepared into it.
+
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        explicit PreparedCiphertext(const MemoryPoolHandle &pool) : pool_(pool)
+        {
+            if (!pool_)
+            {
+                throw std::invalid_argument("pool is uninitialized");
+            }
+        }
+
+        /**
+        Creates a deep copy of a given PreparedCiphertext.
+
+        @param[in] copy The PreparedCiphertext to copy from
+        */
+        PreparedCiphertext(const PreparedCiphertext &copy) :
+            pool_(copy.pool_), hash_block_(copy.hash_block_), multiply_method_(copy.multiply_method_),
+            aux_base_mod_count_(copy.aux_base_mod_count_), size_(copy.size_),
+            uint64_count_(copy.uint64_count_), data_(util::allocate_uint(copy.uint64_count_, pool_))
+        {
+            util::set_uint_uint(copy.data_.get(), uint64_count_, data_.get());
+        }
+
+        /**
+        Creates a new PreparedCiphertext by moving a given one.
+
+        @param[in] source The PreparedCiphertext to move from
+        */
+        PreparedCiphertext(PreparedCiphertext &&source) = default;
+
+        /**
+        Overwrites the PreparedCiphertext with a deep copy of a given one.
+
+        @param[in] assign The PreparedCiphertext to copy from
+        */
+        PreparedCiphertext &operator =(const PreparedCiphertext &assign)
+        {
+            if (this != &assign)
+            {
+                hash_block_ = assign.hash_block_;
+                multiply_method_ = assign.multiply_method_;
+                aux_base_mod_count_ = assign.aux_base_mod_count_;
+                size_ = assign.size_;
+                uint64_count_ = assign.uint64_count_;
+                data_ = util::allocate_uint(uint64_count_, pool_);
+                util::set_uint_uint(assign.data_.get(), uint64_count_, data_.get());
+            }
+            return *this;
+        }
+
+        /**
+        Moves a given PreparedCiphertext to the current one.
+
+        @param[in] assign The PreparedCiphertext to move from
+        */
+        PreparedCiphertext &operator =(PreparedCiphertext &&assign) = default;
+
+        /**
+        Returns the size of the ciphertext that was prepared, or 0 if none was.
+        */
+        inline int size() const
+        {
+            return size_;
+        }
+
+        /**
+        Returns a constant reference to the hash block of the encryption parameters of the
+        ciphertext that was prepared.
+
+        @see EncryptionParameters for more information about the hash block.
+        */
+        inline const EncryptionParameters::hash_block_type &hash_block() const
+        {
+            return hash_block_;
+        }
+
+    private:
+        MemoryPoolHandle pool_ = MemoryPoolHandle::Global();
+
+        EncryptionParameters::hash_block_type hash_block_{ { 0 } };
+
+        // The auxiliary base is Bsk for MultiplyMethod::behz and P for MultiplyMethod::hps
+        MultiplyMethod multiply_method_ = MultiplyMethod::behz;
+
+        int aux_base_mod_count_ = 0;
+
+        int size_ = 0;
+
+        int uint64_count_ = 0;
+
+        // The ciphertext in NTT form modulo the primes of q, followed by the ciphertext in NTT
+        // form modulo the primes of the auxiliary base
+        util::Pointer data_;
+
+        friend class Evaluator;
+    };
+}
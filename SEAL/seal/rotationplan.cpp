@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include "seal/rotationplan.h"
+#include "seal/util/numth.h"
+#include "seal/util/uintarith.h"
+
+using namespace std;
+using namespace seal::util;
+
+namespace seal
+{
+    RotationPlan::RotationPlan(const SEALContext &context, const vector<int> &steps, int max_key_count) :
+        row_size_((context.poly_modulus().coeff_count() - 1) >> 1)
+    {
+        // Verify parameters.
+        if (!context.qualifiers().enable_batching)
+        {
+            throw invalid_argument("encryption parameters are not valid for batching");
+        }
+        if (max_key_count < 0)
+        {
+            throw invalid_argument("max_key_count cannot be negative");
+        }
+
+        // Rotations are steps to the left modulo the row size
+        vector<int> targets;
+        for (int step : steps)
+        {
+            if (abs(step) >= row_size_)
+            {
+                throw invalid_argument("step count too large");
+            }
+            int target = (step + row_size_) % row_size_;
+            if (target != 0 && find(targets.begin(), targets.end(), target) == targets.end())
+            {
+                targets.push_back(target);
+            }
+        }
+
+        vector<int> chosen;
+        if (max_key_count == 0 || max_key_count >= static_cast<int>(targets.size()))
+        {
+            chosen = targets;
+        }
+        else
+        {
+            // Candidates are the steps themselves, the signed powers of two, and the greatest
+            // common divisor of the steps, which reaches every step on its own
+            vector<int> candidates(targets);
+            int divisor = row_size_;
+            for (int target : targets)
+            {
+                divisor = static_cast<int>(gcd(divisor, target));
+            }
+            candidates.push_back(divisor);
+            for (int power = 1; power < row_size_; power <<= 1)
+            {
+                candidates.push_back(power);
+                candidates.push_back(row_size_ - power);
+            }
+            sort(candidates.begin(), candidates.end());
+            candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+            // An unreachable step costs more than reaching all steps, so that the first key
+            // chosen already reaches every step
+            int64_t unreachable_cost = static_cast<int64_t>(row_size_) * targets.size();
+            auto total_cost = [&](const vector<int> &key_steps) {
+                vector<int> distance = distances(key_steps);
+                int64_t cost = 0;
+                for (int target : targets)
+                {
+                    cost += distance[target] < 0 ? unreachable_cost : distance[target];
+                }
+                return cost;
+            };
+
+            int64_t cost = numeric_limits<int64_t>::max();
+            while (static_cast<int>(chosen.size()) < max_key_count &&
+                cost > static_cast<int64_t>(targets.size()))
+            {
+                int best_candidate = 0;
+                int64_t best_cost = cost;
+                for (int candidate : candidates)
+                {
+                    if (find(chosen.begin(), chosen.end(), candidate) != chosen.end())
+                    {
+                        continue;
+                    }
+                    chosen.push_back(candidate);
+                    int64_t candidate_cost = total_cost(chosen);
+                    chosen.pop_back();
+                    if (candidate_cost < best_cost)
+                    {
+                        best_candidate = candidate;
+                        best_cost = candidate_cost;
+                    }
+                }
+                if (best_candidate == 0)
+                {
+                    break;
+                }
+                chosen.push_back(best_candidate);
+                cost = best_cost;
+            }
+        }
+
+        distances_ = distances(chosen);
+        for (int target : targets)
+        {
+            total_key_switch_count_ += distances_[target];
+        }
+
+        // Report the keys as signed steps of smallest absolute value
+        for (int key_step : chosen)
+        {
+            key_steps_.push_back(key_step > row_size_ / 2 ? key_step - row_size_ : key_step);
+        }
+        sort(key_steps_.begin(), key_steps_.end());
+        uint64_t m = static_cast<uint64_t>(row_size_) << 2;
+        for (int key_step : key_steps_)
+        {
+            galois_elts_.push_back(exponentiate_uint64(3, (key_step + row_size_) % row_size_) & (m - 1));
+        }
+    }
+
+    int RotationPlan::key_switch_count(int steps) const
+    {
+        if (abs(steps) >= row_size_)
+        {
+            throw invalid_argument("step count too large");
+        }
+        return distances_[(steps + row_size_) % row_size_];
+    }
+
+    vector<int> RotationPlan::distances(const vector<int> &key_steps) const
+    {
+        // Breadth-first search over the cyclic group of row rotations
+        vector<int> distance(row_size_, -1);
+        vector<int> queue{ 0 };
+        distance[0] = 0;
+        for (size_t i = 0; i < queue.size(); i++)
+        {
+            for (int key_step : key_steps)
+            {
+                int next = (queue[i] + key_step) % row_size_;
+                if (distance[next] < 0)
+                {
+                    distance[next] = distance[queue[i]] + 1;
+                    queue.push_back(next);
+                }
+            }
+        }
+        return distance;
+    }
+}
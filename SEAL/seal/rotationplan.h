@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "seal/context.h"
+
+namespace seal
+{
+    /**
+    Chooses a set of Galois keys for the row rotations an application performs. A key for
+    every step makes each rotation a single key switch, but every key takes as much memory
+    as an evaluation key with the same decomposition bit count. The plan trades key memory
+    against rotation latency explicitly: given the rotation steps and an upper limit on the
+    number of keys, it chooses the keys that minimize the total number of key switches needed
+    to perform each of the steps once. The keys are then generated by passing the plan to
+    KeyGenerator::generate_galois_keys.
+
+    @par Key Choice
+    If the limit allows it, the plan contains one key for each distinct step. Otherwise keys
+    are chosen greedily from the requested steps, the signed powers of two, and the greatest
+    common divisor of the steps, each time adding the key that reduces the total number of
+    key switches the most. The first key always makes every step reachable, so the plan
+    works with any limit of at least one key.
+
+    @par Rotation Paths
+    When Evaluator::rotate_rows has no key for the requested step, it composes the rotation
+    from the keys present, always choosing a path with the fewest key switches. Rotating left
+    and right by the same amount are both considered, so the cost reported by the plan is
+    exactly the number of key switches a rotation takes with the planned keys.
+    */
+    class RotationPlan
+    {
+    public:
+        /**
+        Creates a plan of Galois keys for the given row rotation steps. Positive steps
+        rotate to the left and negative steps to the right, as in Evaluator::rotate_rows.
+
+        @param[in] context The SEALContext
+        @param[in] steps The numbers of steps the application rotates rows by
+        @param[in] max_key_count The largest number of keys to use, or 0 for no limit
+        @throws std::invalid_argument if the encryption parameters do not support batching
+        @throws std::invalid_argument if any step count has too big absolute value
+        @throws std::invalid_argument if max_key_count is negative
+        */
+        RotationPlan(const SEALContext &context, const std::vector<int> &steps,
+            int max_key_count = 0);
+
+        /**
+        Returns the row rotation steps that the planned keys rotate by, each between
+        -N/4 and N/4, where N is the degree of the polynomial modulus.
+        */
+        inline const std::vector<int> &key_steps() const
+        {
+            return key_steps_;
+        }
+
+        /**
+        Returns the Galois elements of the planned keys.
+        */
+        inline const std::vector<std::uint64_t> &galois_elts() const
+        {
+            return galois_elts_;
+        }
+
+        /**
+        Returns the number of key switches that a row rotation by the given number of steps
+        takes with the planned keys, or -1 if the keys cannot perform it.
+
+        @param[in] steps The number of steps to rotate
+        @throws std::invalid_argument if steps has too big absolute value
+        */
+        int key_switch_count(int steps) const;
+
+        /**
+        Returns the total number of key switches needed to rotate once by each distinct
+        requested step with the planned keys.
+        */
+        inline int total_key_switch_count() const
+        {
+            return total_key_switch_count_;
+        }
+
+    private:
+        // Returns the distance of every rotation from the identity using keys with the given
+        // steps, or -1 for rotations that cannot be reached
+        std::vector<int> distances(const std::vector<int> &key_steps) const;
+
+        int row_size_;
+
+        std::vector<int> key_steps_;
+
+        std::vector<std::uint64_t> galois_elts_;
+
+        std::vector<int> distances_;
+
+        int total_key_switch_count_ = 0;
+    };
+}
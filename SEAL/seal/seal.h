@@ -12,13 +12,20 @@
 #include "seal/encryptor.h"
 #include "seal/evaluationkeys.h"
 #include "seal/evaluator.h"
+#include "seal/evaluatorworkspace.h"
+#include "seal/exponentiationplan.h"
+#include "seal/galoiskeystore.h"
 #include "seal/keygenerator.h"
+#include "seal/mappedarchive.h"
 #include "seal/memorypoolhandle.h"
 #include "seal/plaintext.h"
+#include "seal/plainmatrix.h"
 #include "seal/polycrt.h"
+#include "seal/preparedciphertext.h"
 #include "seal/defaultparams.h"
 #include "seal/publickey.h"
 #include "seal/randomgen.h"
+#include "seal/rotationplan.h"
 #include "seal/encryptor.h"
 #include "seal/encryptionparams.h"
 #include "seal/context.h"
@@ -30,5 +37,6 @@
 #include "seal/secretkey.h"
 #include "seal/simulator.h"
 #include "seal/smallmodulus.h"
+#include "seal/threadpoolhandle.h"
 #include "seal/utilities.h"
 
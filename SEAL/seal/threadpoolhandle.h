@@ -0,0 +1,195 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "seal/util/threadpool.h"
+
+namespace seal
+{
+    /**
+    Manages a shared pointer to a thread pool. By default all homomorphic operations run
+    on the calling thread only. For large encryption parameters (e.g. many primes in the
+    coefficient modulus) a single operation contains a lot of independent work, such as
+    the number-theoretic transforms and dyadic products modulo each prime, and the fast
+    base conversions applied to each ciphertext polynomial. Attaching a thread pool to an
+    Evaluator (either directly, or through the SEALContext the Evaluator is created from)
+    spreads this work across several cores, which lowers the latency of each operation.
+    The results are always identical to those computed without a thread pool.
+
+    @par Concurrency Limit
+    The thread calling an operation always takes part in the work itself, so a thread pool
+    of size T uses T-1 additional threads. The number of threads that a single operation
+    may use at the same time can be further limited with set_max_concurrency(...), e.g. to
+    leave cores free for other work. The limit can be changed at any time.
+
+    @par Memory Pools
+    Parts of an operation running in parallel allocate from the MemoryPoolHandle passed
+    to the operation. If that memory pool is thread-unsafe, the parts of the operation
+    that allocate memory run sequentially on the calling thread.
+
+    @par Initialized and Uninitialized Handles
+    A ThreadPoolHandle that has not been assigned ThreadPoolHandle::New(...) is said to be
+    uninitialized. Passing an uninitialized ThreadPoolHandle to an Evaluator means that
+    the Evaluator runs all operations sequentially.
+
+    @par Managing Lifetime
+    Internally, the ThreadPoolHandle wraps an std::shared_ptr pointing to a SEAL thread
+    pool class. As long as a ThreadPoolHandle pointing to a particular thread pool exists,
+    the pool and its worker threads stay alive.
+    */
+    class ThreadPoolHandle
+    {
+    public:
+        /**
+        Creates a new uninitialized ThreadPoolHandle.
+        */
+        ThreadPoolHandle() = default;
+
+        /**
+        Creates a copy of a given ThreadPoolHandle. As a result, the created
+        ThreadPoolHandle will point to the same underlying thread pool as the copied
+        instance.
+
+        @param[in] copy The ThreadPoolHandle to copy from
+        */
+        ThreadPoolHandle(const ThreadPoolHandle &copy) = default;
+
+        /**
+        Creates a new ThreadPoolHandle by moving a given one. As a result, the moved
+        ThreadPoolHandle will become uninitialized.
+
+        @param[in] source The ThreadPoolHandle to move from
+        */
+        ThreadPoolHandle(ThreadPoolHandle &&source) noexcept = default;
+
+        /**
+        Overwrites the ThreadPoolHandle instance with the specified instance. As a result,
+        the current ThreadPoolHandle will point to the same underlying thread pool as
+        the assigned instance.
+
+        @param[in] assign The ThreadPoolHandle instance to assign to the current instance
+        */
+        ThreadPoolHandle &operator =(const ThreadPoolHandle &assign) = default;
+
+        /**
+        Moves a specified ThreadPoolHandle instance to the current instance. As a result,
+        the assigned ThreadPoolHandle will become uninitialized.
+
+        @param[in] assign The ThreadPoolHandle instance to assign to the current instance
+        */
+        ThreadPoolHandle &operator =(ThreadPoolHandle &&assign) noexcept = default;
+
+        /**
+        Returns a ThreadPoolHandle pointing to a new thread pool of the given size. The
+        size includes the thread calling the operations, so thread_count-1 worker threads
+        are created. A natural choice is std::thread::hardware_concurrency().
+
+        @param[in] thread_count The total number of threads an operation can use
+        @throws std::invalid_argument if thread_count is less than 1
+        */
+        inline static ThreadPoolHandle New(int thread_count)
+        {
+            return ThreadPoolHandle(std::make_shared<util::ThreadPool>(thread_count));
+        }
+
+        /**
+        Returns a reference to the internal SEAL thread pool that the ThreadPoolHandle
+        points to. This function is mainly for internal use.
+
+        @throws std::logic_error if the ThreadPoolHandle is uninitialized
+        */
+        inline operator util::ThreadPool &() const
+        {
+#ifdef SEAL_DEBUG
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+#endif
+            return *pool_.get();
+        }
+
+        /**
+        Returns the total number of threads that an operation can use, including the
+        calling thread.
+
+        @throws std::logic_error if the ThreadPoolHandle is uninitialized
+        */
+        inline int thread_count() const
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            return pool_->thread_count();
+        }
+
+        /**
+        Returns the maximum number of threads that a single operation uses concurrently.
+
+        @throws std::logic_error if the ThreadPoolHandle is uninitialized
+        */
+        inline int max_concurrency() const
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            return pool_->max_concurrency();
+        }
+
+        /**
+        Limits the number of threads that a single operation uses concurrently. Values
+        larger than thread_count() have the same effect as thread_count(), and setting
+        the limit to 1 makes all operations run sequentially on the calling thread.
+
+        @param[in] max_concurrency The maximum number of threads used by one operation
+        @throws std::logic_error if the ThreadPoolHandle is uninitialized
+        @throws std::invalid_argument if max_concurrency is less than 1
+        */
+        inline void set_max_concurrency(int max_concurrency)
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            pool_->set_max_concurrency(max_concurrency);
+        }
+
+        /**
+        Returns whether the ThreadPoolHandle is initialized.
+        */
+        inline operator bool () const
+        {
+            return !!pool_;
+        }
+
+        /**
+        Compares ThreadPoolHandles. This function returns whether the current
+        ThreadPoolHandle points to the same thread pool as a given ThreadPoolHandle.
+        */
+        inline bool operator ==(const ThreadPoolHandle &compare)
+        {
+            return pool_ == compare.pool_;
+        }
+
+        /**
+        Compares ThreadPoolHandles. This function returns whether the current
+        ThreadPoolHandle points to a different thread pool than a given
+        ThreadPoolHandle.
+        */
+        inline bool operator !=(const ThreadPoolHandle &compare)
+        {
+            return pool_ != compare.pool_;
+        }
+
+    private:
+        ThreadPoolHandle(std::shared_ptr<util::ThreadPool> pool) noexcept :
+            pool_(std::move(pool))
+        {
+        }
+
+        std::shared_ptr<util::ThreadPool> pool_ = nullptr;
+    };
+}
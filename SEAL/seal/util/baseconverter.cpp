@@ -1,4 +1,5 @@
 #include <stdexcept>
+#include <algorithm>
 #include "seal/util/mempool.h"
 #include "seal/util/uintcore.h"
 #include "seal/memorypoolhandle.h"
@@ -62,34 +63,17 @@ namespace seal
             mtilde_inv_coeff_base_products_mod_coeff_array_.resize(coeff_base_mod_count_);
             inv_aux_base_products_mod_aux_array_.resize(aux_base_mod_count_);
             inv_coeff_base_products_mod_coeff_array_.resize(coeff_base_mod_count_);
-            coeff_base_products_mod_mtilde_array_.resize(coeff_base_mod_count_);
             inv_coeff_products_all_mod_aux_bsk_array_.resize(bsk_base_mod_count_);
-            aux_base_products_mod_msk_array_.resize(aux_base_mod_count_);
             aux_products_all_mod_coeff_array_.resize(coeff_base_mod_count_);
             inv_mtilde_mod_bsk_array_.resize(bsk_base_mod_count_);
             coeff_products_all_mod_bsk_array_.resize(bsk_base_mod_count_);
             neg_inv_coeff_products_all_mod_plain_gamma_array_.resize(plain_gamma_count_);
             plain_gamma_product_mod_coeff_array_.resize(coeff_base_mod_count_);
 
-            // We use a reversed order here for performance reasons
-            coeff_base_products_mod_aux_bsk_array_.resize(bsk_base_mod_count_);
-            for (int i = 0; i < bsk_base_mod_count_; i++)
-            {
-                coeff_base_products_mod_aux_bsk_array_[i].resize(coeff_base_mod_count_);
-            }
-
-            // We use a reversed order here for performance reasons
-            aux_base_products_mod_coeff_array_.resize(coeff_base_mod_count_);
-            for (int i = 0; i < coeff_base_mod_count_; i++)
-            {
-                aux_base_products_mod_coeff_array_[i].resize(aux_base_mod_count_);
-            }
-
-            coeff_products_mod_plain_gamma_array_.resize(plain_gamma_count_);
-            for (int i = 0; i < plain_gamma_count_; i++)
-            {
-                coeff_products_mod_plain_gamma_array_[i].resize(coeff_base_mod_count_);
-            }
+            // The conversion matrices have one row per output modulus
+            coeff_base_products_mod_bsk_mtilde_matrix_.resize((bsk_base_mod_count_ + 1) * coeff_base_mod_count_);
+            aux_base_products_mod_coeff_msk_matrix_.resize((coeff_base_mod_count_ + 1) * aux_base_mod_count_);
+            coeff_base_products_mod_plain_gamma_matrix_.resize(plain_gamma_count_ * coeff_base_mod_count_);
 
             // Copy coeff base and auxiliary base arrays
             coeff_base_array_ = coeff_base;
@@ -99,6 +83,10 @@ namespace seal
             }
             bsk_base_array_ = aux_base_array_;
             bsk_base_array_.emplace_back(m_sk_);
+            bsk_mtilde_base_array_ = bsk_base_array_;
+            bsk_mtilde_base_array_.emplace_back(m_tilde_);
+            coeff_msk_base_array_ = coeff_base_array_;
+            coeff_msk_base_array_.emplace_back(m_sk_);
 
             // Generate Bsk U {mtilde} small ntt tables which is used in Evaluator
             int coeff_power_count = coeff_power;
@@ -156,7 +144,7 @@ namespace seal
             // Compute auxiliary base products mod m_sk
             for (int i = 0; i < aux_base_mod_count_; i++)
             {
-                aux_base_products_mod_msk_array_[i] = modulo_uint(aux_products_array.get() + (i * aux_products_uint64_count), aux_products_uint64_count, m_sk_, pool_);
+                aux_base_products_mod_coeff_msk_matrix_[(coeff_base_mod_count_ * aux_base_mod_count_) + i] = modulo_uint(aux_products_array.get() + (i * aux_products_uint64_count), aux_products_uint64_count, m_sk_, pool_);
             }
 
             // Compute inverse coeff base mod coeff base array (qi^(-1)) mod qi and mtilde inv coeff products mod auxiliary moduli  (m_tilda*qi^(-1)) mod qi
@@ -188,7 +176,7 @@ namespace seal
             // Compute coeff modulus products mod mtilde (qi) mod m_tilde_ 
             for (int i = 0; i < coeff_base_mod_count_; i++)
             {
-                coeff_base_products_mod_mtilde_array_[i] = modulo_uint(coeff_products_array.get() + (i * coeff_products_uint64_count), 
+                coeff_base_products_mod_bsk_mtilde_matrix_[(bsk_base_mod_count_ * coeff_base_mod_count_) + i] = modulo_uint(coeff_products_array.get() + (i * coeff_products_uint64_count), 
                     coeff_products_uint64_count, m_tilde_, pool_);
             }
 
@@ -197,7 +185,7 @@ namespace seal
             {
                 for (int j = 0; j < coeff_base_mod_count_; j++)
                 {
-                    coeff_base_products_mod_aux_bsk_array_[i][j] = modulo_uint(coeff_products_array.get() + (j * coeff_products_uint64_count), 
+                    coeff_base_products_mod_bsk_mtilde_matrix_[(i * coeff_base_mod_count_) + j] = modulo_uint(coeff_products_array.get() + (j * coeff_products_uint64_count), 
                         coeff_products_uint64_count, aux_base_array_[i], pool_);
                 }
             }
@@ -205,7 +193,7 @@ namespace seal
             // Add qi mod msk at the end of the array
             for (int i = 0; i < coeff_base_mod_count_; i++)
             {
-                coeff_base_products_mod_aux_bsk_array_[aux_base_mod_count_][i] = modulo_uint(coeff_products_array.get() + (i * coeff_products_uint64_count),
+                coeff_base_products_mod_bsk_mtilde_matrix_[(aux_base_mod_count_ * coeff_base_mod_count_) + i] = modulo_uint(coeff_products_array.get() + (i * coeff_products_uint64_count),
                     coeff_products_uint64_count, m_sk_, pool_);
             }
 
@@ -214,7 +202,7 @@ namespace seal
             {
                 for (int j = 0; j < aux_base_mod_count_; j++)
                 {
-                    aux_base_products_mod_coeff_array_[i][j] = modulo_uint(aux_products_array.get() + (j * aux_products_uint64_count), 
+                    aux_base_products_mod_coeff_msk_matrix_[(i * aux_base_mod_count_) + j] = modulo_uint(aux_products_array.get() + (j * aux_products_uint64_count), 
                         aux_products_uint64_count, coeff_base_array_[i], pool_);
                 }
             }
@@ -316,7 +304,7 @@ namespace seal
             {
                 for (int j = 0; j < coeff_base_mod_count_; j++)
                 {
-                    coeff_products_mod_plain_gamma_array_[i][j] = modulo_uint(coeff_products_array.get() + (j * coeff_products_uint64_count), 
+                    coeff_base_products_mod_plain_gamma_matrix_[(i * coeff_base_mod_count_) + j] = modulo_uint(coeff_products_array.get() + (j * coeff_products_uint64_count), 
                         coeff_products_uint64_count, plain_gamma_array_[i], pool_);
                 }
             }
@@ -347,6 +335,28 @@ namespace seal
                 plain_gamma_product_mod_coeff_array_[i] = multiply_uint_uint_mod(small_plain_mod_.value(), gamma_.value(), coeff_base_array_[i]);
             }
 
+            // Compute the scaled versions of the constants that inputs are multiplied with
+            for (int i = 0; i < coeff_base_mod_count_; i++)
+            {
+                scaled_inv_coeff_base_products_mod_coeff_array_.push_back(
+                    scale_uint_mod(inv_coeff_base_products_mod_coeff_array_[i], coeff_base_array_[i]));
+                scaled_mtilde_inv_coeff_base_products_mod_coeff_array_.push_back(
+                    scale_uint_mod(mtilde_inv_coeff_base_products_mod_coeff_array_[i], coeff_base_array_[i]));
+            }
+            for (int i = 0; i < aux_base_mod_count_; i++)
+            {
+                scaled_inv_aux_base_products_mod_aux_array_.push_back(
+                    scale_uint_mod(inv_aux_base_products_mod_aux_array_[i], aux_base_array_[i]));
+            }
+            for (int i = 0; i < bsk_base_mod_count_; i++)
+            {
+                scaled_inv_coeff_products_all_mod_aux_bsk_array_.push_back(
+                    scale_uint_mod(inv_coeff_products_all_mod_aux_bsk_array_[i], bsk_base_array_[i]));
+                scaled_inv_mtilde_mod_bsk_array_.push_back(scale_uint_mod(inv_mtilde_mod_bsk_array_[i], bsk_base_array_[i]));
+            }
+            scaled_inv_coeff_products_mod_mtilde_ = scale_uint_mod(inv_coeff_products_mod_mtilde_, m_tilde_);
+            scaled_inv_aux_products_mod_msk_ = scale_uint_mod(inv_aux_products_mod_msk_, m_sk_);
+
             // Everything went well
             generated_ = true;
         }
@@ -358,22 +368,30 @@ namespace seal
             aux_base_array_.clear();
             bsk_base_array_.clear();
             plain_gamma_array_.clear();
+            bsk_mtilde_base_array_.clear();
+            coeff_msk_base_array_.clear();
             mtilde_inv_coeff_base_products_mod_coeff_array_.clear();
+            scaled_mtilde_inv_coeff_base_products_mod_coeff_array_.clear();
             inv_aux_base_products_mod_aux_array_.clear();
+            scaled_inv_aux_base_products_mod_aux_array_.clear();
             inv_coeff_products_all_mod_aux_bsk_array_.clear();
+            scaled_inv_coeff_products_all_mod_aux_bsk_array_.clear();
             inv_coeff_base_products_mod_coeff_array_.clear();
-            aux_base_products_mod_coeff_array_.clear();
-            coeff_base_products_mod_aux_bsk_array_.clear();
-            coeff_base_products_mod_mtilde_array_.clear();
-            aux_base_products_mod_msk_array_.clear();
+            scaled_inv_coeff_base_products_mod_coeff_array_.clear();
+            aux_base_products_mod_coeff_msk_matrix_.clear();
+            coeff_base_products_mod_bsk_mtilde_matrix_.clear();
             aux_products_all_mod_coeff_array_.clear();
             inv_mtilde_mod_bsk_array_.clear();
+            scaled_inv_mtilde_mod_bsk_array_.clear();
             coeff_products_all_mod_bsk_array_.clear();
-            coeff_products_mod_plain_gamma_array_.clear();
+            coeff_base_products_mod_plain_gamma_matrix_.clear();
             neg_inv_coeff_products_all_mod_plain_gamma_array_.clear();
             plain_gamma_product_mod_coeff_array_.clear();
             bsk_small_ntt_table_.clear();
             inv_coeff_products_mod_mtilde_ = 0;
+            scaled_inv_coeff_products_mod_mtilde_ = 0;
+            inv_aux_products_mod_msk_ = 0;
+            scaled_inv_aux_products_mod_msk_ = 0;
             m_tilde_ = 0;
             m_sk_ = 0;
             gamma_ = 0;
@@ -384,6 +402,105 @@ namespace seal
             inv_gamma_mod_plain_ = 0;
         }
 
+        namespace
+        {
+            // Number of coefficients that fast_convert_array processes at a time. The scaled inputs 
+            // for one block should fit comfortably in the L1 cache.
+            const int base_conversion_block_size = 64;
+
+            // Sets destination[j * destination_stride + k] to the sum over i of block[k * column_count + i]
+            // times matrix[j * column_count + i], reduced modulo output_moduli[j]. Here k ranges over the 
+            // block_count rows of block and j over the output_count rows of matrix.
+            void multiply_block_matrix(const uint64_t *block, int block_count, int column_count, 
+                const uint64_t *matrix, const SmallModulus *output_moduli, int output_count, 
+                uint64_t *destination, int destination_stride)
+            {
+                for (int j = 0; j < output_count; j++)
+                {
+                    const uint64_t *matrix_row = matrix + (j * column_count);
+                    const SmallModulus &output_modulus = output_moduli[j];
+                    const uint64_t *block_ptr = block;
+                    uint64_t *destination_ptr = destination + (j * destination_stride);
+                    for (int k = 0; k < block_count; k++)
+                    {
+                        uint64_t wide_sum[2]{ 0 };
+                        for (int i = 0; i < column_count; i++)
+                        {
+                            // Lazy reduction
+                            uint64_t wide_product[2];
+
+                            // Products are at most 61 bit + 61 bit = 122 bit, so can sum up to 63 of them 
+                            // with no reduction. Thus need at most 63 input moduli, which the restriction 
+                            // on the number of coeff modulus primes guarantees.
+                            multiply_uint64(*block_ptr++, matrix_row[i], wide_product);
+                            unsigned char carry = add_uint64(wide_sum[0], wide_product[0], 0, wide_sum);
+                            wide_sum[1] += wide_product[1] + carry;
+                        }
+                        *destination_ptr++ = barrett_reduce_128(wide_sum, output_modulus);
+                    }
+                }
+            }
+
+            // Computes the core of a fast base conversion. For every coefficient index, each input value 
+            // input[i] is first multiplied by input_scalars[i] modulo input_moduli[i], and then destination[j] 
+            // is set to the sum over i of these products times matrix[j * input_count + i], reduced modulo 
+            // output_moduli[j], for the first output_count output moduli. Here input and destination are 
+            // arrays of polys with coeff_count coefficients each. The coefficients are processed in blocks 
+            // small enough to stay in cache while they are used for every output modulus.
+            //
+            // If inv_input_moduli is given, the conversion is exact: the matrix then has input_count + 1 
+            // columns, and the last one is multiplied by the number of times the product of the input 
+            // moduli overflows, which is obtained by rounding the sum of the products divided by the 
+            // corresponding input moduli.
+            void fast_convert_array(const uint64_t *input, const vector<uint64_t> &input_scalars,
+                const vector<uint64_t> &scaled_input_scalars, const vector<SmallModulus> &input_moduli,
+                const vector<uint64_t> &matrix, const vector<SmallModulus> &output_moduli, int output_count, 
+                int coeff_count, uint64_t *destination, const MemoryPoolHandle &pool, 
+                const vector<double> *inv_input_moduli = nullptr)
+            {
+                int input_count = input_scalars.size();
+                int column_count = inv_input_moduli ? input_count + 1 : input_count;
+                int block_size = min(coeff_count, base_conversion_block_size);
+
+                // The scaled inputs for one block, stored so that the values for each coefficient are 
+                // consecutive and can be multiplied with a matrix row directly
+                Pointer block(allocate_uint(block_size * column_count, pool));
+                for (int block_start = 0; block_start < coeff_count; block_start += block_size)
+                {
+                    int block_count = min(block_size, coeff_count - block_start);
+                    for (int i = 0; i < input_count; i++)
+                    {
+                        const uint64_t *input_ptr = input + (i * coeff_count) + block_start;
+                        uint64_t *block_ptr = block.get() + i;
+                        uint64_t input_scalar = input_scalars[i];
+                        uint64_t scaled_input_scalar = scaled_input_scalars[i];
+                        const SmallModulus &input_modulus = input_moduli[i];
+                        for (int k = 0; k < block_count; k++, block_ptr += column_count)
+                        {
+                            *block_ptr = multiply_uint_scaled_mod(*input_ptr++, input_scalar, scaled_input_scalar, input_modulus);
+                        }
+                    }
+
+                    if (inv_input_moduli)
+                    {
+                        uint64_t *block_ptr = block.get();
+                        for (int k = 0; k < block_count; k++, block_ptr += column_count)
+                        {
+                            double overflow = 0;
+                            for (int i = 0; i < input_count; i++)
+                            {
+                                overflow += static_cast<double>(block_ptr[i]) * (*inv_input_moduli)[i];
+                            }
+                            block_ptr[input_count] = static_cast<uint64_t>(overflow + 0.5);
+                        }
+                    }
+
+                    multiply_block_matrix(block.get(), block_count, column_count, matrix.data(), 
+                        output_moduli.data(), output_count, destination + block_start, coeff_count);
+                }
+            }
+        }
+
         void BaseConverter::fastbconv(const uint64_t *input, uint64_t *destination, const MemoryPoolHandle &pool) const
         {
 #ifdef SEAL_DEBUG
@@ -408,40 +525,9 @@ namespace seal
              Require: Input in q
              Ensure: Output in Bsk = {m1,...,ml} U {msk}
             */
-            Pointer temp_coeff_transition(allocate_uint(coeff_count_ * coeff_base_mod_count_, pool));
-            for (int i = 0; i < coeff_base_mod_count_; i++)
-            {
-                uint64_t inv_coeff_base_products_mod_coeff_elt = inv_coeff_base_products_mod_coeff_array_[i];
-                SmallModulus coeff_base_array_elt = coeff_base_array_[i];
-                for (int k = 0; k < coeff_count_; k++)
-                {
-                    temp_coeff_transition[i + (k * coeff_base_mod_count_)] = multiply_uint_uint_mod(*input++,
-                        inv_coeff_base_products_mod_coeff_elt, coeff_base_array_elt);
-                }
-            }
-
-            for (int j = 0; j < bsk_base_mod_count_; j++)
-            {
-                uint64_t *temp_coeff_transition_ptr = temp_coeff_transition.get();
-                SmallModulus bsk_base_array_elt = bsk_base_array_[j];
-                for (int k = 0; k < coeff_count_; k++)
-                {
-                    const uint64_t *coeff_base_products_mod_aux_bsk_array_ptr = coeff_base_products_mod_aux_bsk_array_[j].data();
-                    uint64_t aux_transition[2]{ 0 };
-                    for (int i = 0; i < coeff_base_mod_count_; i++)
-                    {
-                        // Lazy reduction
-                        uint64_t temp[2];
-
-                        // Product is 60 bit + 61 bit = 121 bit, so can sum up to 127 of them with no reduction
-                        // Thus need coeff_base_mod_count_ <= 127 to guarantee success
-                        multiply_uint64(*temp_coeff_transition_ptr++, *coeff_base_products_mod_aux_bsk_array_ptr++, temp);
-                        unsigned char carry = add_uint64(aux_transition[0], temp[0], 0, aux_transition);
-                        aux_transition[1] += temp[1] + carry;
-                    }
-                    *destination++ = barrett_reduce_128(aux_transition, bsk_base_array_elt);
-                }
-            }
+            fast_convert_array(input, inv_coeff_base_products_mod_coeff_array_, scaled_inv_coeff_base_products_mod_coeff_array_,
+                coeff_base_array_, coeff_base_products_mod_bsk_mtilde_matrix_, bsk_mtilde_base_array_, bsk_base_mod_count_,
+                coeff_count_, destination, pool);
         }
 
         void BaseConverter::fastbconv_sk(const uint64_t *input, uint64_t *destination, const MemoryPoolHandle &pool) const
@@ -465,100 +551,36 @@ namespace seal
              Ensure: Output in base q
             */
 
-            // Fast convert B -> q
-            Pointer temp_coeff_transition(allocate_uint(coeff_count_ * coeff_base_mod_count_, pool));
-            const uint64_t *input_ptr = input;
-            for (int i = 0; i < coeff_base_mod_count_; i++)
-            {
-                uint64_t inv_aux_base_products_mod_aux_array_elt = inv_aux_base_products_mod_aux_array_[i];
-                SmallModulus aux_base_array_elt = aux_base_array_[i];
-                for (int k = 0; k < coeff_count_; k++)
-                {
-                    temp_coeff_transition[i + (k * coeff_base_mod_count_)] = multiply_uint_uint_mod(*input_ptr++, 
-                        inv_aux_base_products_mod_aux_array_elt, aux_base_array_elt);
-                }
-            }
+            // Fast convert B -> q U {m_sk}; we only use the coefficients in B
+            Pointer temp_coeff_msk(allocate_uint(coeff_count_ * (coeff_base_mod_count_ + 1), pool));
+            fast_convert_array(input, inv_aux_base_products_mod_aux_array_, scaled_inv_aux_base_products_mod_aux_array_,
+                aux_base_array_, aux_base_products_mod_coeff_msk_matrix_, coeff_msk_base_array_, coeff_base_mod_count_ + 1,
+                coeff_count_, temp_coeff_msk.get(), pool);
 
-            uint64_t *destination_ptr = destination;
-            uint64_t *temp_ptr;
-            for (int j = 0; j < coeff_base_mod_count_; j++)
-            {
-                temp_ptr = temp_coeff_transition.get();
-                SmallModulus coeff_base_array_elt = coeff_base_array_[j];
-                for (int k = 0; k < coeff_count_; k++)
-                {
-                    const uint64_t *aux_base_products_mod_coeff_array_ptr = aux_base_products_mod_coeff_array_[j].data();
-                    uint64_t aux_transition[2]{ 0 };
-                    for (int i = 0; i < aux_base_mod_count_; i++)
-                    {
-                        // Lazy reduction
-                        uint64_t temp[2];
-
-                        // Product is 61 bit + 60 bit = 121 bit, so can sum up to 127 of them with no reduction
-                        // Thus need aux_base_mod_count_ <= 127, so coeff_base_mod_count_ <= 126 to guarantee success
-                        multiply_uint64(*temp_ptr++, *aux_base_products_mod_coeff_array_ptr++, temp);
-                        unsigned char carry = add_uint64(aux_transition[0], temp[0], 0, aux_transition);
-                        aux_transition[1] += temp[1] + carry;
-                    }
-                    *destination_ptr++ = barrett_reduce_128(aux_transition, coeff_base_array_elt);
-                }
-            }
-            
             // Compute alpha_sk
-            // Require: Input is in Bsk 
-            // we only use coefficient in B 
-            // Fast convert B -> m_sk
-            Pointer tmp(allocate_uint(coeff_count_, pool));
-            destination_ptr = tmp.get();
-            temp_ptr = temp_coeff_transition.get();
-            for (int k = 0; k < coeff_count_; k++)
-            {
-                uint64_t msk_transition[2]{ 0 };
-                const uint64_t *aux_base_products_mod_msk_array_ptr = aux_base_products_mod_msk_array_.data();
-                for (int i = 0; i < aux_base_mod_count_; i++)
-                {
-                    //multiply_uint64_mod(&coeff_transition, &aux_base_products_mod_msk_array_[i], m_sk_, &msk_transition);
-                    //add_uint_uint_smallmod(&msk_transition, tmp.get() + k, m_sk_, tmp.get() + k);
-
-                    // Lazy reduction
-                    uint64_t temp[2];
-
-                    // Product is 61 bit + 61 bit = 122 bit, so can sum up to 63 of them with no reduction
-                    // Thus need aux_base_mod_count_ <= 63, so coeff_base_mod_count_ <= 62 to guarantee success
-                    // This gives the strongest restriction on the number of coeff modulus primes
-                    multiply_uint64(*temp_ptr++, *aux_base_products_mod_msk_array_ptr++, temp);
-                    unsigned char carry = add_uint64(msk_transition[0], temp[0], 0, msk_transition);
-                    msk_transition[1] += temp[1] + carry;
-                }
-                *destination_ptr++ = barrett_reduce_128(msk_transition, m_sk_);
-            }
-
             Pointer alpha_sk(allocate_uint(coeff_count_, pool));
-            input_ptr = input + (aux_base_mod_count_ * coeff_count_);
-            destination_ptr = alpha_sk.get();
-            temp_ptr = tmp.get();
+            const uint64_t *input_ptr = input + (aux_base_mod_count_ * coeff_count_);
+            const uint64_t *temp_ptr = temp_coeff_msk.get() + (coeff_base_mod_count_ * coeff_count_);
+            uint64_t *destination_ptr = alpha_sk.get();
             const uint64_t m_sk_value = m_sk_.value();
             // x_sk is allocated in input[aux_base_mod_count_]
             for (int i = 0; i < coeff_count_; i++)
             {
-                //sub_uint_uint_smallmod(tmp.get() + i, input + i + (aux_base_mod_count_ * coeff_count_), m_sk_, tmp.get() + i);
-                //multiply_uint64_mod(tmp.get() + i, &inv_aux_products_mod_msk_, m_sk_, alpha_sk.get() + i);
-
                 // It is not necessary for the negation to be reduced modulo the small prime
-                //negate_uint_smallmod(input + i + (aux_base_mod_count_ * coeff_count_), m_sk_, &negated_input);
                 uint64_t negated_input = m_sk_value - *input_ptr++;
-                *destination_ptr++ = multiply_uint_uint_mod(*temp_ptr++ + negated_input, inv_aux_products_mod_msk_, m_sk_);
+                *destination_ptr++ = multiply_uint_scaled_mod(*temp_ptr++ + negated_input, inv_aux_products_mod_msk_, 
+                    scaled_inv_aux_products_mod_msk_, m_sk_);
             }
 
             const uint64_t m_sk_div_2 = m_sk_value >> 1;
-            destination_ptr = destination;
+            const uint64_t *temp_coeff_ptr = temp_coeff_msk.get();
             for (int i = 0; i < coeff_base_mod_count_; i++)
             {
                 uint64_t aux_products_all_mod_coeff_array_elt = aux_products_all_mod_coeff_array_[i];
                 temp_ptr = alpha_sk.get();
                 SmallModulus coeff_base_array_elt = coeff_base_array_[i];
                 uint64_t coeff_base_array_elt_value = coeff_base_array_elt.value();
-                for (int k = 0; k < coeff_count_; k++, temp_ptr++, destination++)
+                for (int k = 0; k < coeff_count_; k++, temp_ptr++, temp_coeff_ptr++, destination++)
                 {
                     uint64_t m_alpha_sk[2];
 
@@ -567,7 +589,7 @@ namespace seal
                     {
                         // Lazy reduction
                         multiply_uint64(aux_products_all_mod_coeff_array_elt, m_sk_value - *temp_ptr, m_alpha_sk);
-                        m_alpha_sk[1] += add_uint64(m_alpha_sk[0], *destination, 0, m_alpha_sk);
+                        m_alpha_sk[1] += add_uint64(m_alpha_sk[0], *temp_coeff_ptr, 0, m_alpha_sk);
                         *destination = barrett_reduce_128(m_alpha_sk, coeff_base_array_elt);
                     }
                     // No correction needed
@@ -577,7 +599,7 @@ namespace seal
                         // It is not necessary for the negation to be reduced modulo the small prime
                         multiply_uint64(coeff_base_array_elt_value - aux_products_all_mod_coeff_array_elt, 
                             *temp_ptr, m_alpha_sk);
-                        m_alpha_sk[1] += add_uint64(*destination, m_alpha_sk[0], 0, m_alpha_sk);
+                        m_alpha_sk[1] += add_uint64(*temp_coeff_ptr, m_alpha_sk[0], 0, m_alpha_sk);
                         *destination = barrett_reduce_128(m_alpha_sk, coeff_base_array_elt);
                     }
                 }
@@ -605,13 +627,15 @@ namespace seal
             {
                 uint64_t coeff_products_all_mod_bsk_array_elt = coeff_products_all_mod_bsk_array_[k];
                 uint64_t inv_mtilde_mod_bsk_array_elt = inv_mtilde_mod_bsk_array_[k];
+                uint64_t scaled_inv_mtilde_mod_bsk_array_elt = scaled_inv_mtilde_mod_bsk_array_[k];
                 SmallModulus bsk_base_array_elt = bsk_base_array_[k];
                 const uint64_t *input_m_tilde_ptr_copy = input_m_tilde_ptr;
                 // Compute result for aux base
                 for (int i = 0; i < coeff_count_; i++)
                 {
                     // Compute r_mtilde
-                    uint64_t r_mtilde = multiply_uint_uint_mod(*input_m_tilde_ptr_copy++, inv_coeff_products_mod_mtilde_, m_tilde_);
+                    uint64_t r_mtilde = multiply_uint_scaled_mod(*input_m_tilde_ptr_copy++, inv_coeff_products_mod_mtilde_, 
+                        scaled_inv_coeff_products_mod_mtilde_, m_tilde_);
                     r_mtilde = negate_uint_mod(r_mtilde, m_tilde_);
 
                     // Lazy reduction
@@ -619,7 +643,8 @@ namespace seal
                     multiply_uint64(coeff_products_all_mod_bsk_array_elt, r_mtilde, tmp);
                     tmp[1] += add_uint64(tmp[0], *input++, 0, tmp);
                     r_mtilde = barrett_reduce_128(tmp, bsk_base_array_elt);
-                    *destination++ = multiply_uint_uint_mod(r_mtilde, inv_mtilde_mod_bsk_array_elt, bsk_base_array_elt);
+                    *destination++ = multiply_uint_scaled_mod(r_mtilde, inv_mtilde_mod_bsk_array_elt, 
+                        scaled_inv_mtilde_mod_bsk_array_elt, bsk_base_array_elt);
                 }
             }
         }
@@ -653,12 +678,13 @@ namespace seal
                 SmallModulus bsk_base_array_elt = bsk_base_array_[i];
                 uint64_t bsk_base_array_value = bsk_base_array_elt.value();
                 uint64_t inv_coeff_products_all_mod_aux_bsk_array_elt = inv_coeff_products_all_mod_aux_bsk_array_[i];
+                uint64_t scaled_inv_coeff_products_all_mod_aux_bsk_array_elt = scaled_inv_coeff_products_all_mod_aux_bsk_array_[i];
                 for (int k = 0; k < coeff_count_; k++, destination++)
                 {
                     // It is not necessary for the negation to be reduced modulo the small prime
-                    //negate_uint_smallmod(base_convert_Bsk.get() + k + (i * coeff_count_), bsk_base_array_[i], &negated_base_convert_Bsk);
-                    *destination = multiply_uint_uint_mod(*input++ + bsk_base_array_value - *destination, 
-                        inv_coeff_products_all_mod_aux_bsk_array_elt, bsk_base_array_elt);
+                    *destination = multiply_uint_scaled_mod(*input++ + bsk_base_array_value - *destination, 
+                        inv_coeff_products_all_mod_aux_bsk_array_elt, scaled_inv_coeff_products_all_mod_aux_bsk_array_elt,
+                        bsk_base_array_elt);
                 }
             }
         }
@@ -683,68 +709,288 @@ namespace seal
              Require: Input in q
              Ensure: Output in Bsk U {m_tilde}
             */
-            
-            // Compute in Bsk first; we compute |m_tilde*q^-1i| mod qi
-            Pointer temp_coeff_transition(allocate_uint(coeff_count_ * coeff_base_mod_count_, pool));
+
+            // We compute |m_tilde*q^-1i| mod qi and convert to Bsk U {m_tilde} at once
+            fast_convert_array(input, mtilde_inv_coeff_base_products_mod_coeff_array_, 
+                scaled_mtilde_inv_coeff_base_products_mod_coeff_array_, coeff_base_array_, 
+                coeff_base_products_mod_bsk_mtilde_matrix_, bsk_mtilde_base_array_, bsk_base_mod_count_ + 1,
+                coeff_count_, destination, pool);
+        }
+
+        void BaseConverter::fastbconv_plain_gamma(const uint64_t *input, uint64_t *destination, const MemoryPoolHandle &pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (input == nullptr)
+            {
+                throw invalid_argument("input cannot be null");
+            }
+            if (destination == nullptr)
+            {
+                throw invalid_argument("destination cannot be null");
+            }
+#endif
+            /**
+             Require: Input in q
+             Ensure: Output in t (plain modulus) U gamma 
+            */
+            fast_convert_array(input, inv_coeff_base_products_mod_coeff_array_, scaled_inv_coeff_base_products_mod_coeff_array_,
+                coeff_base_array_, coeff_base_products_mod_plain_gamma_matrix_, plain_gamma_array_, plain_gamma_count_,
+                coeff_count_, destination, pool);
+        }
+
+        HPSConverter::HPSConverter(const vector<SmallModulus> &coeff_base, int coeff_count, int coeff_power,
+            const SmallModulus &small_plain_mod, const MemoryPoolHandle &pool) : pool_(pool)
+        {
+#ifdef SEAL_DEBUG
+            if (coeff_base.size() == 0)
+            {
+                throw invalid_argument("coeff bases cannot be empty");
+            }
+#endif
+            reset();
+
+            coeff_count_ = coeff_count;
+            coeff_base_mod_count_ = coeff_base.size();
+            coeff_base_array_ = coeff_base;
+
+            // The products have absolute value at most K * n * q^2 / 4, where K takes into account cross 
+            // terms when larger size ciphertexts are used, and after scaling by t/q they must still have 
+            // a unique representative in (-P/2, P/2]. We reserve 32 bits for K * n as in BaseConverter. 
+            // All primes in P are 61 bits, so each contributes at least 60 bits to P.
+            int total_coeff_bit_count = 0;
             for (int i = 0; i < coeff_base_mod_count_; i++)
             {
-                SmallModulus coeff_base_array_elt = coeff_base_array_[i];
-                uint64_t mtilde_inv_coeff_base_products_mod_coeff_elt = mtilde_inv_coeff_base_products_mod_coeff_array_[i];
-                for (int k = 0; k < coeff_count_; k++)
+                total_coeff_bit_count += coeff_base[i].bit_count();
+            }
+            int required_bit_count = 33 + small_plain_mod.bit_count() + total_coeff_bit_count;
+            p_base_mod_count_ = (required_bit_count + 59) / 60;
+            if (p_base_mod_count_ > static_cast<int>(global_variables::internal_mods::aux_small_mods.size()))
+            {
+                reset();
+                return;
+            }
+            p_base_array_.assign(global_variables::internal_mods::aux_small_mods.begin(),
+                global_variables::internal_mods::aux_small_mods.begin() + p_base_mod_count_);
+
+            // Generate P small ntt tables which are used in Evaluator
+            for (int j = 0; j < p_base_mod_count_; j++)
+            {
+                p_small_ntt_table_.emplace_back(pool_);
+                if (!p_small_ntt_table_[j].generate(coeff_power, p_base_array_[j]))
                 {
-                    temp_coeff_transition[i + (k * coeff_base_mod_count_)] = multiply_uint_uint_mod(*input++,
-                        mtilde_inv_coeff_base_products_mod_coeff_elt, coeff_base_array_elt);
+                    reset();
+                    return;
                 }
             }
 
-            uint64_t *destination_ptr = destination;
-            for (int j = 0; j < bsk_base_mod_count_; j++)
+            // Compute the products of all but one modulus, and the product of all moduli, in q and in P
+            Pointer coeff_products_array(allocate_zero_uint(coeff_base_mod_count_ * coeff_base_mod_count_, pool_));
+            Pointer coeff_products_all(allocate_uint(coeff_base_mod_count_, pool_));
+            Pointer tmp_coeff(allocate_uint(coeff_base_mod_count_, pool_));
+            set_uint(1, coeff_base_mod_count_, coeff_products_all.get());
+            for (int i = 0; i < coeff_base_mod_count_; i++)
             {
-                const uint64_t *coeff_base_products_mod_aux_bsk_array_ptr = coeff_base_products_mod_aux_bsk_array_[j].data();
-                uint64_t *temp_coeff_transition_ptr = temp_coeff_transition.get();
-                SmallModulus bsk_base_array_elt = bsk_base_array_[j];
-                for (int k = 0; k < coeff_count_; k++)
+                coeff_products_array[i * coeff_base_mod_count_] = 1;
+                for (int j = 0; j < coeff_base_mod_count_; j++)
                 {
-                    uint64_t aux_transition[2]{ 0 };
-                    const uint64_t *temp_ptr = coeff_base_products_mod_aux_bsk_array_ptr;
-                    for (int i = 0; i < coeff_base_mod_count_; i++)
+                    if (i != j)
                     {
-                        // Lazy reduction
-                        uint64_t temp[2];
+                        multiply_uint_uint64(coeff_products_array.get() + (i * coeff_base_mod_count_), coeff_base_mod_count_,
+                            coeff_base_array_[j].value(), coeff_base_mod_count_, tmp_coeff.get());
+                        set_uint_uint(tmp_coeff.get(), coeff_base_mod_count_, coeff_products_array.get() + (i * coeff_base_mod_count_));
+                    }
+                }
+                multiply_uint_uint64(coeff_products_all.get(), coeff_base_mod_count_, coeff_base_array_[i].value(), 
+                    coeff_base_mod_count_, tmp_coeff.get());
+                set_uint_uint(tmp_coeff.get(), coeff_base_mod_count_, coeff_products_all.get());
+            }
 
-                        // Product is 60 bit + 61 bit = 121 bit, so can sum up to 127 of them with no reduction
-                        // Thus need coeff_base_mod_count_ <= 127
-                        multiply_uint64(*temp_coeff_transition_ptr++, *temp_ptr++, temp);
-                        unsigned char carry = add_uint64(aux_transition[0], temp[0], 0, aux_transition);
-                        aux_transition[1] += temp[1] + carry;
+            Pointer p_products_array(allocate_zero_uint(p_base_mod_count_ * p_base_mod_count_, pool_));
+            Pointer p_products_all(allocate_uint(p_base_mod_count_, pool_));
+            Pointer tmp_p(allocate_uint(p_base_mod_count_, pool_));
+            set_uint(1, p_base_mod_count_, p_products_all.get());
+            for (int i = 0; i < p_base_mod_count_; i++)
+            {
+                p_products_array[i * p_base_mod_count_] = 1;
+                for (int j = 0; j < p_base_mod_count_; j++)
+                {
+                    if (i != j)
+                    {
+                        multiply_uint_uint64(p_products_array.get() + (i * p_base_mod_count_), p_base_mod_count_,
+                            p_base_array_[j].value(), p_base_mod_count_, tmp_p.get());
+                        set_uint_uint(tmp_p.get(), p_base_mod_count_, p_products_array.get() + (i * p_base_mod_count_));
                     }
-                    *destination_ptr++ = barrett_reduce_128(aux_transition, bsk_base_array_elt);
                 }
+                multiply_uint_uint64(p_products_all.get(), p_base_mod_count_, p_base_array_[i].value(), 
+                    p_base_mod_count_, tmp_p.get());
+                set_uint_uint(tmp_p.get(), p_base_mod_count_, p_products_all.get());
             }
-            
-            // Computing the last element (mod m_tilde) and add it at the end of destination array
-            uint64_t *temp_coeff_transition_ptr = temp_coeff_transition.get();
-            destination += bsk_base_mod_count_ * coeff_count_;
-            for (int k = 0; k < coeff_count_; k++)
+
+            // Compute the tables for the exact conversion from q to P
+            inv_coeff_base_products_mod_coeff_array_.resize(coeff_base_mod_count_);
+            inv_coeff_base_array_.resize(coeff_base_mod_count_);
+            coeff_base_products_mod_p_matrix_.resize(p_base_mod_count_ * (coeff_base_mod_count_ + 1));
+            for (int i = 0; i < coeff_base_mod_count_; i++)
+            {
+                inv_coeff_base_products_mod_coeff_array_[i] = modulo_uint(coeff_products_array.get() + (i * coeff_base_mod_count_),
+                    coeff_base_mod_count_, coeff_base_array_[i], pool_);
+                if (!try_invert_uint_mod(inv_coeff_base_products_mod_coeff_array_[i], coeff_base_array_[i], 
+                    inv_coeff_base_products_mod_coeff_array_[i]))
+                {
+                    reset();
+                    return;
+                }
+                inv_coeff_base_array_[i] = 1.0 / static_cast<double>(coeff_base_array_[i].value());
+            }
+            for (int j = 0; j < p_base_mod_count_; j++)
             {
-                uint64_t wide_result[2]{ 0 };
-                const uint64_t *coeff_base_products_mod_mtilde_array_ptr = coeff_base_products_mod_mtilde_array_.data();
+                uint64_t *matrix_row = coeff_base_products_mod_p_matrix_.data() + (j * (coeff_base_mod_count_ + 1));
                 for (int i = 0; i < coeff_base_mod_count_; i++)
                 {
-                    // Lazy reduction
-                    uint64_t aux_transition[2];
+                    matrix_row[i] = modulo_uint(coeff_products_array.get() + (i * coeff_base_mod_count_),
+                        coeff_base_mod_count_, p_base_array_[j], pool_);
+                }
+                matrix_row[coeff_base_mod_count_] = negate_uint_mod(modulo_uint(coeff_products_all.get(), 
+                    coeff_base_mod_count_, p_base_array_[j], pool_), p_base_array_[j]);
+            }
+
+            // Compute the tables for scaling by t/q. Write x = sum_i xi*(qP/qi) + sum_j yj*(qP/pj) mod qP, 
+            // where xi = [x*(qP/qi)^(-1)]_qi and yj = [x*(qP/pj)^(-1)]_pj. Then t*x/q modulo pj equals
+            // sum_i xi*(t*P/qi) + x*t*q^(-1) up to multiples of pj. The quotients t*P/qi are split into
+            // integral parts, reduced modulo pj, and fractional parts. To keep the floating-point error 
+            // small, each xi is split further as xi = 2^30*hi + lo.
+            inv_all_products_mod_coeff_array_.resize(coeff_base_mod_count_);
+            scale_integral_mod_p_matrix_.resize(p_base_mod_count_ * (2 * coeff_base_mod_count_ + 1));
+            scale_fractional_array_.resize(2 * coeff_base_mod_count_);
+            for (int i = 0; i < coeff_base_mod_count_; i++)
+            {
+                const SmallModulus &coeff_mod = coeff_base_array_[i];
+                uint64_t p_products_all_mod_coeff = modulo_uint(p_products_all.get(), p_base_mod_count_, coeff_mod, pool_);
+                if (!try_invert_uint_mod(p_products_all_mod_coeff, coeff_mod, inv_all_products_mod_coeff_array_[i]))
+                {
+                    reset();
+                    return;
+                }
+                inv_all_products_mod_coeff_array_[i] = multiply_uint_uint_mod(inv_all_products_mod_coeff_array_[i], 
+                    inv_coeff_base_products_mod_coeff_array_[i], coeff_mod);
+
+                // The remainders of t*P and 2^30*t*P modulo qi
+                uint64_t remainder = multiply_uint_uint_mod(small_plain_mod.value() % coeff_mod.value(), 
+                    p_products_all_mod_coeff, coeff_mod);
+                uint64_t shifted_remainder = multiply_uint_uint_mod(remainder, (1ULL << 30) % coeff_mod.value(), coeff_mod);
+                scale_fractional_array_[2 * i] = static_cast<double>(shifted_remainder) / static_cast<double>(coeff_mod.value());
+                scale_fractional_array_[2 * i + 1] = static_cast<double>(remainder) / static_cast<double>(coeff_mod.value());
+
+                // Since t*P is divisible by pj, floor(t*P/qi) = -remainder * qi^(-1) mod pj
+                for (int j = 0; j < p_base_mod_count_; j++)
+                {
+                    const SmallModulus &p_mod = p_base_array_[j];
+                    uint64_t inv_coeff_mod;
+                    if (!try_invert_uint_mod(coeff_mod.value() % p_mod.value(), p_mod, inv_coeff_mod))
+                    {
+                        reset();
+                        return;
+                    }
+                    uint64_t *matrix_row = scale_integral_mod_p_matrix_.data() + (j * (2 * coeff_base_mod_count_ + 1));
+                    matrix_row[2 * i] = negate_uint_mod(multiply_uint_uint_mod(shifted_remainder % p_mod.value(), 
+                        inv_coeff_mod, p_mod), p_mod);
+                    matrix_row[2 * i + 1] = negate_uint_mod(multiply_uint_uint_mod(remainder % p_mod.value(), 
+                        inv_coeff_mod, p_mod), p_mod);
+                }
+            }
+            plain_inv_coeff_products_mod_p_array_.resize(p_base_mod_count_);
+            for (int j = 0; j < p_base_mod_count_; j++)
+            {
+                const SmallModulus &p_mod = p_base_array_[j];
 
-                    // Product is 60 bit + 33 bit = 93 bit
-                    multiply_uint64(*temp_coeff_transition_ptr++,
-                        *coeff_base_products_mod_mtilde_array_ptr++, aux_transition);
-                    unsigned char carry = add_uint64(aux_transition[0], wide_result[0], 0, wide_result);
-                    wide_result[1] += aux_transition[1] + carry;
+                // The rounded fractional part is added with coefficient one
+                scale_integral_mod_p_matrix_[(j * (2 * coeff_base_mod_count_ + 1)) + 2 * coeff_base_mod_count_] = 1;
+
+                uint64_t inv_coeff_products_all;
+                if (!try_invert_uint_mod(modulo_uint(coeff_products_all.get(), coeff_base_mod_count_, p_mod, pool_), 
+                    p_mod, inv_coeff_products_all))
+                {
+                    reset();
+                    return;
                 }
-                *destination++ = barrett_reduce_128(wide_result, m_tilde_);
+                plain_inv_coeff_products_mod_p_array_[j] = multiply_uint_uint_mod(small_plain_mod.value() % p_mod.value(),
+                    inv_coeff_products_all, p_mod);
+            }
+
+            // Compute the tables for the exact conversion from P to q
+            inv_p_base_products_mod_p_array_.resize(p_base_mod_count_);
+            inv_p_base_array_.resize(p_base_mod_count_);
+            p_base_products_mod_coeff_matrix_.resize(coeff_base_mod_count_ * (p_base_mod_count_ + 1));
+            for (int j = 0; j < p_base_mod_count_; j++)
+            {
+                inv_p_base_products_mod_p_array_[j] = modulo_uint(p_products_array.get() + (j * p_base_mod_count_),
+                    p_base_mod_count_, p_base_array_[j], pool_);
+                if (!try_invert_uint_mod(inv_p_base_products_mod_p_array_[j], p_base_array_[j], 
+                    inv_p_base_products_mod_p_array_[j]))
+                {
+                    reset();
+                    return;
+                }
+                inv_p_base_array_[j] = 1.0 / static_cast<double>(p_base_array_[j].value());
+            }
+            for (int i = 0; i < coeff_base_mod_count_; i++)
+            {
+                uint64_t *matrix_row = p_base_products_mod_coeff_matrix_.data() + (i * (p_base_mod_count_ + 1));
+                for (int j = 0; j < p_base_mod_count_; j++)
+                {
+                    matrix_row[j] = modulo_uint(p_products_array.get() + (j * p_base_mod_count_),
+                        p_base_mod_count_, coeff_base_array_[i], pool_);
+                }
+                matrix_row[p_base_mod_count_] = negate_uint_mod(modulo_uint(p_products_all.get(), 
+                    p_base_mod_count_, coeff_base_array_[i], pool_), coeff_base_array_[i]);
+            }
+
+            // Compute the scaled versions of the constants that inputs are multiplied with
+            for (int i = 0; i < coeff_base_mod_count_; i++)
+            {
+                scaled_inv_coeff_base_products_mod_coeff_array_.push_back(
+                    scale_uint_mod(inv_coeff_base_products_mod_coeff_array_[i], coeff_base_array_[i]));
+                scaled_inv_all_products_mod_coeff_array_.push_back(
+                    scale_uint_mod(inv_all_products_mod_coeff_array_[i], coeff_base_array_[i]));
+            }
+            for (int j = 0; j < p_base_mod_count_; j++)
+            {
+                scaled_plain_inv_coeff_products_mod_p_array_.push_back(
+                    scale_uint_mod(plain_inv_coeff_products_mod_p_array_[j], p_base_array_[j]));
+                scaled_inv_p_base_products_mod_p_array_.push_back(
+                    scale_uint_mod(inv_p_base_products_mod_p_array_[j], p_base_array_[j]));
             }
+
+            // Everything went well
+            generated_ = true;
         }
 
-        void BaseConverter::fastbconv_plain_gamma(const uint64_t *input, uint64_t *destination, const MemoryPoolHandle &pool) const
+        void HPSConverter::reset()
+        {
+            generated_ = false;
+            coeff_base_array_.clear();
+            p_base_array_.clear();
+            inv_coeff_base_products_mod_coeff_array_.clear();
+            scaled_inv_coeff_base_products_mod_coeff_array_.clear();
+            inv_coeff_base_array_.clear();
+            coeff_base_products_mod_p_matrix_.clear();
+            inv_all_products_mod_coeff_array_.clear();
+            scaled_inv_all_products_mod_coeff_array_.clear();
+            scale_integral_mod_p_matrix_.clear();
+            scale_fractional_array_.clear();
+            plain_inv_coeff_products_mod_p_array_.clear();
+            scaled_plain_inv_coeff_products_mod_p_array_.clear();
+            inv_p_base_products_mod_p_array_.clear();
+            scaled_inv_p_base_products_mod_p_array_.clear();
+            inv_p_base_array_.clear();
+            p_base_products_mod_coeff_matrix_.clear();
+            p_small_ntt_table_.clear();
+            coeff_count_ = 0;
+            coeff_base_mod_count_ = 0;
+            p_base_mod_count_ = 0;
+        }
+
+        void HPSConverter::exact_convert_q_to_p(const uint64_t *input, uint64_t *destination, const MemoryPoolHandle &pool) const
         {
 #ifdef SEAL_DEBUG
             if (input == nullptr)
@@ -755,73 +1001,131 @@ namespace seal
             {
                 throw invalid_argument("destination cannot be null");
             }
+            if (!pool)
+            {
+                throw invalid_argument("pool is not initialied");
+            }
+            if (!generated_)
+            {
+                throw logic_error("HPSConverter is not generated");
+            }
 #endif
             /**
              Require: Input in q
-             Ensure: Output in t (plain modulus) U gamma 
+             Ensure: Output in P
             */
-            //for (int k = 0; k < coeff_count_; k++)
-            //{
-            //    uint64_t wide_result[4]{ 0 };
-            //    for (int i = 0; i < coeff_base_mod_count_; i++)
-            //    {
-            //        uint64_t temp_coeff_transition = multiply_uint_uint_mod(input[k + (i * coeff_count_)], 
-            //            inv_coeff_base_products_mod_coeff_array_[i], coeff_base_array_[i]);
-            //        
-            //        for (int j = 0; j < plain_gamma_count_; j++)
-            //        {
-            //            // Lazy reduction
-            //            uint64_t plain_transition[2];
-
-            //            // Product is 60 bit + 61 bit = 121 bit, so can sum up to 127 of them with no reduction
-            //            // Thus need coeff_base_mod_count_ <= 127
-            //            multiply_uint64(temp_coeff_transition, coeff_products_mod_plain_gamma_array_[i][j], plain_transition);
-            //            unsigned char carry = add_uint64(plain_transition[0], wide_result[2 * j], 0, wide_result + (2 * j));
-            //            wide_result[2 * j + 1] += plain_transition[1] + carry;
-            //        }
-            //    }
-
-            //    for (int j = 0; j < plain_gamma_count_; j++)
-            //    {
-            //        destination[k + (j * coeff_count_)] = barrett_reduce_128(wide_result + (2 * j), plain_gamma_array_[j]);
-            //    }
-            //}
-
-            Pointer temp_coeff_transition(allocate_uint(coeff_count_ * coeff_base_mod_count_, pool));
-            for (int i = 0; i < coeff_base_mod_count_; i++)
+            fast_convert_array(input, inv_coeff_base_products_mod_coeff_array_, scaled_inv_coeff_base_products_mod_coeff_array_,
+                coeff_base_array_, coeff_base_products_mod_p_matrix_, p_base_array_, p_base_mod_count_,
+                coeff_count_, destination, pool, &inv_coeff_base_array_);
+        }
+
+        void HPSConverter::scale_and_round(const uint64_t *input, uint64_t *destination, const MemoryPoolHandle &pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (input == nullptr)
             {
-                uint64_t inv_coeff_base_products_mod_coeff_elt = inv_coeff_base_products_mod_coeff_array_[i];
-                SmallModulus coeff_base_array_elt = coeff_base_array_[i];
-                for (int k = 0; k < coeff_count_; k++)
-                {
-                    temp_coeff_transition[i + (k * coeff_base_mod_count_)] = multiply_uint_uint_mod(*input++,
-                        inv_coeff_base_products_mod_coeff_elt, coeff_base_array_elt);
-                }
+                throw invalid_argument("input cannot be null");
+            }
+            if (destination == nullptr)
+            {
+                throw invalid_argument("destination cannot be null");
+            }
+            if (!pool)
+            {
+                throw invalid_argument("pool is not initialied");
             }
+            if (!generated_)
+            {
+                throw logic_error("HPSConverter is not generated");
+            }
+#endif
+            /**
+             Require: Input in q U P
+             Ensure: Output in P
+            */
+            int column_count = 2 * coeff_base_mod_count_ + 1;
+            int block_size = min(coeff_count_, base_conversion_block_size);
+            const uint64_t low_mask = (1ULL << 30) - 1;
 
-            for (int j = 0; j < plain_gamma_count_; j++)
+            // For each coefficient the block holds the high and low parts of [x*(qP/qi)^(-1)]_qi for 
+            // each qi, followed by the rounded sum of the fractional parts
+            Pointer block(allocate_uint(block_size * column_count, pool));
+            for (int block_start = 0; block_start < coeff_count_; block_start += block_size)
             {
-                SmallModulus plain_gamma_array_elt = plain_gamma_array_[j];
-                uint64_t *temp_coeff_transition_ptr = temp_coeff_transition.get();
-                const uint64_t *coeff_products_mod_plain_gamma_array_ptr = coeff_products_mod_plain_gamma_array_[j].data();
-                for (int k = 0; k < coeff_count_; k++)
+                int block_count = min(block_size, coeff_count_ - block_start);
+                for (int i = 0; i < coeff_base_mod_count_; i++)
                 {
-                    uint64_t wide_result[2]{ 0 };
-                    const uint64_t *temp_ptr = coeff_products_mod_plain_gamma_array_ptr;
-                    for (int i = 0; i < coeff_base_mod_count_; i++)
+                    const uint64_t *input_ptr = input + (i * coeff_count_) + block_start;
+                    uint64_t *block_ptr = block.get() + (2 * i);
+                    uint64_t input_scalar = inv_all_products_mod_coeff_array_[i];
+                    uint64_t scaled_input_scalar = scaled_inv_all_products_mod_coeff_array_[i];
+                    const SmallModulus &coeff_mod = coeff_base_array_[i];
+                    for (int k = 0; k < block_count; k++, block_ptr += column_count)
                     {
-                        uint64_t plain_transition[2];
+                        uint64_t value = multiply_uint_scaled_mod(*input_ptr++, input_scalar, scaled_input_scalar, coeff_mod);
+                        block_ptr[0] = value >> 30;
+                        block_ptr[1] = value & low_mask;
+                    }
+                }
 
-                        // Lazy reduction
-                        // Product is 60 bit + 61 bit = 121 bit, so can sum up to 127 of them with no reduction
-                        // Thus need coeff_base_mod_count_ <= 127
-                        multiply_uint64(*temp_coeff_transition_ptr++, *temp_ptr++, plain_transition);
-                        unsigned char carry = add_uint64(plain_transition[0], wide_result[0], 0, wide_result);
-                        wide_result[1] += plain_transition[1] + carry;
+                // Each term is less than 2^30, so the error in the sum is far below 1/2
+                uint64_t *block_ptr = block.get();
+                for (int k = 0; k < block_count; k++, block_ptr += column_count)
+                {
+                    double fractional_sum = 0;
+                    for (int i = 0; i < 2 * coeff_base_mod_count_; i++)
+                    {
+                        fractional_sum += static_cast<double>(block_ptr[i]) * scale_fractional_array_[i];
                     }
-                    *destination++ = barrett_reduce_128(wide_result, plain_gamma_array_elt);
+                    block_ptr[2 * coeff_base_mod_count_] = static_cast<uint64_t>(fractional_sum + 0.5);
                 }
+
+                multiply_block_matrix(block.get(), block_count, column_count, scale_integral_mod_p_matrix_.data(),
+                    p_base_array_.data(), p_base_mod_count_, destination + block_start, coeff_count_);
             }
+
+            // Add the contribution of the input in P
+            input += coeff_base_mod_count_ * coeff_count_;
+            for (int j = 0; j < p_base_mod_count_; j++)
+            {
+                const SmallModulus &p_mod = p_base_array_[j];
+                uint64_t plain_inv_coeff_products = plain_inv_coeff_products_mod_p_array_[j];
+                uint64_t scaled_plain_inv_coeff_products = scaled_plain_inv_coeff_products_mod_p_array_[j];
+                for (int k = 0; k < coeff_count_; k++, destination++)
+                {
+                    *destination = add_uint_uint_mod(*destination, multiply_uint_scaled_mod(*input++, 
+                        plain_inv_coeff_products, scaled_plain_inv_coeff_products, p_mod), p_mod);
+                }
+            }
+        }
+
+        void HPSConverter::exact_convert_p_to_q(const uint64_t *input, uint64_t *destination, const MemoryPoolHandle &pool) const
+        {
+#ifdef SEAL_DEBUG
+            if (input == nullptr)
+            {
+                throw invalid_argument("input cannot be null");
+            }
+            if (destination == nullptr)
+            {
+                throw invalid_argument("destination cannot be null");
+            }
+            if (!pool)
+            {
+                throw invalid_argument("pool is not initialied");
+            }
+            if (!generated_)
+            {
+                throw logic_error("HPSConverter is not generated");
+            }
+#endif
+            /**
+             Require: Input in P
+             Ensure: Output in q
+            */
+            fast_convert_array(input, inv_p_base_products_mod_p_array_, scaled_inv_p_base_products_mod_p_array_,
+                p_base_array_, p_base_products_mod_coeff_matrix_, coeff_base_array_, coeff_base_mod_count_,
+                coeff_count_, destination, pool, &inv_p_base_array_);
         }
     }
 }
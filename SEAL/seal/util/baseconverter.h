@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <vector>
 #include "seal/util/mempool.h"
 #include "seal/memorypoolhandle.h"
 #include "seal/smallmodulus.h"
@@ -147,36 +148,54 @@ namespace seal
 
             // Array of plain modulus U gamma
             std::vector<SmallModulus> plain_gamma_array_;
+
+            // Array of Bsk U {m_tilde} moduli
+            std::vector<SmallModulus> bsk_mtilde_base_array_;
+
+            // Array of coefficient U {m_sk_} moduli
+            std::vector<SmallModulus> coeff_msk_base_array_;
             
-            // Matrix which contains the products of coeff moduli mod aux
-            std::vector<std::vector<std::uint64_t> > coeff_base_products_mod_aux_bsk_array_;
+            // Matrix of coeff moduli products mod each modulus in Bsk U {m_tilde}, with one row per modulus
+            std::vector<std::uint64_t> coeff_base_products_mod_bsk_mtilde_matrix_;
 
             // Array of inverse coeff modulus products mod each small coeff mods 
             std::vector<std::uint64_t> inv_coeff_base_products_mod_coeff_array_;
 
-            // Array of coeff moduli products mod m_tilde
-            std::vector<std::uint64_t> coeff_base_products_mod_mtilde_array_;
+            // Shoup constant of each entry of inv_coeff_base_products_mod_coeff_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_inv_coeff_base_products_mod_coeff_array_;
 
             // Array of coeff modulus products times m_tilda mod each coeff modulus 
             std::vector<std::uint64_t> mtilde_inv_coeff_base_products_mod_coeff_array_;
+
+            // Shoup constant of each entry of mtilde_inv_coeff_base_products_mod_coeff_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_mtilde_inv_coeff_base_products_mod_coeff_array_;
             
             // Matrix of the inversion of coeff modulus products mod each auxiliary mods
             std::vector<std::uint64_t> inv_coeff_products_all_mod_aux_bsk_array_;
+
+            // Shoup constant of each entry of inv_coeff_products_all_mod_aux_bsk_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_inv_coeff_products_all_mod_aux_bsk_array_;
             
-            // Matrix of auxiliary mods products mod each coeff modulus 
-            std::vector<std::vector<std::uint64_t> > aux_base_products_mod_coeff_array_;
+            // Matrix of auxiliary mods products mod each coeff modulus and m_sk_, with one row per modulus
+            std::vector<std::uint64_t> aux_base_products_mod_coeff_msk_matrix_;
 
             // Array of inverse auxiliary mod products mod each auxiliary mods 
             std::vector<std::uint64_t> inv_aux_base_products_mod_aux_array_;
 
-            // Array of auxiliary bases products mod m_sk_
-            std::vector<std::uint64_t> aux_base_products_mod_msk_array_;
+            // Shoup constant of each entry of inv_aux_base_products_mod_aux_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_inv_aux_base_products_mod_aux_array_;
 
             // Coeff moduli products inverse mod m_tilde 
             std::uint64_t inv_coeff_products_mod_mtilde_ = 0;
 
+            // Shoup constant of inv_coeff_products_mod_mtilde_ for multiply_uint_scaled_mod
+            std::uint64_t scaled_inv_coeff_products_mod_mtilde_ = 0;
+
             // Auxiliary base products mod m_sk_  (m1*m2*...*ml)-1 mod m_sk
             std::uint64_t inv_aux_products_mod_msk_ = 0;
+
+            // Shoup constant of inv_aux_products_mod_msk_ for multiply_uint_scaled_mod
+            std::uint64_t scaled_inv_aux_products_mod_msk_ = 0;
             
             // Gamma inverse mod plain modulus
             std::uint64_t inv_gamma_mod_plain_ = 0;
@@ -187,11 +206,14 @@ namespace seal
             // Array of m_tilde inverse mod Bsk = m U {msk}
             std::vector<std::uint64_t> inv_mtilde_mod_bsk_array_;
 
+            // Shoup constant of each entry of inv_mtilde_mod_bsk_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_inv_mtilde_mod_bsk_array_;
+
             // Array of all coeff base products mod Bsk
             std::vector<std::uint64_t> coeff_products_all_mod_bsk_array_;
 
-            // Matrix of coeff base product mod plain modulus and gamma
-            std::vector<std::vector<std::uint64_t> > coeff_products_mod_plain_gamma_array_;
+            // Matrix of coeff base product mod plain modulus and gamma, with one row per modulus
+            std::vector<std::uint64_t> coeff_base_products_mod_plain_gamma_matrix_;
 
             // Array of negative inverse all coeff base product mod plain modulus and gamma
             std::vector<std::uint64_t> neg_inv_coeff_products_all_mod_plain_gamma_array_;
@@ -210,5 +232,138 @@ namespace seal
 
             SmallModulus gamma_;
         };
+
+        class HPSConverter
+        {
+        public:
+            HPSConverter(const MemoryPoolHandle &pool = MemoryPoolHandle::Global()) :
+                pool_(pool)
+            {
+            }
+
+            /**
+            Performs the pre-computations for the RNS variant of multiplication described in 
+            "An Improved RNS Variant of the BFV Homomorphic Encryption Scheme" by Halevi, Polyakov, 
+            and Shoup. Ciphertexts are extended exactly from the coefficient modulus q to an auxiliary 
+            base P, multiplied in q U P, scaled by t/q into P using floating-point arithmetic for the 
+            rounding, and finally converted exactly back to q. The base P is chosen large enough to 
+            hold the scaled product.
+            */
+            HPSConverter(const std::vector<SmallModulus> &coeff_base, int coeff_count, int coeff_power,
+                const SmallModulus &small_plain_mod, const MemoryPoolHandle &pool = MemoryPoolHandle::Global());
+
+            HPSConverter(const HPSConverter &copy) = default;
+
+            HPSConverter(HPSConverter &&source) = default;
+
+            HPSConverter &operator =(const HPSConverter &assign) = default;
+
+            HPSConverter &operator =(HPSConverter &&assign) = default;
+
+            /**
+            Exact base converter from q to P, using the representative in (-q/2, q/2]
+            */
+            void exact_convert_q_to_p(const std::uint64_t *input, std::uint64_t *destination, const MemoryPoolHandle &pool) const;
+
+            /**
+            Computes round(t/q * x) in P for an input x in q U P
+            */
+            void scale_and_round(const std::uint64_t *input, std::uint64_t *destination, const MemoryPoolHandle &pool) const;
+
+            /**
+            Exact base converter from P to q, using the representative in (-P/2, P/2]
+            */
+            void exact_convert_p_to_q(const std::uint64_t *input, std::uint64_t *destination, const MemoryPoolHandle &pool) const;
+
+            void reset();
+
+            inline bool is_generated() const
+            {
+                return generated_;
+            }
+
+            inline int coeff_base_mod_count() const
+            {
+                return coeff_base_mod_count_;
+            }
+
+            inline int p_base_mod_count() const
+            {
+                return p_base_mod_count_;
+            }
+
+            inline const std::vector<SmallModulus> &get_p_mod_array() const
+            {
+                return p_base_array_;
+            }
+
+            inline const std::vector<util::SmallNTTTables> &get_p_small_ntt_table() const
+            {
+                return p_small_ntt_table_;
+            }
+
+        private:
+            MemoryPoolHandle pool_;
+
+            bool generated_ = false;
+
+            int coeff_base_mod_count_ = 0;
+
+            int p_base_mod_count_ = 0;
+
+            int coeff_count_ = 0;
+
+            // Array of coefficient small moduli
+            std::vector<SmallModulus> coeff_base_array_;
+
+            // Array of moduli in P
+            std::vector<SmallModulus> p_base_array_;
+
+            // Array of inverse coeff modulus products mod each coeff modulus (q/qi)^(-1) mod qi
+            std::vector<std::uint64_t> inv_coeff_base_products_mod_coeff_array_;
+
+            // Shoup constant of each entry of inv_coeff_base_products_mod_coeff_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_inv_coeff_base_products_mod_coeff_array_;
+
+            // Array of 1/qi
+            std::vector<double> inv_coeff_base_array_;
+
+            // Matrix of (q/qi) mod pj, with one row per modulus in P and a last column of -q mod pj
+            std::vector<std::uint64_t> coeff_base_products_mod_p_matrix_;
+
+            // Array of inverse products of all moduli in q U P mod each coeff modulus (qP/qi)^(-1) mod qi
+            std::vector<std::uint64_t> inv_all_products_mod_coeff_array_;
+
+            // Shoup constant of each entry of inv_all_products_mod_coeff_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_inv_all_products_mod_coeff_array_;
+
+            // Matrix with one row per modulus in P, holding floor(2^30*t*P/qi) mod pj and floor(t*P/qi) mod pj 
+            // alternately, and a last column of ones
+            std::vector<std::uint64_t> scale_integral_mod_p_matrix_;
+
+            // Fractional parts of 2^30*t*P/qi and t*P/qi, alternately
+            std::vector<double> scale_fractional_array_;
+
+            // Array of t*q^(-1) mod pj
+            std::vector<std::uint64_t> plain_inv_coeff_products_mod_p_array_;
+
+            // Shoup constant of each entry of plain_inv_coeff_products_mod_p_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_plain_inv_coeff_products_mod_p_array_;
+
+            // Array of inverse P products mod each modulus in P (P/pj)^(-1) mod pj
+            std::vector<std::uint64_t> inv_p_base_products_mod_p_array_;
+
+            // Shoup constant of each entry of inv_p_base_products_mod_p_array_ for multiply_uint_scaled_mod
+            std::vector<std::uint64_t> scaled_inv_p_base_products_mod_p_array_;
+
+            // Array of 1/pj
+            std::vector<double> inv_p_base_array_;
+
+            // Matrix of (P/pj) mod qi, with one row per coeff modulus and a last column of -P mod qi
+            std::vector<std::uint64_t> p_base_products_mod_coeff_matrix_;
+
+            // Array of small NTT tables for moduli in P
+            std::vector<SmallNTTTables> p_small_ntt_table_;
+        };
     }
 }
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include "seal/util/common.h"
+#include "seal/util/defines.h"
+#include "seal/util/uintcore.h"
+
+namespace seal
+{
+    namespace util
+    {
+        // Returns the number of uint64 words that count values of bit_count bits each take
+        // when packed
+        inline int get_packed_uint64_count(int count, int bit_count)
+        {
+            return static_cast<int>((static_cast<std::int64_t>(count) * bit_count + bits_per_uint64 - 1) / bits_per_uint64);
+        }
+
+        // Returns the number of bytes that count values of bit_count bits each take when
+        // packed; the bytes are a prefix of the packed uint64 words on little-endian platforms
+        inline int get_packed_byte_count(int count, int bit_count)
+        {
+            return static_cast<int>((static_cast<std::int64_t>(count) * bit_count + bits_per_byte - 1) / bits_per_byte);
+        }
+
+        // Writes the lowest bit_count bits of each value consecutively, starting from the
+        // least significant bit of the first destination word. The values must be less than
+        // 2^bit_count, and the unused high bits of the last word are set to zero.
+        inline void pack_uint64(const std::uint64_t *values, int count, int bit_count, std::uint64_t *destination)
+        {
+#ifdef SEAL_DEBUG
+            if (values == nullptr && count > 0)
+            {
+                throw std::invalid_argument("values");
+            }
+            if (bit_count < 0 || bit_count > bits_per_uint64)
+            {
+                throw std::invalid_argument("bit_count");
+            }
+            if (destination == nullptr && count > 0 && bit_count > 0)
+            {
+                throw std::invalid_argument("destination");
+            }
+#endif
+            if (bit_count == bits_per_uint64)
+            {
+                set_uint_uint(values, count, destination);
+                return;
+            }
+            if (bit_count == 0)
+            {
+                return;
+            }
+            std::uint64_t buffer = 0;
+            int buffer_bit_count = 0;
+            for (int i = 0; i < count; i++)
+            {
+                std::uint64_t value = values[i];
+                buffer |= value << buffer_bit_count;
+                buffer_bit_count += bit_count;
+                if (buffer_bit_count >= bits_per_uint64)
+                {
+                    *destination++ = buffer;
+                    buffer_bit_count -= bits_per_uint64;
+
+                    // The bits of value that did not fit, if any
+                    buffer = buffer_bit_count ? value >> (bit_count - buffer_bit_count) : 0;
+                }
+            }
+            if (buffer_bit_count)
+            {
+                *destination = buffer;
+            }
+        }
+
+        // Reads count values of bit_count bits each, as written by pack_uint64
+        inline void unpack_uint64(const std::uint64_t *source, int count, int bit_count, std::uint64_t *values)
+        {
+#ifdef SEAL_DEBUG
+            if (source == nullptr && count > 0 && bit_count > 0)
+            {
+                throw std::invalid_argument("source");
+            }
+            if (bit_count < 0 || bit_count > bits_per_uint64)
+            {
+                throw std::invalid_argument("bit_count");
+            }
+            if (values == nullptr && count > 0)
+            {
+                throw std::invalid_argument("values");
+            }
+#endif
+            if (bit_count == bits_per_uint64)
+            {
+                set_uint_uint(source, count, values);
+                return;
+            }
+            if (bit_count == 0)
+            {
+                set_zero_uint(count, values);
+                return;
+            }
+            std::uint64_t mask = (static_cast<std::uint64_t>(1) << bit_count) - 1;
+            int bit_index = 0;
+            for (int i = 0; i < count; i++)
+            {
+                std::uint64_t value = *source >> bit_index;
+                bit_index += bit_count;
+                if (bit_index >= bits_per_uint64)
+                {
+                    bit_index -= bits_per_uint64;
+                    source++;
+
+                    // The bits of the value that continue in the next word, if any
+                    if (bit_index)
+                    {
+                        value |= *source << (bit_count - bit_index);
+                    }
+                }
+                values[i] = value & mask;
+            }
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#include "seal/util/cpufeatures.h"
+#include "seal/util/defines.h"
+#include <atomic>
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            SIMDLevel detect_cpu_simd_level()
+            {
+#if defined(SEAL_ENABLE_AVX512F) || defined(SEAL_ENABLE_AVX2)
+                __builtin_cpu_init();
+#endif
+#ifdef SEAL_ENABLE_AVX512F
+                if (__builtin_cpu_supports("avx512f"))
+                {
+                    return SIMDLevel::avx512f;
+                }
+#endif
+#ifdef SEAL_ENABLE_AVX2
+                if (__builtin_cpu_supports("avx2"))
+                {
+                    return SIMDLevel::avx2;
+                }
+#endif
+                return SIMDLevel::none;
+            }
+
+            atomic<int> max_simd_level(static_cast<int>(SIMDLevel::avx512f));
+        }
+
+        SIMDLevel get_cpu_simd_level()
+        {
+            static const SIMDLevel cpu_level = detect_cpu_simd_level();
+            return cpu_level;
+        }
+
+        SIMDLevel get_simd_level()
+        {
+            int cpu_level = static_cast<int>(get_cpu_simd_level());
+            int cap = max_simd_level.load(memory_order_relaxed);
+            return static_cast<SIMDLevel>(cpu_level < cap ? cpu_level : cap);
+        }
+
+        void set_max_simd_level(SIMDLevel level)
+        {
+            max_simd_level.store(static_cast<int>(level), memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Vector instruction set levels that SEAL can dispatch kernels to. The levels are
+        ordered, so that a kernel requiring a given level can run on any higher level.
+        */
+        enum class SIMDLevel : int
+        {
+            none = 0,
+            avx2 = 1,
+            avx512f = 2
+        };
+
+        /**
+        Returns the highest SIMDLevel that is both compiled into the library (see
+        SEAL_ENABLE_AVX2 and SEAL_ENABLE_AVX512F in config.h) and supported by the
+        processor that is currently running. The processor is queried only once.
+        */
+        SIMDLevel get_cpu_simd_level();
+
+        /**
+        Returns the SIMDLevel that vectorized kernels should dispatch to. This is the
+        smaller of get_cpu_simd_level() and the cap set by set_max_simd_level(...).
+        */
+        SIMDLevel get_simd_level();
+
+        /**
+        Caps the SIMDLevel used by vectorized kernels. Setting the cap to SIMDLevel::none
+        forces the scalar code paths, which is useful for testing and benchmarking. The
+        cap is global and affects all threads.
+
+        @param[in] level The highest SIMDLevel that kernels are allowed to use
+        */
+        void set_max_simd_level(SIMDLevel level);
+    }
+}
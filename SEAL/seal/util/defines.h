@@ -159,7 +159,7 @@
 #endif //SEAL_ENABLE__ADDCARRY_U64
 
 #ifdef SEAL_ENABLE__SUBBORROW_U64
-#if (__GNUC__ == 7) && (__GNUC_MINOR__ >= 2)
+#if (__GNUC__ > 7) || ((__GNUC__ == 7) && (__GNUC_MINOR__ >= 2))
 // The inverted arguments problem was fixed in GCC-7.2 
 // (https://patchwork.ozlabs.org/patch/784309/)
 #define SEAL_SUB_BORROW_UINT64(operand1, operand2, borrow, result) _subborrow_u64(  \
@@ -174,7 +174,7 @@
     static_cast<unsigned long long>(operand2),                                      \
     static_cast<unsigned long long>(operand1),                                      \
     reinterpret_cast<unsigned long long*>(result))
-#endif //(__GNUC__ == 7) && (__GNUC_MINOR__ >= 2)
+#endif //(__GNUC__ > 7) || ((__GNUC__ == 7) && (__GNUC_MINOR__ >= 2))
 #endif //SEAL_ENABLE__SUBBORROW_U64
 
 #endif //SEAL_ENABLE_INTRIN
@@ -127,5 +127,43 @@ namespace seal
             sha3_block = sha3_zero_block;
             sponge_squeeze(state, sha3_block);
         }
+
+        Shake256Stream::Shake256Stream(const uint64_t *seed, int uint64_count)
+        {
+#ifdef SEAL_DEBUG
+            if (seed == nullptr && uint64_count > 0)
+            {
+                throw invalid_argument("seed cannot be null");
+            }
+            if (uint64_count < 0)
+            {
+                throw invalid_argument("uint64_count cannot be negative");
+            }
+#endif
+            // Padding with the SHAKE domain separation bits
+            int rate_uint64_count = HashFunction::sha3_rate_uint64_count;
+            int padded_uint64_count = rate_uint64_count * ((uint64_count / rate_uint64_count) + 1);
+            Pointer padded_seed(global_variables::global_memory_pool->get_for_uint64_count(padded_uint64_count));
+            memcpy(padded_seed.get(), seed, uint64_count * bytes_per_uint64);
+            for (int i = uint64_count; i < padded_uint64_count; i++)
+            {
+                padded_seed[i] = 0;
+                if (i == uint64_count)
+                {
+                    padded_seed[i] |= 0x1FULL;
+                }
+                if (i == padded_uint64_count - 1)
+                {
+                    padded_seed[i] |= 0x1ULL << 63;
+                }
+            }
+
+            // Absorb; the state then holds the first block of output
+            memset(state_, 0, HashFunction::sha3_state_uint64_count * bytes_per_uint64);
+            for (int i = 0; i < padded_uint64_count; i += rate_uint64_count)
+            {
+                HashFunction::sponge_absorb(padded_seed.get() + i, state_);
+            }
+        }
     }
 }
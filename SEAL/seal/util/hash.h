@@ -26,6 +26,8 @@ namespace seal
             }
 
         private:
+            friend class Shake256Stream;
+
             static const std::uint8_t sha3_round_count = 24;
 
             static const std::uint8_t sha3_rate_uint64_count = 17; // Rate 1088 = 17 * 64 bits
@@ -102,5 +104,31 @@ namespace seal
                 sha3_block[3] = sha3_state[3][0];
             }
         };
+
+        // Expands a seed into a deterministic stream of pseudo-random 64-bit words with the 
+        // SHAKE256 extendable-output function. The words are the little-endian 64-bit blocks of
+        // the SHAKE256 output on the little-endian bytes of the seed.
+        class Shake256Stream
+        {
+        public:
+            Shake256Stream(const std::uint64_t *seed, int uint64_count);
+
+            inline std::uint64_t generate()
+            {
+                if (index_ == HashFunction::sha3_rate_uint64_count)
+                {
+                    HashFunction::keccak_1600(state_);
+                    index_ = 0;
+                }
+                std::uint64_t result = state_[index_ % 5][index_ / 5];
+                index_++;
+                return result;
+            }
+
+        private:
+            HashFunction::sha3_state_type state_;
+
+            int index_ = 0;
+        };
     }
 }
\ No newline at end of file
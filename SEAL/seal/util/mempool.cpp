@@ -1,5 +1,9 @@
 #include <cstring>
 #include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <new>
+#include <unordered_map>
 #include "seal/util/mempool.h"
 
 using namespace std;
@@ -8,20 +12,391 @@ namespace seal
 {
     namespace util
     {
+        namespace
+        {
+            // Upper bound on the bytes a thread keeps cached for one size class
+            const uint64_t thread_cache_bin_byte_limit = 1 << 20;
+
+            const uint64_t thread_cache_bin_min_count = 2;
+
+            const uint64_t thread_cache_bin_max_count = 64;
+        }
+
+        struct ThreadCacheBin
+        {
+            MemoryPoolHeadMT *head = nullptr;
+
+            MemoryPoolItem *first = nullptr;
+
+            uint64_t count = 0;
+
+            uint64_t capacity = 0;
+        };
+
+        // One thread's cache for one pool. The owning thread holds the flag while it uses the
+        // bins, and a thread trimming the pool holds it while it takes the blocks back; the 
+        // flag is almost never contended.
+        struct ThreadPoolCache
+        {
+            shared_ptr<MemoryPoolControl> control;
+
+            atomic<bool> locked{ false };
+
+            // Bins keyed by uint64_count
+            unordered_map<uint64_t, ThreadCacheBin> bins;
+
+            inline void lock()
+            {
+                while (locked.exchange(true, memory_order_acquire))
+                {
+                }
+            }
+
+            inline void unlock()
+            {
+                locked.store(false, memory_order_release);
+            }
+
+            ThreadCacheBin &bin(uint64_t uint64_count)
+            {
+                auto it = bins.find(uint64_count);
+                if (it != bins.end())
+                {
+                    return it->second;
+                }
+                ThreadCacheBin &new_bin = bins[uint64_count];
+                uint64_t capacity = thread_cache_bin_byte_limit / (uint64_count * bytes_per_uint64);
+                new_bin.capacity = max(thread_cache_bin_min_count, min(thread_cache_bin_max_count, capacity));
+                return new_bin;
+            }
+        };
+
+        namespace
+        {
+            void delete_items(MemoryPoolItem *first)
+            {
+                while (first != nullptr)
+                {
+                    MemoryPoolItem *next = first->next();
+                    delete first;
+                    first = next;
+                }
+            }
+
+            // Hands every cached block back to its head, or frees the items if the pool is gone
+            void flush(ThreadPoolCache &pool)
+            {
+                ReaderLock lock = pool.control->locker.acquire_read();
+                bool alive = pool.control->alive.load(memory_order_acquire);
+                pool.lock();
+                for (auto &entry : pool.bins)
+                {
+                    ThreadCacheBin &bin = entry.second;
+                    if (bin.first == nullptr)
+                    {
+                        continue;
+                    }
+                    if (alive)
+                    {
+                        MemoryPoolItem *last = bin.first;
+                        while (last->next() != nullptr)
+                        {
+                            last = last->next();
+                        }
+                        bin.head->add_shared(bin.first, last);
+                    }
+                    else
+                    {
+                        delete_items(bin.first);
+                    }
+                    bin.first = nullptr;
+                    bin.count = 0;
+                }
+                pool.unlock();
+            }
+
+            // Flushes a cache and removes it from its pool's list before it is destroyed
+            void retire(ThreadPoolCache &pool)
+            {
+                flush(pool);
+                lock_guard<mutex> lock(pool.control->thread_caches_mutex);
+                auto &caches = pool.control->thread_caches;
+                caches.erase(remove(caches.begin(), caches.end(), &pool), caches.end());
+            }
+
+            class ThreadCache
+            {
+            public:
+                ~ThreadCache()
+                {
+                    for (auto &pool : pools_)
+                    {
+                        retire(*pool);
+                    }
+                }
+
+                ThreadPoolCache &pool(const shared_ptr<MemoryPoolControl> &control)
+                {
+                    if (last_ == nullptr || last_->control != control)
+                    {
+                        last_ = find_or_add(control);
+                    }
+                    return *last_;
+                }
+
+            private:
+                ThreadPoolCache *find_or_add(const shared_ptr<MemoryPoolControl> &control)
+                {
+                    for (auto &pool : pools_)
+                    {
+                        if (pool->control == control)
+                        {
+                            return pool.get();
+                        }
+                    }
+
+                    // Drop caches of pools that have been destroyed; their blocks are gone.
+                    for (auto it = pools_.begin(); it != pools_.end(); )
+                    {
+                        if (!(*it)->control->alive.load(memory_order_acquire))
+                        {
+                            retire(**it);
+                            it = pools_.erase(it);
+                        }
+                        else
+                        {
+                            it++;
+                        }
+                    }
+                    pools_.emplace_back(unique_ptr<ThreadPoolCache>(new ThreadPoolCache));
+                    ThreadPoolCache *new_pool = pools_.back().get();
+                    new_pool->control = control;
+                    lock_guard<mutex> lock(control->thread_caches_mutex);
+                    control->thread_caches.push_back(new_pool);
+                    return new_pool;
+                }
+
+                vector<unique_ptr<ThreadPoolCache>> pools_;
+
+                ThreadPoolCache *last_ = nullptr;
+            };
+
+            // Trivially destructible, so it stays readable after the cache below is destroyed
+            thread_local bool thread_cache_destroyed = false;
+
+            thread_local int no_allocation_depth = 0;
+
+            struct ThreadCacheHolder
+            {
+                ~ThreadCacheHolder()
+                {
+                    thread_cache_destroyed = true;
+                }
+
+                ThreadCache cache;
+            };
+
+            // Returns the calling thread's cache for a pool, or nullptr while the thread is being
+            // torn down
+            ThreadPoolCache *thread_pool_cache(const shared_ptr<MemoryPoolControl> &control)
+            {
+                if (thread_cache_destroyed)
+                {
+                    return nullptr;
+                }
+                static thread_local ThreadCacheHolder holder;
+                return &holder.cache.pool(control);
+            }
+
+            // Holds a thread's cache for a pool while the thread uses its bins
+            class ThreadPoolCacheLock
+            {
+            public:
+                ThreadPoolCacheLock(ThreadPoolCache &pool) : pool_(pool)
+                {
+                    pool_.lock();
+                }
+
+                ~ThreadPoolCacheLock()
+                {
+                    pool_.unlock();
+                }
+
+            private:
+                ThreadPoolCacheLock(const ThreadPoolCacheLock &copy) = delete;
+
+                ThreadPoolCacheLock &operator =(const ThreadPoolCacheLock &assign) = delete;
+
+                ThreadPoolCache &pool_;
+            };
+
+            inline MemoryPoolItem *take_from_bin(ThreadCacheBin &bin)
+            {
+                MemoryPoolItem *item = bin.first;
+                if (item == nullptr)
+                {
+                    return bin.head->get_shared();
+                }
+                bin.first = item->next();
+                bin.count--;
+                item->next() = nullptr;
+                return item;
+            }
+
+            // Frees the allocations all of whose items are on the free list, removing those items 
+            // from it. Returns the number of uint64 words released.
+            uint64_t release_unused_allocations(vector<MemoryPoolHead::allocation> &allocs, 
+                MemoryPoolItem *&first_item, uint64_t uint64_count)
+            {
+                if (allocs.empty())
+                {
+                    return 0;
+                }
+
+                // Sort allocations by address so that each item can be located by binary search.
+                vector<uint64_t> order(allocs.size());
+                iota(order.begin(), order.end(), 0);
+                sort(order.begin(), order.end(), [&allocs](uint64_t a, uint64_t b) {
+                    return allocs[a].ptr < allocs[b].ptr; });
+                auto owner = [&](const MemoryPoolItem *item) {
+                    auto it = upper_bound(order.begin(), order.end(), item->pointer(), 
+                        [&allocs](const uint64_t *ptr, uint64_t index) { return ptr < allocs[index].ptr; });
+                    return *(it - 1);
+                };
+
+                vector<uint64_t> free_counts(allocs.size(), 0);
+                for (MemoryPoolItem *item = first_item; item != nullptr; item = item->next())
+                {
+                    free_counts[owner(item)]++;
+                }
+                vector<bool> unused(allocs.size());
+                bool any_unused = false;
+                for (uint64_t i = 0; i < allocs.size(); i++)
+                {
+                    unused[i] = free_counts[i] + allocs[i].free == allocs[i].size;
+                    any_unused = any_unused || unused[i];
+                }
+                if (!any_unused)
+                {
+                    return 0;
+                }
+
+                MemoryPoolItem **link = &first_item;
+                while (*link != nullptr)
+                {
+                    MemoryPoolItem *item = *link;
+                    if (unused[owner(item)])
+                    {
+                        *link = item->next();
+                        delete item;
+                    }
+                    else
+                    {
+                        link = &item->next();
+                    }
+                }
+
+                // Keep the order of the remaining allocations; the last one is carved from next.
+                uint64_t released = 0;
+                vector<MemoryPoolHead::allocation> kept;
+                for (uint64_t i = 0; i < allocs.size(); i++)
+                {
+                    if (unused[i])
+                    {
+                        delete[] allocs[i].ptr;
+                        released += allocs[i].size * uint64_count;
+                    }
+                    else
+                    {
+                        kept.push_back(allocs[i]);
+                    }
+                }
+                allocs.swap(kept);
+                return released;
+            }
+        }
+
+        NoAllocationScope::NoAllocationScope()
+        {
+            no_allocation_depth++;
+        }
+
+        NoAllocationScope::~NoAllocationScope()
+        {
+            no_allocation_depth--;
+        }
+
+        void NoAllocationScope::check()
+        {
+            if (no_allocation_depth > 0)
+            {
+                throw logic_error("memory pool allocation inside NoAllocationScope");
+            }
+        }
+
+        uint64_t MemoryPoolControl::reserve(uint64_t item_count, uint64_t uint64_count)
+        {
+            uint64_t current = alloc_uint64_count.load(memory_order_relaxed);
+            while (true)
+            {
+                uint64_t count = item_count;
+                uint64_t cap = byte_cap.load(memory_order_relaxed);
+                if (cap != 0)
+                {
+                    uint64_t uint64_cap = cap / bytes_per_uint64;
+                    uint64_t room = current < uint64_cap ? uint64_cap - current : 0;
+                    count = min(count, room / uint64_count);
+                    if (count == 0)
+                    {
+                        return 0;
+                    }
+                }
+                if (alloc_uint64_count.compare_exchange_weak(current, current + count * uint64_count, 
+                    memory_order_relaxed))
+                {
+                    return count;
+                }
+            }
+        }
+
+        void MemoryPoolControl::set_idle_release(chrono::milliseconds interval)
+        {
+            last_release_ms.store(chrono::duration_cast<chrono::milliseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count(), memory_order_relaxed);
+            idle_release_ms.store(interval.count(), memory_order_relaxed);
+        }
+
+        bool MemoryPoolControl::idle_release_due()
+        {
+            int64_t interval = idle_release_ms.load(memory_order_relaxed);
+            if (interval == 0)
+            {
+                return false;
+            }
+            int64_t now = chrono::duration_cast<chrono::milliseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count();
+            int64_t last = last_release_ms.load(memory_order_relaxed);
+            return now - last >= interval && 
+                last_release_ms.compare_exchange_strong(last, now, memory_order_relaxed);
+        }
+
+        void MemoryPoolControl::flush_thread_caches()
+        {
+            lock_guard<mutex> lock(thread_caches_mutex);
+            for (ThreadPoolCache *pool : thread_caches)
+            {
+                flush(*pool);
+            }
+        }
+
         const uint64_t MemoryPoolHead::allocation::first_alloc_count = 1;
 
         const double MemoryPoolHead::allocation::alloc_size_multiplier = 1.05;
 
-        MemoryPoolHeadMT::MemoryPoolHeadMT(uint64_t uint64_count) : 
-            locked_(false), uint64_count_(uint64_count), alloc_item_count_(allocation::first_alloc_count), first_item_(nullptr)
+        MemoryPoolHeadMT::MemoryPoolHeadMT(uint64_t uint64_count, shared_ptr<MemoryPoolControl> control) : 
+            locked_(false), uint64_count_(uint64_count), alloc_item_count_(0), first_item_(nullptr),
+            control_(move(control))
         {
-            allocation new_alloc;
-            new_alloc.ptr = new std::uint64_t[allocation::first_alloc_count * uint64_count];
-            new_alloc.size = allocation::first_alloc_count;
-            new_alloc.free = allocation::first_alloc_count;
-            new_alloc.head_ptr = new_alloc.ptr;
-            allocs_.clear();
-            allocs_.push_back(new_alloc);
         }
 
         MemoryPoolHeadMT::~MemoryPoolHeadMT()
@@ -40,6 +415,54 @@ namespace seal
         }
 
         MemoryPoolItem *MemoryPoolHeadMT::get()
+        {
+            ThreadPoolCache *pool = control_ ? thread_pool_cache(control_) : nullptr;
+            if (pool == nullptr)
+            {
+                return get_shared();
+            }
+            ThreadPoolCacheLock lock(*pool);
+            ThreadCacheBin *bin = &pool->bin(uint64_count_);
+            bin->head = this;
+            return take_from_bin(*bin);
+        }
+
+        void MemoryPoolHeadMT::add(MemoryPoolItem *new_first)
+        {
+            ThreadPoolCache *pool = control_ ? thread_pool_cache(control_) : nullptr;
+            if (pool == nullptr)
+            {
+                add_shared(new_first, new_first);
+                return;
+            }
+            ThreadPoolCacheLock lock(*pool);
+            ThreadCacheBin *bin = &pool->bin(uint64_count_);
+            bin->head = this;
+            new_first->next() = bin->first;
+            bin->first = new_first;
+            bin->count++;
+            if (bin->count > bin->capacity)
+            {
+                // Keep the most recently freed half and spill the rest in one locked operation.
+                uint64_t keep_count = bin->capacity / 2;
+                MemoryPoolItem *keep_last = bin->first;
+                for (uint64_t i = 1; i < keep_count; i++)
+                {
+                    keep_last = keep_last->next();
+                }
+                MemoryPoolItem *spill_first = keep_last->next();
+                MemoryPoolItem *spill_last = spill_first;
+                while (spill_last->next() != nullptr)
+                {
+                    spill_last = spill_last->next();
+                }
+                keep_last->next() = nullptr;
+                bin->count = keep_count;
+                add_shared(spill_first, spill_last);
+            }
+        }
+
+        MemoryPoolItem *MemoryPoolHeadMT::get_shared()
         {
             bool expected = false;
             while (!locked_.compare_exchange_strong(expected, true, memory_order_acquire))
@@ -51,11 +474,11 @@ namespace seal
             // Is pool empty?
             if (old_first == nullptr)
             {
-                allocation &last_alloc = allocs_.back();
                 MemoryPoolItem *new_item = nullptr;
-                if (last_alloc.free > 0)
+                if (!allocs_.empty() && allocs_.back().free > 0)
                 {
                     // Pool is empty; there is memory
+                    allocation &last_alloc = allocs_.back();
                     new_item = new MemoryPoolItem(last_alloc.head_ptr);
                     last_alloc.free--;
                     last_alloc.head_ptr += uint64_count_;
@@ -64,7 +487,17 @@ namespace seal
                 {
                     // Pool is empty; there is no memory
                     allocation new_alloc;
-                    uint64_t new_size = static_cast<uint64_t>(ceil(allocation::alloc_size_multiplier * static_cast<double>(last_alloc.size)));
+                    uint64_t new_size = allocs_.empty() ? allocation::first_alloc_count :
+                        static_cast<uint64_t>(ceil(allocation::alloc_size_multiplier * static_cast<double>(allocs_.back().size)));
+                    if (control_)
+                    {
+                        new_size = control_->reserve(new_size, uint64_count_);
+                        if (new_size == 0)
+                        {
+                            locked_.store(false, memory_order_release);
+                            return nullptr;
+                        }
+                    }
                     new_alloc.ptr = new uint64_t[new_size * uint64_count_];
                     new_alloc.size = new_size;
                     new_alloc.free = new_size - 1;
@@ -84,16 +517,28 @@ namespace seal
             return old_first;
         }
 
-        MemoryPoolHeadST::MemoryPoolHeadST(uint64_t uint64_count) :
-            uint64_count_(uint64_count), alloc_item_count_(allocation::first_alloc_count), first_item_(nullptr)
+        uint64_t MemoryPoolHeadMT::trim()
+        {
+            bool expected = false;
+            while (!locked_.compare_exchange_strong(expected, true, memory_order_acquire))
+            {
+                expected = false;
+            }
+            MemoryPoolItem *first_item = first_item_;
+            uint64_t released = release_unused_allocations(allocs_, first_item, uint64_count_);
+            first_item_ = first_item;
+            alloc_item_count_ -= released / uint64_count_;
+            locked_.store(false, memory_order_release);
+            if (control_)
+            {
+                control_->unreserve(released);
+            }
+            return released;
+        }
+
+        MemoryPoolHeadST::MemoryPoolHeadST(uint64_t uint64_count, shared_ptr<MemoryPoolControl> control) :
+            uint64_count_(uint64_count), alloc_item_count_(0), first_item_(nullptr), control_(move(control))
         {
-            allocation new_alloc;
-            new_alloc.ptr = new std::uint64_t[allocation::first_alloc_count * uint64_count];
-            new_alloc.size = allocation::first_alloc_count;
-            new_alloc.free = allocation::first_alloc_count;
-            new_alloc.head_ptr = new_alloc.ptr;
-            allocs_.clear();
-            allocs_.push_back(new_alloc);
         }
 
         MemoryPoolHeadST::~MemoryPoolHeadST()
@@ -113,11 +558,11 @@ namespace seal
             // Is pool empty?
             if (old_first == nullptr)
             {
-                allocation &last_alloc = allocs_.back();
                 MemoryPoolItem *new_item = nullptr;
-                if (last_alloc.free > 0)
+                if (!allocs_.empty() && allocs_.back().free > 0)
                 {
                     // Pool is empty; there is memory
+                    allocation &last_alloc = allocs_.back();
                     new_item = new MemoryPoolItem(last_alloc.head_ptr);
                     last_alloc.free--;
                     last_alloc.head_ptr += uint64_count_;
@@ -126,7 +571,16 @@ namespace seal
                 {
                     // Pool is empty; there is no memory
                     allocation new_alloc;
-                    uint64_t new_size = static_cast<uint64_t>(ceil(allocation::alloc_size_multiplier * static_cast<double>(last_alloc.size)));
+                    uint64_t new_size = allocs_.empty() ? allocation::first_alloc_count :
+                        static_cast<uint64_t>(ceil(allocation::alloc_size_multiplier * static_cast<double>(allocs_.back().size)));
+                    if (control_)
+                    {
+                        new_size = control_->reserve(new_size, uint64_count_);
+                        if (new_size == 0)
+                        {
+                            return nullptr;
+                        }
+                    }
                     new_alloc.ptr = new uint64_t[new_size * uint64_count_];
                     new_alloc.size = new_size;
                     new_alloc.free = new_size - 1;
@@ -144,8 +598,38 @@ namespace seal
             return old_first;
         }
 
+        uint64_t MemoryPoolHeadST::trim()
+        {
+            uint64_t released = release_unused_allocations(allocs_, first_item_, uint64_count_);
+            alloc_item_count_ -= released / uint64_count_;
+            if (control_)
+            {
+                control_->unreserve(released);
+            }
+            return released;
+        }
+
+        void MemoryPoolHeadST::release_idle()
+        {
+            control_->pool->trim();
+        }
+
         MemoryPoolMT::~MemoryPoolMT()
         {
+            {
+                lock_guard<mutex> lock(releaser_mutex_);
+                releaser_stop_ = true;
+            }
+            releaser_cv_.notify_all();
+            if (releaser_.joinable())
+            {
+                releaser_.join();
+            }
+            {
+                // Threads flushing their caches hold a reader lock; after this none touch the heads.
+                WriterLock control_lock = control_->locker.acquire_write();
+                control_->alive.store(false, memory_order_release);
+            }
             WriterLock lock = pools_locker_.acquire_write();
             for (uint64_t i = 0; i < pools_.size(); i++)
             {
@@ -160,7 +644,41 @@ namespace seal
             {
                 return Pointer();
             }
+            NoAllocationScope::check();
 
+            // Sizes this thread has seen before are served from its cache without any locks.
+            MemoryPoolHead *head = nullptr;
+            MemoryPoolItem *item = nullptr;
+            if (ThreadPoolCache *pool = thread_pool_cache(control_))
+            {
+                ThreadPoolCacheLock lock(*pool);
+                ThreadCacheBin &bin = pool->bin(uint64_count);
+                if (bin.head != nullptr)
+                {
+                    head = bin.head;
+                    item = take_from_bin(bin);
+                }
+            }
+            if (head == nullptr)
+            {
+                head = find_or_add_head(uint64_count);
+                item = head->get();
+            }
+            if (item == nullptr)
+            {
+                // Growing would exceed the byte cap; release unused memory and try once more.
+                trim();
+                item = head->get();
+                if (item == nullptr)
+                {
+                    throw bad_alloc();
+                }
+            }
+            return Pointer(head, item);
+        }
+
+        MemoryPoolHead *MemoryPoolMT::find_or_add_head(uint64_t uint64_count)
+        {
             // For part 1, obtain just a reader lock and attempt to find size.
             ReaderLock reader_lock = pools_locker_.acquire_read();
             uint64_t start = 0;
@@ -180,7 +698,7 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer(mid_head);
+                    return mid_head;
                 }
             }
             reader_lock.release();
@@ -204,12 +722,12 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer(mid_head);
+                    return mid_head;
                 }
             }
 
             // Size was still not found, but we own an exclusive lock so just add it.
-            MemoryPoolHead *new_head = new MemoryPoolHeadMT(uint64_count);
+            MemoryPoolHead *new_head = new MemoryPoolHeadMT(uint64_count, control_);
             if (!pools_.empty())
             {
                 pools_.insert(pools_.begin() + start, new_head);
@@ -218,8 +736,52 @@ namespace seal
             {
                 pools_.emplace_back(new_head);
             }
+            return new_head;
+        }
+
+        uint64_t MemoryPoolMT::trim()
+        {
+            // Blocks that any thread holds in its cache count as unused here, so that idle 
+            // threads do not keep memory alive.
+            control_->flush_thread_caches();
+
+            ReaderLock lock = pools_locker_.acquire_read();
+            uint64_t uint64_count = 0;
+            for (uint64_t i = 0; i < pools_.size(); i++)
+            {
+                uint64_count += pools_[i]->trim();
+            }
+            return uint64_count * bytes_per_uint64;
+        }
+
+        void MemoryPoolMT::set_idle_release(chrono::milliseconds interval)
+        {
+            lock_guard<mutex> lock(releaser_mutex_);
+            control_->set_idle_release(interval);
+            releaser_cv_.notify_all();
+            if (interval.count() != 0 && !releaser_.joinable())
+            {
+                releaser_ = thread(&MemoryPoolMT::release_idle, this);
+            }
+        }
 
-            return Pointer(new_head);
+        void MemoryPoolMT::release_idle()
+        {
+            unique_lock<mutex> lock(releaser_mutex_);
+            while (!releaser_stop_)
+            {
+                int64_t interval = control_->idle_release_ms.load(memory_order_relaxed);
+                if (interval == 0)
+                {
+                    releaser_cv_.wait(lock);
+                }
+                else if (releaser_cv_.wait_for(lock, chrono::milliseconds(interval)) == cv_status::timeout)
+                {
+                    lock.unlock();
+                    trim();
+                    lock.lock();
+                }
+            }
         }
 
         uint64_t MemoryPoolMT::alloc_uint64_count() const
@@ -249,8 +811,25 @@ namespace seal
             {
                 return Pointer();
             }
+            NoAllocationScope::check();
 
-            // For part 1, obtain just a reader lock and attempt to find size.
+            MemoryPoolHead *head = find_or_add_head(uint64_count);
+            MemoryPoolItem *item = head->get();
+            if (item == nullptr)
+            {
+                // Growing would exceed the byte cap; release unused memory and try once more.
+                trim();
+                item = head->get();
+                if (item == nullptr)
+                {
+                    throw bad_alloc();
+                }
+            }
+            return Pointer(head, item);
+        }
+
+        MemoryPoolHead *MemoryPoolST::find_or_add_head(uint64_t uint64_count)
+        {
             uint64_t start = 0;
             uint64_t end = pools_.size();
             while (start < end)
@@ -268,12 +847,12 @@ namespace seal
                 }
                 else
                 {
-                    return Pointer(mid_head);
+                    return mid_head;
                 }
             }
 
-            // Size was still not found, but we own an exclusive lock so just add it.
-            MemoryPoolHead *new_head = new MemoryPoolHeadST(uint64_count);
+            // Size was not found, so add it.
+            MemoryPoolHead *new_head = new MemoryPoolHeadST(uint64_count, control_);
             if (!pools_.empty())
             {
                 pools_.insert(pools_.begin() + start, new_head);
@@ -282,8 +861,157 @@ namespace seal
             {
                 pools_.emplace_back(new_head);
             }
+            return new_head;
+        }
+
+        uint64_t MemoryPoolST::trim()
+        {
+            uint64_t uint64_count = 0;
+            for (uint64_t i = 0; i < pools_.size(); i++)
+            {
+                uint64_count += pools_[i]->trim();
+            }
+            return uint64_count * bytes_per_uint64;
+        }
+
+        MemoryPoolArena::MemoryPoolArena(uint64_t uint64_count) : 
+            used_uint64_count_(0), live_count_(0), byte_cap_(0), head_(*this)
+        {
+            if (uint64_count > 0)
+            {
+                add_buffer(uint64_count);
+            }
+        }
+
+        MemoryPoolArena::~MemoryPoolArena()
+        {
+            for (auto &buf : buffers_)
+            {
+                delete[] buf.ptr;
+            }
+            buffers_.clear();
+        }
+
+        Pointer MemoryPoolArena::get_for_uint64_count(uint64_t uint64_count)
+        {
+            if (uint64_count == 0)
+            {
+                return Pointer();
+            }
+            if (buffers_.empty() || buffers_.back().size - used_uint64_count_ < uint64_count)
+            {
+                add_buffer(uint64_count);
+            }
+            uint64_t *ptr = buffers_.back().ptr + used_uint64_count_;
+            used_uint64_count_ += uint64_count;
+
+            MemoryPoolItem *item = nullptr;
+            if (free_items_.empty())
+            {
+                NoAllocationScope::check();
+                items_.emplace_back(new MemoryPoolItem(ptr));
+                item = items_.back().get();
+
+                // Returning every item at once must never reallocate
+                free_items_.reserve(items_.size());
+            }
+            else
+            {
+                item = free_items_.back();
+                free_items_.pop_back();
+                item->set_pointer(ptr);
+            }
+            live_count_++;
+            return Pointer(&head_, item);
+        }
+
+        uint64_t MemoryPoolArena::alloc_uint64_count() const
+        {
+            uint64_t uint64_count = 0;
+            for (auto &buf : buffers_)
+            {
+                uint64_count += buf.size;
+            }
+            return uint64_count;
+        }
+
+        uint64_t MemoryPoolArena::trim()
+        {
+            if (live_count_ > 0)
+            {
+                return 0;
+            }
+            uint64_t byte_count = alloc_byte_count();
+            for (auto &buf : buffers_)
+            {
+                delete[] buf.ptr;
+            }
+            buffers_.clear();
+            used_uint64_count_ = 0;
+            return byte_count;
+        }
+
+        void MemoryPoolArena::add_buffer(uint64_t min_uint64_count)
+        {
+            NoAllocationScope::check();
+
+            // Grow geometrically so that the last buffer quickly covers the peak usage.
+            uint64_t total_uint64_count = alloc_uint64_count();
+            uint64_t new_uint64_count = max(min_uint64_count, total_uint64_count);
+            if (byte_cap_ != 0 && (total_uint64_count + new_uint64_count) * bytes_per_uint64 > byte_cap_)
+            {
+                new_uint64_count = min_uint64_count;
+                if ((total_uint64_count + new_uint64_count) * bytes_per_uint64 > byte_cap_)
+                {
+                    throw bad_alloc();
+                }
+            }
+            buffer new_buffer;
+            new_buffer.ptr = new uint64_t[new_uint64_count];
+            new_buffer.size = new_uint64_count;
+            buffers_.push_back(new_buffer);
+            used_uint64_count_ = 0;
+        }
+
+        void MemoryPoolArena::release(MemoryPoolItem *item)
+        {
+            free_items_.push_back(item);
+            live_count_--;
+            if (live_count_ > 0)
+            {
+                return;
+            }
 
-            return Pointer(new_head);
+            // Everything is back. If the work outgrew the first buffer, merge all buffers into
+            // one that fits the peak usage, so the next call needs no new buffer. This runs in
+            // Pointer::release, so a failed allocation must not throw; keep the largest buffer.
+            if (buffers_.size() > 1)
+            {
+                uint64_t total_uint64_count = alloc_uint64_count();
+                buffer merged;
+                merged.ptr = new (nothrow) uint64_t[total_uint64_count];
+                merged.size = total_uint64_count;
+                if (merged.ptr == nullptr)
+                {
+                    merged = *max_element(buffers_.begin(), buffers_.end(), 
+                        [](const buffer &a, const buffer &b) { return a.size < b.size; });
+                }
+                for (auto &buf : buffers_)
+                {
+                    if (buf.ptr != merged.ptr)
+                    {
+                        delete[] buf.ptr;
+                    }
+                }
+                buffers_.clear();
+                buffers_.push_back(merged);
+            }
+            used_uint64_count_ = 0;
+        }
+
+        MemoryPoolItem *MemoryPoolArena::Head::get()
+        {
+            throw logic_error("MemoryPoolArena blocks are obtained through the pool");
         }
     }
 }
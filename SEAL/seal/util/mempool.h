@@ -5,6 +5,11 @@
 #include <vector>
 #include <stdexcept>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "seal/util/globals.h"
 #include "seal/util/common.h"
 #include "seal/util/locks.h"
@@ -30,6 +35,11 @@ namespace seal
                 return pointer_;
             }
 
+            inline void set_pointer(std::uint64_t *pointer)
+            {
+                pointer_ = pointer;
+            }
+
             inline MemoryPoolItem* &next()
             {
                 return next_;
@@ -50,6 +60,26 @@ namespace seal
             MemoryPoolItem *next_;
         };
 
+        // While an instance is alive, any allocation from a memory pool on the constructing 
+        // thread throws std::logic_error. Scopes may be nested. This is an instrumentation aid 
+        // for checking that a code region, e.g. a homomorphic operation using an 
+        // EvaluatorWorkspace, runs without allocating.
+        class NoAllocationScope
+        {
+        public:
+            NoAllocationScope();
+
+            ~NoAllocationScope();
+
+            // Throws std::logic_error if a NoAllocationScope is alive on the current thread
+            static void check();
+
+        private:
+            NoAllocationScope(const NoAllocationScope &copy) = delete;
+
+            NoAllocationScope &operator =(const NoAllocationScope &assign) = delete;
+        };
+
         class MemoryPoolHead
         {
         public:
@@ -88,13 +118,81 @@ namespace seal
             virtual MemoryPoolItem *get() = 0;
 
             virtual void add(MemoryPoolItem *new_first) = 0;
+
+            // Frees allocations none of whose items are in use and returns the number of 
+            // uint64 words released
+            virtual std::uint64_t trim() = 0;
+        };
+
+        class MemoryPool;
+
+        struct ThreadPoolCache;
+
+        // Shared by a memory pool, its heads, and every thread cache holding blocks from it. 
+        // Tracks the memory held by the heads against the byte cap and the idle release 
+        // policy. A thread exiting flushes its cached blocks back to the heads only while 
+        // the pool is alive.
+        struct MemoryPoolControl
+        {
+            MemoryPoolControl() : alive(true), alloc_uint64_count(0), byte_cap(0), 
+                idle_release_ms(0), last_release_ms(0), pool(nullptr)
+            {
+            }
+
+            // Reserves room for at most item_count items of uint64_count words each without 
+            // exceeding the cap, and returns the number of items reserved
+            std::uint64_t reserve(std::uint64_t item_count, std::uint64_t uint64_count);
+
+            inline void unreserve(std::uint64_t uint64_count)
+            {
+                alloc_uint64_count.fetch_sub(uint64_count, std::memory_order_relaxed);
+            }
+
+            inline bool idle_release_enabled() const
+            {
+                return idle_release_ms.load(std::memory_order_relaxed) != 0;
+            }
+
+            // Sets the idle release interval; the first interval starts now
+            void set_idle_release(std::chrono::milliseconds interval);
+
+            // Returns true at most once per idle release interval
+            bool idle_release_due();
+
+            // Hands the blocks cached by every thread back to the heads
+            void flush_thread_caches();
+
+            ReaderWriterLocker locker;
+
+            std::atomic<bool> alive;
+
+            std::atomic<std::uint64_t> alloc_uint64_count;
+
+            // In bytes; zero means no cap
+            std::atomic<std::uint64_t> byte_cap;
+
+            // Zero means idle release is disabled
+            std::atomic<std::int64_t> idle_release_ms;
+
+            std::atomic<std::int64_t> last_release_ms;
+
+            // The pool owning the heads, so that a head can release the memory of the whole
+            // pool; only set for MemoryPoolST
+            MemoryPool *pool;
+
+            // The caches of all threads holding blocks from the pool
+            std::mutex thread_caches_mutex;
+
+            std::vector<ThreadPoolCache*> thread_caches;
         };
 
         class MemoryPoolHeadMT : public MemoryPoolHead
         {
         public:
-            // Creates a new MemoryPoolHeadMT with allocation for one single item.
-            MemoryPoolHeadMT(std::uint64_t uint64_count);
+            // Creates a new MemoryPoolHeadMT; memory is allocated on the first get. If control 
+            // is set, get and add go through a per-thread cache in front of the shared free 
+            // list, and allocations are accounted against the pool's byte cap.
+            MemoryPoolHeadMT(std::uint64_t uint64_count, std::shared_ptr<MemoryPoolControl> control = nullptr);
 
             ~MemoryPoolHeadMT() override;
 
@@ -111,19 +209,27 @@ namespace seal
 
             MemoryPoolItem *get() override;
 
-            inline void add(MemoryPoolItem *new_first) override
+            void add(MemoryPoolItem *new_first) override;
+
+            // Takes one item from the shared free list, allocating if it is empty. Returns 
+            // nullptr if a new allocation would exceed the byte cap.
+            MemoryPoolItem *get_shared();
+
+            // Returns the linked list first..last to the shared free list under one lock
+            inline void add_shared(MemoryPoolItem *first, MemoryPoolItem *last)
             {
                 bool expected = false;
                 while (!locked_.compare_exchange_strong(expected, true, std::memory_order_acquire))
                 {
                     expected = false;
                 }
-                MemoryPoolItem *old_first = first_item_;
-                new_first->next() = old_first;
-                first_item_ = new_first;
+                last->next() = first_item_;
+                first_item_ = first;
                 locked_.store(false, std::memory_order_release);
             }
 
+            std::uint64_t trim() override;
+
         private:
             MemoryPoolHeadMT(const MemoryPoolHeadMT &copy) = delete;
 
@@ -138,13 +244,16 @@ namespace seal
             std::vector<allocation> allocs_;
 
             MemoryPoolItem* volatile first_item_;
+
+            std::shared_ptr<MemoryPoolControl> control_;
         };
 
         class MemoryPoolHeadST : public MemoryPoolHead
         {
         public:
-            // Creates a new MemoryPoolHeadST with allocation for one single item.
-            MemoryPoolHeadST(std::uint64_t uint64_count);
+            // Creates a new MemoryPoolHeadST; memory is allocated on the first get. If control 
+            // is set, allocations are accounted against the pool's byte cap.
+            MemoryPoolHeadST(std::uint64_t uint64_count, std::shared_ptr<MemoryPoolControl> control = nullptr);
 
             ~MemoryPoolHeadST() override;
 
@@ -159,14 +268,21 @@ namespace seal
                 return alloc_item_count_;
             }
 
+            // Returns nullptr if a new allocation would exceed the byte cap
             MemoryPoolItem *get() override;
 
             inline void add(MemoryPoolItem* new_first) override
             {
                 new_first->next() = first_item_;
                 first_item_ = new_first;
+                if (control_ && control_->idle_release_enabled() && control_->idle_release_due())
+                {
+                    release_idle();
+                }
             }
 
+            std::uint64_t trim() override;
+
         private:
             MemoryPoolHeadST(const MemoryPoolHeadST &copy) = delete;
 
@@ -179,6 +295,11 @@ namespace seal
             std::vector<allocation> allocs_;
 
             MemoryPoolItem *first_item_;
+
+            std::shared_ptr<MemoryPoolControl> control_;
+
+            // Releases the unused memory of the whole pool
+            void release_idle();
         };
 
         class ConstPointer;
@@ -205,6 +326,10 @@ namespace seal
                 pointer_ = item_->pointer();
             }
 
+            Pointer(MemoryPoolHead *head, MemoryPoolItem *item) : pointer_(item->pointer()), head_(head), item_(item), alias_(false)
+            {
+            }
+
             Pointer(Pointer &&move) noexcept : pointer_(move.pointer_), head_(move.head_), item_(move.item_), alias_(move.alias_)
             {
                 move.pointer_ = nullptr;
@@ -527,12 +652,26 @@ namespace seal
             virtual std::uint64_t alloc_uint64_count() const = 0;
 
             virtual std::uint64_t alloc_byte_count() const = 0;
+
+            // Frees all fully unused allocations and returns the number of bytes released
+            virtual std::uint64_t trim() = 0;
+
+            virtual void set_byte_cap(std::uint64_t byte_cap) = 0;
+
+            virtual std::uint64_t byte_cap() const = 0;
+
+            virtual void set_idle_release(std::chrono::milliseconds interval) = 0;
         };
 
+        // Allocations and frees are served from a small per-thread cache of blocks for each 
+        // size class, so that the common path takes no locks. Cached blocks spill back to the 
+        // shared heads in bulk when a cache grows too large, when the thread exits, and when
+        // the pool is trimmed. With idle release enabled, a background thread trims the pool
+        // once per interval.
         class MemoryPoolMT : public MemoryPool
         {
         public:
-            MemoryPoolMT() 
+            MemoryPoolMT() : control_(std::make_shared<MemoryPoolControl>())
             {
             }
 
@@ -558,21 +697,53 @@ namespace seal
                 return alloc_uint64_count() * bytes_per_uint64;
             }
 
+            // Blocks cached by any thread are handed back to the heads first
+            std::uint64_t trim();
+
+            inline void set_byte_cap(std::uint64_t byte_cap)
+            {
+                control_->byte_cap.store(byte_cap, std::memory_order_relaxed);
+            }
+
+            inline std::uint64_t byte_cap() const
+            {
+                return control_->byte_cap.load(std::memory_order_relaxed);
+            }
+
+            // Starts the background thread on the first call with a non-zero interval
+            void set_idle_release(std::chrono::milliseconds interval);
+
         private:
             MemoryPoolMT(const MemoryPoolMT &copy) = delete;
 
             MemoryPoolMT &operator =(const MemoryPoolMT &assign) = delete;
 
+            MemoryPoolHead *find_or_add_head(std::uint64_t uint64_count);
+
+            // Body of the background thread; trims the pool whenever an interval passes
+            void release_idle();
+
             mutable ReaderWriterLocker pools_locker_;
 
             std::vector<MemoryPoolHead*> pools_;
+
+            std::shared_ptr<MemoryPoolControl> control_;
+
+            std::thread releaser_;
+
+            std::mutex releaser_mutex_;
+
+            std::condition_variable releaser_cv_;
+
+            bool releaser_stop_ = false;
         };
 
         class MemoryPoolST : public MemoryPool
         {
         public:
-            MemoryPoolST()
+            MemoryPoolST() : control_(std::make_shared<MemoryPoolControl>())
             {
+                control_->pool = this;
             }
 
             ~MemoryPoolST();
@@ -606,12 +777,159 @@ namespace seal
                 return alloc_uint64_count() * bytes_per_uint64;
             }
 
+            std::uint64_t trim();
+
+            inline void set_byte_cap(std::uint64_t byte_cap)
+            {
+                control_->byte_cap.store(byte_cap, std::memory_order_relaxed);
+            }
+
+            inline std::uint64_t byte_cap() const
+            {
+                return control_->byte_cap.load(std::memory_order_relaxed);
+            }
+
+            // Memory is released by the next free after the interval, since no other thread
+            // may touch the pool
+            inline void set_idle_release(std::chrono::milliseconds interval)
+            {
+                control_->set_idle_release(interval);
+            }
+
         private:
             MemoryPoolST(const MemoryPoolST &copy) = delete;
 
             MemoryPoolST &operator =(const MemoryPoolST &assign) = delete;
 
+            MemoryPoolHead *find_or_add_head(std::uint64_t uint64_count);
+
             std::vector<MemoryPoolHead*> pools_;
+
+            std::shared_ptr<MemoryPoolControl> control_;
+        };
+
+        // Scratch memory pool backing EvaluatorWorkspace. Blocks are carved from one contiguous 
+        // buffer by bumping an offset, with no size-class lookup and no locking, and the whole 
+        // buffer is reclaimed at once when every block has been returned. When a buffer runs 
+        // out another one is added, and at the next reclaim all buffers are merged into one, 
+        // so after the first call the buffer covers the peak usage and no further allocation 
+        // happens. Blocks that outlive the work they were allocated for prevent reclaiming, 
+        // so memory from this pool should only be used for temporaries. Not thread-safe.
+        class MemoryPoolArena : public MemoryPool
+        {
+        public:
+            MemoryPoolArena(std::uint64_t uint64_count = 0);
+
+            ~MemoryPoolArena();
+
+            inline Pointer get_for_byte_count(std::uint64_t byte_count)
+            {
+                std::uint64_t uint64_count = (byte_count + bytes_per_uint64 - 1) / bytes_per_uint64;
+                return get_for_uint64_count(uint64_count);
+            }
+
+            Pointer get_for_uint64_count(std::uint64_t uint64_count);
+
+            // Returns the number of buffers currently held
+            inline std::uint64_t pool_count() const
+            {
+                return buffers_.size();
+            }
+
+            std::uint64_t alloc_uint64_count() const;
+
+            inline std::uint64_t alloc_byte_count() const
+            {
+                return alloc_uint64_count() * bytes_per_uint64;
+            }
+
+            // Frees all buffers if no block is in use
+            std::uint64_t trim();
+
+            inline void set_byte_cap(std::uint64_t byte_cap)
+            {
+                byte_cap_ = byte_cap;
+            }
+
+            inline std::uint64_t byte_cap() const
+            {
+                return byte_cap_;
+            }
+
+            // No-op for arenas: the buffer is only released by trim(), never on a timer
+            inline void set_idle_release(std::chrono::milliseconds)
+            {
+            }
+
+            // Returns the number of blocks currently in use
+            inline std::uint64_t live_count() const
+            {
+                return live_count_;
+            }
+
+        private:
+            class Head : public MemoryPoolHead
+            {
+            public:
+                Head(MemoryPoolArena &arena) : arena_(arena)
+                {
+                }
+
+                inline std::uint64_t uint64_count() const override
+                {
+                    return 0;
+                }
+
+                inline std::uint64_t alloc_item_count() const override
+                {
+                    return 0;
+                }
+
+                MemoryPoolItem *get() override;
+
+                inline void add(MemoryPoolItem *new_first) override
+                {
+                    arena_.release(new_first);
+                }
+
+                inline std::uint64_t trim() override
+                {
+                    return 0;
+                }
+
+            private:
+                MemoryPoolArena &arena_;
+            };
+
+            struct buffer
+            {
+                std::uint64_t *ptr;
+
+                std::uint64_t size;
+            };
+
+            MemoryPoolArena(const MemoryPoolArena &copy) = delete;
+
+            MemoryPoolArena &operator =(const MemoryPoolArena &assign) = delete;
+
+            void add_buffer(std::uint64_t min_uint64_count);
+
+            void release(MemoryPoolItem *item);
+
+            std::vector<buffer> buffers_;
+
+            // Offset of the first unused word in the last buffer
+            std::uint64_t used_uint64_count_;
+
+            std::uint64_t live_count_;
+
+            std::vector<std::unique_ptr<MemoryPoolItem>> items_;
+
+            std::vector<MemoryPoolItem*> free_items_;
+
+            std::uint64_t byte_cap_;
+
+            Head head_;
         };
 
         inline Pointer duplicate_if_needed(std::uint64_t *original, int uint64_count, bool condition, MemoryPool &pool)
@@ -369,7 +369,7 @@ namespace seal
             }
 #endif
             std::uint32_t coeff_count = 1U << coeff_count_power;
-            std::uint32_t m_minus_one = 2 * coeff_count;
+            std::uint32_t m_minus_one = 2 * coeff_count - 1;
             for (std::uint32_t i = 0; i < coeff_count; i++)
             {
                 std::uint32_t reversed = reverse_bits(i, coeff_count_power);
@@ -443,6 +443,113 @@ namespace seal
             }
         }
 
+        // Reduces the 128-bit value z using base 2^64 Barrett reduction, with the value and 
+        // const_ratio of the modulus passed in so that the dyadic product kernels load them once
+        inline std::uint64_t barrett_reduce_128_with_ratio(const std::uint64_t *z, std::uint64_t modulus_value,
+            std::uint64_t const_ratio_0, std::uint64_t const_ratio_1)
+        {
+            std::uint64_t tmp1, tmp2[2], tmp3, carry;
+            multiply_uint64_hw64(z[0], const_ratio_0, &carry);
+            multiply_uint64(z[0], const_ratio_1, tmp2);
+            tmp3 = tmp2[1] + add_uint64(tmp2[0], carry, 0, &tmp1);
+            multiply_uint64(z[1], const_ratio_0, tmp2);
+            carry = tmp2[1] + add_uint64(tmp1, tmp2[0], 0, &tmp1);
+            tmp1 = z[1] * const_ratio_1 + tmp3 + carry;
+            tmp3 = z[0] - tmp1 * modulus_value;
+            return tmp3 - (modulus_value & static_cast<std::uint64_t>(-static_cast<std::int64_t>(tmp3 >= modulus_value)));
+        }
+
+        // Computes the tensor product (c0, c1) x (d0, d1) = (c0*d0, c0*d1 + c1*d0, c1*d1) of two 
+        // size 2 ciphertexts in NTT form, with all coefficients of the operands less than modulus. 
+        // The products are accumulated in 128 bits and each output is reduced only once.
+        inline void dyadic_product_2x2_coeffmod(const std::uint64_t *c0, const std::uint64_t *c1, 
+            const std::uint64_t *d0, const std::uint64_t *d1, int coeff_count, const SmallModulus &modulus, 
+            std::uint64_t *result0, std::uint64_t *result1, std::uint64_t *result2)
+        {
+#ifdef SEAL_DEBUG
+            if (c0 == nullptr || c1 == nullptr || d0 == nullptr || d1 == nullptr)
+            {
+                throw std::invalid_argument("operand");
+            }
+            if (result0 == nullptr || result1 == nullptr || result2 == nullptr)
+            {
+                throw std::invalid_argument("result");
+            }
+            if (coeff_count <= 0)
+            {
+                throw std::invalid_argument("coeff_count");
+            }
+            if (modulus.is_zero())
+            {
+                throw std::invalid_argument("modulus");
+            }
+#endif
+            const std::uint64_t modulus_value = modulus.value();
+            const std::uint64_t const_ratio_0 = modulus.const_ratio()[0];
+            const std::uint64_t const_ratio_1 = modulus.const_ratio()[1];
+            for (int i = 0; i < coeff_count; i++)
+            {
+                std::uint64_t z0[2], z1[2], z2[2], cross[2];
+                multiply_uint64(c0[i], d0[i], z0);
+                multiply_uint64(c0[i], d1[i], z1);
+                multiply_uint64(c1[i], d0[i], cross);
+                multiply_uint64(c1[i], d1[i], z2);
+
+                // Less than 2 * modulus^2, so no overflow
+                z1[1] += cross[1] + add_uint64(z1[0], cross[0], 0, z1);
+
+                result0[i] = barrett_reduce_128_with_ratio(z0, modulus_value, const_ratio_0, const_ratio_1);
+                result1[i] = barrett_reduce_128_with_ratio(z1, modulus_value, const_ratio_0, const_ratio_1);
+                result2[i] = barrett_reduce_128_with_ratio(z2, modulus_value, const_ratio_0, const_ratio_1);
+            }
+        }
+
+        // Computes the same tensor product as dyadic_product_2x2_coeffmod with three products 
+        // instead of four, using c0*d1 + c1*d0 = (c0 + c1)*(d0 + d1) - c0*d0 - c1*d1. The sums 
+        // are not reduced and the subtractions are exact in 128 bits, so again each output is 
+        // reduced only once. This is faster only when 64-bit multiplication is expensive.
+        inline void dyadic_product_2x2_karatsuba_coeffmod(const std::uint64_t *c0, const std::uint64_t *c1,
+            const std::uint64_t *d0, const std::uint64_t *d1, int coeff_count, const SmallModulus &modulus,
+            std::uint64_t *result0, std::uint64_t *result1, std::uint64_t *result2)
+        {
+#ifdef SEAL_DEBUG
+            if (c0 == nullptr || c1 == nullptr || d0 == nullptr || d1 == nullptr)
+            {
+                throw std::invalid_argument("operand");
+            }
+            if (result0 == nullptr || result1 == nullptr || result2 == nullptr)
+            {
+                throw std::invalid_argument("result");
+            }
+            if (coeff_count <= 0)
+            {
+                throw std::invalid_argument("coeff_count");
+            }
+            if (modulus.is_zero())
+            {
+                throw std::invalid_argument("modulus");
+            }
+#endif
+            const std::uint64_t modulus_value = modulus.value();
+            const std::uint64_t const_ratio_0 = modulus.const_ratio()[0];
+            const std::uint64_t const_ratio_1 = modulus.const_ratio()[1];
+            for (int i = 0; i < coeff_count; i++)
+            {
+                std::uint64_t z0[2], z1[2], z2[2];
+                multiply_uint64(c0[i], d0[i], z0);
+                multiply_uint64(c1[i], d1[i], z2);
+
+                // Less than 4 * modulus^2, so no overflow
+                multiply_uint64(c0[i] + c1[i], d0[i] + d1[i], z1);
+                z1[1] -= z0[1] + sub_uint64(z1[0], z0[0], 0, z1);
+                z1[1] -= z2[1] + sub_uint64(z1[0], z2[0], 0, z1);
+
+                result0[i] = barrett_reduce_128_with_ratio(z0, modulus_value, const_ratio_0, const_ratio_1);
+                result1[i] = barrett_reduce_128_with_ratio(z1, modulus_value, const_ratio_0, const_ratio_1);
+                result2[i] = barrett_reduce_128_with_ratio(z2, modulus_value, const_ratio_0, const_ratio_1);
+            }
+        }
+
         void modulo_poly_inplace(std::uint64_t *value, int value_coeff_count, const PolyModulus &poly_modulus,
             const SmallModulus &modulus);
 
@@ -5,7 +5,11 @@
 #include "seal/smallmodulus.h"
 #include "seal/util/uintarithsmallmod.h"
 #include "seal/util/defines.h"
+#include "seal/util/cpufeatures.h"
 #include <algorithm>
+#if defined(SEAL_ENABLE_AVX2) || defined(SEAL_ENABLE_AVX512F)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -188,25 +192,14 @@ namespace seal
             }
         }
 
-        /**
-        This function computes in-place the negacyclic NTT. The input is a polynomial a of degree n in R_q,
-        where n is assumed to be a power of 2 and q is a prime such that q = 1 (mod 2n).
-
-        The output is a vector A such that the following hold:
-        A[j] =  a(psi**(2*bit_reverse(j) + 1)), 0 <= j < n.
-
-        For details, see Michael Naehrig and Patrick Longa.
-        */
-        void ntt_negacyclic_harvey_lazy(uint64_t *operand, const SmallNTTTables &tables)
+        namespace
         {
-            uint64_t modulus = tables.modulus().value();
-            uint64_t two_times_modulus = modulus * 2;
-            
-            // Return the NTT in scrambled order
-            int n = 1 << tables.coeff_count_power();
-            int t = n >> 1;
-            for (int m = 1; m < n; m <<= 1)
+            // One layer of forward Harvey butterflies: m groups of t butterflies each.
+            void ntt_negacyclic_harvey_lazy_layer(uint64_t *operand, const SmallNTTTables &tables, int m, int t)
             {
+                uint64_t modulus = tables.modulus().value();
+                uint64_t two_times_modulus = modulus * 2;
+
                 if (t >= 4)
                 {
                     for (int i = 0; i < m; i++)
@@ -273,22 +266,14 @@ namespace seal
                         }
                     }
                 }
-                t >>= 1;
             }
-        }
 
-        // Inverse negacyclic NTT using Harvey's butterfly. (See Patrick Longa and Michael Naehrig). 
-        void inverse_ntt_negacyclic_harvey_lazy(uint64_t *operand, const SmallNTTTables &tables)
-        {
-            uint64_t modulus = tables.modulus().value();
-            uint64_t two_times_modulus = modulus * 2;
-
-            // return the bit-reversed order of NTT. 
-            int n = 1 << tables.coeff_count_power();
-            int t = 1;
-
-            for (int m = n; m > 1; m >>= 1)
+            // One layer of inverse Harvey butterflies: m / 2 groups of t butterflies each.
+            void inverse_ntt_negacyclic_harvey_lazy_layer(uint64_t *operand, const SmallNTTTables &tables, int m, int t)
             {
+                uint64_t modulus = tables.modulus().value();
+                uint64_t two_times_modulus = modulus * 2;
+
                 int j1 = 0;
                 int h = m >> 1;
                 if (t >= 4)
@@ -376,6 +361,301 @@ namespace seal
                         j1 += (t << 1);
                     }
                 }
+            }
+#ifdef SEAL_ENABLE_AVX2
+            // The vectorized layers below compute exactly the same integer operations as the 
+            // scalar layers above, so their (lazy) outputs are bit-identical. There is no 64x64 
+            // multiply in AVX2 or AVX-512F, so products are assembled from 32x32 -> 64 multiplies.
+            __attribute__((target("avx2")))
+            inline __m256i mm256_multiply_uint64_hw64(__m256i operand1, __m256i operand2)
+            {
+                const __m256i low32_mask = _mm256_set1_epi64x(0xFFFFFFFF);
+                __m256i operand1_hi = _mm256_srli_epi64(operand1, 32);
+                __m256i operand2_hi = _mm256_srli_epi64(operand2, 32);
+
+                __m256i right = _mm256_mul_epu32(operand1, operand2);
+                __m256i middle1 = _mm256_mul_epu32(operand1_hi, operand2);
+                __m256i middle2 = _mm256_mul_epu32(operand1, operand2_hi);
+                __m256i left = _mm256_mul_epu32(operand1_hi, operand2_hi);
+
+                // Neither sum can overflow: (2^32 - 1)^2 + 2 * (2^32 - 1) < 2^64
+                __m256i temp_sum = _mm256_add_epi64(middle1, _mm256_srli_epi64(right, 32));
+                __m256i middle = _mm256_add_epi64(middle2, _mm256_and_si256(temp_sum, low32_mask));
+                return _mm256_add_epi64(_mm256_add_epi64(left, _mm256_srli_epi64(temp_sum, 32)), 
+                    _mm256_srli_epi64(middle, 32));
+            }
+
+            __attribute__((target("avx2")))
+            inline __m256i mm256_multiply_uint64_lw64(__m256i operand1, __m256i operand2)
+            {
+                __m256i right = _mm256_mul_epu32(operand1, operand2);
+                __m256i middle = _mm256_add_epi64(
+                    _mm256_mul_epu32(_mm256_srli_epi64(operand1, 32), operand2),
+                    _mm256_mul_epu32(operand1, _mm256_srli_epi64(operand2, 32)));
+                return _mm256_add_epi64(right, _mm256_slli_epi64(middle, 32));
+            }
+
+            // Unsigned 64-bit comparison operand1 > operand2; AVX2 only has the signed one.
+            __attribute__((target("avx2")))
+            inline __m256i mm256_cmpgt_epu64(__m256i operand1, __m256i operand2)
+            {
+                const __m256i sign_bit = _mm256_set1_epi64x(static_cast<int64_t>(0x8000000000000000ULL));
+                return _mm256_cmpgt_epi64(_mm256_xor_si256(operand1, sign_bit), _mm256_xor_si256(operand2, sign_bit));
+            }
+
+            // Requires t to be a multiple of 4
+            __attribute__((target("avx2")))
+            void ntt_negacyclic_harvey_lazy_layer_avx2(uint64_t *operand, const SmallNTTTables &tables, int m, int t)
+            {
+                uint64_t modulus = tables.modulus().value();
+                const __m256i vec_modulus = _mm256_set1_epi64x(static_cast<int64_t>(modulus));
+                const __m256i vec_two_times_modulus = _mm256_set1_epi64x(static_cast<int64_t>(modulus * 2));
+                const __m256i vec_two_times_modulus_minus_one = _mm256_set1_epi64x(static_cast<int64_t>(modulus * 2 - 1));
+
+                for (int i = 0; i < m; i++)
+                {
+                    const __m256i W = _mm256_set1_epi64x(static_cast<int64_t>(tables.get_from_root_powers(m + i)));
+                    const __m256i Wprime = _mm256_set1_epi64x(static_cast<int64_t>(tables.get_from_scaled_root_powers(m + i)));
+
+                    __m256i *X = reinterpret_cast<__m256i*>(operand + 2 * i * t);
+                    __m256i *Y = reinterpret_cast<__m256i*>(operand + 2 * i * t + t);
+                    for (int j = 0; j < t; j += 4, X++, Y++)
+                    {
+                        __m256i currX = _mm256_loadu_si256(X);
+                        __m256i currY = _mm256_loadu_si256(Y);
+                        currX = _mm256_sub_epi64(currX, _mm256_and_si256(vec_two_times_modulus, 
+                            mm256_cmpgt_epu64(currX, vec_two_times_modulus_minus_one)));
+                        __m256i Q = mm256_multiply_uint64_hw64(Wprime, currY);
+                        Q = _mm256_sub_epi64(mm256_multiply_uint64_lw64(currY, W), mm256_multiply_uint64_lw64(Q, vec_modulus));
+                        _mm256_storeu_si256(X, _mm256_add_epi64(currX, Q));
+                        _mm256_storeu_si256(Y, _mm256_add_epi64(currX, _mm256_sub_epi64(vec_two_times_modulus, Q)));
+                    }
+                }
+            }
+
+            // Requires t to be a multiple of 4
+            __attribute__((target("avx2")))
+            void inverse_ntt_negacyclic_harvey_lazy_layer_avx2(uint64_t *operand, const SmallNTTTables &tables, int m, int t)
+            {
+                uint64_t modulus = tables.modulus().value();
+                const __m256i vec_modulus = _mm256_set1_epi64x(static_cast<int64_t>(modulus));
+                const __m256i vec_two_times_modulus = _mm256_set1_epi64x(static_cast<int64_t>(modulus * 2));
+                const __m256i one = _mm256_set1_epi64x(1);
+
+                int h = m >> 1;
+                for (int i = 0; i < h; i++)
+                {
+                    const __m256i W = _mm256_set1_epi64x(static_cast<int64_t>(tables.get_from_inv_root_powers_div_two(h + i)));
+                    const __m256i Wprime = _mm256_set1_epi64x(static_cast<int64_t>(tables.get_from_scaled_inv_root_powers_div_two(h + i)));
+
+                    __m256i *U = reinterpret_cast<__m256i*>(operand + 2 * i * t);
+                    __m256i *V = reinterpret_cast<__m256i*>(operand + 2 * i * t + t);
+                    for (int j = 0; j < t; j += 4, U++, V++)
+                    {
+                        __m256i currU = _mm256_loadu_si256(U);
+                        __m256i currV = _mm256_loadu_si256(V);
+                        __m256i T = _mm256_add_epi64(_mm256_sub_epi64(vec_two_times_modulus, currV), currU);
+
+                        // Subtract 2q from U + V unless (U << 1) < T
+                        __m256i keep = mm256_cmpgt_epu64(T, _mm256_slli_epi64(currU, 1));
+                        currU = _mm256_sub_epi64(_mm256_add_epi64(currU, currV), _mm256_andnot_si256(keep, vec_two_times_modulus));
+
+                        // Add q when T is odd and divide by two
+                        __m256i odd = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(T, one));
+                        _mm256_storeu_si256(U, _mm256_srli_epi64(_mm256_add_epi64(currU, _mm256_and_si256(vec_modulus, odd)), 1));
+
+                        __m256i H = mm256_multiply_uint64_hw64(Wprime, T);
+                        _mm256_storeu_si256(V, _mm256_sub_epi64(mm256_multiply_uint64_lw64(T, W), mm256_multiply_uint64_lw64(H, vec_modulus)));
+                    }
+                }
+            }
+#endif
+#ifdef SEAL_ENABLE_AVX512F
+            // GCC implements the unmasked multiply and shift intrinsics by merging into an
+            // undefined vector, which -Wmaybe-uninitialized reports; the zero-masked forms
+            // with every lane selected compile to the same instructions
+            constexpr __mmask8 all_lanes = 0xFF;
+
+            __attribute__((target("avx512f")))
+            inline __m512i mm512_multiply_uint64_hw64(__m512i operand1, __m512i operand2)
+            {
+                const __m512i low32_mask = _mm512_set1_epi64(0xFFFFFFFF);
+                __m512i operand1_hi = _mm512_maskz_srli_epi64(all_lanes, operand1, 32);
+                __m512i operand2_hi = _mm512_maskz_srli_epi64(all_lanes, operand2, 32);
+
+                __m512i right = _mm512_maskz_mul_epu32(all_lanes, operand1, operand2);
+                __m512i middle1 = _mm512_maskz_mul_epu32(all_lanes, operand1_hi, operand2);
+                __m512i middle2 = _mm512_maskz_mul_epu32(all_lanes, operand1, operand2_hi);
+                __m512i left = _mm512_maskz_mul_epu32(all_lanes, operand1_hi, operand2_hi);
+
+                __m512i temp_sum = _mm512_add_epi64(middle1, _mm512_maskz_srli_epi64(all_lanes, right, 32));
+                __m512i middle = _mm512_add_epi64(middle2, _mm512_and_si512(temp_sum, low32_mask));
+                return _mm512_add_epi64(_mm512_add_epi64(left, _mm512_maskz_srli_epi64(all_lanes, temp_sum, 32)), 
+                    _mm512_maskz_srli_epi64(all_lanes, middle, 32));
+            }
+
+            __attribute__((target("avx512f")))
+            inline __m512i mm512_multiply_uint64_lw64(__m512i operand1, __m512i operand2)
+            {
+                __m512i right = _mm512_maskz_mul_epu32(all_lanes, operand1, operand2);
+                __m512i middle = _mm512_add_epi64(
+                    _mm512_maskz_mul_epu32(all_lanes, _mm512_maskz_srli_epi64(all_lanes, operand1, 32), operand2),
+                    _mm512_maskz_mul_epu32(all_lanes, operand1, _mm512_maskz_srli_epi64(all_lanes, operand2, 32)));
+                return _mm512_add_epi64(right, _mm512_maskz_slli_epi64(all_lanes, middle, 32));
+            }
+
+            // Requires t to be a multiple of 8
+            __attribute__((target("avx512f")))
+            void ntt_negacyclic_harvey_lazy_layer_avx512f(uint64_t *operand, const SmallNTTTables &tables, int m, int t)
+            {
+                uint64_t modulus = tables.modulus().value();
+                const __m512i vec_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
+                const __m512i vec_two_times_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus * 2));
+
+                for (int i = 0; i < m; i++)
+                {
+                    const __m512i W = _mm512_set1_epi64(static_cast<int64_t>(tables.get_from_root_powers(m + i)));
+                    const __m512i Wprime = _mm512_set1_epi64(static_cast<int64_t>(tables.get_from_scaled_root_powers(m + i)));
+
+                    uint64_t *X = operand + 2 * i * t;
+                    uint64_t *Y = X + t;
+                    for (int j = 0; j < t; j += 8, X += 8, Y += 8)
+                    {
+                        __m512i currX = _mm512_loadu_si512(X);
+                        __m512i currY = _mm512_loadu_si512(Y);
+                        currX = _mm512_mask_sub_epi64(currX, _mm512_cmpge_epu64_mask(currX, vec_two_times_modulus), 
+                            currX, vec_two_times_modulus);
+                        __m512i Q = mm512_multiply_uint64_hw64(Wprime, currY);
+                        Q = _mm512_sub_epi64(mm512_multiply_uint64_lw64(currY, W), mm512_multiply_uint64_lw64(Q, vec_modulus));
+                        _mm512_storeu_si512(X, _mm512_add_epi64(currX, Q));
+                        _mm512_storeu_si512(Y, _mm512_add_epi64(currX, _mm512_sub_epi64(vec_two_times_modulus, Q)));
+                    }
+                }
+            }
+
+            // Requires t to be a multiple of 8
+            __attribute__((target("avx512f")))
+            void inverse_ntt_negacyclic_harvey_lazy_layer_avx512f(uint64_t *operand, const SmallNTTTables &tables, int m, int t)
+            {
+                uint64_t modulus = tables.modulus().value();
+                const __m512i vec_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
+                const __m512i vec_two_times_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus * 2));
+                const __m512i one = _mm512_set1_epi64(1);
+
+                int h = m >> 1;
+                for (int i = 0; i < h; i++)
+                {
+                    const __m512i W = _mm512_set1_epi64(static_cast<int64_t>(tables.get_from_inv_root_powers_div_two(h + i)));
+                    const __m512i Wprime = _mm512_set1_epi64(static_cast<int64_t>(tables.get_from_scaled_inv_root_powers_div_two(h + i)));
+
+                    uint64_t *U = operand + 2 * i * t;
+                    uint64_t *V = U + t;
+                    for (int j = 0; j < t; j += 8, U += 8, V += 8)
+                    {
+                        __m512i currU = _mm512_loadu_si512(U);
+                        __m512i currV = _mm512_loadu_si512(V);
+                        __m512i T = _mm512_add_epi64(_mm512_sub_epi64(vec_two_times_modulus, currV), currU);
+
+                        __m512i sum = _mm512_add_epi64(currU, currV);
+                        currU = _mm512_mask_sub_epi64(sum, _mm512_cmpge_epu64_mask(_mm512_maskz_slli_epi64(all_lanes, currU, 1), T), 
+                            sum, vec_two_times_modulus);
+                        currU = _mm512_mask_add_epi64(currU, _mm512_test_epi64_mask(T, one), currU, vec_modulus);
+                        _mm512_storeu_si512(U, _mm512_maskz_srli_epi64(all_lanes, currU, 1));
+
+                        __m512i H = mm512_multiply_uint64_hw64(Wprime, T);
+                        _mm512_storeu_si512(V, _mm512_sub_epi64(mm512_multiply_uint64_lw64(T, W), mm512_multiply_uint64_lw64(H, vec_modulus)));
+                    }
+                }
+            }
+#endif
+        }
+
+        SIMDLevel get_ntt_simd_level()
+        {
+            SIMDLevel simd_level = get_simd_level();
+#ifdef SEAL_ENABLE_AVX512F
+            if (simd_level >= SIMDLevel::avx512f)
+            {
+                return SIMDLevel::avx512f;
+            }
+#endif
+#ifdef SEAL_ENABLE_AVX2
+            if (simd_level >= SIMDLevel::avx2)
+            {
+                return SIMDLevel::avx2;
+            }
+#endif
+            return SIMDLevel::none;
+        }
+
+        /**
+        This function computes in-place the negacyclic NTT. The input is a polynomial a of degree n in R_q,
+        where n is assumed to be a power of 2 and q is a prime such that q = 1 (mod 2n).
+
+        The output is a vector A such that the following hold:
+        A[j] =  a(psi**(2*bit_reverse(j) + 1)), 0 <= j < n.
+
+        For details, see Michael Naehrig and Patrick Longa.
+
+        Layers with enough butterflies per group are dispatched to AVX-512F or AVX2 kernels
+        when the processor supports them (see util/cpufeatures.h); the output is identical.
+        */
+        void ntt_negacyclic_harvey_lazy(uint64_t *operand, const SmallNTTTables &tables)
+        {
+            SIMDLevel simd_level = get_ntt_simd_level();
+            // Return the NTT in scrambled order
+            int n = 1 << tables.coeff_count_power();
+            int t = n >> 1;
+            for (int m = 1; m < n; m <<= 1)
+            {
+#ifdef SEAL_ENABLE_AVX512F
+                if (simd_level == SIMDLevel::avx512f && t >= 8)
+                {
+                    ntt_negacyclic_harvey_lazy_layer_avx512f(operand, tables, m, t);
+                    t >>= 1;
+                    continue;
+                }
+#endif
+#ifdef SEAL_ENABLE_AVX2
+                if (simd_level == SIMDLevel::avx2 && t >= 4)
+                {
+                    ntt_negacyclic_harvey_lazy_layer_avx2(operand, tables, m, t);
+                    t >>= 1;
+                    continue;
+                }
+#endif
+                ntt_negacyclic_harvey_lazy_layer(operand, tables, m, t);
+                t >>= 1;
+            }
+        }
+
+        // Inverse negacyclic NTT using Harvey's butterfly. (See Patrick Longa and Michael Naehrig). 
+        void inverse_ntt_negacyclic_harvey_lazy(uint64_t *operand, const SmallNTTTables &tables)
+        {
+            SIMDLevel simd_level = get_ntt_simd_level();
+            // return the bit-reversed order of NTT. 
+            int n = 1 << tables.coeff_count_power();
+            int t = 1;
+
+            for (int m = n; m > 1; m >>= 1)
+            {
+#ifdef SEAL_ENABLE_AVX512F
+                if (simd_level == SIMDLevel::avx512f && t >= 8)
+                {
+                    inverse_ntt_negacyclic_harvey_lazy_layer_avx512f(operand, tables, m, t);
+                    t <<= 1;
+                    continue;
+                }
+#endif
+#ifdef SEAL_ENABLE_AVX2
+                if (simd_level == SIMDLevel::avx2 && t >= 4)
+                {
+                    inverse_ntt_negacyclic_harvey_lazy_layer_avx2(operand, tables, m, t);
+                    t <<= 1;
+                    continue;
+                }
+#endif
+                inverse_ntt_negacyclic_harvey_lazy_layer(operand, tables, m, t);
                 t <<= 1;
             }
         }
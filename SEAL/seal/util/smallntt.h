@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include "seal/memorypoolhandle.h"
 #include "seal/smallmodulus.h"
+#include "seal/util/cpufeatures.h"
 
 namespace seal
 {
@@ -200,6 +201,13 @@ namespace seal
 
         };
 
+        /**
+        Returns the SIMDLevel of the kernels that ntt_negacyclic_harvey_lazy(...) and
+        inverse_ntt_negacyclic_harvey_lazy(...) currently dispatch their wide layers to. This is
+        get_simd_level() limited to the kernels compiled into the library.
+        */
+        SIMDLevel get_ntt_simd_level();
+
         void ntt_negacyclic_harvey_lazy(std::uint64_t *operand, const SmallNTTTables &tables);
 
         inline void ntt_negacyclic_harvey(std::uint64_t *operand, const SmallNTTTables &tables)
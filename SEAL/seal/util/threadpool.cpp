@@ -0,0 +1,164 @@
+#include "seal/util/threadpool.h"
+#include <stdexcept>
+#include <exception>
+#include <algorithm>
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            // Set for threads currently executing a parallel_for task, so that nested
+            // calls run inline instead of waiting on workers that may all be busy.
+            thread_local bool inside_parallel_for = false;
+
+            struct ParallelForJob
+            {
+                const function<void(int)> *func;
+
+                int count;
+
+                atomic<int> next_index;
+
+                int pending_helpers;
+
+                exception_ptr error;
+
+                mutex job_mutex;
+
+                condition_variable done_cv;
+
+                void run()
+                {
+                    bool was_inside = inside_parallel_for;
+                    inside_parallel_for = true;
+                    int index;
+                    while ((index = next_index.fetch_add(1, memory_order_relaxed)) < count)
+                    {
+                        try
+                        {
+                            (*func)(index);
+                        }
+                        catch (...)
+                        {
+                            lock_guard<mutex> lock(job_mutex);
+                            if (!error)
+                            {
+                                error = current_exception();
+                            }
+                        }
+                    }
+                    inside_parallel_for = was_inside;
+                }
+            };
+        }
+
+        ThreadPool::ThreadPool(int thread_count) : stop_(false), max_concurrency_(thread_count)
+        {
+            if (thread_count < 1)
+            {
+                throw invalid_argument("thread_count must be positive");
+            }
+            workers_.reserve(thread_count - 1);
+            for (int i = 0; i < thread_count - 1; i++)
+            {
+                workers_.emplace_back(&ThreadPool::worker_loop, this);
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                lock_guard<mutex> lock(tasks_mutex_);
+                stop_ = true;
+            }
+            tasks_cv_.notify_all();
+            for (auto &worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        void ThreadPool::set_max_concurrency(int max_concurrency)
+        {
+            if (max_concurrency < 1)
+            {
+                throw invalid_argument("max_concurrency must be positive");
+            }
+            max_concurrency_.store(max_concurrency, memory_order_relaxed);
+        }
+
+        void ThreadPool::worker_loop()
+        {
+            while (true)
+            {
+                function<void()> task;
+                {
+                    unique_lock<mutex> lock(tasks_mutex_);
+                    tasks_cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                    if (tasks_.empty())
+                    {
+                        return;
+                    }
+                    task = move(tasks_.front());
+                    tasks_.pop_front();
+                }
+                task();
+            }
+        }
+
+        void ThreadPool::parallel_for(int count, const function<void(int)> &func)
+        {
+            if (count <= 0)
+            {
+                return;
+            }
+
+            int helper_count = min(min(max_concurrency(), thread_count()), count) - 1;
+            if (helper_count <= 0 || inside_parallel_for)
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    func(i);
+                }
+                return;
+            }
+
+            // The job lives on this stack frame; we do not return before all helpers
+            // have signaled that they are done with it.
+            ParallelForJob job;
+            job.func = &func;
+            job.count = count;
+            job.next_index.store(0, memory_order_relaxed);
+            job.pending_helpers = helper_count;
+
+            {
+                lock_guard<mutex> lock(tasks_mutex_);
+                for (int i = 0; i < helper_count; i++)
+                {
+                    tasks_.emplace_back([&job] {
+                        job.run();
+                        lock_guard<mutex> job_lock(job.job_mutex);
+                        if (--job.pending_helpers == 0)
+                        {
+                            job.done_cv.notify_one();
+                        }
+                    });
+                }
+            }
+            tasks_cv_.notify_all();
+
+            job.run();
+
+            unique_lock<mutex> job_lock(job.job_mutex);
+            job.done_cv.wait(job_lock, [&job] { return job.pending_helpers == 0; });
+            if (job.error)
+            {
+                rethrow_exception(job.error);
+            }
+        }
+    }
+}
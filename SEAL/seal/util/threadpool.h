@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        A fixed-size pool of worker threads used to spread independent pieces of a single
+        homomorphic operation (e.g. the per-prime NTTs in RNS arithmetic) across cores.
+        The thread calling parallel_for(...) always participates in the work, so a pool
+        with thread_count equal to T spawns only T-1 worker threads.
+        */
+        class ThreadPool
+        {
+        public:
+            ThreadPool(int thread_count);
+
+            ~ThreadPool();
+
+            inline int thread_count() const
+            {
+                return static_cast<int>(workers_.size()) + 1;
+            }
+
+            inline int max_concurrency() const
+            {
+                return max_concurrency_.load(std::memory_order_relaxed);
+            }
+
+            void set_max_concurrency(int max_concurrency);
+
+            // Calls func(0), ..., func(count - 1), distributing the calls over at most
+            // max_concurrency() threads, and returns once all of them have completed.
+            // Calls made from inside a task run sequentially on the calling thread. If
+            // any call throws, the first exception is rethrown after all calls finish.
+            void parallel_for(int count, const std::function<void(int)> &func);
+
+        private:
+            ThreadPool(const ThreadPool &copy) = delete;
+
+            ThreadPool &operator =(const ThreadPool &assign) = delete;
+
+            void worker_loop();
+
+            std::vector<std::thread> workers_;
+
+            std::deque<std::function<void()> > tasks_;
+
+            std::mutex tasks_mutex_;
+
+            std::condition_variable tasks_cv_;
+
+            bool stop_;
+
+            std::atomic<int> max_concurrency_;
+        };
+    }
+}
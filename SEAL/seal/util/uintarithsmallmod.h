@@ -178,6 +178,49 @@ namespace seal
             return barrett_reduce_128(z, modulus);
         }
 
+        // Returns floor(operand * 2^64 / modulus) for operand less than modulus. This is the 
+        // precomputed quotient that multiply_uint_scaled_mod needs to multiply by operand.
+        inline std::uint64_t scale_uint_mod(std::uint64_t operand, const SmallModulus &modulus)
+        {
+#ifdef SEAL_DEBUG
+            if (modulus.value() == 0)
+            {
+                throw std::invalid_argument("modulus");
+            }
+            if (operand >= modulus.value())
+            {
+                throw std::out_of_range("operand");
+            }
+#endif
+            std::uint64_t wide_operand[2]{ 0, operand };
+            std::uint64_t wide_quotient[2]{ 0 };
+            divide_uint128_uint64_inplace(wide_operand, modulus.value(), wide_quotient);
+            return wide_quotient[0];
+        }
+
+        // Returns operand1 * operand2 mod modulus, where scaled_operand2 is scale_uint_mod(operand2, modulus).
+        // This uses Shoup's method and is much faster than multiply_uint_uint_mod when operand2 is a 
+        // constant. Here operand1 can be any 64-bit value.
+        inline std::uint64_t multiply_uint_scaled_mod(std::uint64_t operand1, std::uint64_t operand2, 
+            std::uint64_t scaled_operand2, const SmallModulus &modulus)
+        {
+#ifdef SEAL_DEBUG
+            if (modulus.value() == 0)
+            {
+                throw std::invalid_argument("modulus");
+            }
+            if (operand2 >= modulus.value())
+            {
+                throw std::out_of_range("operand2");
+            }
+#endif
+            // The estimated quotient is at most one too small
+            std::uint64_t quotient;
+            multiply_uint64_hw64(operand1, scaled_operand2, &quotient);
+            std::uint64_t result = operand1 * operand2 - quotient * modulus.value();
+            return result - (modulus.value() & static_cast<std::uint64_t>(-static_cast<std::int64_t>(result >= modulus.value())));
+        }
+
         inline void modulo_uint_inplace(std::uint64_t *value, int value_uint64_count, const SmallModulus &modulus)
         {
 #ifdef SEAL_DEBUG
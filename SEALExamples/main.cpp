@@ -10,6 +10,7 @@
 #include <limits>
 
 #include "seal/seal.h"
+#include "seal/util/polyarithsmallmod.h"
 
 using namespace std;
 using namespace seal;
@@ -96,6 +97,12 @@ better performance in multi-threaded applications.
 */
 void example_performance_mt(int th_count);
 
+/*
+Compares Karatsuba and schoolbook tensoring of size 2 ciphertexts, which is the
+core of ciphertext multiplication.
+*/
+void example_performance_tensoring();
+
 int main()
 {
     cout << "SEAL version: " << SEAL_VERSION_STRING << endl;
@@ -110,6 +117,7 @@ int main()
         cout << "  5. Automatic Parameter Selection" << endl;
         cout << "  6. Single-Threaded Performance Test" << endl;
         cout << "  7. Multi-Threaded Performance Test" << endl;
+        cout << "  8. Tensoring Performance Test" << endl;
         cout << "  0. Exit" << endl;
 
         /*
@@ -166,6 +174,10 @@ int main()
             break;
         }
 
+        case 8:
+            example_performance_tensoring();
+            break;
+
         case 0: 
             return 0;
 
@@ -2024,3 +2036,85 @@ void example_performance_mt(int th_count)
         th_vector[i].join();
     }
 }
+
+void example_performance_tensoring()
+{
+    print_example_banner("Example: Tensoring Performance Test");
+
+    /*
+    Multiplying two ciphertexts of size 2 computes the tensor product 
+    (c0, c1) x (d0, d1) = (c0*d0, c0*d1 + c1*d0, c1*d1) modulo every prime of the
+    coefficient modulus and of an auxiliary base, with the operands in NTT form.
+    Karatsuba computes c0*d1 + c1*d0 as (c0 + c1)*(d0 + d1) - c0*d0 - c1*d1, which
+    saves one of the four products per coefficient but needs four more additions
+    and subtractions. Whether this is faster depends on how expensive a 64-bit 
+    product is. SEAL uses schoolbook by default; configure with --enable-karatsuba
+    (or define SEAL_USE_KARATSUBA_2X2) if this example shows Karatsuba winning 
+    on the target machine. Here we time both methods directly for the default parameters of each degree, so 
+    with growing numbers of primes, to show where the crossover lies on this 
+    machine.
+    */
+#ifdef SEAL_USE_KARATSUBA_2X2
+    cout << "Evaluator::multiply uses: Karatsuba" << endl << endl;
+#else
+    cout << "Evaluator::multiply uses: schoolbook" << endl << endl;
+#endif
+
+    int count = 20;
+    random_device rd;
+    cout << setw(12) << "degree" << setw(12) << "primes" << setw(20) << "schoolbook (us)" 
+        << setw(20) << "Karatsuba (us)" << setw(12) << "ratio" << endl;
+    for (int coeff_count : { 4096, 8192, 16384, 32768 })
+    {
+        vector<SmallModulus> primes = coeff_modulus_128(coeff_count);
+        int prime_count = static_cast<int>(primes.size());
+
+        /*
+        Operands are reduced modulo each prime, as they are after the forward NTT.
+        */
+        vector<uint64_t> operands(4 * coeff_count * prime_count);
+        vector<uint64_t> results(3 * coeff_count * prime_count);
+        for (int j = 0; j < prime_count; j++)
+        {
+            for (int i = 0; i < 4 * coeff_count; i++)
+            {
+                operands[(j * 4 * coeff_count) + i] = 
+                    ((static_cast<uint64_t>(rd()) << 32) | rd()) % primes[j].value();
+            }
+        }
+
+        chrono::microseconds time_sum[2]{ chrono::microseconds(0), chrono::microseconds(0) };
+        for (int i = 0; i < count; i++)
+        {
+            for (int method = 0; method < 2; method++)
+            {
+                auto time_start = chrono::high_resolution_clock::now();
+                for (int j = 0; j < prime_count; j++)
+                {
+                    const uint64_t *c0 = operands.data() + (j * 4 * coeff_count);
+                    uint64_t *result = results.data() + (j * 3 * coeff_count);
+                    if (method == 0)
+                    {
+                        util::dyadic_product_2x2_coeffmod(c0, c0 + coeff_count, 
+                            c0 + 2 * coeff_count, c0 + 3 * coeff_count, coeff_count, primes[j], 
+                            result, result + coeff_count, result + 2 * coeff_count);
+                    }
+                    else
+                    {
+                        util::dyadic_product_2x2_karatsuba_coeffmod(c0, c0 + coeff_count, 
+                            c0 + 2 * coeff_count, c0 + 3 * coeff_count, coeff_count, primes[j], 
+                            result, result + coeff_count, result + 2 * coeff_count);
+                    }
+                }
+                auto time_end = chrono::high_resolution_clock::now();
+                time_sum[method] += chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+            }
+        }
+
+        auto avg_schoolbook = time_sum[0].count() / count;
+        auto avg_karatsuba = time_sum[1].count() / count;
+        cout << setw(12) << coeff_count << setw(12) << prime_count << setw(20) << avg_schoolbook << setw(20) << avg_karatsuba 
+            << setw(12) << fixed << setprecision(2) 
+            << static_cast<double>(time_sum[1].count()) / time_sum[0].count() << endl;
+    }
+}
@@ -1,4 +1,5 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include "seal/base64.h"
 #include "seal/bigpoly.h"
@@ -11,13 +12,22 @@
 #include "seal/encryptor.h"
 #include "seal/encryptionparams.h"
 #include "seal/evaluator.h"
+#include "seal/evaluatorworkspace.h"
+#include "seal/exponentiationplan.h"
+#include "seal/galoiskeystore.h"
 #include "seal/keygenerator.h"
 #include "seal/memorypoolhandle.h"
 #include "seal/plaintext.h"
+#include "seal/plainmatrix.h"
+#include "seal/preparedciphertext.h"
 #include "seal/defaultparams.h"
 #include "seal/publickey.h"
+#include "seal/rotationplan.h"
 #include "seal/secretkey.h"
 #include "seal/polycrt.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
 
 namespace py = pybind11;
 
@@ -27,28 +37,214 @@ using namespace std;
 
 // http://pybind11.readthedocs.io/en/stable/classes.html
 
+// Releases the GIL while a long-running native function runs, so that Python threads calling
+// into SEAL run in parallel. The function must not touch Python objects; its arguments are
+// converted before the GIL is released, and its result after it is reacquired.
+using release_gil = py::call_guard<py::gil_scoped_release>;
+
+// Arrays that are passed to SEAL without copying must be C-contiguous and of the exact dtype
+template<class T>
+using c_array = py::array_t<T, py::array::c_style>;
+
+// Returns a read-only array of the given shape over data owned by owner, which the array
+// keeps alive. The array is invalidated if the owner is resized.
+py::array read_only_view(const std::uint64_t *data, std::vector<py::ssize_t> shape, py::handle owner) {
+    py::array_t<std::uint64_t> view(shape, data, owner);
+    view.attr("setflags")("write"_a = false);
+    return view;
+}
+
+template<class T>
+void compose_array(PolyCRTBuilder &crtbuilder, c_array<T> values, Plaintext &destination) {
+    if (values.size() > static_cast<py::ssize_t>(crtbuilder.slot_count())) {
+        throw std::logic_error("values_matrix size is too large");
+    }
+    const T *data = values.data();
+    int count = static_cast<int>(values.size());
+    py::gil_scoped_release release;
+    crtbuilder.compose(data, count, destination);
+}
+
 template<class T>
-py::tuple serialize(T &c) {
-    std::stringstream output(std::ios::binary | std::ios::out);
+void decompose_array(PolyCRTBuilder &crtbuilder, const Plaintext &plain, c_array<T> destination) {
+    if (destination.size() < static_cast<py::ssize_t>(crtbuilder.slot_count())) {
+        throw std::invalid_argument("destination is smaller than slot count");
+    }
+    T *data = destination.mutable_data();
+    py::gil_scoped_release release;
+    crtbuilder.decompose(plain, data);
+}
+
+// Collects the output of save() in a string, which is then copied once into a bytes object
+class string_streambuf : public std::streambuf {
+public:
+    const std::string &str() const {
+        return str_;
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            str_.push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char *s, std::streamsize count) override {
+        str_.append(s, static_cast<std::size_t>(count));
+        return count;
+    }
+
+private:
+    std::string str_;
+};
+
+// Reads a sequence of memory ranges as one stream without copying them
+class memory_streambuf : public std::streambuf {
+public:
+    void append(const void *data, std::size_t byte_count) {
+        ranges_.emplace_back(static_cast<char *>(const_cast<void *>(data)), byte_count);
+    }
+
+protected:
+    int_type underflow() override {
+        while (gptr() == egptr() && next_range_ < ranges_.size()) {
+            char *begin = ranges_[next_range_].first;
+            setg(begin, begin, begin + ranges_[next_range_].second);
+            next_range_++;
+        }
+        return gptr() == egptr() ? traits_type::eof() : traits_type::to_int_type(*gptr());
+    }
+
+private:
+    std::vector<std::pair<char *, std::size_t>> ranges_;
+    std::size_t next_range_ = 0;
+};
+
+// Returns the size in bytes of a buffer, such as a bytes object or an out-of-band pickle buffer,
+// after checking that its memory is C-contiguous
+std::size_t contiguous_byte_count(const py::buffer_info &info) {
+    py::ssize_t stride = info.itemsize;
+    for (py::ssize_t i = static_cast<py::ssize_t>(info.ndim) - 1; i >= 0; i--) {
+        if (info.shape[i] > 1 && info.strides[i] != stride) {
+            throw std::invalid_argument("(Pickle) Buffer is not contiguous!");
+        }
+        stride *= info.shape[i];
+    }
+    return static_cast<std::size_t>(info.size * info.itemsize);
+}
+
+template<class T>
+py::bytes to_bytes(const T &c) {
+    string_streambuf output_buffer;
+    std::ostream output(&output_buffer);
     c.save(output);
-    std::string cipherstr = output.str();
-    std::string base64_encoded_cipher = base64_encode(reinterpret_cast<const unsigned char*>(cipherstr.c_str()), cipherstr.length());
-    return py::make_tuple(base64_encoded_cipher);
+    return py::bytes(output_buffer.str().data(), output_buffer.str().size());
+}
+
+// Loads c from the concatenation of the given buffers without copying them first
+template<class T>
+void load_buffers(T &c, const std::vector<py::buffer> &buffers) {
+    std::vector<py::buffer_info> infos;
+    infos.reserve(buffers.size());
+    memory_streambuf input_buffer;
+    for (const py::buffer &buffer : buffers) {
+        infos.push_back(buffer.request());
+        input_buffer.append(infos.back().ptr, contiguous_byte_count(infos.back()));
+    }
+    std::istream input(&input_buffer);
+    c.load(input);
+    if (!input || input.peek() != std::char_traits<char>::eof()) {
+        throw std::invalid_argument("(Pickle) Input has the wrong size!");
+    }
+}
+
+template<class T>
+py::tuple serialize(const T &c) {
+    return py::make_tuple(to_bytes(c));
 }
 
 template<class T>
 T deserialize(py::tuple t) {
     if (t.size() != 1)
         throw std::runtime_error("(Pickle) Invalid input tuple!");
+
     T c = T();
-    std::string cipherstr_encoded = t[0].cast<std::string>();
-    std::string cipherstr_decoded = base64_decode(cipherstr_encoded);
-    std::stringstream input(std::ios::binary | std::ios::in);
-    input.str(cipherstr_decoded);
-    c.load(input);
+
+    // Objects pickled by earlier versions hold the output of save() encoded in base64
+    if (py::isinstance<py::str>(t[0])) {
+        std::string decoded = base64_decode(t[0].cast<std::string>());
+        std::stringstream input(std::ios::binary | std::ios::in);
+        input.str(decoded);
+        c.load(input);
+        return c;
+    }
+    load_buffers(c, { t[0].cast<py::buffer>() });
     return c;
 }
 
+// Returns what pickle needs to create an uninitialized object like self and pass state to its
+// __setstate__, which is defined by py::pickle
+py::tuple reduce_with_state(py::object self, py::tuple state) {
+    return py::make_tuple(py::module::import("copyreg").attr("__newobj__"),
+        py::make_tuple(self.attr("__class__")), state);
+}
+
+// With protocol 5 or higher, a ciphertext is pickled as its metadata and a PickleBuffer over
+// its coefficients, which pickle can pass out-of-band without copying them. A ciphertext with
+// a seed is pickled in the compact form of save() instead, which is half the size.
+py::tuple reduce_ciphertext(py::object self, int protocol) {
+    const Ciphertext &encrypted = self.cast<const Ciphertext &>();
+    if (protocol < 5 || encrypted.has_seed()) {
+        return reduce_with_state(self, serialize(encrypted));
+    }
+    string_streambuf metadata_buffer;
+    std::ostream metadata(&metadata_buffer);
+    encrypted.save_metadata(metadata);
+    py::object coefficients = py::module::import("pickle").attr("PickleBuffer")(
+        read_only_view(encrypted.pointer(), { encrypted.uint64_count() }, self));
+    return reduce_with_state(self, py::make_tuple(
+        py::bytes(metadata_buffer.str().data(), metadata_buffer.str().size()), coefficients));
+}
+
+Ciphertext deserialize_ciphertext(py::tuple t) {
+    if (t.size() != 2) {
+        return deserialize<Ciphertext>(t);
+    }
+    Ciphertext encrypted;
+    load_buffers(encrypted, { t[0].cast<py::buffer>(), t[1].cast<py::buffer>() });
+    return encrypted;
+}
+
+// With protocol 5 or higher, a plaintext is pickled as its coefficient count and a PickleBuffer
+// over its coefficients
+py::tuple reduce_plaintext(py::object self, int protocol) {
+    const Plaintext &plain = self.cast<const Plaintext &>();
+    if (protocol < 5) {
+        return reduce_with_state(self, serialize(plain));
+    }
+    py::object coefficients = py::module::import("pickle").attr("PickleBuffer")(
+        read_only_view(plain.pointer(), { plain.coeff_count() }, self));
+    return reduce_with_state(self, py::make_tuple(plain.coeff_count(), coefficients));
+}
+
+Plaintext deserialize_plaintext(py::tuple t) {
+    if (t.size() != 2) {
+        return deserialize<Plaintext>(t);
+    }
+    int coeff_count = t[0].cast<int>();
+    py::buffer_info info = t[1].cast<py::buffer>().request();
+    std::size_t byte_count = contiguous_byte_count(info);
+    if (coeff_count < 0 || byte_count != static_cast<std::size_t>(coeff_count) * sizeof(std::uint64_t)) {
+        throw std::invalid_argument("(Pickle) Input has the wrong size!");
+    }
+    Plaintext plain(coeff_count);
+    if (byte_count > 0) {
+        std::memcpy(plain.pointer(), info.ptr, byte_count);
+    }
+    return plain;
+}
+
 PYBIND11_MODULE(seal, m) {
 
   py::class_<BigPoly>(m, "BigPoly")
@@ -184,34 +380,46 @@ PYBIND11_MODULE(seal, m) {
     .def("reserve", (void (Ciphertext::*)(const EncryptionParameters &, int, const MemoryPoolHandle &)) &Ciphertext::reserve,
         "Allocates enough memory to accommodate the backing array of a ciphertext with given capacity")
     .def("size", &Ciphertext::size, "Returns the capacity of the allocation")
-    .def(py::pickle(&serialize<Ciphertext>, &deserialize<Ciphertext>))
+    .def("is_ntt_form", &Ciphertext::is_ntt_form, "Returns whether the ciphertext is in NTT form")
+    .def("has_seed", &Ciphertext::has_seed, "Returns whether the ciphertext is stored in seeded compact form")
+    .def("as_array", [](py::object self) {
+          const Ciphertext &encrypted = self.cast<const Ciphertext &>();
+          return read_only_view(encrypted.pointer(), { encrypted.size(), encrypted.coeff_mod_count(),
+            encrypted.poly_coeff_count() }, self);
+        }, "Returns a read-only uint64 array view of the coefficients, of shape (size, coeff_mod_count, \
+        poly_coeff_count). The view is invalidated if the ciphertext is resized")
+    .def(py::pickle(&serialize<Ciphertext>, &deserialize_ciphertext))
+    .def("__reduce_ex__", &reduce_ciphertext, "Pickles the ciphertext, passing its coefficients out-of-band \
+        with protocol 5")
     .def("save", (void (Ciphertext::*)(std::string &)) &Ciphertext::python_save,
         "Saves Ciphertext object to file given filepath")
     .def("load", (void (Ciphertext::*)(std::string &)) &Ciphertext::python_load,
         "Loads Ciphertext object from file given filepath");
 
   py::class_<Decryptor>(m, "Decryptor")
-    .def(py::init<const SEALContext &, const SecretKey &>())
-    .def(py::init<const SEALContext &, const SecretKey &, const MemoryPoolHandle &>())
+    .def(py::init<const SEALContext &, const SecretKey &>(), release_gil())
+    .def(py::init<const SEALContext &, const SecretKey &, const MemoryPoolHandle &>(), release_gil())
     .def("decrypt", (void (Decryptor::*)(const Ciphertext &, Plaintext &, const MemoryPoolHandle &)) &Decryptor::decrypt,
-        "Decrypts a ciphertext and writes the result to a given destination.")
+        "Decrypts a ciphertext and writes the result to a given destination.", release_gil())
     .def("decrypt", (void (Decryptor::*)(const Ciphertext &, Plaintext &)) &Decryptor::decrypt,
-        "Decrypts a ciphertext and writes the result to a given destination.")
+        "Decrypts a ciphertext and writes the result to a given destination.", release_gil())
     .def("invariant_noise_budget", (int (Decryptor::*)(const Ciphertext &))
-        &Decryptor::invariant_noise_budget, "Returns noise budget")
+        &Decryptor::invariant_noise_budget, "Returns noise budget", release_gil())
     .def("invariant_noise_budget", (int (Decryptor::*)(const Ciphertext &, const MemoryPoolHandle &))
-        &Decryptor::invariant_noise_budget, "Returns noise budget");
+        &Decryptor::invariant_noise_budget, "Returns noise budget", release_gil());
 
   py::class_<Encryptor>(m, "Encryptor")
-    .def(py::init<const SEALContext &, const PublicKey &>())
-    .def(py::init<const SEALContext &, const PublicKey &, const MemoryPoolHandle &>())
-    .def(py::init<const Encryptor &>())
-    .def(py::init<Encryptor &>())
+    .def(py::init<const SEALContext &, const PublicKey &>(), release_gil())
+    .def(py::init<const SEALContext &, const PublicKey &, const MemoryPoolHandle &>(), release_gil())
+    .def(py::init<const SEALContext &, const SecretKey &>(), release_gil())
+    .def(py::init<const SEALContext &, const SecretKey &, const MemoryPoolHandle &>(), release_gil())
+    .def(py::init<const Encryptor &>(), release_gil())
+    .def(py::init<Encryptor &>(), release_gil())
     .def("encrypt", (void (Encryptor::*)(const Plaintext &, Ciphertext &,
         const MemoryPoolHandle &)) &Encryptor::encrypt,
-        "Encrypts a plaintext and writes the result to a given destination")
+        "Encrypts a plaintext and writes the result to a given destination", release_gil())
     .def("encrypt", (void (Encryptor::*)(const Plaintext &, Ciphertext &)) &Encryptor::encrypt,
-        "Encrypts a plaintext and writes the result to a given destination");
+        "Encrypts a plaintext and writes the result to a given destination", release_gil());
 
   py::class_<EncryptionParameters>(m, "EncryptionParameters")
     .def(py::init<>())
@@ -242,104 +450,151 @@ PYBIND11_MODULE(seal, m) {
     .def("decomposition_bit_count", &EvaluationKeys::decomposition_bit_count, "Returns the decomposition bit count");
 
   py::class_<Evaluator>(m, "Evaluator")
-    .def(py::init<const SEALContext &>())
-    .def(py::init<const SEALContext &, const MemoryPoolHandle &>())
+    .def(py::init<const SEALContext &>(), release_gil())
+    .def(py::init<const SEALContext &, const MemoryPoolHandle &>(), release_gil())
     .def("square", (void (Evaluator::*)(Ciphertext &)) &Evaluator::square,
-        "Squares a ciphertext")
+        "Squares a ciphertext", release_gil())
     .def("square", (void (Evaluator::*)(Ciphertext &, const MemoryPoolHandle &)) &Evaluator::square,
-        "Squares a ciphertext")
+        "Squares a ciphertext", release_gil())
     .def("add_many", (void (Evaluator::*)(const std::vector<Ciphertext> &, Ciphertext &)) &Evaluator::add_many,
-        "Adds together a vector of ciphertexts and stores the result in the destination parameter.")
+        "Adds together a vector of ciphertexts and stores the result in the destination parameter.", release_gil())
+    .def("dot_product", (void (Evaluator::*)(const std::vector<Ciphertext> &,
+        const std::vector<Ciphertext> &, Ciphertext &)) &Evaluator::dot_product,
+        "Computes the inner product of two vectors of ciphertexts.", release_gil())
+    .def("dot_product", (void (Evaluator::*)(const std::vector<Ciphertext> &,
+        const std::vector<Ciphertext> &, Ciphertext &, const MemoryPoolHandle &)) &Evaluator::dot_product,
+        "Computes the inner product of two vectors of ciphertexts.", release_gil())
+    .def("dot_product_plain", &Evaluator::dot_product_plain,
+        "Computes the inner product of NTT transformed ciphertexts and plaintexts.", release_gil())
+    .def("transform_to_ntt", (void (Evaluator::*)(Plaintext &)) &Evaluator::transform_to_ntt,
+        "Transforms a plaintext to NTT domain.", release_gil())
+    .def("transform_to_ntt", (void (Evaluator::*)(Ciphertext &)) &Evaluator::transform_to_ntt,
+        "Transforms a ciphertext to NTT domain.", release_gil())
+    .def("transform_from_ntt", (void (Evaluator::*)(Ciphertext &)) &Evaluator::transform_from_ntt,
+        "Transforms a ciphertext back from NTT domain.", release_gil())
     .def("add_plain", (void (Evaluator::*)(Ciphertext &, const Plaintext &)) &Evaluator::add_plain,
-        "Adds a ciphertext and a plaintext.")
+        "Adds a ciphertext and a plaintext.", release_gil())
     .def("add_plain", (void (Evaluator::*)(const Ciphertext &, const Plaintext &, Ciphertext &))
-        &Evaluator::add_plain, "Adds a ciphertext and a plaintext.")
+        &Evaluator::add_plain, "Adds a ciphertext and a plaintext.", release_gil())
     .def("sub_plain", (void (Evaluator::*)(Ciphertext &, const Plaintext &))
-        &Evaluator::sub_plain, "Subtracts a plaintext from a ciphertext.")
+        &Evaluator::sub_plain, "Subtracts a plaintext from a ciphertext.", release_gil())
     .def("sub_plain", (void (Evaluator::*)(const Ciphertext &, const Plaintext &, Ciphertext &))
-        &Evaluator::sub_plain, "Subtracts a plaintext from a ciphertext.")
+        &Evaluator::sub_plain, "Subtracts a plaintext from a ciphertext.", release_gil())
     .def("exponentiate", (void (Evaluator::*)(Ciphertext &, std::uint64_t,
         const EvaluationKeys &, const MemoryPoolHandle &))
-        &Evaluator::exponentiate, "Exponentiates a ciphertext.")
+        &Evaluator::exponentiate, "Exponentiates a ciphertext.", release_gil())
     .def("exponentiate", (void (Evaluator::*)(Ciphertext &, std::uint64_t,
         const EvaluationKeys &))
-        &Evaluator::exponentiate, "Exponentiates a ciphertext.")
+        &Evaluator::exponentiate, "Exponentiates a ciphertext.", release_gil())
     .def("exponentiate", (void (Evaluator::*)(const Ciphertext &, std::uint64_t,
         const EvaluationKeys &, Ciphertext &, const MemoryPoolHandle &))
-        &Evaluator::exponentiate, "Exponentiates a ciphertext.")
+        &Evaluator::exponentiate, "Exponentiates a ciphertext.", release_gil())
     .def("exponentiate", (void (Evaluator::*)(const Ciphertext &, std::uint64_t,
         const EvaluationKeys &, Ciphertext &))
-        &Evaluator::exponentiate, "Exponentiates a ciphertext.")
+        &Evaluator::exponentiate, "Exponentiates a ciphertext.", release_gil())
+    .def("exponentiate", (void (Evaluator::*)(Ciphertext &, const ExponentiationPlan &,
+        const EvaluationKeys &, const MemoryPoolHandle &))
+        &Evaluator::exponentiate, "Exponentiates a ciphertext following an ExponentiationPlan.", release_gil())
+    .def("exponentiate", (void (Evaluator::*)(Ciphertext &, const ExponentiationPlan &,
+        const EvaluationKeys &))
+        &Evaluator::exponentiate, "Exponentiates a ciphertext following an ExponentiationPlan.", release_gil())
+    .def("exponentiate", (void (Evaluator::*)(const Ciphertext &, const ExponentiationPlan &,
+        const EvaluationKeys &, Ciphertext &))
+        &Evaluator::exponentiate, "Exponentiates a ciphertext following an ExponentiationPlan.", release_gil())
     .def("negate", (void (Evaluator::*)(Ciphertext &)) &Evaluator::negate,
-        "Negates a ciphertext")
+        "Negates a ciphertext", release_gil())
     .def("negate", (void (Evaluator::*)(const Ciphertext &, Ciphertext &)) &Evaluator::negate,
-        "Negates a ciphertext and writes to a given destination")
+        "Negates a ciphertext and writes to a given destination", release_gil())
     .def("add", (void (Evaluator::*)(const Ciphertext &, const Ciphertext &,
         Ciphertext &)) &Evaluator::add,
-        "Adds two ciphertexts and writes to a given destination")
+        "Adds two ciphertexts and writes to a given destination", release_gil())
     .def("add", (void (Evaluator::*)(Ciphertext &, const Ciphertext &)) &Evaluator::add,
-        "Adds two ciphertexts and writes output over the first ciphertext")
+        "Adds two ciphertexts and writes output over the first ciphertext", release_gil())
     .def("sub", (void (Evaluator::*)(Ciphertext &, const Ciphertext &)) &Evaluator::sub,
-        "Subtracts two ciphertexts and writes output over the first ciphertext")
+        "Subtracts two ciphertexts and writes output over the first ciphertext", release_gil())
     .def("sub", (void (Evaluator::*)(const Ciphertext &, const Ciphertext &,
         Ciphertext &)) &Evaluator::sub,
-        "Subtracts two ciphertexts and writes to a given destination")
+        "Subtracts two ciphertexts and writes to a given destination", release_gil())
     .def("multiply", (void (Evaluator::*)(Ciphertext &, const Ciphertext &,
         const MemoryPoolHandle &)) &Evaluator::multiply,
-        "Multiplies two ciphertexts and writes output over the first ciphertext")
+        "Multiplies two ciphertexts and writes output over the first ciphertext", release_gil())
     .def("multiply", (void (Evaluator::*)(Ciphertext &, const Ciphertext &)) &Evaluator::multiply,
-        "Multiplies two ciphertexts and writes output over the first ciphertext")
+        "Multiplies two ciphertexts and writes output over the first ciphertext", release_gil())
     .def("multiply", (void (Evaluator::*)(const Ciphertext &, const Ciphertext &,
         Ciphertext &, const MemoryPoolHandle &)) &Evaluator::multiply,
-        "Multiplies two ciphertexts and writes to a given destination")
+        "Multiplies two ciphertexts and writes to a given destination", release_gil())
     .def("multiply", (void (Evaluator::*)(const Ciphertext &, const Ciphertext &,
         Ciphertext &)) &Evaluator::multiply,
-        "Multiplies two ciphertexts and writes to a given destination")
+        "Multiplies two ciphertexts and writes to a given destination", release_gil())
+    .def("prepare", (void (Evaluator::*)(const Ciphertext &, PreparedCiphertext &))
+        &Evaluator::prepare, "Prepares a ciphertext for repeated multiplication", release_gil())
+    .def("multiply", (void (Evaluator::*)(const PreparedCiphertext &, const Ciphertext &,
+        Ciphertext &)) &Evaluator::multiply,
+        "Multiplies a prepared ciphertext with a ciphertext and writes to a given destination", release_gil())
     .def("multiply_plain", (void (Evaluator::*)(Ciphertext &, const Plaintext &,
         const MemoryPoolHandle &)) &Evaluator::multiply_plain,
-        "Multiplies a ciphertext with a plaintext")
+        "Multiplies a ciphertext with a plaintext", release_gil())
     .def("multiply_plain", (void (Evaluator::*)(Ciphertext &, const Plaintext &))
-        &Evaluator::multiply_plain, "Multiplies a ciphertext with a plaintext")
+        &Evaluator::multiply_plain, "Multiplies a ciphertext with a plaintext", release_gil())
     .def("multiply_plain", (void (Evaluator::*)(const Ciphertext &, const Plaintext &,
         Ciphertext &, const MemoryPoolHandle &)) &Evaluator::multiply_plain,
-        "Multiplies a ciphertext with a plaintext and writes to a given destination")
+        "Multiplies a ciphertext with a plaintext and writes to a given destination", release_gil())
     .def("multiply_plain", (void (Evaluator::*)(const Ciphertext &, const Plaintext &,
         Ciphertext &)) &Evaluator::multiply_plain,
-        "Multiplies a ciphertext with a plaintext and writes to a given destination")
+        "Multiplies a ciphertext with a plaintext and writes to a given destination", release_gil())
     .def("relinearize", (void (Evaluator::*)(Ciphertext &, const EvaluationKeys &,
-        const MemoryPoolHandle &)) &Evaluator::relinearize, "Relinearizes a ciphertext")
+        const MemoryPoolHandle &)) &Evaluator::relinearize, "Relinearizes a ciphertext", release_gil())
     .def("relinearize", (void (Evaluator::*)(Ciphertext &, const EvaluationKeys &))
-        &Evaluator::relinearize, "Relinearizes a ciphertext")
+        &Evaluator::relinearize, "Relinearizes a ciphertext", release_gil())
     .def("relinearize", (void (Evaluator::*)(const Ciphertext &, const EvaluationKeys &,
         Ciphertext &, const MemoryPoolHandle &)) &Evaluator::relinearize,
-        "Relinearizes a ciphertext and writes to a given destination")
+        "Relinearizes a ciphertext and writes to a given destination", release_gil())
     .def("relinearize", (void (Evaluator::*)(const Ciphertext &, const EvaluationKeys &,
         Ciphertext &)) &Evaluator::relinearize,
-        "Relinearizes a ciphertext and writes to a given destination")
+        "Relinearizes a ciphertext and writes to a given destination", release_gil())
     .def("rotate_rows", (void (Evaluator::*)(const Ciphertext &, int,
         const GaloisKeys &, Ciphertext &)) &Evaluator::rotate_rows,
-        "Rotates plaintext matrix rows cyclically")
+        "Rotates plaintext matrix rows cyclically", release_gil())
     .def("rotate_rows", (void (Evaluator::*)(const Ciphertext &, int,
         const GaloisKeys &, Ciphertext &, const MemoryPoolHandle &)) &Evaluator::rotate_rows,
-        "Rotates plaintext matrix rows cyclically")
+        "Rotates plaintext matrix rows cyclically", release_gil())
     .def("rotate_rows", (void (Evaluator::*)(Ciphertext &, int,
         const GaloisKeys &, const MemoryPoolHandle &)) &Evaluator::rotate_rows,
-        "Rotates plaintext matrix rows cyclically")
+        "Rotates plaintext matrix rows cyclically", release_gil())
     .def("rotate_rows", (void (Evaluator::*)(Ciphertext &, int,
         const GaloisKeys &)) &Evaluator::rotate_rows,
-        "Rotates plaintext matrix rows cyclically")
+        "Rotates plaintext matrix rows cyclically", release_gil())
+    .def("rotate_rows_many", [](Evaluator &evaluator, const Ciphertext &encrypted,
+        const std::vector<int> &steps, const GaloisKeys &galois_keys) {
+            std::vector<Ciphertext> destination;
+            evaluator.rotate_rows_many(encrypted, steps, galois_keys, destination);
+            return destination;
+        }, "Rotates plaintext matrix rows cyclically by several step counts at once", release_gil())
+    .def("multiply_plain_matrix", (void (Evaluator::*)(const Ciphertext &, const PlainMatrix &,
+        const GaloisKeys &, Ciphertext &)) &Evaluator::multiply_plain_matrix,
+        "Multiplies a plaintext matrix with an encrypted vector of batching slots", release_gil())
     .def("rotate_columns", (void (Evaluator::*)(Ciphertext &,
         const GaloisKeys &, const MemoryPoolHandle &)) &Evaluator::rotate_columns,
-        "Rotates plaintext matrix rows cyclically")
+        "Rotates plaintext matrix rows cyclically", release_gil())
     .def("rotate_columns", (void (Evaluator::*)(Ciphertext &,
         const GaloisKeys &)) &Evaluator::rotate_columns,
-        "Rotates plaintext matrix rows cyclically")
+        "Rotates plaintext matrix rows cyclically", release_gil())
     .def("rotate_columns", (void (Evaluator::*)(const Ciphertext &, const GaloisKeys &,
         Ciphertext &, const MemoryPoolHandle &)) &Evaluator::rotate_columns,
-        "Rotates plaintext matrix rows cyclically")
+        "Rotates plaintext matrix rows cyclically", release_gil())
     .def("rotate_columns", (void (Evaluator::*)(const Ciphertext &, const GaloisKeys &,
         Ciphertext &)) &Evaluator::rotate_columns,
-        "Rotates plaintext matrix rows cyclically");
+        "Rotates plaintext matrix rows cyclically", release_gil())
+    .def("mod_switch_to_next", (void (Evaluator::*)(Ciphertext &)) &Evaluator::mod_switch_to_next,
+        "Switches a ciphertext down to the next level of the coefficient modulus", release_gil())
+    .def("mod_switch_to_next", (void (Evaluator::*)(const Ciphertext &, Ciphertext &)) &Evaluator::mod_switch_to_next,
+        "Switches a ciphertext down to the next level of the coefficient modulus", release_gil())
+    .def("mod_switch_to", (void (Evaluator::*)(Ciphertext &, int)) &Evaluator::mod_switch_to,
+        "Switches a ciphertext down to a given level of the coefficient modulus", release_gil())
+    .def("mod_switch_to", (void (Evaluator::*)(const Ciphertext &, int, Ciphertext &)) &Evaluator::mod_switch_to,
+        "Switches a ciphertext down to a given level of the coefficient modulus", release_gil())
+    .def("min_level", &Evaluator::min_level,
+        "Returns the lowest level that ciphertexts can be switched down to");
 
   py::class_<FractionalEncoder>(m, "FractionalEncoder")
     .def(py::init<const SmallModulus &, const BigPoly &, int, int,
@@ -357,7 +612,37 @@ PYBIND11_MODULE(seal, m) {
 
   py::class_<GaloisKeys>(m, "GaloisKeys")
     .def(py::init<>())
-    .def(py::init<const GaloisKeys &>());
+    .def(py::init<const GaloisKeys &>())
+    .def(py::init<const std::shared_ptr<GaloisKeyStore> &>())
+    .def("size", &GaloisKeys::size, "Returns the current number of Galois keys")
+    .def("has_key", &GaloisKeys::has_key,
+        "Returns whether a Galois key corresponding to a given Galois element exists")
+    .def("galois_elts", &GaloisKeys::galois_elts,
+        "Returns the Galois elements for which a Galois key exists");
+
+  py::class_<GaloisKeyStore, std::shared_ptr<GaloisKeyStore>>(m, "GaloisKeyStore")
+    .def(py::init<const std::string &, std::size_t>(), py::arg("path"), py::arg("max_cache_byte_count") = 0)
+    .def_static("save", [](const GaloisKeys &galois_keys, const std::string &path) {
+          std::ofstream stream(path, std::ios::binary);
+          GaloisKeyStore::save(galois_keys, stream);
+        }, "Writes Galois keys to a file that GaloisKeyStore loads them from on demand")
+    .def("size", &GaloisKeyStore::size, "Returns the number of keys in the store")
+    .def("has_key", &GaloisKeyStore::has_key,
+        "Returns whether the store has a key for the given Galois element")
+    .def("galois_elts", &GaloisKeyStore::galois_elts,
+        "Returns the Galois elements of the keys in the store")
+    .def("prefetch", (void (GaloisKeyStore::*)(const std::vector<std::uint64_t> &)) &GaloisKeyStore::prefetch,
+        "Starts loading the keys for the given Galois elements in the background")
+    .def("max_cache_byte_count", &GaloisKeyStore::max_cache_byte_count,
+        "Returns the largest number of bytes that loaded keys take in memory")
+    .def("set_max_cache_byte_count", &GaloisKeyStore::set_max_cache_byte_count,
+        "Sets the largest number of bytes that loaded keys take in memory")
+    .def("cache_byte_count", &GaloisKeyStore::cache_byte_count,
+        "Returns the number of bytes that the keys in the cache take in memory")
+    .def("cached_key_count", &GaloisKeyStore::cached_key_count,
+        "Returns the number of keys in the cache")
+    .def("load_count", &GaloisKeyStore::load_count,
+        "Returns the number of times a key has been loaded from the file");
 
   py::class_<IntegerEncoder>(m, "IntegerEncoder")
     .def(py::init<const SmallModulus &, std::uint64_t, const MemoryPoolHandle &>())
@@ -384,18 +669,24 @@ PYBIND11_MODULE(seal, m) {
     //    "Decodes a plaintext polynomial and returns the result as std::uint32_t");
 
   py::class_<KeyGenerator>(m, "KeyGenerator")
-    .def(py::init<const SEALContext &>())
-    .def(py::init<const SEALContext &, const MemoryPoolHandle &>())
-    .def(py::init<const SEALContext &, const SecretKey &, const PublicKey &, const MemoryPoolHandle &>())
+    .def(py::init<const SEALContext &>(), release_gil())
+    .def(py::init<const SEALContext &, const MemoryPoolHandle &>(), release_gil())
+    .def(py::init<const SEALContext &, const SecretKey &, const PublicKey &, const MemoryPoolHandle &>(), release_gil())
     .def("generate_evaluation_keys", (void (KeyGenerator::*)(int, int,
         EvaluationKeys &)) &KeyGenerator::generate_evaluation_keys,
-        "Generates the specified number of evaluation keys")
+        "Generates the specified number of evaluation keys", release_gil())
     .def("generate_evaluation_keys", (void (KeyGenerator::*)(int,
         EvaluationKeys &)) &KeyGenerator::generate_evaluation_keys,
-        "Generates the specified number of evaluation keys")
+        "Generates the specified number of evaluation keys", release_gil())
     .def("generate_galois_keys", (void (KeyGenerator::*)(int,
         GaloisKeys &)) &KeyGenerator::generate_galois_keys,
-        "Generates Galois keys")
+        "Generates Galois keys", release_gil())
+    .def("generate_galois_keys", (void (KeyGenerator::*)(int, const std::vector<std::uint64_t> &,
+        GaloisKeys &)) &KeyGenerator::generate_galois_keys,
+        "Generates Galois keys for the given Galois elements", release_gil())
+    .def("generate_galois_keys", (void (KeyGenerator::*)(int, const RotationPlan &,
+        GaloisKeys &)) &KeyGenerator::generate_galois_keys,
+        "Generates the Galois keys chosen by a RotationPlan", release_gil())
     .def("public_key", &KeyGenerator::public_key, "Returns public key")
     .def("secret_key", &KeyGenerator::secret_key, "Returns secret key");
 
@@ -405,7 +696,69 @@ PYBIND11_MODULE(seal, m) {
     .def_static("New", &MemoryPoolHandle::New,
                "Returns a MemoryPoolHandle pointing to a new memory pool")
     .def_static("acquire_global", &MemoryPoolHandle::Global,
-               "Returns a MemoryPoolHandle pointing to the global memory pool");
+               "Returns a MemoryPoolHandle pointing to the global memory pool")
+    .def("alloc_byte_count", &MemoryPoolHandle::alloc_byte_count,
+        "Returns the total number of bytes allocated by the memory pool")
+    .def("trim", &MemoryPoolHandle::trim,
+        "Releases unused memory and returns the number of bytes released")
+    .def("set_byte_cap", &MemoryPoolHandle::set_byte_cap,
+        "Sets an upper bound on the memory held by the pool; zero means no limit")
+    .def("byte_cap", &MemoryPoolHandle::byte_cap,
+        "Returns the byte cap of the memory pool, or zero if there is none")
+    .def("set_idle_release", [](const MemoryPoolHandle &pool, std::int64_t milliseconds) {
+          pool.set_idle_release(std::chrono::milliseconds(milliseconds));
+        }, "Enables releasing unused memory automatically once per given number of milliseconds");
+
+  py::class_<EvaluatorWorkspace>(m, "EvaluatorWorkspace")
+    .def(py::init<>())
+    .def(py::init<std::uint64_t>())
+    .def("pool", &EvaluatorWorkspace::pool,
+        "Returns a MemoryPoolHandle pointing to the workspace, to be passed to Evaluator functions")
+    .def("byte_count", &EvaluatorWorkspace::byte_count,
+        "Returns the size in bytes of the memory held by the workspace");
+
+  py::enum_<ExponentiationStrategy>(m, "ExponentiationStrategy")
+     .value("min_depth", ExponentiationStrategy::min_depth)
+     .value("min_multiplies", ExponentiationStrategy::min_multiplies);
+
+  py::class_<ExponentiationPlan>(m, "ExponentiationPlan")
+    .def(py::init<std::uint64_t>())
+    .def(py::init<std::uint64_t, ExponentiationStrategy>())
+    .def(py::init<std::uint64_t, ExponentiationStrategy, int>())
+    .def("exponent", &ExponentiationPlan::exponent, "Returns the power the plan raises ciphertexts to")
+    .def("strategy", &ExponentiationPlan::strategy, "Returns the strategy the plan was created with")
+    .def("max_size", &ExponentiationPlan::max_size,
+        "Returns the largest ciphertext size allowed before relinearizing")
+    .def("depth", &ExponentiationPlan::depth, "Returns the multiplicative depth of the plan")
+    .def("multiply_count", &ExponentiationPlan::multiply_count,
+        "Returns the number of ciphertext multiplications in the plan, including squarings")
+    .def("relinearize_count", &ExponentiationPlan::relinearize_count,
+        "Returns the number of relinearizations performed on a ciphertext of size 2");
+
+  py::class_<PlainMatrix>(m, "PlainMatrix")
+    .def(py::init<const SEALContext &, const std::vector<std::vector<std::uint64_t> > &>())
+    .def(py::init<const SEALContext &, const std::vector<std::vector<std::uint64_t> > &, int>())
+    .def("dimension", &PlainMatrix::dimension, "Returns the dimension of the matrix")
+    .def("baby_step_count", &PlainMatrix::baby_step_count, "Returns the number of baby steps")
+    .def("giant_step_count", &PlainMatrix::giant_step_count, "Returns the number of giant steps")
+    .def("rotation_steps", &PlainMatrix::rotation_steps,
+        "Returns the row rotation steps that multiply_plain_matrix performs");
+
+  py::class_<PreparedCiphertext>(m, "PreparedCiphertext")
+    .def(py::init<>())
+    .def(py::init<const MemoryPoolHandle &>())
+    .def(py::init<const PreparedCiphertext &>())
+    .def("size", &PreparedCiphertext::size, "Returns the size of the prepared ciphertext");
+
+  py::class_<RotationPlan>(m, "RotationPlan")
+    .def(py::init<const SEALContext &, const std::vector<int> &>())
+    .def(py::init<const SEALContext &, const std::vector<int> &, int>())
+    .def("key_steps", &RotationPlan::key_steps, "Returns the row rotation steps of the planned keys")
+    .def("galois_elts", &RotationPlan::galois_elts, "Returns the Galois elements of the planned keys")
+    .def("key_switch_count", &RotationPlan::key_switch_count,
+        "Returns the number of key switches a row rotation takes with the planned keys")
+    .def("total_key_switch_count", &RotationPlan::total_key_switch_count,
+        "Returns the total number of key switches for rotating once by each requested step");
 
   py::class_<Plaintext>(m, "Plaintext")
      .def(py::init<>())
@@ -420,26 +773,39 @@ PYBIND11_MODULE(seal, m) {
      .def("to_string", &Plaintext::to_string, "Returns the plaintext as a formatted string")
      .def("coeff_count", &Plaintext::coeff_count, "Returns the coefficient count of the current plaintext polynomial")
      .def("coeff_at", &Plaintext::coeff_at, "Returns coefficient at a given index")
-     .def(py::pickle(&serialize<Plaintext>, &deserialize<Plaintext> ))
+     .def("as_array", [](py::object self) {
+          const Plaintext &plain = self.cast<const Plaintext &>();
+          return read_only_view(plain.pointer(), { plain.coeff_count() }, self);
+        }, "Returns a read-only uint64 array view of the coefficients. The view is invalidated if \
+        the plaintext is resized")
+     .def(py::pickle(&serialize<Plaintext>, &deserialize_plaintext))
+     .def("__reduce_ex__", &reduce_plaintext, "Pickles the plaintext, passing its coefficients out-of-band \
+        with protocol 5")
      .def("save", (void (Plaintext::*)(std::string &)) &Plaintext::python_save,
         "Saves Plaintext object to file given filepath")
      .def("load", (void (Plaintext::*)(std::string &)) &Plaintext::python_load,
         "Loads Plaintext object from file given filepath");
 
   py::class_<PolyCRTBuilder>(m, "PolyCRTBuilder")
-    .def(py::init<const SEALContext &, const MemoryPoolHandle &>())
-    .def(py::init<const SEALContext &>())
-    .def(py::init<const PolyCRTBuilder &>())
+    .def(py::init<const SEALContext &, const MemoryPoolHandle &>(), release_gil())
+    .def(py::init<const SEALContext &>(), release_gil())
+    .def(py::init<const PolyCRTBuilder &>(), release_gil())
     .def("slot_count", (int (PolyCRTBuilder::*)())
         &PolyCRTBuilder::slot_count, "Returns the number of slots")
+    .def("compose", &compose_array<std::uint64_t>,
+        "Creates a SEAL plaintext from a given uint64 array without copying it",
+        "values"_a.noconvert(), "destination"_a)
+    .def("compose", &compose_array<std::int64_t>,
+        "Creates a SEAL plaintext from a given int64 array without copying it",
+        "values"_a.noconvert(), "destination"_a)
     .def("compose", (void (PolyCRTBuilder::*)(const std::vector<std::uint64_t> &, Plaintext &))
-        &PolyCRTBuilder::compose, "Creates a SEAL plaintext from a given matrix")
+        &PolyCRTBuilder::compose, "Creates a SEAL plaintext from a given matrix", release_gil())
     .def("compose", (void (PolyCRTBuilder::*)(const std::vector<std::int64_t> &, Plaintext &))
-        &PolyCRTBuilder::compose, "Creates a SEAL plaintext from a given matrix")
+        &PolyCRTBuilder::compose, "Creates a SEAL plaintext from a given matrix", release_gil())
     .def("compose", (void (PolyCRTBuilder::*)(Plaintext &, const MemoryPoolHandle &))
-        &PolyCRTBuilder::compose, "Creates a SEAL plaintext from a given matrix")
+        &PolyCRTBuilder::compose, "Creates a SEAL plaintext from a given matrix", release_gil())
     .def("compose", (void (PolyCRTBuilder::*)(Plaintext &))
-        &PolyCRTBuilder::compose, "Creates a SEAL plaintext from a given matrix")
+        &PolyCRTBuilder::compose, "Creates a SEAL plaintext from a given matrix", release_gil())
 
     /*Error with the commented-out below functions due to what appears to be a scope issue.
     Specifically, when a Python list is passed as the second argument, it's not actually modified by decompose().
@@ -457,10 +823,16 @@ PYBIND11_MODULE(seal, m) {
     .def("decompose", (void (PolyCRTBuilder::*)(const Plaintext &, std::vector<std::int64_t> &))
         &PolyCRTBuilder::decompose, "Inverse of compose. This function unbatches a given SEAL plaintext")*/
 
+    .def("decompose", &decompose_array<std::uint64_t>,
+        "Inverse of compose. This function unbatches a given SEAL plaintext into a preallocated uint64 array",
+        "plain"_a, "destination"_a.noconvert())
+    .def("decompose", &decompose_array<std::int64_t>,
+        "Inverse of compose. This function unbatches a given SEAL plaintext into a preallocated int64 array",
+        "plain"_a, "destination"_a.noconvert())
     .def("decompose", (void (PolyCRTBuilder::*)(Plaintext &, const MemoryPoolHandle &))
-        &PolyCRTBuilder::decompose, "Inverse of compose. This function unbatches a given SEAL plaintext")
+        &PolyCRTBuilder::decompose, "Inverse of compose. This function unbatches a given SEAL plaintext", release_gil())
     .def("decompose", (void (PolyCRTBuilder::*)(Plaintext &))
-        &PolyCRTBuilder::decompose, "Inverse of compose. This function unbatches a given SEAL plaintext");
+        &PolyCRTBuilder::decompose, "Inverse of compose. This function unbatches a given SEAL plaintext", release_gil());
 
   py::class_<PublicKey>(m, "PublicKey")
      .def(py::init<>())
@@ -478,9 +850,15 @@ PYBIND11_MODULE(seal, m) {
         "Loads PublicKey object from file given filepath")
      .def(py::pickle(&serialize<SecretKey>, &deserialize<SecretKey>));
 
+  py::enum_<MultiplyMethod>(m, "MultiplyMethod")
+     .value("behz", MultiplyMethod::behz)
+     .value("hps", MultiplyMethod::hps);
+
   py::class_<SEALContext>(m, "SEALContext")
      .def(py::init<const EncryptionParameters &>())
      .def(py::init<const EncryptionParameters &, const MemoryPoolHandle &>())
+     .def(py::init<const EncryptionParameters &, MultiplyMethod>())
+     .def(py::init<const EncryptionParameters &, MultiplyMethod, const MemoryPoolHandle &>())
      .def("parms", (const EncryptionParameters & (SEALContext::*)()) &SEALContext::parms,
         "Returns a constant reference to the underlying encryption parameters")
      .def("noise_standard_deviation", (double (SEALContext::*)()) &SEALContext::noise_standard_deviation,
@@ -491,6 +869,16 @@ PYBIND11_MODULE(seal, m) {
      .def("plain_modulus", (const SmallModulus & (SEALContext::*)()) &SEALContext::plain_modulus, "Returns a constant reference to the plaintext modulus")
      .def("qualifiers", (EncryptionParameterQualifiers (SEALContext::*)()) &SEALContext::qualifiers,
         "Returns a copy of EncryptionParameterQualifiers corresponding to the current encryption parameters")
+     .def("multiply_method", &SEALContext::multiply_method,
+        "Returns the method that Evaluator instances created from this SEALContext use for multiplying ciphertexts")
+     .def("max_level", &SEALContext::max_level,
+        "Returns the highest level, i.e. the number of primes in the coefficient modulus")
+     .def("min_level", &SEALContext::min_level,
+        "Returns the lowest level that ciphertexts can be switched down to")
+     .def("level_context", &SEALContext::level_context, py::return_value_policy::reference_internal,
+        "Returns the SEALContext for the encryption parameters at a given level")
+     .def("is_level_context_created", &SEALContext::is_level_context_created,
+        "Returns whether the pre-computations for a given level have been performed")
         .def(py::pickle(
         [](const SEALContext &context) {
             EncryptionParameters parms_ = context.parms();
@@ -596,6 +596,21 @@ def example_pickle():
 	decryptor.decrypt(pickle_encrypted, decrypted)
 	print("Read serialized ciphertext back in and decrypt to: '{}'".format(decrypted.to_string()))
 
+	# With pickle protocol 5 (Python 3.8 and later) the coefficients of Ciphertext and
+	# Plaintext objects are handed to pickle as PickleBuffer objects pointing at their
+	# memory. Given a buffer_callback, pickle passes them out-of-band without copying
+	# them into the pickle, which is how multiprocessing, Dask and Ray can ship large
+	# ciphertexts between processes cheaply. With lower protocols, or without a
+	# buffer_callback, the data is written into the pickle as bytes.
+	if pickle.HIGHEST_PROTOCOL >= 5:
+		buffers = []
+		data = pickle.dumps(encrypted1, protocol=5, buffer_callback=buffers.append)
+		print("Pickled ciphertext into {} bytes with {} out-of-band buffer(s) of {} bytes".format(
+			len(data), len(buffers), sum(len(buffer.raw()) for buffer in buffers)))
+		oob_encrypted = pickle.loads(data, buffers=buffers)
+		decryptor.decrypt(oob_encrypted, decrypted)
+		print("Unpickled out-of-band ciphertext and decrypt to: '{}'".format(decrypted.to_string()))
+
 
 def example_weighted_average():
 	print_example_banner("Example: Weighted Average")
@@ -1313,6 +1328,8 @@ def example_performance_mt(th_count):
 	# local memory pools using the MemoryPoolHandle class, which can be either
 	# thread-safe (slower) or thread-unsafe (faster). For example, here we use
 	# the MemoryPoolHandle class to essentially get thread-local memory pools.
+	# The wrapper releases the GIL while SEAL functions run, so the Python
+	# threads below really do run in parallel.
 
 	# First we set up shared instances of EncryptionParameters, SEALContext,
 	# KeyGenerator, keys, Encryptor, Decryptor, Evaluator, PolyCRTBuilder.
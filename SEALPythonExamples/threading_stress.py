@@ -0,0 +1,104 @@
+import os
+import sys
+import time
+import numpy as np
+from concurrent.futures import ThreadPoolExecutor
+import seal
+from seal import Ciphertext, \
+	Decryptor, \
+	Encryptor, \
+	EncryptionParameters, \
+	EvaluationKeys, \
+	Evaluator, \
+	KeyGenerator, \
+	MemoryPoolHandle, \
+	Plaintext, \
+	PolyCRTBuilder, \
+	SEALContext
+
+# Runs ciphertext multiplications from an increasing number of Python threads
+# that share one Evaluator, Encryptor and Decryptor, checks every result, and
+# prints the throughput relative to a single thread. Since the wrapper releases
+# the GIL while SEAL functions run, the speedup should grow nearly linearly
+# with the number of threads, up to the number of cores.
+#
+# Usage: python3 threading_stress.py [max_threads] [multiplies_per_thread]
+
+def setup():
+	parms = EncryptionParameters()
+	parms.set_poly_modulus("1x^4096 + 1")
+	parms.set_coeff_modulus(seal.coeff_modulus_128(4096))
+	parms.set_plain_modulus(40961)
+	context = SEALContext(parms)
+
+	keygen = KeyGenerator(context)
+	evaluation_keys = EvaluationKeys()
+	keygen.generate_evaluation_keys(30, evaluation_keys)
+	tools = {
+		'evaluator': Evaluator(context),
+		'decryptor': Decryptor(context, keygen.secret_key()),
+		'crtbuilder': PolyCRTBuilder(context),
+		'evaluation_keys': evaluation_keys
+	}
+
+	# Every thread multiplies the same shared inputs
+	plain_modulus = context.plain_modulus().value()
+	values = np.arange(tools['crtbuilder'].slot_count(), dtype=np.uint64) % plain_modulus
+	plain = Plaintext()
+	tools['crtbuilder'].compose(values, plain)
+	encryptor = Encryptor(context, keygen.public_key())
+	tools['encrypted'] = Ciphertext()
+	encryptor.encrypt(plain, tools['encrypted'])
+	tools['expected'] = values * values % plain_modulus
+	return tools
+
+def worker(tools, count):
+	# Each thread allocates from its own memory pool, and writes to its own
+	# destination objects
+	pool = MemoryPoolHandle.New(False)
+	product = Ciphertext(pool)
+	plain = Plaintext()
+	result = np.empty_like(tools['expected'])
+	failures = 0
+	for i in range(count):
+		tools['evaluator'].multiply(tools['encrypted'], tools['encrypted'], product, pool)
+		tools['evaluator'].relinearize(product, tools['evaluation_keys'], pool)
+		tools['decryptor'].decrypt(product, plain, pool)
+		tools['crtbuilder'].decompose(plain, result)
+		if not np.array_equal(result, tools['expected']):
+			failures += 1
+	return failures
+
+def run(tools, thread_count, count):
+	time_start = time.time()
+	with ThreadPoolExecutor(max_workers = thread_count) as executor:
+		failures = sum(executor.map(lambda i: worker(tools, count), range(thread_count)))
+	elapsed = time.time() - time_start
+	return thread_count * count / elapsed, failures
+
+def main():
+	max_threads = int(sys.argv[1]) if len(sys.argv) > 1 else (os.cpu_count() or 1)
+	count = int(sys.argv[2]) if len(sys.argv) > 2 else 20
+	tools = setup()
+
+	# Warm up, so that the first measurement does not include one-time costs
+	run(tools, 1, 1)
+
+	baseline = None
+	total_failures = 0
+	print("threads  multiplies/s  speedup")
+	thread_count = 1
+	while thread_count <= max_threads:
+		throughput, failures = run(tools, thread_count, count)
+		baseline = baseline or throughput
+		total_failures += failures
+		print("%7d  %12.1f  %7.2f" % (thread_count, throughput, throughput / baseline))
+		thread_count = thread_count * 2 if thread_count * 2 <= max_threads or thread_count == max_threads \
+			else max_threads
+	if total_failures:
+		print("%d results were wrong" % total_failures)
+		sys.exit(1)
+	print("All results are correct")
+
+if __name__ == '__main__':
+	main()
@@ -3,6 +3,8 @@
 #include "seal/context.h"
 #include "seal/keygenerator.h"
 #include "seal/encryptor.h"
+#include "seal/evaluator.h"
+#include "seal/decryptor.h"
 #include "seal/memorypoolhandle.h"
 #include "seal/defaultparams.h"
 
@@ -132,6 +134,192 @@ namespace SEALTest
             Assert::IsTrue(ctxt.hash_block() == ctxt2.hash_block());
             Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), parms.poly_modulus().coeff_count() * parms.coeff_modulus().size() * 2));
             Assert::IsTrue(ctxt.pointer() != ctxt2.pointer());
+            Assert::IsFalse(ctxt2.is_ntt_form());
+
+            Evaluator evaluator(context);
+            evaluator.transform_to_ntt(ctxt);
+            ctxt.save(stream);
+            ctxt2.load(stream);
+            Assert::IsTrue(ctxt2.is_ntt_form());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), parms.poly_modulus().coeff_count() * parms.coeff_modulus().size() * 2));
+        }
+
+        TEST_METHOD(LoadCiphertextWithoutFlags)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_coeff_modulus({ small_mods_30bit(0), small_mods_40bit(0) });
+            parms.set_plain_modulus(1 << 6);
+            parms.set_noise_standard_deviation(3.19);
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            Encryptor encryptor(context, keygen.public_key());
+            Decryptor decryptor(context, keygen.secret_key());
+            Plaintext plain("1x^3 + 2x^2 + 3x^1 + 4");
+            Ciphertext ctxt, ctxt2;
+            encryptor.encrypt(plain, ctxt);
+
+            // Ciphertexts saved before the flags were added have the size right after the
+            // hash block, followed by the other dimensions and the data
+            stringstream stream;
+            stream.write(reinterpret_cast<const char*>(&ctxt.hash_block()), sizeof(EncryptionParameters::hash_block_type));
+            int32_t dimensions[3]{ ctxt.size(), ctxt.poly_coeff_count(), ctxt.coeff_mod_count() };
+            stream.write(reinterpret_cast<const char*>(dimensions), sizeof(dimensions));
+            stream.write(reinterpret_cast<const char*>(ctxt.pointer()), ctxt.uint64_count() * 8);
+
+            // The destination does not keep its NTT form
+            Evaluator evaluator(context);
+            ctxt2 = ctxt;
+            evaluator.transform_to_ntt(ctxt2);
+            ctxt2.load(stream);
+            Assert::IsTrue(ctxt.hash_block() == ctxt2.hash_block());
+            Assert::IsFalse(ctxt2.is_ntt_form());
+            Assert::IsFalse(ctxt2.has_seed());
+            Assert::AreEqual(2, ctxt2.size());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), ctxt.uint64_count()));
+            Plaintext plain2;
+            decryptor.decrypt(ctxt2, plain2);
+            Assert::IsTrue(plain == plain2);
+        }
+
+        TEST_METHOD(SaveLoadSeededCiphertext)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^1024 + 1");
+            parms.set_coeff_modulus(coeff_modulus_128(1024));
+            parms.set_plain_modulus(0xF0F0);
+            parms.set_noise_standard_deviation(3.14159);
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            Encryptor encryptor(context, keygen.secret_key());
+            Decryptor decryptor(context, keygen.secret_key());
+            Plaintext plain("Ax^10 + 9x^9 + 8x^8 + 7x^7 + 6x^6 + 5x^5 + 4x^4 + 3x^3 + 2x^2 + 1");
+
+            Ciphertext ctxt, ctxt2;
+            encryptor.encrypt(plain, ctxt);
+            stringstream stream;
+            ctxt.save(stream);
+            int poly_byte_count = parms.poly_modulus().coeff_count() * parms.coeff_modulus().size() * 8;
+            Assert::IsTrue(stream.str().size() < poly_byte_count + 100);
+
+            // Loading expands the seed to the same ciphertext, which keeps the seed
+            ctxt2.load(stream);
+            Assert::IsTrue(ctxt.hash_block() == ctxt2.hash_block());
+            Assert::IsTrue(ctxt2.has_seed());
+            Assert::IsFalse(ctxt2.is_ntt_form());
+            Assert::AreEqual(2, ctxt2.size());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), 2 * poly_byte_count / 8));
+            Plaintext plain2;
+            decryptor.decrypt(ctxt2, plain2);
+            Assert::IsTrue(plain == plain2);
+
+            stringstream stream2;
+            ctxt2.save(stream2);
+            Assert::IsTrue(stream.str() == stream2.str());
+
+            // Once modified, the ciphertext is saved in full
+            Evaluator evaluator(context);
+            evaluator.negate(ctxt2);
+            Assert::IsFalse(ctxt2.has_seed());
+            stringstream stream3;
+            ctxt2.save(stream3);
+            Assert::IsTrue(stream3.str().size() > 2 * poly_byte_count);
+            ctxt.load(stream3);
+            Assert::IsFalse(ctxt.has_seed());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), 2 * poly_byte_count / 8));
+        }
+
+        TEST_METHOD(SaveLoadPackedCiphertext)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^1024 + 1");
+            parms.set_coeff_modulus({ small_mods_30bit(0), small_mods_40bit(0) });
+            parms.set_plain_modulus(1 << 6);
+            parms.set_noise_standard_deviation(3.19);
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            Encryptor encryptor(context, keygen.public_key());
+            Encryptor symmetric_encryptor(context, keygen.secret_key());
+            Evaluator evaluator(context);
+            int coeff_count = parms.poly_modulus().coeff_count();
+            Plaintext plain("1x^3 + 2x^2 + 3x^1 + 4");
+
+            Ciphertext ctxt, ctxt2;
+            encryptor.encrypt(plain, ctxt);
+            stringstream stream;
+            ctxt.save_packed(stream);
+            Assert::IsTrue(stream.str().size() < 2 * coeff_count * (30 + 40) / 8 + 64);
+            ctxt2.load(stream);
+            Assert::IsTrue(ctxt.hash_block() == ctxt2.hash_block());
+            Assert::IsFalse(ctxt2.is_ntt_form());
+            Assert::AreEqual(2, ctxt2.size());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), ctxt.uint64_count()));
+
+            evaluator.square(ctxt);
+            evaluator.transform_to_ntt(ctxt);
+            ctxt.save_packed(stream);
+            ctxt2.load(stream);
+            Assert::IsTrue(ctxt2.is_ntt_form());
+            Assert::AreEqual(3, ctxt2.size());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), ctxt.uint64_count()));
+
+            // Seeded ciphertexts pack the first polynomial only
+            symmetric_encryptor.encrypt(plain, ctxt);
+            stringstream stream2;
+            ctxt.save_packed(stream2);
+            Assert::IsTrue(stream2.str().size() < coeff_count * (30 + 40) / 8 + 128);
+            ctxt2.load(stream2);
+            Assert::IsTrue(ctxt2.has_seed());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), ctxt.uint64_count()));
+
+            // Unknown versions of the packed format are rejected
+            ctxt.save_packed(stream2);
+            string data = stream2.str();
+            data[sizeof(EncryptionParameters::hash_block_type) + sizeof(int32_t) + 1] = 2;
+            stringstream stream3(data);
+            Assert::ExpectException<invalid_argument>([&]() {
+                ctxt2.load(stream3);
+            });
+        }
+
+        TEST_METHOD(SaveMetadataCiphertext)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_coeff_modulus({ small_mods_30bit(0), small_mods_40bit(0) });
+            parms.set_plain_modulus(1 << 6);
+            parms.set_noise_standard_deviation(3.19);
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            Encryptor encryptor(context, keygen.public_key());
+            Encryptor symmetric_encryptor(context, keygen.secret_key());
+            Evaluator evaluator(context);
+            Plaintext plain("1x^3 + 2x^2 + 3x^1 + 4");
+
+            // Without a seed, the metadata followed by the data is the same as save()
+            Ciphertext ctxt, ctxt2;
+            encryptor.encrypt(plain, ctxt);
+            evaluator.transform_to_ntt(ctxt);
+            stringstream stream, stream2;
+            ctxt.save(stream);
+            ctxt.save_metadata(stream2);
+            stream2.write(reinterpret_cast<const char*>(ctxt.pointer()), ctxt.uint64_count() * 8);
+            Assert::IsTrue(stream.str() == stream2.str());
+            ctxt2.load(stream2);
+            Assert::IsTrue(ctxt.hash_block() == ctxt2.hash_block());
+            Assert::IsTrue(ctxt2.is_ntt_form());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), ctxt.uint64_count()));
+
+            // With a seed, all polynomials are loaded from the data and the seed is dropped
+            symmetric_encryptor.encrypt(plain, ctxt);
+            stringstream stream3;
+            ctxt.save_metadata(stream3);
+            stream3.write(reinterpret_cast<const char*>(ctxt.pointer()), ctxt.uint64_count() * 8);
+            ctxt2.load(stream3);
+            Assert::IsFalse(ctxt2.has_seed());
+            Assert::IsFalse(ctxt2.is_ntt_form());
+            Assert::AreEqual(2, ctxt2.size());
+            Assert::IsTrue(is_equal_uint_uint(ctxt.pointer(), ctxt2.pointer(), ctxt.uint64_count()));
         }
     };
 }
\ No newline at end of file
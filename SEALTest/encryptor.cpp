@@ -4,6 +4,8 @@
 #include "seal/decryptor.h"
 #include "seal/keygenerator.h"
 #include "seal/encoder.h"
+#include "seal/evaluator.h"
+#include "seal/util/uintcore.h"
 #include <cstdint>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -182,5 +184,73 @@ namespace SEALTest
                 Assert::IsTrue(encrypted.hash_block() == parms.hash_block());
             }
         }
+
+        TEST_METHOD(FVEncryptSymmetricDecrypt)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(1 << 6);
+            parms.set_noise_standard_deviation(3.19);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_poly_modulus("1x^256 + 1");
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1), small_mods_40bit(2) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+
+            BalancedEncoder encoder(plain_modulus);
+
+            Encryptor encryptor(context, keygen.secret_key());
+            Decryptor decryptor(context, keygen.secret_key());
+
+            Ciphertext encrypted;
+            Plaintext plain;
+            encryptor.encrypt(encoder.encode(0x12345678), encrypted);
+            Assert::IsTrue(encrypted.has_seed());
+            decryptor.decrypt(encrypted, plain);
+            Assert::AreEqual(0x12345678ULL, encoder.decode_uint64(plain));
+            Assert::IsTrue(encrypted.hash_block() == parms.hash_block());
+
+            encryptor.encrypt(encoder.encode(0), encrypted);
+            decryptor.decrypt(encrypted, plain);
+            Assert::AreEqual(0ULL, encoder.decode_uint64(plain));
+
+            encryptor.encrypt(encoder.encode(0x7FFFFFFFFFFFFFFF), encrypted);
+            decryptor.decrypt(encrypted, plain);
+            Assert::AreEqual(0x7FFFFFFFFFFFFFFFULL, encoder.decode_uint64(plain));
+
+            // Two encryptions use different seeds
+            Ciphertext encrypted2;
+            encryptor.encrypt(encoder.encode(0x7FFFFFFFFFFFFFFF), encrypted2);
+            Assert::IsFalse(util::is_equal_uint_uint(encrypted.pointer(1), encrypted2.pointer(1), 
+                parms.poly_modulus().coeff_count() * parms.coeff_modulus().size()));
+
+            // A copy keeps the seed, and computing on the ciphertext discards it
+            Ciphertext copy(encrypted);
+            Assert::IsTrue(copy.has_seed());
+            Evaluator evaluator(context);
+            evaluator.add(encrypted, encrypted2);
+            Assert::IsFalse(encrypted.has_seed());
+            decryptor.decrypt(encrypted, plain);
+            Assert::AreEqual(static_cast<uint64_t>(0xFFFFFFFFFFFFFFFE), encoder.decode_uint64(plain));
+
+            // On a thread pool the seed is discarded once before the polynomials are modified
+            Evaluator evaluator_mt(context, ThreadPoolHandle::New(4));
+            evaluator_mt.transform_to_ntt(copy);
+            Assert::IsFalse(copy.has_seed());
+            evaluator_mt.transform_from_ntt(copy);
+            evaluator_mt.negate(copy);
+            decryptor.decrypt(copy, plain);
+            Assert::AreEqual(-0x7FFFFFFFFFFFFFFFLL, encoder.decode_int64(plain));
+
+            Encryptor encryptor_copy(encryptor);
+            encryptor_copy.encrypt(encoder.encode(314159265), encrypted);
+            Assert::IsTrue(encrypted.has_seed());
+            decryptor.decrypt(encrypted, plain);
+            Assert::AreEqual(314159265ULL, encoder.decode_uint64(plain));
+
+            // Public key encryptions have no seed
+            Encryptor public_encryptor(context, keygen.public_key());
+            public_encryptor.encrypt(encoder.encode(1), encrypted);
+            Assert::IsFalse(encrypted.has_seed());
+        }
     };
 }
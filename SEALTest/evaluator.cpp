@@ -7,7 +7,9 @@
 #include "seal/polycrt.h"
 #include "seal/encoder.h"
 #include <cstdint>
+#include <algorithm>
 #include <string>
+#include <sstream>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace seal;
@@ -533,6 +535,143 @@ namespace SEALTest
             }
         }
 
+        TEST_METHOD(FVEncryptMultiplyPreparedDecrypt)
+        {
+            auto assert_equal = [](const Ciphertext &a, const Ciphertext &b) {
+                Assert::AreEqual(a.size(), b.size());
+                Assert::IsTrue(a.hash_block() == b.hash_block());
+                Assert::IsTrue(equal(a.pointer(), a.pointer() + a.uint64_count(), b.pointer()));
+            };
+
+            for (MultiplyMethod method : { MultiplyMethod::behz, MultiplyMethod::hps })
+            {
+                EncryptionParameters parms;
+                SmallModulus plain_modulus(1 << 6);
+                parms.set_poly_modulus("1x^64 + 1");
+                parms.set_plain_modulus(plain_modulus);
+                parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1) });
+                SEALContext context(parms, method);
+                KeyGenerator keygen(context);
+
+                BalancedEncoder encoder(plain_modulus);
+                Encryptor encryptor(context, keygen.public_key());
+                Evaluator evaluator(context);
+                Decryptor decryptor(context, keygen.secret_key());
+
+                // One prepared ciphertext multiplied with several others gives the same
+                // results as multiply
+                Ciphertext query;
+                encryptor.encrypt(encoder.encode(7), query);
+                PreparedCiphertext prepared;
+                Assert::AreEqual(0, prepared.size());
+                evaluator.prepare(query, prepared);
+                Assert::AreEqual(2, prepared.size());
+                Assert::IsTrue(prepared.hash_block() == parms.hash_block());
+                for (int64_t value : { 0, 1, -3, 12345 })
+                {
+                    Ciphertext encrypted;
+                    encryptor.encrypt(encoder.encode(value), encrypted);
+                    Ciphertext expected;
+                    evaluator.multiply(query, encrypted, expected);
+                    Ciphertext product;
+                    evaluator.multiply(prepared, encrypted, product);
+                    assert_equal(expected, product);
+
+                    Plaintext plain;
+                    decryptor.decrypt(product, plain);
+                    Assert::AreEqual(7 * value, encoder.decode_int64(plain));
+
+                    // Destination may be the other operand
+                    evaluator.multiply(prepared, encrypted, encrypted);
+                    assert_equal(expected, encrypted);
+                }
+
+                // Larger ciphertexts, and copies of prepared ciphertexts
+                Ciphertext encrypted;
+                encryptor.encrypt(encoder.encode(-2), encrypted);
+                evaluator.square(query);
+                evaluator.prepare(query, prepared);
+                PreparedCiphertext prepared_copy(prepared);
+                prepared = PreparedCiphertext();
+                Assert::AreEqual(3, prepared_copy.size());
+                Ciphertext expected;
+                evaluator.multiply(query, encrypted, expected);
+                Ciphertext product;
+                evaluator.multiply(prepared_copy, encrypted, product);
+                assert_equal(expected, product);
+                evaluator.prepare(encrypted, prepared);
+                evaluator.multiply(prepared, query, product);
+                evaluator.multiply(encrypted, query);
+                assert_equal(encrypted, product);
+                Plaintext plain;
+                decryptor.decrypt(product, plain);
+                Assert::AreEqual(static_cast<int64_t>(-2 * 49), encoder.decode_int64(plain));
+
+                // Lower levels
+                encryptor.encrypt(encoder.encode(3), query);
+                encryptor.encrypt(encoder.encode(5), encrypted);
+                evaluator.mod_switch_to_next(query);
+                evaluator.mod_switch_to_next(encrypted);
+                evaluator.prepare(query, prepared);
+                evaluator.multiply(prepared, encrypted, product);
+                evaluator.multiply(query, encrypted, expected);
+                assert_equal(expected, product);
+                decryptor.decrypt(product, plain);
+                Assert::AreEqual(static_cast<int64_t>(15), encoder.decode_int64(plain));
+
+                // Operands must be at the same level, and empty prepared ciphertexts are invalid
+                encryptor.encrypt(encoder.encode(5), encrypted);
+                bool threw = false;
+                try
+                {
+                    evaluator.multiply(prepared, encrypted, product);
+                }
+                catch (const invalid_argument &)
+                {
+                    threw = true;
+                }
+                Assert::IsTrue(threw);
+                threw = false;
+                try
+                {
+                    evaluator.multiply(PreparedCiphertext(), encrypted, product);
+                }
+                catch (const invalid_argument &)
+                {
+                    threw = true;
+                }
+                Assert::IsTrue(threw);
+            }
+
+            // The auxiliary base depends on the multiplication method, so a ciphertext prepared
+            // for one method is rejected by an evaluator using the other one, even though the
+            // encryption parameters are the same
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(1 << 6);
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1) });
+            SEALContext context_behz(parms, MultiplyMethod::behz);
+            SEALContext context_hps(parms, MultiplyMethod::hps);
+            KeyGenerator keygen(context_behz);
+            BalancedEncoder encoder(plain_modulus);
+            Encryptor encryptor(context_behz, keygen.public_key());
+            Evaluator evaluator_behz(context_behz);
+            Evaluator evaluator_hps(context_hps);
+            Ciphertext encrypted, product;
+            encryptor.encrypt(encoder.encode(3), encrypted);
+            PreparedCiphertext prepared_behz, prepared_hps;
+            evaluator_behz.prepare(encrypted, prepared_behz);
+            evaluator_hps.prepare(encrypted, prepared_hps);
+            Assert::IsTrue(prepared_behz.hash_block() == prepared_hps.hash_block());
+            Assert::ExpectException<invalid_argument>([&]() {
+                evaluator_hps.multiply(prepared_behz, encrypted, product);
+            });
+            Assert::ExpectException<invalid_argument>([&]() {
+                evaluator_behz.multiply(prepared_hps, encrypted, product);
+            });
+        }
+
         TEST_METHOD(FVEncryptSquareDecrypt)
         {
             EncryptionParameters parms;
@@ -724,6 +863,63 @@ namespace SEALTest
             Assert::IsTrue(encrypted.hash_block() == parms.hash_block());
         }
 
+        TEST_METHOD(FVEncryptExponentiatePlanDecrypt)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            PolyCRTBuilder crtbuilder(context);
+            EvaluationKeys evk;
+            keygen.generate_evaluation_keys(16, 4, evk);
+
+            vector<uint64_t> values(64);
+            for (uint64_t i = 0; i < 64; i++)
+            {
+                values[i] = i;
+            }
+            Plaintext plain;
+            crtbuilder.compose(values, plain);
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+
+            for (auto strategy : { ExponentiationStrategy::min_depth, ExponentiationStrategy::min_multiplies })
+            {
+                for (int max_size : { 2, 3 })
+                {
+                    for (uint64_t exponent : { 1, 5, 7, 8 })
+                    {
+                        ExponentiationPlan plan(exponent, strategy, max_size);
+                        Ciphertext result;
+                        evaluator.exponentiate(encrypted, plan, evk, result);
+                        Assert::IsTrue(result.size() <= max_size);
+                        Assert::IsTrue(result.hash_block() == parms.hash_block());
+
+                        Plaintext plain_result;
+                        decryptor.decrypt(result, plain_result);
+                        vector<uint64_t> result_values;
+                        crtbuilder.decompose(plain_result, result_values);
+                        for (uint64_t i = 0; i < 64; i++)
+                        {
+                            uint64_t expected = 1;
+                            for (uint64_t j = 0; j < exponent; j++)
+                            {
+                                expected = (expected * i) % 257;
+                            }
+                            Assert::AreEqual(expected, result_values[i]);
+                        }
+                    }
+                }
+            }
+        }
+
         TEST_METHOD(FVEncryptAddManyDecrypt)
         {
             EncryptionParameters parms;
@@ -820,6 +1016,108 @@ namespace SEALTest
             Assert::IsTrue(sum.hash_block() == parms.hash_block());
         }
 
+        TEST_METHOD(FVEncryptDotProductDecrypt)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_60bit(0), small_mods_60bit(1) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            PolyCRTBuilder crtbuilder(context);
+            auto assert_equal = [](const Ciphertext &a, const Ciphertext &b) {
+                Assert::AreEqual(a.size(), b.size());
+                Assert::IsTrue(equal(a.pointer(), a.pointer() + a.uint64_count(), b.pointer()));
+            };
+
+            // Enough pairs that the lazily reduced sums must be reduced along the way
+            int pair_count = 300;
+            vector<Ciphertext> encrypteds(pair_count);
+            vector<Plaintext> plains(pair_count);
+            vector<uint64_t> values(crtbuilder.slot_count());
+            uint64_t expected_value = 0;
+            for (int i = 0; i < pair_count; i++)
+            {
+                fill(values.begin(), values.end(), static_cast<uint64_t>(i % 7));
+                crtbuilder.compose(values, plains[i]);
+                encryptor.encrypt(plains[i], encrypteds[i]);
+                evaluator.transform_to_ntt(encrypteds[i]);
+                fill(values.begin(), values.end(), static_cast<uint64_t>(i % 5 + 1));
+                crtbuilder.compose(values, plains[i]);
+                evaluator.transform_to_ntt(plains[i]);
+                expected_value += (i % 7) * (i % 5 + 1);
+            }
+
+            Ciphertext expected, product, result;
+            evaluator.multiply_plain_ntt(encrypteds[0], plains[0], expected);
+            for (int i = 1; i < pair_count; i++)
+            {
+                evaluator.multiply_plain_ntt(encrypteds[i], plains[i], product);
+                evaluator.add(expected, product);
+            }
+            evaluator.dot_product_plain(encrypteds, plains, result);
+            Assert::IsTrue(result.is_ntt_form());
+            assert_equal(expected, result);
+
+            Plaintext plain;
+            evaluator.transform_from_ntt(result);
+            decryptor.decrypt(result, plain);
+            crtbuilder.decompose(plain, values);
+            Assert::AreEqual(expected_value % 257, values[0]);
+
+            // The destination may be one of the inputs
+            vector<Ciphertext> aliased(encrypteds.begin(), encrypteds.begin() + 10);
+            vector<Plaintext> aliased_plains(plains.begin(), plains.begin() + 10);
+            evaluator.dot_product_plain(aliased, aliased_plains, expected);
+            evaluator.dot_product_plain(aliased, aliased_plains, aliased[4]);
+            assert_equal(expected, aliased[4]);
+
+            bool threw = false;
+            try
+            {
+                aliased_plains.pop_back();
+                evaluator.dot_product_plain(aliased, aliased_plains, result);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            // Ciphertext-ciphertext inner product
+            pair_count = 20;
+            vector<Ciphertext> encrypteds1(pair_count), encrypteds2(pair_count);
+            expected_value = 0;
+            for (int i = 0; i < pair_count; i++)
+            {
+                fill(values.begin(), values.end(), static_cast<uint64_t>(i % 7));
+                crtbuilder.compose(values, plain);
+                encryptor.encrypt(plain, encrypteds1[i]);
+                fill(values.begin(), values.end(), static_cast<uint64_t>(i % 5 + 1));
+                crtbuilder.compose(values, plain);
+                encryptor.encrypt(plain, encrypteds2[i]);
+                expected_value += (i % 7) * (i % 5 + 1);
+            }
+            evaluator.multiply(encrypteds1[0], encrypteds2[0], expected);
+            for (int i = 1; i < pair_count; i++)
+            {
+                evaluator.multiply(encrypteds1[i], encrypteds2[i], product);
+                evaluator.add(expected, product);
+            }
+            evaluator.dot_product(encrypteds1, encrypteds2, result);
+            Assert::AreEqual(3, result.size());
+            assert_equal(expected, result);
+
+            decryptor.decrypt(result, plain);
+            crtbuilder.decompose(plain, values);
+            Assert::AreEqual(expected_value % 257, values[0]);
+        }
+
         TEST_METHOD(TransformPlainToNTT)
         {
             EncryptionParameters parms;
@@ -964,6 +1262,319 @@ namespace SEALTest
             Assert::IsTrue(encrypted.hash_block() == parms.hash_block());
         }
 
+        TEST_METHOD(FVEncryptNTTFormOperationsDecrypt)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            BigPoly poly_modulus("1x^16 + 1");
+            parms.set_poly_modulus(poly_modulus);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1), small_mods_40bit(2) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            EvaluationKeys evk;
+            keygen.generate_evaluation_keys(16, evk);
+            GaloisKeys glk;
+            keygen.generate_galois_keys(24, glk);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+
+            Plaintext plain1("1x^15 + 2x^9 + 3x^3 + 4");
+            Plaintext plain2("5x^14 + 6x^2 + 7x^1");
+            Plaintext plain_multiplier("3x^5 + 2");
+            Ciphertext encrypted1;
+            Ciphertext encrypted2;
+            encryptor.encrypt(plain1, encrypted1);
+            encryptor.encrypt(plain2, encrypted2);
+            Assert::IsFalse(encrypted1.is_ntt_form());
+
+            // Compute the same function in coefficient representation and in NTT form
+            Ciphertext expected;
+            evaluator.multiply(encrypted1, encrypted2, expected);
+            Ciphertext result(expected);
+            evaluator.transform_to_ntt(result);
+            Assert::IsTrue(result.is_ntt_form());
+            Ciphertext encrypted1_ntt;
+            Ciphertext encrypted2_ntt;
+            evaluator.transform_to_ntt(encrypted1, encrypted1_ntt);
+            evaluator.transform_to_ntt(encrypted2, encrypted2_ntt);
+
+            evaluator.relinearize(expected, evk);
+            evaluator.add(expected, encrypted1);
+            evaluator.sub(expected, encrypted2);
+            evaluator.negate(expected);
+            evaluator.add_plain(expected, plain1);
+            evaluator.sub_plain(expected, plain2);
+            evaluator.multiply_plain(expected, plain_multiplier);
+            evaluator.rotate_rows(expected, 3, glk);
+            evaluator.rotate_columns(expected, glk);
+
+            evaluator.relinearize(result, evk);
+            evaluator.add(result, encrypted1_ntt);
+            evaluator.sub(result, encrypted2_ntt);
+            evaluator.negate(result);
+            evaluator.add_plain(result, plain1);
+            evaluator.sub_plain(result, plain2);
+            evaluator.multiply_plain(result, plain_multiplier);
+            evaluator.rotate_rows(result, 3, glk);
+            evaluator.rotate_columns(result, glk);
+            Assert::IsTrue(result.is_ntt_form());
+            Assert::AreEqual(2, result.size());
+
+            // Decryption works directly in NTT form
+            Plaintext plain_expected;
+            Plaintext plain_result;
+            decryptor.decrypt(expected, plain_expected);
+            decryptor.decrypt(result, plain_result);
+            Assert::IsTrue(plain_expected == plain_result);
+            Assert::IsTrue(decryptor.invariant_noise_budget(result) > 0);
+
+            Ciphertext result_coeff;
+            evaluator.transform_from_ntt(result, result_coeff);
+            Assert::IsFalse(result_coeff.is_ntt_form());
+            decryptor.decrypt(result_coeff, plain_result);
+            Assert::IsTrue(plain_expected == plain_result);
+
+            // Hoisted rotations keep NTT form too
+            vector<Ciphertext> rotated;
+            evaluator.rotate_rows_many(result, vector<int>{ 1, 0, 3 }, glk, rotated);
+            for (size_t i = 0; i < rotated.size(); i++)
+            {
+                Assert::IsTrue(rotated[i].is_ntt_form());
+            }
+            evaluator.rotate_rows(result_coeff, 3, glk);
+            decryptor.decrypt(result_coeff, plain_expected);
+            decryptor.decrypt(rotated[2], plain_result);
+            Assert::IsTrue(plain_expected == plain_result);
+
+            // Operations that need coefficient representation, or mix the two, throw
+            bool threw = false;
+            try
+            {
+                evaluator.multiply(result, encrypted1_ntt);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            threw = false;
+            try
+            {
+                evaluator.add(result, encrypted1);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            threw = false;
+            try
+            {
+                evaluator.transform_to_ntt(result);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            // Encrypting into an NTT form ciphertext resets the flag
+            encryptor.encrypt(plain1, result);
+            Assert::IsFalse(result.is_ntt_form());
+        }
+
+        TEST_METHOD(FVEncryptModSwitchDecrypt)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            BigPoly poly_modulus("1x^16 + 1");
+            parms.set_poly_modulus(poly_modulus);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1), small_mods_40bit(2) });
+            SEALContext context(parms);
+            Assert::AreEqual(3, context.max_level());
+            Assert::AreEqual(1, context.min_level());
+            Assert::AreEqual(2, static_cast<int>(context.level_context(2).parms().coeff_modulus().size()));
+            Assert::IsTrue(&context == &context.level_context(3));
+
+            KeyGenerator keygen(context);
+            EvaluationKeys evk;
+            keygen.generate_evaluation_keys(16, evk);
+            GaloisKeys glk;
+            keygen.generate_galois_keys(24, glk);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            Assert::AreEqual(1, evaluator.min_level());
+
+            Plaintext plain1("1x^15 + 2x^9 + 3x^3 + 4");
+            Plaintext plain2("5x^14 + 6x^2 + 7x^1");
+            Plaintext plain;
+            Ciphertext encrypted1;
+            Ciphertext encrypted2;
+            encryptor.encrypt(plain1, encrypted1);
+            encryptor.encrypt(plain2, encrypted2);
+            Assert::AreEqual(3, encrypted1.coeff_mod_count());
+
+            // Switching down keeps the message
+            evaluator.mod_switch_to_next(encrypted1);
+            Assert::AreEqual(2, encrypted1.coeff_mod_count());
+            Assert::IsTrue(encrypted1.hash_block() == context.level_context(2).parms().hash_block());
+            decryptor.decrypt(encrypted1, plain);
+            Assert::IsTrue(plain1 == plain);
+            Assert::IsTrue(decryptor.invariant_noise_budget(encrypted1) > 0);
+
+            // The same keys work at lower levels
+            Ciphertext expected;
+            Ciphertext encrypted2_level2;
+            evaluator.mod_switch_to(encrypted2, 2, encrypted2_level2);
+            Assert::AreEqual(3, encrypted2.coeff_mod_count());
+            Ciphertext product;
+            evaluator.multiply(encrypted1, encrypted2_level2, product);
+            evaluator.relinearize(product, evk);
+            Assert::AreEqual(2, product.size());
+            Assert::AreEqual(2, product.coeff_mod_count());
+            Plaintext plain_product;
+            decryptor.decrypt(product, plain_product);
+            encryptor.encrypt(plain1, expected);
+            evaluator.multiply(expected, encrypted2);
+            decryptor.decrypt(expected, plain);
+            Assert::IsTrue(plain == plain_product);
+
+            evaluator.add(product, encrypted1);
+            evaluator.sub_plain(product, plain2);
+            evaluator.multiply_plain(product, plain2);
+            evaluator.negate(product);
+            evaluator.rotate_rows(product, 3, glk);
+            evaluator.rotate_columns(product, glk);
+            Assert::AreEqual(2, product.coeff_mod_count());
+            Assert::IsTrue(decryptor.invariant_noise_budget(product) > 0);
+
+            // Switch all the way down
+            evaluator.mod_switch_to(product, 1);
+            Assert::AreEqual(1, product.coeff_mod_count());
+            decryptor.decrypt(product, plain_product);
+            bool threw = false;
+            try
+            {
+                evaluator.mod_switch_to_next(product);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            // Ciphertexts at different levels cannot be combined
+            threw = false;
+            try
+            {
+                evaluator.add(product, encrypted1);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            // NTT form is kept, and plaintexts transformed for the highest level can be used
+            Plaintext plain2_ntt;
+            evaluator.transform_to_ntt(plain2, plain2_ntt);
+            Ciphertext encrypted_ntt;
+            encryptor.encrypt(plain1, encrypted1);
+            evaluator.transform_to_ntt(encrypted1, encrypted_ntt);
+            evaluator.mod_switch_to_next(encrypted_ntt);
+            Assert::IsTrue(encrypted_ntt.is_ntt_form());
+            evaluator.mod_switch_to_next(encrypted1);
+            evaluator.multiply_plain(encrypted1, plain2);
+            evaluator.multiply_plain_ntt(encrypted_ntt, plain2_ntt);
+            decryptor.decrypt(encrypted1, plain);
+            decryptor.decrypt(encrypted_ntt, plain_product);
+            Assert::IsTrue(plain == plain_product);
+            evaluator.transform_from_ntt(encrypted_ntt);
+            Assert::AreEqual(2, encrypted_ntt.coeff_mod_count());
+
+            // Lower levels serialize to fewer bytes
+            stringstream stream_top;
+            stringstream stream_low;
+            encryptor.encrypt(plain1, encrypted1);
+            encrypted1.save(stream_top);
+            evaluator.mod_switch_to(encrypted1, 1);
+            encrypted1.save(stream_low);
+            Assert::IsTrue(stream_low.str().size() < stream_top.str().size());
+            Ciphertext loaded;
+            loaded.load(stream_low);
+            Assert::AreEqual(1, loaded.coeff_mod_count());
+            decryptor.decrypt(loaded, plain);
+            Assert::IsTrue(plain1 == plain);
+
+            // Copies of the Evaluator and Decryptor handle the lower levels too
+            Evaluator evaluator_copy(evaluator);
+            Decryptor decryptor_copy(decryptor);
+            encryptor.encrypt(plain1, encrypted1);
+            evaluator_copy.mod_switch_to(encrypted1, 2);
+            evaluator_copy.square(encrypted1);
+            decryptor_copy.decrypt(encrypted1, plain);
+            encryptor.encrypt(plain1, encrypted2);
+            evaluator.square(encrypted2);
+            decryptor.decrypt(encrypted2, plain_product);
+            Assert::IsTrue(plain == plain_product);
+        }
+
+        TEST_METHOD(FVLevelContextsCreatedOnFirstUse)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            BigPoly poly_modulus("1x^16 + 1");
+            parms.set_poly_modulus(poly_modulus);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1), small_mods_40bit(2), small_mods_40bit(3) });
+            SEALContext context(parms);
+            Assert::AreEqual(1, context.min_level());
+            Assert::IsTrue(context.is_level_context_created(4));
+
+            // Keys, Evaluators, Decryptors and copies of them do not create the lower levels
+            KeyGenerator keygen(context);
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            Evaluator evaluator_copy(evaluator);
+            Decryptor decryptor_copy(decryptor);
+            SEALContext context_copy(context);
+            for (int level = 1; level < 4; level++)
+            {
+                Assert::IsFalse(context.is_level_context_created(level));
+            }
+
+            Plaintext plain("1x^15 + 2x^9 + 3x^3 + 4");
+            Plaintext decrypted;
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+            evaluator.mod_switch_to_next(encrypted);
+            Assert::IsTrue(context.is_level_context_created(3));
+            Assert::IsFalse(context.is_level_context_created(2));
+            Assert::IsFalse(context.is_level_context_created(1));
+
+            // Copies of the SEALContext share the levels
+            Assert::IsTrue(context_copy.is_level_context_created(3));
+            decryptor.decrypt(encrypted, decrypted);
+            Assert::IsTrue(plain == decrypted);
+
+            evaluator_copy.mod_switch_to(encrypted, 1);
+            for (int level = 1; level < 4; level++)
+            {
+                Assert::IsTrue(context.is_level_context_created(level));
+            }
+            decryptor_copy.decrypt(encrypted, decrypted);
+            Assert::IsTrue(plain == decrypted);
+        }
+
         TEST_METHOD(FVEncryptRotateMatrixDecrypt)
         {
             EncryptionParameters parms;
@@ -1031,5 +1642,598 @@ namespace SEALTest
                 6, 7, 8, 5
             });
         }
+
+        TEST_METHOD(FVEncryptRotatePlannedKeysDecrypt)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            BigPoly poly_modulus("1x^64 + 1");
+            parms.set_poly_modulus(poly_modulus);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1), small_mods_40bit(2) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            PolyCRTBuilder crtbuilder(context);
+            int row_size = crtbuilder.slot_count() / 2;
+
+            Plaintext plain;
+            vector<uint64_t> plain_vec(crtbuilder.slot_count());
+            for (int i = 0; i < crtbuilder.slot_count(); i++)
+            {
+                plain_vec[i] = i + 1;
+            }
+            crtbuilder.compose(plain_vec, plain);
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+
+            auto check_rotation = [&](const GaloisKeys &glk, int steps) {
+                Ciphertext rotated;
+                evaluator.rotate_rows(encrypted, steps, glk, rotated);
+                Assert::IsTrue(decryptor.invariant_noise_budget(rotated) > 0);
+                decryptor.decrypt(rotated, plain);
+                crtbuilder.decompose(plain, plain_vec);
+                for (int j = 0; j < row_size; j++)
+                {
+                    int source = ((j + steps) % row_size + row_size) % row_size;
+                    Assert::AreEqual(static_cast<uint64_t>(source + 1), plain_vec[j]);
+                    Assert::AreEqual(static_cast<uint64_t>(source + row_size + 1), plain_vec[j + row_size]);
+                }
+            };
+
+            // Keys for exactly the planned steps
+            RotationPlan plan(context, { 3, -5, 11 });
+            GaloisKeys glk;
+            keygen.generate_galois_keys(24, plan, glk);
+            for (uint64_t galois_elt : plan.galois_elts())
+            {
+                Assert::IsTrue(glk.has_key(galois_elt));
+            }
+            check_rotation(glk, 3);
+            check_rotation(glk, -5);
+            check_rotation(glk, 11);
+            check_rotation(glk, 6);
+            check_rotation(glk, -2);
+
+            // A single key composes every rotation
+            RotationPlan plan1(context, { 3, -5, 11 }, 1);
+            keygen.generate_galois_keys(24, plan1, glk);
+            Assert::AreEqual(1, static_cast<int>(plan1.galois_elts().size()));
+            check_rotation(glk, 3);
+            check_rotation(glk, -5);
+            check_rotation(glk, 11);
+            check_rotation(glk, 1);
+
+            // Rotations that the keys cannot compose fail
+            keygen.generate_galois_keys(24, vector<uint64_t>{ 9, 127 }, glk);
+            check_rotation(glk, 2);
+            bool threw = false;
+            try
+            {
+                evaluator.rotate_rows(encrypted, 1, glk);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            // The row swap is composed of rotating left by 1, and rotating right by 1 while
+            // swapping the rows, which has Galois element 3^31 * 127 mod 128 = 85
+            keygen.generate_galois_keys(24, vector<uint64_t>{ 3, 85 }, glk);
+            Ciphertext swapped;
+            evaluator.rotate_columns(encrypted, glk, swapped);
+            decryptor.decrypt(swapped, plain);
+            crtbuilder.decompose(plain, plain_vec);
+            for (int j = 0; j < row_size; j++)
+            {
+                Assert::AreEqual(static_cast<uint64_t>(j + row_size + 1), plain_vec[j]);
+                Assert::AreEqual(static_cast<uint64_t>(j + 1), plain_vec[j + row_size]);
+            }
+        }
+
+        TEST_METHOD(FVEncryptRotateRowsManyDecrypt)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            BigPoly poly_modulus("1x^16 + 1");
+            parms.set_poly_modulus(poly_modulus);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1), small_mods_40bit(2) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            GaloisKeys glk;
+            keygen.generate_galois_keys(24, glk);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            PolyCRTBuilder crtbuilder(context);
+
+            Plaintext plain;
+            vector<uint64_t> plain_vec{
+                1, 2, 3, 4, 5, 6, 7, 8,
+                9, 10, 11, 12, 13, 14, 15, 16
+            };
+            crtbuilder.compose(plain_vec, plain);
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+
+            // Steps 1, 2, 4, and -1 have Galois keys and are hoisted; 3 and -3 are composed
+            vector<int> steps{ 1, 2, 0, 3, 4, -1, -3 };
+            vector<Ciphertext> rotated;
+            evaluator.rotate_rows_many(encrypted, steps, glk, rotated);
+            Assert::AreEqual(static_cast<int>(steps.size()), static_cast<int>(rotated.size()));
+
+            for (size_t i = 0; i < steps.size(); i++)
+            {
+                Ciphertext expected;
+                evaluator.rotate_rows(encrypted, steps[i], glk, expected);
+
+                Plaintext plain_expected;
+                decryptor.decrypt(expected, plain_expected);
+                decryptor.decrypt(rotated[i], plain);
+                Assert::IsTrue(plain == plain_expected);
+                Assert::IsTrue(decryptor.invariant_noise_budget(rotated[i]) > 0);
+
+                crtbuilder.decompose(plain, plain_vec);
+                int row_size = crtbuilder.slot_count() / 2;
+                for (int j = 0; j < row_size; j++)
+                {
+                    int source = ((j + steps[i]) % row_size + row_size) % row_size;
+                    Assert::AreEqual(static_cast<uint64_t>(source + 1), plain_vec[j]);
+                    Assert::AreEqual(static_cast<uint64_t>(source + 9), plain_vec[j + row_size]);
+                }
+            }
+
+            // The input can be an element of the destination, which grows here
+            vector<Ciphertext> aliased{ encrypted };
+            evaluator.rotate_rows_many(aliased[0], steps, glk, aliased);
+            Assert::AreEqual(static_cast<int>(steps.size()), static_cast<int>(aliased.size()));
+            for (size_t i = 0; i < steps.size(); i++)
+            {
+                Plaintext plain_expected;
+                decryptor.decrypt(rotated[i], plain_expected);
+                decryptor.decrypt(aliased[i], plain);
+                Assert::IsTrue(plain == plain_expected);
+            }
+
+            // Rotating an empty list of steps does nothing
+            evaluator.rotate_rows_many(encrypted, vector<int>{}, glk, rotated);
+            Assert::AreEqual(0, static_cast<int>(rotated.size()));
+        }
+
+        TEST_METHOD(FVEncryptMultiplyPlainMatrixDecrypt)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            BigPoly poly_modulus("1x^64 + 1");
+            parms.set_poly_modulus(poly_modulus);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1), small_mods_40bit(2) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            GaloisKeys glk;
+            keygen.generate_galois_keys(24, glk);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            PolyCRTBuilder crtbuilder(context);
+            int row_size = crtbuilder.slot_count() / 2;
+
+            // Multiplies the matrix with the vectors in both rows, each repeated with period d
+            auto check = [&](const vector<vector<uint64_t> > &matrix, int baby_step_count, bool ntt_form) {
+                int d = static_cast<int>(matrix.size());
+                vector<uint64_t> slots(crtbuilder.slot_count());
+                for (int i = 0; i < crtbuilder.slot_count(); i++)
+                {
+                    slots[i] = (i < row_size ? 3 * (i % d) + 1 : 7 * (i % d) + 5) % 257;
+                }
+                Plaintext plain;
+                crtbuilder.compose(slots, plain);
+                Ciphertext encrypted;
+                encryptor.encrypt(plain, encrypted);
+                if (ntt_form)
+                {
+                    evaluator.transform_to_ntt(encrypted);
+                }
+
+                PlainMatrix plain_matrix(context, matrix, baby_step_count);
+                Ciphertext product;
+                evaluator.multiply_plain_matrix(encrypted, plain_matrix, glk, product);
+                Assert::IsTrue(product.is_ntt_form() == ntt_form);
+                if (ntt_form)
+                {
+                    evaluator.transform_from_ntt(product);
+                }
+                Assert::IsTrue(decryptor.invariant_noise_budget(product) > 0);
+                decryptor.decrypt(product, plain);
+                vector<uint64_t> result;
+                crtbuilder.decompose(plain, result);
+                for (int i = 0; i < crtbuilder.slot_count(); i++)
+                {
+                    int row_start = i < row_size ? 0 : row_size;
+                    uint64_t expected = 0;
+                    for (int j = 0; j < d; j++)
+                    {
+                        expected = (expected + matrix[i % d][j] * slots[row_start + j]) % 257;
+                    }
+                    Assert::AreEqual(expected, result[i]);
+                }
+            };
+
+            vector<vector<uint64_t> > matrix(32, vector<uint64_t>(32));
+            for (int i = 0; i < 32; i++)
+            {
+                for (int j = 0; j < 32; j++)
+                {
+                    matrix[i][j] = (i * i + 5 * j + 11) % 257;
+                }
+            }
+            check(matrix, 0, false);
+            check(matrix, 0, true);
+            check(matrix, 32, false);
+            check(matrix, 1, false);
+
+            matrix.assign(8, vector<uint64_t>(8, 0));
+            for (int i = 0; i < 8; i++)
+            {
+                matrix[i][i] = 2;
+                matrix[i][(i + 1) % 8] = 1;
+                matrix[i][(i + 7) % 8] = 256;
+            }
+            check(matrix, 0, false);
+            check(matrix, 3, true);
+            check({ { 5 } }, 0, false);
+
+            // Keys for the rotation steps of the matrix suffice; baby steps whose diagonals
+            // are all zero are not rotated
+            PlainMatrix tridiagonal(context, matrix);
+            Assert::IsTrue(tridiagonal.rotation_steps() == vector<int>{ 1, 6 });
+            keygen.generate_galois_keys(24, RotationPlan(context, tridiagonal.rotation_steps()), glk);
+            check(matrix, 0, false);
+            check(matrix, 0, true);
+
+            // Only diagonals 0 and 6; a rotation by 1 or 2 steps cannot be composed of the key
+            matrix.assign(8, vector<uint64_t>(8, 0));
+            for (int i = 0; i < 8; i++)
+            {
+                matrix[i][i] = 3;
+                matrix[i][(i + 6) % 8] = 4;
+            }
+            PlainMatrix sparse(context, matrix);
+            Assert::IsTrue(sparse.rotation_steps() == vector<int>{ 6 });
+            keygen.generate_galois_keys(24, RotationPlan(context, sparse.rotation_steps()), glk);
+            Assert::AreEqual(1, glk.size());
+            check(matrix, 0, false);
+            check(matrix, 0, true);
+
+            // Matrix and ciphertext must be valid for the encryption parameters
+            Plaintext plain;
+            crtbuilder.compose(vector<uint64_t>{ 1, 2, 3 }, plain);
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+            EncryptionParameters other_parms(parms);
+            other_parms.set_coeff_modulus({ small_mods_40bit(3) });
+            SEALContext other_context(other_parms);
+            PlainMatrix other_matrix(other_context, matrix);
+            bool threw = false;
+            try
+            {
+                evaluator.multiply_plain_matrix(encrypted, other_matrix, glk, encrypted);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+        }
+
+        TEST_METHOD(FVThreadPoolMatchesSequential)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            BigPoly poly_modulus("1x^64 + 1");
+            parms.set_poly_modulus(poly_modulus);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1), small_mods_40bit(2), small_mods_40bit(3) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            EvaluationKeys evk;
+            keygen.generate_evaluation_keys(16, evk);
+            GaloisKeys glk;
+            keygen.generate_galois_keys(24, glk);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Decryptor decryptor(context, keygen.secret_key());
+            PolyCRTBuilder crtbuilder(context);
+            Evaluator evaluator(context);
+
+            ThreadPoolHandle thread_pool = ThreadPoolHandle::New(4);
+            Assert::AreEqual(4, thread_pool.thread_count());
+            Evaluator evaluator_mt(context, thread_pool);
+            Assert::IsTrue(evaluator_mt.thread_pool() == thread_pool);
+            Assert::IsFalse(evaluator.thread_pool());
+
+            // The thread pool can also be set through the context
+            context.set_thread_pool(thread_pool);
+            Evaluator evaluator_context(context);
+            Assert::IsTrue(evaluator_context.thread_pool() == thread_pool);
+
+            vector<uint64_t> plain_vec(crtbuilder.slot_count());
+            for (int i = 0; i < crtbuilder.slot_count(); i++)
+            {
+                plain_vec[i] = static_cast<uint64_t>(i);
+            }
+            Plaintext plain;
+            crtbuilder.compose(plain_vec, plain);
+            Ciphertext encrypted1;
+            encryptor.encrypt(plain, encrypted1);
+            Ciphertext encrypted2;
+            encryptor.encrypt(plain, encrypted2);
+
+            Ciphertext expected;
+            Ciphertext result;
+            auto assert_equal = [](const Ciphertext &a, const Ciphertext &b) {
+                Assert::AreEqual(a.size(), b.size());
+                Assert::IsTrue(equal(a.pointer(), a.pointer() + a.uint64_count(), b.pointer()));
+            };
+
+            evaluator.multiply(encrypted1, encrypted2, expected);
+            evaluator_mt.multiply(encrypted1, encrypted2, result);
+            assert_equal(expected, result);
+
+            evaluator.relinearize(expected, evk);
+            evaluator_mt.relinearize(result, evk);
+            assert_equal(expected, result);
+
+            evaluator.multiply(expected, encrypted2);
+            evaluator_mt.multiply(result, encrypted2);
+            assert_equal(expected, result);
+
+            evaluator.square(encrypted1, expected);
+            evaluator_mt.square(encrypted1, result);
+            assert_equal(expected, result);
+
+            evaluator.multiply_plain(encrypted1, plain, expected);
+            evaluator_mt.multiply_plain(encrypted1, plain, result);
+            assert_equal(expected, result);
+
+            evaluator.rotate_rows(encrypted1, 3, glk, expected);
+            evaluator_mt.rotate_rows(encrypted1, 3, glk, result);
+            assert_equal(expected, result);
+
+            evaluator.rotate_columns(encrypted1, glk, expected);
+            evaluator_context.rotate_columns(encrypted1, glk, result);
+            assert_equal(expected, result);
+
+            expected = encrypted1;
+            result = encrypted1;
+            evaluator.transform_to_ntt(expected);
+            evaluator_mt.transform_to_ntt(result);
+            assert_equal(expected, result);
+            evaluator_mt.transform_from_ntt(result);
+            assert_equal(encrypted1, result);
+
+            // A thread-unsafe memory pool makes allocating steps run sequentially
+            MemoryPoolHandle pool_st = MemoryPoolHandle::New(false);
+            evaluator.multiply(encrypted1, encrypted2, expected);
+            evaluator_mt.multiply(encrypted1, encrypted2, result, pool_st);
+            assert_equal(expected, result);
+
+            // Limiting concurrency to one thread runs everything on the calling thread
+            thread_pool.set_max_concurrency(1);
+            Assert::AreEqual(1, thread_pool.max_concurrency());
+            evaluator_mt.square(encrypted1, result);
+            evaluator.square(encrypted1, expected);
+            assert_equal(expected, result);
+
+            decryptor.decrypt(result, plain);
+            crtbuilder.decompose(plain, plain_vec);
+            for (int i = 0; i < crtbuilder.slot_count(); i++)
+            {
+                Assert::IsTrue(plain_vec[i] == (static_cast<uint64_t>(i) * i) % 257);
+            }
+        }
+
+        TEST_METHOD(FVThreadPoolManyMatchesSequential)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_60bit(0), small_mods_60bit(1) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            EvaluationKeys evk;
+            keygen.generate_evaluation_keys(16, evk);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Decryptor decryptor(context, keygen.secret_key());
+            PolyCRTBuilder crtbuilder(context);
+            Evaluator evaluator(context);
+            Evaluator evaluator_mt(context, ThreadPoolHandle::New(4));
+            auto assert_equal = [](const Ciphertext &a, const Ciphertext &b) {
+                Assert::AreEqual(a.size(), b.size());
+                Assert::IsTrue(equal(a.pointer(), a.pointer() + a.uint64_count(), b.pointer()));
+            };
+
+            // Enough inputs that the lazily reduced sums must be reduced several times
+            vector<Ciphertext> encrypteds(50);
+            vector<uint64_t> plain_vec(crtbuilder.slot_count());
+            Plaintext plain;
+            for (int i = 0; i < 50; i++)
+            {
+                fill(plain_vec.begin(), plain_vec.end(), static_cast<uint64_t>(i));
+                crtbuilder.compose(plain_vec, plain);
+                encryptor.encrypt(plain, encrypteds[i]);
+            }
+            evaluator.square(encrypteds[7]);
+
+            Ciphertext expected = encrypteds[0];
+            for (int i = 1; i < 50; i++)
+            {
+                evaluator.add(expected, encrypteds[i]);
+            }
+            Ciphertext result;
+            evaluator.add_many(encrypteds, result);
+            assert_equal(expected, result);
+            evaluator_mt.add_many(encrypteds, result);
+            assert_equal(expected, result);
+            decryptor.decrypt(result, plain);
+            crtbuilder.decompose(plain, plain_vec);
+            Assert::AreEqual(static_cast<uint64_t>((49 * 50 / 2 - 7 + 49) % 257), plain_vec[0]);
+
+            // The destination may be one of the inputs
+            vector<Ciphertext> aliased = encrypteds;
+            evaluator_mt.add_many(aliased, aliased[3]);
+            assert_equal(expected, aliased[3]);
+
+            // Odd numbers of ciphertexts carry one over to the next level of the tree
+            vector<Ciphertext> factors(encrypteds.begin() + 1, encrypteds.begin() + 8);
+            factors[6] = factors[5];
+            evaluator.multiply_many(factors, evk, expected);
+            evaluator_mt.multiply_many(factors, evk, result);
+            assert_equal(expected, result);
+            evaluator_mt.multiply_many(factors, evk, result, MemoryPoolHandle::New(false));
+            assert_equal(expected, result);
+            decryptor.decrypt(result, plain);
+            crtbuilder.decompose(plain, plain_vec);
+            Assert::AreEqual(static_cast<uint64_t>(1 * 2 * 3 * 4 * 5 * 6 * 6 % 257), plain_vec[0]);
+        }
+
+        TEST_METHOD(FVEncryptMultiplyDecryptHPS)
+        {
+            {
+                EncryptionParameters parms;
+                SmallModulus plain_modulus(1 << 6);
+                parms.set_poly_modulus("1x^64 + 1");
+                parms.set_plain_modulus(plain_modulus);
+                parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1) });
+                SEALContext context(parms, MultiplyMethod::hps);
+                Assert::IsTrue(context.qualifiers().parameters_set);
+                Assert::IsTrue(context.multiply_method() == MultiplyMethod::hps);
+                Assert::IsTrue(context.level_context(1).multiply_method() == MultiplyMethod::hps);
+                KeyGenerator keygen(context);
+
+                BalancedEncoder encoder(plain_modulus);
+                Encryptor encryptor(context, keygen.public_key());
+                Evaluator evaluator(context);
+                Decryptor decryptor(context, keygen.secret_key());
+
+                Ciphertext encrypted1;
+                Ciphertext encrypted2;
+                Plaintext plain;
+                encryptor.encrypt(encoder.encode(0x12345678), encrypted1);
+                encryptor.encrypt(encoder.encode(0x54321), encrypted2);
+                evaluator.multiply(encrypted1, encrypted2);
+                decryptor.decrypt(encrypted1, plain);
+                Assert::AreEqual(static_cast<uint64_t>(0x5FCBBBB88D78), encoder.decode_uint64(plain));
+                Assert::IsTrue(encrypted1.hash_block() == parms.hash_block());
+
+                encryptor.encrypt(encoder.encode(5), encrypted1);
+                encryptor.encrypt(encoder.encode(-3), encrypted2);
+                evaluator.multiply(encrypted1, encrypted2);
+                decryptor.decrypt(encrypted1, plain);
+                Assert::IsTrue(static_cast<int64_t>(-15) == encoder.decode_int64(plain));
+
+                // Size 3 times size 2
+                encryptor.encrypt(encoder.encode(-7), encrypted2);
+                evaluator.multiply(encrypted1, encrypted2);
+                Assert::AreEqual(4, encrypted1.size());
+                decryptor.decrypt(encrypted1, plain);
+                Assert::IsTrue(static_cast<int64_t>(105) == encoder.decode_int64(plain));
+
+                encryptor.encrypt(encoder.encode(-123), encrypted1);
+                evaluator.square(encrypted1);
+                decryptor.decrypt(encrypted1, plain);
+                Assert::AreEqual(static_cast<uint64_t>(15129), encoder.decode_uint64(plain));
+
+                // Multiplication at a lower level
+                encryptor.encrypt(encoder.encode(0x123), encrypted1);
+                encryptor.encrypt(encoder.encode(0x321), encrypted2);
+                evaluator.mod_switch_to_next(encrypted1);
+                evaluator.mod_switch_to_next(encrypted2);
+                evaluator.multiply(encrypted1, encrypted2);
+                Assert::AreEqual(1, encrypted1.coeff_mod_count());
+                decryptor.decrypt(encrypted1, plain);
+                Assert::AreEqual(static_cast<uint64_t>(0x123 * 0x321), encoder.decode_uint64(plain));
+            }
+            {
+                EncryptionParameters parms;
+                SmallModulus plain_modulus(40961);
+                parms.set_poly_modulus("1x^64 + 1");
+                parms.set_plain_modulus(plain_modulus);
+                parms.set_coeff_modulus({ small_mods_60bit(0), small_mods_60bit(1), small_mods_60bit(2) });
+                SEALContext context(parms);
+                SEALContext context_hps(parms, MultiplyMethod::hps);
+                Assert::IsTrue(context.multiply_method() == MultiplyMethod::behz);
+                KeyGenerator keygen(context);
+                EvaluationKeys evk;
+                keygen.generate_evaluation_keys(30, evk);
+
+                Encryptor encryptor(context, keygen.public_key());
+                Decryptor decryptor(context, keygen.secret_key());
+                PolyCRTBuilder crtbuilder(context);
+                Evaluator evaluator(context);
+                Evaluator evaluator_hps(context_hps);
+
+                int slot_count = crtbuilder.slot_count();
+                vector<uint64_t> plain_vec1(slot_count);
+                vector<uint64_t> plain_vec2(slot_count);
+                for (int i = 0; i < slot_count; i++)
+                {
+                    plain_vec1[i] = (static_cast<uint64_t>(i) * 12345 + 678) % 40961;
+                    plain_vec2[i] = (static_cast<uint64_t>(i) * 54321 + 9876) % 40961;
+                }
+                Plaintext plain1;
+                Plaintext plain2;
+                crtbuilder.compose(plain_vec1, plain1);
+                crtbuilder.compose(plain_vec2, plain2);
+                Ciphertext encrypted1;
+                Ciphertext encrypted2;
+                encryptor.encrypt(plain1, encrypted1);
+                encryptor.encrypt(plain2, encrypted2);
+
+                // Both methods must decrypt to the same result with about the same noise
+                Ciphertext product;
+                Ciphertext product_hps;
+                evaluator.multiply(encrypted1, encrypted2, product);
+                evaluator_hps.multiply(encrypted1, encrypted2, product_hps);
+                int budget = decryptor.invariant_noise_budget(product);
+                int budget_hps = decryptor.invariant_noise_budget(product_hps);
+                Assert::IsTrue(budget_hps >= budget - 2);
+
+                Plaintext plain;
+                vector<uint64_t> result;
+                decryptor.decrypt(product_hps, plain);
+                crtbuilder.decompose(plain, result);
+                for (int i = 0; i < slot_count; i++)
+                {
+                    Assert::IsTrue(result[i] == (plain_vec1[i] * plain_vec2[i]) % 40961);
+                }
+
+                // Repeated squaring with relinearization
+                product_hps = encrypted1;
+                vector<uint64_t> expected(plain_vec1);
+                for (int k = 0; k < 3; k++)
+                {
+                    evaluator_hps.square(product_hps);
+                    evaluator_hps.relinearize(product_hps, evk);
+                    for (int i = 0; i < slot_count; i++)
+                    {
+                        expected[i] = (expected[i] * expected[i]) % 40961;
+                    }
+                }
+                Assert::IsTrue(decryptor.invariant_noise_budget(product_hps) > 0);
+                decryptor.decrypt(product_hps, plain);
+                crtbuilder.decompose(plain, result);
+                Assert::IsTrue(result == expected);
+            }
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "CppUnitTest.h"
+#include "seal/context.h"
+#include "seal/encryptor.h"
+#include "seal/decryptor.h"
+#include "seal/evaluator.h"
+#include "seal/evaluatorworkspace.h"
+#include "seal/keygenerator.h"
+#include "seal/polycrt.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+    TEST_CLASS(EvaluatorWorkspaceTest)
+    {
+    public:
+        TEST_METHOD(FVEvaluatorWorkspaceMatchesPool)
+        {
+            EncryptionParameters parms;
+            SmallModulus plain_modulus(257);
+            BigPoly poly_modulus("1x^64 + 1");
+            parms.set_poly_modulus(poly_modulus);
+            parms.set_plain_modulus(plain_modulus);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            EvaluationKeys evk;
+            keygen.generate_evaluation_keys(16, evk);
+            GaloisKeys glk;
+            keygen.generate_galois_keys(24, glk);
+
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+            Decryptor decryptor(context, keygen.secret_key());
+            PolyCRTBuilder crtbuilder(context);
+
+            vector<uint64_t> values(64);
+            for (uint64_t i = 0; i < 64; i++)
+            {
+                values[i] = i;
+            }
+            Plaintext plain;
+            crtbuilder.compose(values, plain);
+            Ciphertext encrypted1, encrypted2;
+            encryptor.encrypt(plain, encrypted1);
+            encryptor.encrypt(plain, encrypted2);
+
+            EvaluatorWorkspace workspace;
+            Assert::AreEqual(0ULL, workspace.byte_count());
+            Ciphertext expected, result;
+            evaluator.multiply(encrypted1, encrypted2, expected);
+            evaluator.relinearize(expected, evk);
+            evaluator.rotate_rows(expected, 1, glk);
+            evaluator.multiply(encrypted1, encrypted2, result, workspace);
+            evaluator.relinearize(result, evk, workspace);
+            evaluator.rotate_rows(result, 1, glk, workspace);
+            Assert::IsTrue(workspace.byte_count() > 0);
+
+            Plaintext plain_expected, plain_result;
+            decryptor.decrypt(expected, plain_expected);
+            decryptor.decrypt(result, plain_result);
+            Assert::IsTrue(plain_expected == plain_result);
+            crtbuilder.decompose(plain_result, values);
+            Assert::AreEqual(1ULL, values[0]);
+            Assert::AreEqual(4ULL, values[1]);
+
+            // Once the workspace has grown, steady-state evaluation does not allocate
+            Ciphertext product, rotated;
+            product.reserve(parms, 3);
+            rotated.reserve(parms, 3);
+            evaluator.multiply(encrypted1, encrypted2, product, workspace);
+            evaluator.relinearize(product, evk, workspace);
+            evaluator.rotate_rows(product, 1, glk, rotated, workspace);
+            evaluator.square(rotated, workspace);
+            evaluator.multiply_plain(rotated, plain, workspace);
+            uint64_t byte_count = workspace.byte_count();
+            {
+                NoAllocationScope scope;
+                for (int i = 0; i < 3; i++)
+                {
+                    evaluator.multiply(encrypted1, encrypted2, product, workspace);
+                    evaluator.relinearize(product, evk, workspace);
+                    evaluator.rotate_rows(product, 1, glk, rotated, workspace);
+                    evaluator.square(rotated, workspace);
+                    evaluator.multiply_plain(rotated, plain, workspace);
+                }
+            }
+            Assert::AreEqual(byte_count, workspace.byte_count());
+
+            // The same calls through a memory pool are caught
+            bool threw = false;
+            try
+            {
+                NoAllocationScope scope;
+                evaluator.multiply(encrypted1, encrypted2, product);
+            }
+            catch (const logic_error &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+        }
+    };
+}
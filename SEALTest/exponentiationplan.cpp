@@ -0,0 +1,137 @@
+#include "CppUnitTest.h"
+#include "seal/exponentiationplan.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace seal;
+using namespace std;
+
+namespace SEALTest
+{
+    namespace
+    {
+        // Runs a plan on exponents instead of ciphertexts: squaring doubles and
+        // multiplying adds
+        uint64_t run_plan(const ExponentiationPlan &plan)
+        {
+            vector<uint64_t> slots(plan.slot_count(), 0);
+            slots[0] = 1;
+            for (const auto &step : plan.steps())
+            {
+                Assert::IsTrue(slots[step.operand1] != 0);
+                Assert::IsTrue(slots[step.operand2] != 0);
+                slots[step.destination] = slots[step.operand1] + slots[step.operand2];
+            }
+            return slots[plan.result_slot()];
+        }
+    }
+
+    TEST_CLASS(ExponentiationPlanTest)
+    {
+    public:
+        TEST_METHOD(ExponentiationPlanMinDepth)
+        {
+            ExponentiationPlan plan(1);
+            Assert::AreEqual(0, plan.depth());
+            Assert::AreEqual(0, plan.multiply_count());
+            Assert::AreEqual(0, plan.relinearize_count());
+            Assert::AreEqual(static_cast<uint64_t>(1), run_plan(plan));
+
+            plan = ExponentiationPlan(2);
+            Assert::AreEqual(1, plan.depth());
+            Assert::AreEqual(1, plan.multiply_count());
+            Assert::AreEqual(1, plan.relinearize_count());
+            Assert::AreEqual(static_cast<uint64_t>(2), run_plan(plan));
+
+            plan = ExponentiationPlan(7);
+            Assert::AreEqual(3, plan.depth());
+            Assert::AreEqual(4, plan.multiply_count());
+            Assert::AreEqual(static_cast<uint64_t>(7), run_plan(plan));
+
+            plan = ExponentiationPlan(65537);
+            Assert::AreEqual(17, plan.depth());
+            Assert::AreEqual(17, plan.multiply_count());
+            Assert::AreEqual(2, plan.slot_count());
+            Assert::AreEqual(static_cast<uint64_t>(65537), run_plan(plan));
+
+            plan = ExponentiationPlan(0xFFFFFFFF);
+            Assert::AreEqual(32, plan.depth());
+            Assert::AreEqual(62, plan.multiply_count());
+            Assert::AreEqual(static_cast<uint64_t>(0xFFFFFFFF), run_plan(plan));
+
+            for (uint64_t exponent = 1; exponent < 1000; exponent++)
+            {
+                plan = ExponentiationPlan(exponent);
+                Assert::AreEqual(exponent, run_plan(plan));
+                int depth = 0;
+                while ((uint64_t(1) << depth) < exponent)
+                {
+                    depth++;
+                }
+                Assert::AreEqual(depth, plan.depth());
+            }
+        }
+
+        TEST_METHOD(ExponentiationPlanMinMultiplies)
+        {
+            ExponentiationPlan plan(255, ExponentiationStrategy::min_multiplies);
+            Assert::AreEqual(11, plan.multiply_count());
+            Assert::AreEqual(11, plan.depth());
+            Assert::AreEqual(static_cast<uint64_t>(255), run_plan(plan));
+
+            plan = ExponentiationPlan(0xFFFFFFFF, ExponentiationStrategy::min_multiplies);
+            Assert::AreEqual(43, plan.multiply_count());
+            Assert::AreEqual(static_cast<uint64_t>(0xFFFFFFFF), run_plan(plan));
+
+            // Never worse than the minimum depth plan, and just as deep when no
+            // multiplications are saved
+            for (uint64_t exponent = 1; exponent < 1000; exponent++)
+            {
+                ExponentiationPlan min_depth_plan(exponent);
+                plan = ExponentiationPlan(exponent, ExponentiationStrategy::min_multiplies);
+                Assert::AreEqual(exponent, run_plan(plan));
+                Assert::IsTrue(plan.multiply_count() <= min_depth_plan.multiply_count());
+                if (plan.multiply_count() == min_depth_plan.multiply_count())
+                {
+                    Assert::AreEqual(min_depth_plan.depth(), plan.depth());
+                }
+            }
+        }
+
+        TEST_METHOD(ExponentiationPlanMaxSize)
+        {
+            ExponentiationPlan plan(3, ExponentiationStrategy::min_depth, 3);
+            Assert::AreEqual(3, plan.max_size());
+            Assert::AreEqual(2, plan.multiply_count());
+            Assert::AreEqual(1, plan.relinearize_count());
+
+            plan = ExponentiationPlan(8, ExponentiationStrategy::min_depth, 3);
+            Assert::AreEqual(3, plan.multiply_count());
+            Assert::AreEqual(2, plan.relinearize_count());
+
+            bool threw = false;
+            try
+            {
+                ExponentiationPlan invalid(0);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            threw = false;
+            try
+            {
+                ExponentiationPlan invalid(3, ExponentiationStrategy::min_depth, 1);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+        }
+    };
+}
@@ -2,6 +2,7 @@
 #include "seal/galoiskeys.h"
 #include "seal/context.h"
 #include "seal/keygenerator.h"
+#include "seal/threadpoolhandle.h"
 #include "seal/util/uintcore.h"
 #include <vector>
 
@@ -147,5 +148,54 @@ namespace SEALTest
                 Assert::AreEqual(14, keys.size());
             }
         }
+
+        TEST_METHOD(GaloisKeysSaveLoadCompact)
+        {
+            EncryptionParameters parms;
+            parms.set_noise_standard_deviation(3.19);
+            parms.set_poly_modulus("1x^256 + 1");
+            parms.set_plain_modulus(65537);
+            parms.set_coeff_modulus({ small_mods_60bit(0), small_mods_50bit(0) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+
+            GaloisKeys keys;
+            keygen.generate_galois_keys(20, keys);
+            int uint64_count = 0;
+            for (const auto &key : keys.data())
+            {
+                for (const auto &key_component : key)
+                {
+                    Assert::IsTrue(key_component.has_seed());
+                    uint64_count += key_component.uint64_count();
+                }
+            }
+            Assert::IsTrue(uint64_count > 0);
+
+            // Only half of the polynomials are saved
+            stringstream stream;
+            keys.save(stream);
+            Assert::IsTrue(stream.str().size() < uint64_count * sizeof(uint64_t) * 6 / 10);
+
+            // Loading with and without a thread pool generates the same keys
+            GaloisKeys test_keys;
+            test_keys.load(stream);
+            stream.seekg(0);
+            GaloisKeys test_keys_parallel;
+            test_keys_parallel.load(stream, ThreadPoolHandle::New(4));
+            Assert::AreEqual(keys.size(), test_keys.size());
+            Assert::AreEqual(keys.size(), test_keys_parallel.size());
+            Assert::IsTrue(keys.hash_block() == test_keys_parallel.hash_block());
+            for (int j = 0; j < static_cast<int>(keys.data().size()); j++)
+            {
+                for (int i = 0; i < static_cast<int>(keys.data()[j].size()); i++)
+                {
+                    const Ciphertext &key_component = keys.data()[j][i];
+                    Assert::IsTrue(test_keys.data()[j][i].has_seed());
+                    Assert::IsTrue(is_equal_uint_uint(key_component.pointer(), test_keys.data()[j][i].pointer(), key_component.uint64_count()));
+                    Assert::IsTrue(is_equal_uint_uint(key_component.pointer(), test_keys_parallel.data()[j][i].pointer(), key_component.uint64_count()));
+                }
+            }
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "CppUnitTest.h"
+#include "seal/context.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
+#include "seal/galoiskeystore.h"
+#include "seal/keygenerator.h"
+#include "seal/util/uintcore.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+    TEST_CLASS(GaloisKeyStoreTest)
+    {
+    public:
+        TEST_METHOD(GaloisKeyStoreLoadOnDemand)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(257);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            GaloisKeys galois_keys;
+            keygen.generate_galois_keys(30, galois_keys);
+            Encryptor encryptor(context, keygen.public_key());
+            Evaluator evaluator(context);
+
+            Plaintext plain("1x^3 + 2x^1 + 3");
+            Ciphertext encrypted;
+            encryptor.encrypt(plain, encrypted);
+
+            string path = "galoiskeystore_test.bin";
+            {
+                ofstream stream(path, ios::binary);
+                GaloisKeyStore::save(galois_keys, stream);
+            }
+
+            // Allow only one key in the cache
+            vector<uint64_t> galois_elts = galois_keys.galois_elts();
+            size_t key_byte_count = 0;
+            for (const Ciphertext &key_component : galois_keys.key(galois_elts[0]))
+            {
+                key_byte_count += key_component.uint64_count() * sizeof(uint64_t);
+            }
+            auto store = make_shared<GaloisKeyStore>(path, key_byte_count);
+            Assert::AreEqual(galois_keys.size(), store->size());
+            Assert::AreEqual(30, store->decomposition_bit_count());
+            Assert::IsTrue(galois_elts == store->galois_elts());
+            Assert::AreEqual(0, store->cached_key_count());
+
+            GaloisKeys stored_keys(store);
+            Assert::AreEqual(galois_keys.size(), stored_keys.size());
+            Assert::IsTrue(stored_keys.has_key(galois_elts[0]));
+            Assert::IsFalse(stored_keys.has_key(galois_elts.back() + 2));
+            Assert::ExpectException<logic_error>([&]() {
+                stored_keys.key(galois_elts[0]);
+            });
+
+            // Rotations with the stored keys give the same results as with the keys in memory
+            Ciphertext expected, result;
+            for (int steps : { 1, 3, -5 })
+            {
+                evaluator.rotate_rows(encrypted, steps, galois_keys, expected);
+                evaluator.rotate_rows(encrypted, steps, stored_keys, result);
+                Assert::IsTrue(is_equal_uint_uint(expected.pointer(), result.pointer(), expected.uint64_count()));
+                Assert::IsTrue(store->cached_key_count() <= 1);
+                Assert::IsTrue(store->cache_byte_count() <= key_byte_count);
+            }
+            evaluator.rotate_columns(encrypted, galois_keys, expected);
+            evaluator.rotate_columns(encrypted, stored_keys, result);
+            Assert::IsTrue(is_equal_uint_uint(expected.pointer(), result.pointer(), expected.uint64_count()));
+
+            vector<Ciphertext> expected_many, result_many;
+            evaluator.rotate_rows_many(encrypted, { 1, 2, 4 }, galois_keys, expected_many);
+            evaluator.rotate_rows_many(encrypted, { 1, 2, 4 }, stored_keys, result_many);
+            for (size_t i = 0; i < expected_many.size(); i++)
+            {
+                Assert::IsTrue(is_equal_uint_uint(expected_many[i].pointer(), result_many[i].pointer(),
+                    expected_many[i].uint64_count()));
+            }
+
+            // Cached keys are not loaded again
+            store->set_max_cache_byte_count(0);
+            store->prefetch(galois_elts);
+            for (uint64_t galois_elt : galois_elts)
+            {
+                store->key(galois_elt);
+            }
+            int load_count = store->load_count();
+            Assert::AreEqual(static_cast<int>(galois_elts.size()), store->cached_key_count());
+            evaluator.rotate_rows(encrypted, 3, stored_keys, result);
+            Assert::AreEqual(load_count, store->load_count());
+            store->set_max_cache_byte_count(key_byte_count);
+            Assert::AreEqual(1, store->cached_key_count());
+
+            // Keys that do not fit in the cache together are not prefetched
+            store->set_max_cache_byte_count(1);
+            Assert::AreEqual(0, store->cached_key_count());
+            store->set_max_cache_byte_count(2 * key_byte_count);
+            store->prefetch(galois_elts);
+            Assert::AreEqual(0, store->cached_key_count());
+            Assert::AreEqual(load_count, store->load_count());
+            store->prefetch({ galois_elts[0], galois_elts[1] });
+            store->key(galois_elts[0]);
+            store->key(galois_elts[1]);
+            Assert::AreEqual(load_count + 2, store->load_count());
+            {
+                GaloisKeyStore unused_store(path, 2 * key_byte_count);
+                unused_store.prefetch(galois_elts);
+                Assert::AreEqual(0, unused_store.cached_key_count());
+            }
+
+            // Prefetches can be spread over a thread pool
+            store->set_max_cache_byte_count(0);
+            store->prefetch(galois_elts, ThreadPoolHandle::New(4));
+            for (uint64_t galois_elt : galois_elts)
+            {
+                store->key(galois_elt);
+            }
+            Assert::AreEqual(load_count + static_cast<int>(galois_elts.size()), store->load_count());
+            Assert::AreEqual(static_cast<int>(galois_elts.size()), store->cached_key_count());
+
+            // The stored keys can be saved and loaded into memory
+            stringstream stream;
+            stored_keys.save(stream);
+            GaloisKeys loaded_keys;
+            loaded_keys.load(stream);
+            Assert::IsTrue(galois_elts == loaded_keys.galois_elts());
+            evaluator.rotate_rows(encrypted, 3, galois_keys, expected);
+            evaluator.rotate_rows(encrypted, 3, loaded_keys, result);
+            Assert::IsTrue(is_equal_uint_uint(expected.pointer(), result.pointer(), expected.uint64_count()));
+
+            Assert::ExpectException<invalid_argument>([&]() {
+                store->key(galois_elts.back() + 2);
+            });
+            Assert::ExpectException<invalid_argument>([&]() {
+                GaloisKeys keys(nullptr);
+            });
+            remove(path.c_str());
+            Assert::ExpectException<runtime_error>([&]() {
+                GaloisKeyStore missing(path);
+            });
+        }
+    };
+}
@@ -0,0 +1,137 @@
+#include "CppUnitTest.h"
+#include "seal/context.h"
+#include "seal/decryptor.h"
+#include "seal/encryptor.h"
+#include "seal/evaluator.h"
+#include "seal/keygenerator.h"
+#include "seal/mappedarchive.h"
+#include "seal/polycrt.h"
+#include "seal/util/uintcore.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+    TEST_CLASS(MappedArchiveTest)
+    {
+    public:
+        TEST_METHOD(MappedArchiveLoad)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(257);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1) });
+            SEALContext context(parms);
+            KeyGenerator keygen(context);
+            EvaluationKeys evk;
+            keygen.generate_evaluation_keys(30, evk);
+            GaloisKeys galois_keys;
+            keygen.generate_galois_keys(30, galois_keys);
+            Encryptor encryptor(context, keygen.public_key());
+            Decryptor decryptor(context, keygen.secret_key());
+            Evaluator evaluator(context);
+            PolyCRTBuilder crtbuilder(context);
+
+            vector<uint64_t> values(64);
+            for (int i = 0; i < 64; i++)
+            {
+                values[i] = static_cast<uint64_t>(i);
+            }
+            Plaintext plain;
+            crtbuilder.compose(values, plain);
+            Ciphertext encrypted1, encrypted2;
+            encryptor.encrypt(plain, encrypted1);
+            encryptor.encrypt(plain, encrypted2);
+            evaluator.transform_to_ntt(encrypted2);
+
+            string path = "mappedarchive_test.bin";
+            {
+                ofstream stream(path, ios::binary);
+                MappedArchiveWriter writer(stream);
+                Assert::AreEqual(0, writer.add(encrypted1));
+                Assert::AreEqual(1, writer.add(evk));
+                Assert::AreEqual(2, writer.add(galois_keys));
+                Assert::AreEqual(3, writer.add(encrypted2));
+                writer.finish();
+                Assert::ExpectException<logic_error>([&]() {
+                    writer.add(encrypted1);
+                });
+            }
+
+            {
+                MappedArchive archive(path);
+                Assert::AreEqual(4, archive.size());
+
+                Ciphertext loaded1, loaded2;
+                archive.load(0, loaded1);
+                archive.load(3, loaded2);
+                Assert::IsTrue(loaded1.is_alias());
+                Assert::IsFalse(loaded1.is_ntt_form());
+                Assert::IsTrue(loaded2.is_ntt_form());
+                Assert::IsTrue(loaded1.hash_block() == encrypted1.hash_block());
+                Assert::AreEqual(encrypted1.uint64_count(), loaded1.uint64_count());
+                Assert::IsTrue(is_equal_uint_uint(encrypted1.pointer(), loaded1.pointer(), encrypted1.uint64_count()));
+                Assert::IsTrue(is_equal_uint_uint(encrypted2.pointer(), loaded2.pointer(), encrypted2.uint64_count()));
+
+                EvaluationKeys loaded_evk;
+                GaloisKeys loaded_galois_keys;
+                archive.load(1, loaded_evk);
+                archive.load(2, loaded_galois_keys);
+                Assert::AreEqual(evk.size(), loaded_evk.size());
+                Assert::AreEqual(30, loaded_evk.decomposition_bit_count());
+                Assert::IsTrue(evk.hash_block() == loaded_evk.hash_block());
+                Assert::AreEqual(galois_keys.size(), loaded_galois_keys.size());
+                Assert::IsTrue(loaded_galois_keys.data()[1][0].is_alias());
+
+                // The loaded objects work in homomorphic operations
+                Ciphertext result;
+                evaluator.square(loaded1, result);
+                evaluator.relinearize(result, loaded_evk);
+                evaluator.rotate_rows(result, 1, loaded_galois_keys);
+                Plaintext decrypted;
+                decryptor.decrypt(result, decrypted);
+                vector<uint64_t> result_values;
+                crtbuilder.decompose(decrypted, result_values);
+                Assert::AreEqual(4ULL, result_values[1]);
+                Assert::AreEqual(31ULL * 31ULL % 257ULL, result_values[30]);
+                Assert::AreEqual(0ULL, result_values[31]);
+
+                // Modifying a loaded ciphertext does not change the archive
+                evaluator.negate(loaded1);
+                MappedArchive archive2(path);
+                Ciphertext reloaded;
+                archive2.load(0, reloaded);
+                Assert::IsTrue(is_equal_uint_uint(encrypted1.pointer(), reloaded.pointer(), encrypted1.uint64_count()));
+
+                Assert::ExpectException<invalid_argument>([&]() {
+                    archive.load(0, loaded_evk);
+                });
+                Assert::ExpectException<out_of_range>([&]() {
+                    archive.load(4, loaded1);
+                });
+            }
+
+            // Truncated archives are rejected
+            {
+                ifstream in(path, ios::binary);
+                string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+                in.close();
+                ofstream out(path, ios::binary);
+                out.write(data.data(), data.size() - 8);
+            }
+            Assert::ExpectException<invalid_argument>([&]() {
+                MappedArchive archive(path);
+            });
+            remove(path.c_str());
+        }
+    };
+}
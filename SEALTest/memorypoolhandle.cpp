@@ -1,6 +1,10 @@
 #include "CppUnitTest.h"
 #include "seal/memorypoolhandle.h"
 #include "seal/util/uintcore.h"
+#include <chrono>
+#include <new>
+#include <thread>
+#include <atomic>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace seal;
@@ -59,5 +63,151 @@ namespace SEALTest
                 Assert::AreEqual(15ULL, pool.alloc_uint64_count());
             }
         }
+
+        TEST_METHOD(MemoryPoolHandleTrim)
+        {
+            for (bool thread_safe : { true, false })
+            {
+                MemoryPoolHandle pool = MemoryPoolHandle::New(thread_safe);
+                Assert::AreEqual(0ULL, pool.trim());
+                {
+                    Pointer ptr(allocate_uint(5, pool));
+                    Pointer ptr2(allocate_uint(5, pool));
+                    Assert::AreEqual(120ULL, pool.alloc_byte_count());
+                }
+                Assert::AreEqual(120ULL, pool.alloc_byte_count());
+                Assert::AreEqual(120ULL, pool.trim());
+                Assert::AreEqual(0ULL, pool.alloc_byte_count());
+                Assert::AreEqual(1ULL, pool.pool_count());
+
+                // Only allocations with no live items are released
+                Pointer ptr(allocate_uint(5, pool));
+                Assert::AreEqual(40ULL, pool.alloc_byte_count());
+                {
+                    Pointer ptr2(allocate_uint(5, pool));
+                    Assert::AreEqual(120ULL, pool.alloc_byte_count());
+                }
+                Assert::AreEqual(80ULL, pool.trim());
+                Assert::AreEqual(40ULL, pool.alloc_byte_count());
+                Assert::AreEqual(0ULL, pool.trim());
+                ptr.release();
+                Assert::AreEqual(40ULL, pool.trim());
+                Assert::AreEqual(0ULL, pool.alloc_byte_count());
+            }
+
+            // Blocks cached by another thread that is still alive are released too
+            MemoryPoolHandle pool = MemoryPoolHandle::New(true);
+            atomic<bool> freed(false);
+            atomic<bool> done(false);
+            thread worker([&]() {
+                {
+                    Pointer ptr(allocate_uint(5, pool));
+                    Pointer ptr2(allocate_uint(7, pool));
+                }
+                freed = true;
+                while (!done)
+                {
+                    this_thread::yield();
+                }
+            });
+            while (!freed)
+            {
+                this_thread::yield();
+            }
+            Assert::AreEqual(96ULL, pool.alloc_byte_count());
+            Assert::AreEqual(96ULL, pool.trim());
+            Assert::AreEqual(0ULL, pool.alloc_byte_count());
+            done = true;
+            worker.join();
+        }
+
+        TEST_METHOD(MemoryPoolHandleByteCap)
+        {
+            for (bool thread_safe : { true, false })
+            {
+                MemoryPoolHandle pool = MemoryPoolHandle::New(thread_safe);
+                Assert::AreEqual(0ULL, pool.byte_cap());
+                pool.set_byte_cap(100);
+                Assert::AreEqual(100ULL, pool.byte_cap());
+
+                // Second allocation is clipped to fit under the cap
+                Pointer ptr(allocate_uint(5, pool));
+                Pointer ptr2(allocate_uint(5, pool));
+                Assert::AreEqual(80ULL, pool.alloc_byte_count());
+
+                bool threw = false;
+                try
+                {
+                    Pointer ptr3(allocate_uint(5, pool));
+                }
+                catch (const bad_alloc &)
+                {
+                    threw = true;
+                }
+                Assert::IsTrue(threw);
+                Assert::AreEqual(80ULL, pool.alloc_byte_count());
+
+                // Freed memory is reused, and released to make room for another size
+                uint64_t *allocation2 = ptr2.get();
+                ptr2.release();
+                Pointer ptr3(allocate_uint(5, pool));
+                Assert::IsTrue(allocation2 == ptr3.get());
+                ptr3.release();
+                Pointer ptr4(allocate_uint(4, pool));
+                Assert::AreEqual(72ULL, pool.alloc_byte_count());
+
+                pool.set_byte_cap(0);
+                Pointer ptr5(allocate_uint(100, pool));
+                Assert::AreEqual(872ULL, pool.alloc_byte_count());
+            }
+        }
+
+        TEST_METHOD(MemoryPoolHandleIdleRelease)
+        {
+            // A thread-safe pool releases every size class once the interval passes, also
+            // what an idle thread keeps cached, without any further allocation or free
+            MemoryPoolHandle pool = MemoryPoolHandle::New(true);
+            pool.set_idle_release(chrono::milliseconds(1));
+            atomic<bool> done(false);
+            thread worker([&]() {
+                {
+                    Pointer ptr(allocate_uint(5, pool));
+                    Pointer ptr2(allocate_uint(7, pool));
+                }
+                while (!done)
+                {
+                    this_thread::yield();
+                }
+            });
+            {
+                Pointer ptr(allocate_uint(3, pool));
+                Pointer ptr2(allocate_uint(9, pool));
+            }
+            auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+            while ((pool.alloc_byte_count() != 0 || pool.pool_count() != 4) && 
+                chrono::steady_clock::now() < deadline)
+            {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+            Assert::AreEqual(4ULL, pool.pool_count());
+            Assert::AreEqual(0ULL, pool.alloc_byte_count());
+            done = true;
+            worker.join();
+
+            // A pool that is not thread-safe releases every size class on the first free
+            // after the interval
+            pool = MemoryPoolHandle::New(false);
+            pool.set_idle_release(chrono::milliseconds(200));
+            {
+                Pointer ptr(allocate_uint(5, pool));
+                Pointer ptr2(allocate_uint(7, pool));
+            }
+            Assert::AreEqual(96ULL, pool.alloc_byte_count());
+            this_thread::sleep_for(chrono::milliseconds(250));
+            {
+                Pointer ptr(allocate_uint(3, pool));
+            }
+            Assert::AreEqual(0ULL, pool.alloc_byte_count());
+        }
     };
 }
\ No newline at end of file
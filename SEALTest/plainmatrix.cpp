@@ -0,0 +1,122 @@
+#include "CppUnitTest.h"
+#include "seal/context.h"
+#include "seal/plainmatrix.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace seal;
+using namespace std;
+
+namespace SEALTest
+{
+    TEST_CLASS(PlainMatrixTest)
+    {
+    public:
+        TEST_METHOD(PlainMatrixDiagonals)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(257);
+            parms.set_coeff_modulus({ small_mods_40bit(0), small_mods_40bit(1) });
+            SEALContext context(parms);
+
+            // Dense matrix uses every diagonal
+            vector<vector<uint64_t> > matrix(32, vector<uint64_t>(32));
+            for (int i = 0; i < 32; i++)
+            {
+                for (int j = 0; j < 32; j++)
+                {
+                    matrix[i][j] = (i * 32 + j) % 257;
+                }
+            }
+            PlainMatrix dense(context, matrix);
+            Assert::AreEqual(32, dense.dimension());
+            Assert::AreEqual(6, dense.baby_step_count());
+            Assert::AreEqual(6, dense.giant_step_count());
+            Assert::IsTrue(dense.hash_block() == parms.hash_block());
+            Assert::IsTrue(dense.rotation_steps() == vector<int>{ 1, 2, 3, 4, 5, 6, 12, 18, 24, 30 });
+            for (int g = 0; g < 6; g++)
+            {
+                for (int b = 0; b < 6; b++)
+                {
+                    int coeff_count = g * 6 + b < 32 ? 65 * 2 : 0;
+                    Assert::AreEqual(coeff_count, dense.diagonals()[g][b].coeff_count());
+                }
+            }
+
+            // Tridiagonal matrix only needs diagonals 0, 1 and 15
+            matrix.assign(16, vector<uint64_t>(16, 0));
+            for (int i = 0; i < 16; i++)
+            {
+                matrix[i][i] = 2;
+                matrix[i][(i + 1) % 16] = 1;
+                matrix[i][(i + 15) % 16] = 256;
+            }
+            PlainMatrix banded(context, matrix);
+            Assert::AreEqual(16, banded.dimension());
+            Assert::AreEqual(4, banded.baby_step_count());
+            Assert::AreEqual(4, banded.giant_step_count());
+            Assert::IsTrue(banded.rotation_steps() == vector<int>{ 1, 3, 12 });
+            Assert::AreEqual(0, banded.diagonals()[1][0].coeff_count());
+            Assert::AreEqual(65 * 2, banded.diagonals()[3][3].coeff_count());
+
+            // Baby step count can be chosen
+            PlainMatrix banded8(context, matrix, 8);
+            Assert::AreEqual(8, banded8.baby_step_count());
+            Assert::AreEqual(2, banded8.giant_step_count());
+            Assert::IsTrue(banded8.rotation_steps() == vector<int>{ 1, 7, 8 });
+
+            PlainMatrix single(context, { { 5 } });
+            Assert::AreEqual(1, single.baby_step_count());
+            Assert::AreEqual(1, single.giant_step_count());
+            Assert::IsTrue(single.rotation_steps().empty());
+        }
+
+        TEST_METHOD(PlainMatrixInvalid)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(257);
+            parms.set_coeff_modulus({ small_mods_40bit(0) });
+            SEALContext context(parms);
+
+            auto throws = [&](const vector<vector<uint64_t> > &matrix, int baby_step_count) {
+                bool threw = false;
+                try
+                {
+                    PlainMatrix plain_matrix(context, matrix, baby_step_count);
+                }
+                catch (const invalid_argument &)
+                {
+                    threw = true;
+                }
+                return threw;
+            };
+            Assert::IsFalse(throws({ { 1, 2 }, { 3, 4 } }, 0));
+            Assert::IsTrue(throws({}, 0));
+            Assert::IsTrue(throws({ { 1, 2 }, { 3 } }, 0));
+            Assert::IsTrue(throws({ { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } }, 0));
+            Assert::IsTrue(throws({ { 1, 2 }, { 3, 257 } }, 0));
+            Assert::IsTrue(throws({ { 0, 0 }, { 0, 0 } }, 0));
+            Assert::IsTrue(throws({ { 1, 2 }, { 3, 4 } }, 3));
+            Assert::IsTrue(throws({ { 1, 2 }, { 3, 4 } }, -1));
+            Assert::IsTrue(throws(vector<vector<uint64_t> >(64, vector<uint64_t>(64, 1)), 0));
+
+            // Batching must be enabled
+            parms.set_plain_modulus(256);
+            SEALContext context_no_batching(parms);
+            bool threw = false;
+            try
+            {
+                PlainMatrix plain_matrix(context_no_batching, { { 1 } });
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+        }
+    };
+}
@@ -141,5 +141,36 @@ namespace SEALTest
             Assert::AreEqual(9ULL, plain2[5]);
             Assert::AreEqual(8ULL, plain2[6]);
         }
+
+        TEST_METHOD(SaveLoadPackedPlaintext)
+        {
+            stringstream stream;
+
+            Plaintext plain;
+            Plaintext plain2;
+            plain.save_packed(stream);
+            plain2.load(stream);
+            Assert::AreEqual(0, plain2.coeff_count());
+
+            plain.resize(100);
+            for (int i = 0; i < 100; i++)
+            {
+                plain[i] = static_cast<uint64_t>(i * 37 % 101);
+            }
+            plain.save_packed(stream);
+            Assert::IsTrue(stream.str().size() < 100 + 16);
+            plain2.load(stream);
+            Assert::AreEqual(100, plain2.coeff_count());
+            Assert::IsTrue(plain == plain2);
+
+            // The unpacked format is still accepted
+            plain[99] = 0xFFFFFFFFFFFFFFFF;
+            plain.save(stream);
+            plain2.load(stream);
+            Assert::IsTrue(plain == plain2);
+            plain.save_packed(stream);
+            plain2.load(stream);
+            Assert::IsTrue(plain == plain2);
+        }
     };
 }
\ No newline at end of file
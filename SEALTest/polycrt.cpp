@@ -2,6 +2,8 @@
 #include "seal/polycrt.h"
 #include "seal/context.h"
 #include "seal/keygenerator.h"
+#include <cstdint>
+#include <stdexcept>
 #include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -173,5 +175,56 @@ namespace SEALTest
                 Assert::IsTrue(short_plain[i] == 0);
             }
         }
+
+        TEST_METHOD(BatchUnbatchArray)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_coeff_modulus({ small_mods_60bit(0) });
+            parms.set_plain_modulus(257);
+
+            SEALContext context(parms);
+            PolyCRTBuilder crtbuilder(context);
+
+            uint64_t values[64];
+            for (int i = 0; i < 64; i++)
+            {
+                values[i] = static_cast<uint64_t>(i);
+            }
+            Plaintext plain, expected;
+            crtbuilder.compose(values, 20, plain);
+            crtbuilder.compose(vector<uint64_t>(values, values + 20), expected);
+            Assert::IsTrue(plain == expected);
+
+            uint64_t decomposed[64];
+            crtbuilder.decompose(plain, decomposed);
+            for (int i = 0; i < 64; i++)
+            {
+                Assert::AreEqual(i < 20 ? values[i] : static_cast<uint64_t>(0), decomposed[i]);
+            }
+
+            int64_t signed_values[64];
+            for (int i = 0; i < 64; i++)
+            {
+                signed_values[i] = static_cast<int64_t>(i) - 32;
+            }
+            crtbuilder.compose(signed_values, 64, plain);
+            int64_t signed_decomposed[64];
+            crtbuilder.decompose(plain, signed_decomposed);
+            for (int i = 0; i < 64; i++)
+            {
+                Assert::AreEqual(signed_values[i], signed_decomposed[i]);
+            }
+
+            Assert::ExpectException<logic_error>([&]() {
+                crtbuilder.compose(values, 65, plain);
+            });
+            Assert::ExpectException<invalid_argument>([&]() {
+                crtbuilder.compose(static_cast<const uint64_t*>(nullptr), 1, plain);
+            });
+            Assert::ExpectException<invalid_argument>([&]() {
+                crtbuilder.decompose(plain, static_cast<uint64_t*>(nullptr));
+            });
+        }
     };
 }
\ No newline at end of file
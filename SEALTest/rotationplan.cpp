@@ -0,0 +1,129 @@
+#include "CppUnitTest.h"
+#include "seal/context.h"
+#include "seal/rotationplan.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace seal;
+using namespace std;
+
+namespace SEALTest
+{
+    TEST_CLASS(RotationPlanTest)
+    {
+    public:
+        TEST_METHOD(RotationPlanUnlimited)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(257);
+            parms.set_coeff_modulus({ small_mods_40bit(0) });
+            SEALContext context(parms);
+
+            // One key for each distinct step; rotating right by 31 is rotating left by 1
+            RotationPlan plan(context, { 1, -1, 5, 5, 0, -31 });
+            Assert::IsTrue(plan.key_steps() == vector<int>{ -1, 1, 5 });
+            Assert::IsTrue(plan.galois_elts() == vector<uint64_t>{ 43, 3, 115 });
+            Assert::AreEqual(3, plan.total_key_switch_count());
+            Assert::AreEqual(0, plan.key_switch_count(0));
+            Assert::AreEqual(1, plan.key_switch_count(-1));
+            Assert::AreEqual(1, plan.key_switch_count(31));
+            Assert::AreEqual(2, plan.key_switch_count(2));
+            Assert::AreEqual(2, plan.key_switch_count(4));
+            Assert::AreEqual(2, plan.key_switch_count(6));
+
+            RotationPlan empty(context, { 0 });
+            Assert::IsTrue(empty.key_steps().empty());
+            Assert::AreEqual(0, empty.total_key_switch_count());
+            Assert::AreEqual(-1, empty.key_switch_count(1));
+        }
+
+        TEST_METHOD(RotationPlanLimited)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(257);
+            parms.set_coeff_modulus({ small_mods_40bit(0) });
+            SEALContext context(parms);
+
+            vector<int> steps{ 1, 2, 3, 4, 5, 6, 7, 8, -8 };
+            int previous_count = 1000;
+            for (int max_key_count = 1; max_key_count <= 9; max_key_count++)
+            {
+                RotationPlan plan(context, steps, max_key_count);
+                Assert::IsTrue(static_cast<int>(plan.key_steps().size()) <= max_key_count);
+                int total_count = 0;
+                for (int step : steps)
+                {
+                    Assert::IsTrue(plan.key_switch_count(step) > 0);
+                    total_count += plan.key_switch_count(step);
+                }
+                Assert::AreEqual(total_count, plan.total_key_switch_count());
+
+                // More keys never make the rotations more expensive
+                Assert::IsTrue(total_count <= previous_count);
+                previous_count = total_count;
+            }
+            Assert::AreEqual(9, previous_count);
+
+            // A single key still reaches every step
+            RotationPlan plan1(context, { 6, 10 }, 1);
+            Assert::AreEqual(1, static_cast<int>(plan1.key_steps().size()));
+            Assert::IsTrue(plan1.key_switch_count(6) > 0);
+            Assert::IsTrue(plan1.key_switch_count(10) > 0);
+        }
+
+        TEST_METHOD(RotationPlanInvalid)
+        {
+            EncryptionParameters parms;
+            parms.set_poly_modulus("1x^64 + 1");
+            parms.set_plain_modulus(257);
+            parms.set_coeff_modulus({ small_mods_40bit(0) });
+            SEALContext context(parms);
+
+            auto throws = [&](const vector<int> &steps, int max_key_count) {
+                bool threw = false;
+                try
+                {
+                    RotationPlan plan(context, steps, max_key_count);
+                }
+                catch (const invalid_argument &)
+                {
+                    threw = true;
+                }
+                return threw;
+            };
+            Assert::IsFalse(throws({ 31, -31 }, 0));
+            Assert::IsTrue(throws({ 32 }, 0));
+            Assert::IsTrue(throws({ -32 }, 0));
+            Assert::IsTrue(throws({ 1 }, -1));
+
+            RotationPlan plan(context, { 1 });
+            bool threw = false;
+            try
+            {
+                plan.key_switch_count(32);
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+
+            parms.set_plain_modulus(256);
+            SEALContext context_no_batching(parms);
+            threw = false;
+            try
+            {
+                RotationPlan plan_no_batching(context_no_batching, { 1 });
+            }
+            catch (const invalid_argument &)
+            {
+                threw = true;
+            }
+            Assert::IsTrue(threw);
+        }
+    };
+}
@@ -0,0 +1,66 @@
+#include "CppUnitTest.h"
+#include "seal/util/bitpack.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+    namespace util
+    {
+        TEST_CLASS(BitPack)
+        {
+        public:
+            TEST_METHOD(PackedCount)
+            {
+                Assert::AreEqual(0, get_packed_uint64_count(0, 30));
+                Assert::AreEqual(0, get_packed_uint64_count(10, 0));
+                Assert::AreEqual(1, get_packed_uint64_count(2, 32));
+                Assert::AreEqual(2, get_packed_uint64_count(3, 30));
+                Assert::AreEqual(4, get_packed_uint64_count(4, 64));
+                Assert::AreEqual(0, get_packed_byte_count(10, 0));
+                Assert::AreEqual(1, get_packed_byte_count(1, 1));
+                Assert::AreEqual(12, get_packed_byte_count(3, 30));
+                Assert::AreEqual(32, get_packed_byte_count(4, 64));
+            }
+
+            TEST_METHOD(PackUnpackUInt64)
+            {
+                uint64_t values[3]{ 0x1, 0x3FFFFFFF, 0x2AAAAAAA };
+                uint64_t packed[2]{ 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF };
+                pack_uint64(values, 3, 30, packed);
+                Assert::AreEqual(0xAFFFFFFFC0000001ULL, packed[0]);
+                Assert::AreEqual(0x2AAAAAAULL, packed[1]);
+                uint64_t unpacked[3]{ 0 };
+                unpack_uint64(packed, 3, 30, unpacked);
+                Assert::AreEqual(values[0], unpacked[0]);
+                Assert::AreEqual(values[1], unpacked[1]);
+                Assert::AreEqual(values[2], unpacked[2]);
+
+                // Every bit count, with value counts ending inside and at the end of a word
+                mt19937_64 random(0);
+                for (int bit_count = 0; bit_count <= 64; bit_count++)
+                {
+                    for (int count : { 1, 63, 64, 65, 1000 })
+                    {
+                        vector<uint64_t> input(count);
+                        for (auto &value : input)
+                        {
+                            value = bit_count == 64 ? random() : random() & ((1ULL << bit_count) - 1);
+                        }
+                        vector<uint64_t> output(count, 1);
+                        vector<uint64_t> buffer(get_packed_uint64_count(count, bit_count) + 1, 0);
+                        pack_uint64(input.data(), count, bit_count, buffer.data());
+                        Assert::AreEqual(0ULL, buffer.back());
+                        unpack_uint64(buffer.data(), count, bit_count, output.data());
+                        Assert::IsTrue(input == output);
+                    }
+                }
+            }
+        };
+    }
+}
@@ -38,6 +38,31 @@ namespace SEALTest
                 HashFunction::sha3_hash(input, 2, hash2);
                 Assert::IsTrue(hash1 != hash2);
             }
+
+            TEST_METHOD(Shake256Generate)
+            {
+                // SHAKE256 of the empty string
+                Shake256Stream empty(nullptr, 0);
+                Assert::AreEqual(0x138da80b2bddb946ULL, empty.generate());
+                Assert::AreEqual(0x24eb3e74eb3f3b23ULL, empty.generate());
+                Assert::AreEqual(0x821bb862ea52cd3fULL, empty.generate());
+                Assert::AreEqual(0x2f76d56e64270cb5ULL, empty.generate());
+
+                // The stream continues past one block and depends only on the seed
+                uint64_t seed[4]{ 1, 2, 3, 4 };
+                Shake256Stream random1(seed, 4);
+                Shake256Stream random2(seed, 4);
+                seed[3] = 5;
+                Shake256Stream random3(seed, 4);
+                bool all_equal3 = true;
+                for (int i = 0; i < 100; i++)
+                {
+                    uint64_t value = random1.generate();
+                    Assert::AreEqual(value, random2.generate());
+                    all_equal3 = all_equal3 && value == random3.generate();
+                }
+                Assert::IsFalse(all_equal3);
+            }
         };
     }
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "CppUnitTest.h"
 #include "seal/util/mempool.h"
 #include <memory>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace seal::util;
@@ -142,6 +146,164 @@ namespace SEALTest
                 p1.release();
             }
 
+            TEST_METHOD(ThreadCacheFlushMT)
+            {
+                MemoryPoolMT pool;
+                uint64_t *allocation1 = nullptr;
+                thread worker([&]() {
+                    Pointer pointer = pool.get_for_uint64_count(3);
+                    allocation1 = pointer.get();
+                });
+                worker.join();
+                Assert::AreEqual(1ULL, pool.pool_count());
+                Assert::AreEqual(24ULL, pool.alloc_byte_count());
+
+                // Block cached by the exited thread must be back in the shared pool
+                Pointer pointer = pool.get_for_uint64_count(3);
+                Assert::IsTrue(allocation1 == pointer.get());
+                Assert::AreEqual(24ULL, pool.alloc_byte_count());
+            }
+
+            TEST_METHOD(ThreadCacheStressMT)
+            {
+                MemoryPoolMT pool;
+                atomic<bool> failed(false);
+                vector<thread> workers;
+                for (uint64_t t = 0; t < 4; t++)
+                {
+                    workers.emplace_back([&pool, &failed, t]() {
+                        vector<Pointer> live;
+                        for (uint64_t i = 0; i < 2000; i++)
+                        {
+                            uint64_t uint64_count = 1 + (i % 5);
+                            Pointer pointer = pool.get_for_uint64_count(uint64_count);
+                            for (uint64_t j = 0; j < uint64_count; j++)
+                            {
+                                pointer[static_cast<int>(j)] = (t << 32) + i;
+                            }
+                            live.emplace_back(move(pointer));
+                            if (live.size() > 100)
+                            {
+                                for (auto &p : live)
+                                {
+                                    uint64_t value = p[0];
+                                    if ((value >> 32) != t)
+                                    {
+                                        failed = true;
+                                    }
+                                }
+                                live.clear();
+                            }
+                        }
+                    });
+                }
+                for (auto &worker : workers)
+                {
+                    worker.join();
+                }
+                Assert::IsFalse(failed);
+                Assert::AreEqual(5ULL, pool.pool_count());
+            }
+
+            TEST_METHOD(ThreadCachePoolDestroyedMT)
+            {
+                atomic<int> stage(0);
+                bool allocated = false;
+                unique_ptr<MemoryPoolMT> pool(new MemoryPoolMT);
+                thread worker([&]() {
+                    {
+                        Pointer pointer = pool->get_for_uint64_count(4);
+                    }
+                    stage = 1;
+                    while (stage != 2);
+
+                    // Touching another pool drops the cache entry of the destroyed one
+                    MemoryPoolMT other_pool;
+                    Pointer pointer = other_pool.get_for_uint64_count(4);
+                    allocated = pointer.is_set();
+                });
+                while (stage != 1);
+                pool.reset();
+                stage = 2;
+                worker.join();
+                Assert::IsTrue(allocated);
+            }
+
+            TEST_METHOD(TestMemoryPoolArena)
+            {
+                MemoryPoolArena pool;
+                Assert::AreEqual(0ULL, pool.alloc_byte_count());
+                Pointer pointer = pool.get_for_uint64_count(0);
+                Assert::IsFalse(pointer.is_set());
+
+                // Blocks are carved consecutively from one buffer
+                pointer = pool.get_for_uint64_count(4);
+                uint64_t *allocation1 = pointer.get();
+                Assert::AreEqual(32ULL, pool.alloc_byte_count());
+                Pointer pointer2 = pool.get_for_uint64_count(4);
+                Assert::AreEqual(64ULL, pool.alloc_byte_count());
+                Assert::AreEqual(2ULL, pool.pool_count());
+                Assert::AreEqual(2ULL, pool.live_count());
+
+                // Buffers are merged once everything is returned
+                pointer.release();
+                pointer2.release();
+                Assert::AreEqual(0ULL, pool.live_count());
+                Assert::AreEqual(1ULL, pool.pool_count());
+                Assert::AreEqual(64ULL, pool.alloc_byte_count());
+                pointer = pool.get_for_uint64_count(4);
+                allocation1 = pointer.get();
+                pointer2 = pool.get_for_uint64_count(4);
+                Assert::IsTrue(allocation1 + 4 == pointer2.get());
+                Assert::AreEqual(64ULL, pool.alloc_byte_count());
+                pointer2.release();
+                pointer.release();
+
+                pointer = pool.get_for_uint64_count(8);
+                Assert::IsTrue(allocation1 == pointer.get());
+                Assert::AreEqual(0ULL, pool.trim());
+                pointer.release();
+                Assert::AreEqual(64ULL, pool.trim());
+                Assert::AreEqual(0ULL, pool.alloc_byte_count());
+            }
+
+            TEST_METHOD(NoAllocationScopeMT)
+            {
+                MemoryPoolMT pool;
+                MemoryPoolArena arena(8);
+                Pointer pointer = arena.get_for_uint64_count(8);
+                pointer.release();
+                {
+                    NoAllocationScope scope;
+                    pointer = arena.get_for_uint64_count(8);
+                    pointer.release();
+
+                    bool threw = false;
+                    try
+                    {
+                        pointer = pool.get_for_uint64_count(1);
+                    }
+                    catch (const logic_error &)
+                    {
+                        threw = true;
+                    }
+                    Assert::IsTrue(threw);
+
+                    threw = false;
+                    try
+                    {
+                        pointer = arena.get_for_uint64_count(9);
+                    }
+                    catch (const logic_error &)
+                    {
+                        threw = true;
+                    }
+                    Assert::IsTrue(threw);
+                }
+                pointer = pool.get_for_uint64_count(1);
+                Assert::IsTrue(pointer.is_set());
+            }
+
             TEST_METHOD(TestMemoryPoolST)
             {
                 MemoryPoolST pool;
@@ -2,6 +2,8 @@
 #include "seal/util/uintcore.h"
 #include "seal/util/polycore.h"
 #include "seal/util/polyarithsmallmod.h"
+#include "seal/util/smallntt.h"
+#include "seal/defaultparams.h"
 #include "seal/bigpolyarray.h"
 #include <cstdint>
 
@@ -304,6 +306,70 @@ namespace SEALTest
                 Assert::AreEqual(6ULL, result[2]);
             }
 
+            TEST_METHOD(DyadicProduct2x2CoeffSmallMod)
+            {
+                MemoryPool &pool = *global_variables::global_memory_pool;
+                Pointer c(allocate_zero_poly(2, 2, pool));
+                Pointer d(allocate_zero_poly(2, 2, pool));
+                Pointer result(allocate_zero_poly(2, 3, pool));
+                SmallModulus mod(13);
+
+                c[0] = 1;
+                c[1] = 3;
+                c[2] = 2;
+                c[3] = 12;
+                d[0] = 4;
+                d[1] = 5;
+                d[2] = 6;
+                d[3] = 12;
+
+                dyadic_product_2x2_coeffmod(c.get(), c.get() + 2, d.get(), d.get() + 2, 2, mod, 
+                    result.get(), result.get() + 2, result.get() + 4);
+                Assert::AreEqual(4ULL, result[0]);
+                Assert::AreEqual(2ULL, result[1]);
+                Assert::AreEqual(1ULL, result[2]);
+                Assert::AreEqual(5ULL, result[3]);
+                Assert::AreEqual(12ULL, result[4]);
+                Assert::AreEqual(1ULL, result[5]);
+
+                set_zero_poly(2, 3, result.get());
+                dyadic_product_2x2_karatsuba_coeffmod(c.get(), c.get() + 2, d.get(), d.get() + 2, 2, mod, 
+                    result.get(), result.get() + 2, result.get() + 4);
+                Assert::AreEqual(4ULL, result[0]);
+                Assert::AreEqual(2ULL, result[1]);
+                Assert::AreEqual(1ULL, result[2]);
+                Assert::AreEqual(5ULL, result[3]);
+                Assert::AreEqual(12ULL, result[4]);
+                Assert::AreEqual(1ULL, result[5]);
+
+                // Largest operands modulo a 61-bit prime
+                mod = 0x1fffffffffe00001;
+                for (int i = 0; i < 4; i++)
+                {
+                    c[i] = mod.value() - 1;
+                    d[i] = mod.value() - 1;
+                }
+
+                dyadic_product_2x2_coeffmod(c.get(), c.get() + 2, d.get(), d.get() + 2, 2, mod, 
+                    result.get(), result.get() + 2, result.get() + 4);
+                Assert::AreEqual(1ULL, result[0]);
+                Assert::AreEqual(1ULL, result[1]);
+                Assert::AreEqual(2ULL, result[2]);
+                Assert::AreEqual(2ULL, result[3]);
+                Assert::AreEqual(1ULL, result[4]);
+                Assert::AreEqual(1ULL, result[5]);
+
+                set_zero_poly(2, 3, result.get());
+                dyadic_product_2x2_karatsuba_coeffmod(c.get(), c.get() + 2, d.get(), d.get() + 2, 2, mod, 
+                    result.get(), result.get() + 2, result.get() + 4);
+                Assert::AreEqual(1ULL, result[0]);
+                Assert::AreEqual(1ULL, result[1]);
+                Assert::AreEqual(2ULL, result[2]);
+                Assert::AreEqual(2ULL, result[3]);
+                Assert::AreEqual(1ULL, result[4]);
+                Assert::AreEqual(1ULL, result[5]);
+            }
+
             TEST_METHOD(SmallModuloPoly)
             {
                 MemoryPool &pool = *global_variables::global_memory_pool;
@@ -470,6 +536,38 @@ namespace SEALTest
                 Assert::AreEqual(9ULL, result[1]);
                 Assert::AreEqual(0ULL, result[2]);
             }
+
+            TEST_METHOD(ApplyGaloisNTT)
+            {
+                MemoryPoolHandle pool = MemoryPoolHandle::Global();
+                int coeff_count_power = 3;
+                int coeff_count = 1 << coeff_count_power;
+                SmallModulus mod(small_mods_40bit(0));
+                SmallNTTTables tables(coeff_count_power, mod, pool);
+
+                Pointer poly(allocate_zero_poly(coeff_count + 1, 1, pool));
+                Pointer poly_ntt(allocate_zero_poly(coeff_count + 1, 1, pool));
+                Pointer expected(allocate_zero_poly(coeff_count + 1, 1, pool));
+                Pointer result(allocate_zero_poly(coeff_count + 1, 1, pool));
+                for (int i = 0; i < coeff_count; i++)
+                {
+                    poly[i] = static_cast<uint64_t>(i + 1);
+                }
+                set_uint_uint(poly.get(), coeff_count + 1, poly_ntt.get());
+                ntt_negacyclic_harvey(poly_ntt.get(), tables);
+
+                // Applying a Galois automorphism in NTT form must commute with the NTT
+                for (uint64_t galois_elt = 1; galois_elt < 2 * static_cast<uint64_t>(coeff_count); galois_elt += 2)
+                {
+                    apply_galois(poly.get(), coeff_count_power, galois_elt, mod, expected.get());
+                    ntt_negacyclic_harvey(expected.get(), tables);
+                    apply_galois_ntt(poly_ntt.get(), coeff_count_power, galois_elt, result.get());
+                    for (int i = 0; i < coeff_count; i++)
+                    {
+                        Assert::AreEqual(expected[i], result[i]);
+                    }
+                }
+            }
         };
     }
 }
\ No newline at end of file
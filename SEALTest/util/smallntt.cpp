@@ -5,6 +5,8 @@
 #include "seal/util/smallntt.h"
 #include "seal/defaultparams.h"
 #include "seal/util/numth.h"
+#include "seal/util/cpufeatures.h"
+#include "seal/util/globals.h"
 #include <random>
 #include <cstdint>
 
@@ -132,6 +134,74 @@ namespace SEALTest
                     Assert::AreEqual(temp[i], poly[i]);
                 }
             }
+
+            TEST_METHOD(NegacyclicSmallNTTSIMDTest)
+            {
+                MemoryPoolHandle pool = MemoryPoolHandle::Global();
+                SmallNTTTables tables(pool);
+
+                int coeff_count_power = 10;
+                int coeff_count = 1 << coeff_count_power;
+                Pointer poly(allocate_poly(coeff_count, 1, pool));
+                Pointer expected(allocate_poly(coeff_count, 1, pool));
+                Pointer input(allocate_poly(coeff_count, 1, pool));
+
+                // The vectorized kernels must produce exactly the same lazy output as the scalar code
+                vector<SmallModulus> moduli{ small_mods_30bit(0), small_mods_60bit(0), 
+                    global_variables::internal_mods::aux_small_mods[0] };
+                SIMDLevel cpu_level = get_cpu_simd_level();
+                random_device rd;
+                for (auto &modulus : moduli)
+                {
+                    tables.generate(coeff_count_power, modulus);
+                    for (int i = 0; i < coeff_count; i++)
+                    {
+                        input[i] = ((static_cast<uint64_t>(rd()) << 32) | rd()) % modulus.value();
+                    }
+                    for (int level = static_cast<int>(SIMDLevel::avx2); level <= static_cast<int>(cpu_level); level++)
+                    {
+                        set_max_simd_level(SIMDLevel::none);
+                        set_uint_uint(input.get(), coeff_count, expected.get());
+                        ntt_negacyclic_harvey_lazy(expected.get(), tables);
+                        set_max_simd_level(static_cast<SIMDLevel>(level));
+                        set_uint_uint(input.get(), coeff_count, poly.get());
+                        ntt_negacyclic_harvey_lazy(poly.get(), tables);
+                        for (int i = 0; i < coeff_count; i++)
+                        {
+                            Assert::AreEqual(expected[i], poly[i]);
+                        }
+
+                        set_max_simd_level(SIMDLevel::none);
+                        inverse_ntt_negacyclic_harvey_lazy(expected.get(), tables);
+                        set_max_simd_level(static_cast<SIMDLevel>(level));
+                        inverse_ntt_negacyclic_harvey_lazy(poly.get(), tables);
+                        for (int i = 0; i < coeff_count; i++)
+                        {
+                            Assert::AreEqual(expected[i], poly[i]);
+                        }
+                    }
+                }
+                set_max_simd_level(SIMDLevel::avx512f);
+            }
+
+            TEST_METHOD(SmallNTTSIMDDispatch)
+            {
+                // The kernels must be compiled in and selected whenever the processor has AVX2,
+                // so that a misconfigured build cannot silently fall back to the scalar code
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx2"))
+                {
+                    Assert::IsTrue(get_cpu_simd_level() >= SIMDLevel::avx2);
+                    set_max_simd_level(SIMDLevel::avx2);
+                    Assert::IsTrue(get_simd_level() == SIMDLevel::avx2);
+                    Assert::IsTrue(get_ntt_simd_level() == SIMDLevel::avx2);
+                }
+#endif
+                set_max_simd_level(SIMDLevel::none);
+                Assert::IsTrue(get_ntt_simd_level() == SIMDLevel::none);
+                set_max_simd_level(SIMDLevel::avx512f);
+            }
         };
     }
-}
\ No newline at end of file
+}
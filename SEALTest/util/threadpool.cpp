@@ -0,0 +1,94 @@
+#include "CppUnitTest.h"
+#include "seal/util/threadpool.h"
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+    namespace util
+    {
+        TEST_CLASS(ThreadPoolTests)
+        {
+        public:
+            TEST_METHOD(ThreadPoolParallelFor)
+            {
+                ThreadPool pool(4);
+                Assert::AreEqual(4, pool.thread_count());
+                Assert::AreEqual(4, pool.max_concurrency());
+
+                vector<int> values(1000, 0);
+                pool.parallel_for(static_cast<int>(values.size()), [&](int i) {
+                    values[i] += i;
+                });
+                for (int i = 0; i < static_cast<int>(values.size()); i++)
+                {
+                    Assert::AreEqual(i, values[i]);
+                }
+
+                // Nothing to do
+                pool.parallel_for(0, [&](int i) {
+                    values[i] = -1;
+                });
+                Assert::AreEqual(0, values[0]);
+
+                // Nested calls run inline
+                atomic<int> count(0);
+                pool.parallel_for(8, [&](int i) {
+                    pool.parallel_for(8, [&](int j) {
+                        count.fetch_add(1);
+                    });
+                });
+                Assert::AreEqual(64, count.load());
+
+                pool.set_max_concurrency(1);
+                Assert::AreEqual(1, pool.max_concurrency());
+                pool.parallel_for(static_cast<int>(values.size()), [&](int i) {
+                    values[i] += i;
+                });
+                for (int i = 0; i < static_cast<int>(values.size()); i++)
+                {
+                    Assert::AreEqual(2 * i, values[i]);
+                }
+            }
+
+            TEST_METHOD(ThreadPoolException)
+            {
+                ThreadPool pool(3);
+                atomic<int> count(0);
+                bool caught = false;
+                try
+                {
+                    pool.parallel_for(100, [&](int i) {
+                        count.fetch_add(1);
+                        if (i == 50)
+                        {
+                            throw logic_error("task failed");
+                        }
+                    });
+                }
+                catch (const logic_error &)
+                {
+                    caught = true;
+                }
+                Assert::IsTrue(caught);
+                Assert::AreEqual(100, count.load());
+
+                bool invalid = false;
+                try
+                {
+                    ThreadPool invalid_pool(0);
+                }
+                catch (const invalid_argument &)
+                {
+                    invalid = true;
+                }
+                Assert::IsTrue(invalid);
+            }
+        };
+    }
+}
@@ -212,6 +212,38 @@ namespace SEALTest
                 Assert::AreEqual(1ULL, multiply_uint_uint_mod(4611686018427289600ULL, 4611686018427289600ULL, mod));
             }
 
+            TEST_METHOD(MultiplyUIntScaledSmallMod)
+            {
+                SmallModulus mod(2);
+                Assert::AreEqual(0ULL, scale_uint_mod(0, mod));
+                Assert::AreEqual(9223372036854775808ULL, scale_uint_mod(1, mod));
+                Assert::AreEqual(0ULL, multiply_uint_scaled_mod(0, 1, scale_uint_mod(1, mod), mod));
+                Assert::AreEqual(1ULL, multiply_uint_scaled_mod(1, 1, scale_uint_mod(1, mod), mod));
+                Assert::AreEqual(0ULL, multiply_uint_scaled_mod(1, 0, scale_uint_mod(0, mod), mod));
+
+                mod = 10;
+                Assert::AreEqual(12912720851596686131ULL, scale_uint_mod(7, mod));
+                Assert::AreEqual(9ULL, multiply_uint_scaled_mod(7, 7, scale_uint_mod(7, mod), mod));
+                Assert::AreEqual(2ULL, multiply_uint_scaled_mod(6, 7, scale_uint_mod(7, mod), mod));
+                Assert::AreEqual(2ULL, multiply_uint_scaled_mod(7, 6, scale_uint_mod(6, mod), mod));
+
+                // The first operand does not need to be reduced
+                Assert::AreEqual(5ULL, multiply_uint_scaled_mod(0xFFFFFFFFFFFFFFFFULL, 1, scale_uint_mod(1, mod), mod));
+                Assert::AreEqual(8ULL, multiply_uint_scaled_mod(0xFFFFFFFFFFFFFFFEULL, 7, scale_uint_mod(7, mod), mod));
+
+                mod = 4611686018427289601ULL;
+                uint64_t scaled = scale_uint_mod(2305843009213644801ULL, mod);
+                Assert::AreEqual(1152921504606822400ULL, multiply_uint_scaled_mod(2305843009213644800ULL, 2305843009213644801ULL, scaled, mod));
+                Assert::AreEqual(3458764513820467201ULL, multiply_uint_scaled_mod(2305843009213644801ULL, 2305843009213644801ULL, scaled, mod));
+                scaled = scale_uint_mod(4611686018427289600ULL, mod);
+                Assert::AreEqual(1ULL, multiply_uint_scaled_mod(4611686018427289600ULL, 4611686018427289600ULL, scaled, mod));
+                for (uint64_t operand = 0xFFFFFFFFFFFFFFFFULL; operand > 0xFFFFFFFFFFFFFF00ULL; operand--)
+                {
+                    Assert::AreEqual(multiply_uint_uint_mod(operand % mod.value(), 4611686018427289600ULL, mod),
+                        multiply_uint_scaled_mod(operand, 4611686018427289600ULL, scaled, mod));
+                }
+            }
+
             TEST_METHOD(ModuloUIntSmallMod)
             {
                 MemoryPool &pool = *global_variables::global_memory_pool;